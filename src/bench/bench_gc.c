@@ -0,0 +1,161 @@
+/* Benchmark : Garbage Collection
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Builds large object graphs, keeps them alive through a global
+ * variable and measures a major collection that marks everything,
+ * followed by one that sweeps everything */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "multiple_err.h"
+#include "vm_startup.h"
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "vm_gc.h"
+#include "vm_err.h"
+
+const char **g_argv;
+int g_argc;
+
+#define BENCH_GC_FLAT_SIZE (1000 * 1000)
+#define BENCH_GC_DEEP_DEPTH (1000 * 1000)
+#define BENCH_GC_TREE_DEPTH 20
+
+static double bench_gc_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+/* A list of 'size' one-element lists */
+static struct virtual_machine_object *bench_gc_build_flat(struct virtual_machine *vm, size_t size)
+{
+    struct virtual_machine_object *object_list, *object_sub, *object_int;
+    size_t idx;
+
+    /* Appended objects are taken over by the list */
+    object_list = virtual_machine_object_list_new(vm);
+    for (idx = 0; idx != size; idx++)
+    {
+        object_sub = virtual_machine_object_list_new(vm);
+        object_int = virtual_machine_object_int_new_with_value(vm, (int)idx);
+        virtual_machine_object_list_append(vm, object_sub, object_int);
+        virtual_machine_object_list_append(vm, object_list, object_sub);
+    }
+
+    return object_list;
+}
+
+/* Lists nested 'depth' levels */
+static struct virtual_machine_object *bench_gc_build_deep(struct virtual_machine *vm, size_t depth)
+{
+    struct virtual_machine_object *object_cur, *object_parent;
+    size_t idx;
+
+    object_cur = virtual_machine_object_list_new(vm);
+    for (idx = 0; idx != depth; idx++)
+    {
+        object_parent = virtual_machine_object_list_new(vm);
+        virtual_machine_object_list_append(vm, object_parent, object_cur);
+        object_cur = object_parent;
+    }
+
+    return object_cur;
+}
+
+/* Complete binary tree of two-element lists */
+static struct virtual_machine_object *bench_gc_build_tree(struct virtual_machine *vm, size_t depth)
+{
+    struct virtual_machine_object *object_node, *object_left, *object_right;
+
+    object_node = virtual_machine_object_list_new(vm);
+    if (depth == 0) return object_node;
+
+    object_left = bench_gc_build_tree(vm, depth - 1);
+    object_right = bench_gc_build_tree(vm, depth - 1);
+    virtual_machine_object_list_append(vm, object_node, object_left);
+    virtual_machine_object_list_append(vm, object_node, object_right);
+
+    return object_node;
+}
+
+static int bench_gc_run(struct virtual_machine *vm, const char *name, \
+        struct virtual_machine_object *object_root)
+{
+    struct virtual_machine_object *object_none;
+    double time_start, time_mark, time_sweep;
+
+    virtual_machine_variable_list_append_with_configure(vm, vm->variables_global, 0, 0, object_root);
+    virtual_machine_object_destroy(vm, object_root);
+
+    /* Everything reachable */
+    time_start = bench_gc_now();
+    virtual_machine_garbage_collect(vm);
+    time_mark = bench_gc_now() - time_start;
+
+    /* Nothing reachable */
+    object_none = virtual_machine_object_int_new_with_value(vm, 0);
+    virtual_machine_variable_list_update_with_configure(vm, vm->variables_global, 0, 0, object_none);
+    virtual_machine_object_destroy(vm, object_none);
+    time_start = bench_gc_now();
+    virtual_machine_garbage_collect(vm);
+    time_sweep = bench_gc_now() - time_start;
+
+    printf("%-8s mark %10.2f ms  sweep %10.2f ms\n", name, time_mark, time_sweep);
+
+    return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+    struct virtual_machine_startup startup;
+    struct vm_err r;
+    struct virtual_machine *vm;
+
+    g_argc = argc;
+    g_argv = argv;
+
+    virtual_machine_startup_init(&startup);
+    vm_err_clear(&r);
+    if ((vm = virtual_machine_new(&startup, &r)) == NULL)
+    {
+        fprintf(stderr, "error: failed to create virtual machine\n");
+        return 1;
+    }
+    /* Objects are built outside of any running program */
+    if ((vm->tp = virtual_machine_thread_new(vm)) == NULL)
+    {
+        fprintf(stderr, "error: failed to create thread\n");
+        virtual_machine_destroy(vm, 1);
+        return 1;
+    }
+
+    bench_gc_run(vm, "flat", bench_gc_build_flat(vm, BENCH_GC_FLAT_SIZE));
+    bench_gc_run(vm, "deep", bench_gc_build_deep(vm, BENCH_GC_DEEP_DEPTH));
+    bench_gc_run(vm, "tree", bench_gc_build_tree(vm, BENCH_GC_TREE_DEPTH));
+
+    virtual_machine_destroy(vm, 0);
+
+    return 0;
+}
+
@@ -0,0 +1,686 @@
+/* Benchmark : Virtual Machine Workloads
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* A fixed set of workloads assembled directly into IR, so the numbers
+ * don't depend on any frontend. Each workload runs in a process of its
+ * own for a clean peak memory figure, and a line is printed for it:
+ *
+ * <name> runs <n>  median <ms> ms  min <ms> ms  max <ms> ms  peak <kb> KB
+ *
+ * Usage: bench_vm [-n <runs>] [<workload> ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "multiple_err.h"
+#include "multiple_ir.h"
+#include "multiple_tunnel.h"
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm.h"
+
+const char **g_argv;
+int g_argc;
+
+#define BENCH_VM_RUNS_DEFAULT 5
+#define BENCH_VM_RUNS_MAX 100
+
+#define BENCH_VM_NUMERIC_COUNT (1000 * 1000)
+#define BENCH_VM_FIB_N 24
+#define BENCH_VM_STRING_OUTER 200
+#define BENCH_VM_STRING_INNER 1000
+#define BENCH_VM_LIST_OUTER 200
+#define BENCH_VM_LIST_INNER 1000
+#define BENCH_VM_HASH_OUTER 50
+#define BENCH_VM_HASH_INNER 1000
+#define BENCH_VM_MESSAGE_COUNT (100 * 1000)
+#define BENCH_VM_METHOD_COUNT (200 * 1000)
+#define BENCH_VM_CLOSURE_COUNT (100 * 1000)
+#define BENCH_VM_LOAD_FUNCTIONS 5000
+
+static double bench_vm_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+}
+
+
+/* Assembling */
+
+static uint32_t bench_vm_data(struct multiple_ir *ir, \
+        enum multiple_ir_data_section_item_type type, int value, const char *str)
+{
+    struct multiple_ir_data_section_item *new_item;
+
+    new_item = multiple_ir_data_section_item_new(type);
+    new_item->id = (uint32_t)ir->data_section->size;
+    if (str != NULL)
+    {
+        new_item->u.value_str.len = strlen(str);
+        new_item->u.value_str.str = (char *)malloc(sizeof(char) * (strlen(str) + 1));
+        memcpy(new_item->u.value_str.str, str, strlen(str) + 1);
+        new_item->size = (uint32_t)strlen(str);
+    }
+    else
+    {
+        new_item->u.value_int = value;
+        new_item->size = sizeof(int);
+    }
+    multiple_ir_data_section_append(ir->data_section, new_item);
+
+    return new_item->id;
+}
+
+static uint32_t bench_vm_int(struct multiple_ir *ir, int value)
+{ return bench_vm_data(ir, MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT, value, NULL); }
+
+/* Identifiers are looked up by name, the first one is reused */
+static uint32_t bench_vm_id(struct multiple_ir *ir, const char *name)
+{
+    struct multiple_ir_data_section_item *item_cur;
+
+    item_cur = ir->data_section->begin;
+    while (item_cur != NULL)
+    {
+        if ((item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER) && \
+                (strcmp(item_cur->u.value_str.str, name) == 0))
+        { return item_cur->id; }
+        item_cur = item_cur->next;
+    }
+
+    return bench_vm_data(ir, MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER, 0, name);
+}
+
+static uint32_t bench_vm_str(struct multiple_ir *ir, const char *str)
+{ return bench_vm_data(ir, MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_STR, 0, str); }
+
+/* The pc of the next instrument */
+static uint32_t bench_vm_pc(struct multiple_ir *ir)
+{ return (uint32_t)ir->text_section->size; }
+
+/* The returned instrument is for patching forward jumps */
+static struct multiple_ir_text_section_item *bench_vm_ins(struct multiple_ir *ir, \
+        uint32_t opcode, uint32_t operand)
+{
+    struct multiple_ir_text_section_item *new_item;
+    struct multiple_ir_debug_section_item *new_debug_item;
+
+    new_debug_item = multiple_ir_debug_section_item_new();
+    new_debug_item->line_number_asm = bench_vm_pc(ir);
+    new_debug_item->line_number_source_start = bench_vm_pc(ir) + 1;
+    new_debug_item->line_number_source_end = bench_vm_pc(ir) + 1;
+    multiple_ir_debug_section_append(ir->debug_section, new_debug_item);
+
+    new_item = multiple_ir_text_section_item_new();
+    new_item->opcode = opcode;
+    new_item->operand = operand;
+    multiple_ir_text_section_append(ir->text_section, new_item);
+
+    return new_item;
+}
+
+static void bench_vm_export(struct multiple_ir *ir, const char *name, uint32_t pc)
+{
+    struct multiple_ir_export_section_item *new_item;
+
+    new_item = multiple_ir_export_section_item_new();
+    new_item->name = bench_vm_id(ir, name);
+    new_item->instrument_number = pc;
+    multiple_ir_export_section_append(ir->export_section, new_item);
+}
+
+/* var = var + 1 */
+static void bench_vm_inc(struct multiple_ir *ir, uint32_t var, uint32_t one)
+{
+    bench_vm_ins(ir, OP_PUSH, var);
+    bench_vm_ins(ir, OP_PUSH, one);
+    bench_vm_ins(ir, OP_ADD, 0);
+    bench_vm_ins(ir, OP_POP, var);
+}
+
+/* Back to 'pc' while var < limit */
+static void bench_vm_loop(struct multiple_ir *ir, uint32_t var, uint32_t limit, uint32_t pc)
+{
+    bench_vm_ins(ir, OP_PUSH, var);
+    bench_vm_ins(ir, OP_PUSH, limit);
+    bench_vm_ins(ir, OP_L, 0);
+    bench_vm_ins(ir, OP_JMPC, pc);
+}
+
+static struct multiple_ir *bench_vm_ir_new(void)
+{
+    struct multiple_ir *ir = multiple_ir_new();
+
+    ir->filename_len = strlen("bench.mp");
+    ir->filename = (char *)malloc(sizeof(char) * (ir->filename_len + 1));
+    memcpy(ir->filename, "bench.mp", ir->filename_len + 1);
+    ir->module_section->name = bench_vm_id(ir, "bench");
+    ir->module_section->enabled = 1;
+
+    return ir;
+}
+
+
+/* Workloads */
+
+/* Integer arithmetic in a counting loop */
+static struct multiple_ir *bench_vm_build_numeric(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i0 = bench_vm_int(ir, 0), i1 = bench_vm_int(ir, 1), i7 = bench_vm_int(ir, 7);
+    uint32_t count = bench_vm_int(ir, BENCH_VM_NUMERIC_COUNT);
+    uint32_t i = bench_vm_id(ir, "i"), s = bench_vm_id(ir, "s");
+    uint32_t pc_loop;
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, s);
+    pc_loop = bench_vm_pc(ir);
+    /* s = (s ^ i) + i % 7 */
+    bench_vm_ins(ir, OP_PUSH, s);
+    bench_vm_ins(ir, OP_PUSH, i);
+    bench_vm_ins(ir, OP_XORA, 0);
+    bench_vm_ins(ir, OP_PUSH, i);
+    bench_vm_ins(ir, OP_PUSH, i7);
+    bench_vm_ins(ir, OP_MOD, 0);
+    bench_vm_ins(ir, OP_ADD, 0);
+    bench_vm_ins(ir, OP_POP, s);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, count, pc_loop);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+/* Naive Fibonacci */
+static struct multiple_ir *bench_vm_build_recursion(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i1 = bench_vm_int(ir, 1), i2 = bench_vm_int(ir, 2);
+    uint32_t fib_n = bench_vm_int(ir, BENCH_VM_FIB_N);
+    uint32_t n = bench_vm_id(ir, "n"), r = bench_vm_id(ir, "r");
+    uint32_t pc_fib;
+    struct multiple_ir_text_section_item *jmp_base;
+
+    pc_fib = bench_vm_pc(ir);
+    bench_vm_export(ir, "fib", pc_fib);
+    bench_vm_ins(ir, OP_ARG, n);
+    bench_vm_ins(ir, OP_PUSH, n);
+    bench_vm_ins(ir, OP_PUSH, i2);
+    bench_vm_ins(ir, OP_L, 0);
+    jmp_base = bench_vm_ins(ir, OP_JMPC, 0);
+    bench_vm_ins(ir, OP_PUSH, n);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_SUB, 0);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_NFUNCMK, pc_fib);
+    bench_vm_ins(ir, OP_CALL, 0);
+    bench_vm_ins(ir, OP_PUSH, n);
+    bench_vm_ins(ir, OP_PUSH, i2);
+    bench_vm_ins(ir, OP_SUB, 0);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_NFUNCMK, pc_fib);
+    bench_vm_ins(ir, OP_CALL, 0);
+    bench_vm_ins(ir, OP_ADD, 0);
+    bench_vm_ins(ir, OP_RETURN, 0);
+    jmp_base->operand = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, n);
+    bench_vm_ins(ir, OP_RETURN, 0);
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, fib_n);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_NFUNCMK, pc_fib);
+    bench_vm_ins(ir, OP_CALL, 0);
+    bench_vm_ins(ir, OP_POP, r);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+/* Growing strings by concatenation */
+static struct multiple_ir *bench_vm_build_string(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i0 = bench_vm_int(ir, 0), i1 = bench_vm_int(ir, 1);
+    uint32_t outer = bench_vm_int(ir, BENCH_VM_STRING_OUTER);
+    uint32_t inner = bench_vm_int(ir, BENCH_VM_STRING_INNER);
+    uint32_t str_init = bench_vm_str(ir, "s"), str_piece = bench_vm_str(ir, "ab");
+    uint32_t i = bench_vm_id(ir, "i"), j = bench_vm_id(ir, "j"), s = bench_vm_id(ir, "s");
+    uint32_t pc_outer, pc_inner;
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, j);
+    pc_outer = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, str_init); bench_vm_ins(ir, OP_POP, s);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    pc_inner = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, s);
+    bench_vm_ins(ir, OP_PUSH, str_piece);
+    bench_vm_ins(ir, OP_ADD, 0);
+    bench_vm_ins(ir, OP_POP, s);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, inner, pc_inner);
+    bench_vm_inc(ir, j, i1);
+    bench_vm_loop(ir, j, outer, pc_outer);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+/* Lists built by appending and dropped */
+static struct multiple_ir *bench_vm_build_list(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i0 = bench_vm_int(ir, 0), i1 = bench_vm_int(ir, 1);
+    uint32_t outer = bench_vm_int(ir, BENCH_VM_LIST_OUTER);
+    uint32_t inner = bench_vm_int(ir, BENCH_VM_LIST_INNER);
+    uint32_t i = bench_vm_id(ir, "i"), j = bench_vm_id(ir, "j"), l = bench_vm_id(ir, "l");
+    uint32_t pc_outer, pc_inner;
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, j);
+    pc_outer = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_LSTMK, 0); bench_vm_ins(ir, OP_POP, l);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    pc_inner = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, i);
+    bench_vm_ins(ir, OP_PUSH, l);
+    bench_vm_ins(ir, OP_LSTADD, 0);
+    bench_vm_ins(ir, OP_POP, l);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, inner, pc_inner);
+    bench_vm_inc(ir, j, i1);
+    bench_vm_loop(ir, j, outer, pc_outer);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+/* Hashes filled, then looked up by every key */
+static struct multiple_ir *bench_vm_build_hash(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i0 = bench_vm_int(ir, 0), i1 = bench_vm_int(ir, 1);
+    uint32_t outer = bench_vm_int(ir, BENCH_VM_HASH_OUTER);
+    uint32_t inner = bench_vm_int(ir, BENCH_VM_HASH_INNER);
+    uint32_t i = bench_vm_id(ir, "i"), j = bench_vm_id(ir, "j"), h = bench_vm_id(ir, "h");
+    uint32_t pc_outer, pc_add, pc_get;
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, j);
+    pc_outer = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_HASHMK, 0); bench_vm_ins(ir, OP_POP, h);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    pc_add = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, j); /* Value */
+    bench_vm_ins(ir, OP_PUSH, i); /* Key */
+    bench_vm_ins(ir, OP_PUSH, h);
+    bench_vm_ins(ir, OP_HASHADD, 0);
+    bench_vm_ins(ir, OP_POP, h);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, inner, pc_add);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    pc_get = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, i);
+    bench_vm_ins(ir, OP_PUSH, h);
+    bench_vm_ins(ir, OP_REFGET, 0);
+    bench_vm_ins(ir, OP_DROP, 0);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, inner, pc_get);
+    bench_vm_inc(ir, j, i1);
+    bench_vm_loop(ir, j, outer, pc_outer);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+/* A forked thread receiving every message sent by the main thread */
+static struct multiple_ir *bench_vm_build_message(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i0 = bench_vm_int(ir, 0), i1 = bench_vm_int(ir, 1);
+    uint32_t count = bench_vm_int(ir, BENCH_VM_MESSAGE_COUNT);
+    uint32_t i = bench_vm_id(ir, "i"), t = bench_vm_id(ir, "t");
+    uint32_t pc_send, pc_receive;
+    struct multiple_ir_text_section_item *jmp_child, *jmp_empty;
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    bench_vm_ins(ir, OP_TFK, 0);
+    bench_vm_ins(ir, OP_POP, t);
+    bench_vm_ins(ir, OP_PUSH, t);
+    bench_vm_ins(ir, OP_TYPEP, OBJECT_TYPE_NONE);
+    jmp_child = bench_vm_ins(ir, OP_JMPC, 0);
+
+    /* Sender */
+    pc_send = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, i);
+    bench_vm_ins(ir, OP_PUSH, t);
+    bench_vm_ins(ir, OP_TSENDMSG, 0);
+    bench_vm_ins(ir, OP_DROP, 0);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, count, pc_send);
+    bench_vm_ins(ir, OP_PUSH, t);
+    bench_vm_ins(ir, OP_TWAIT, 0);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    /* Receiver */
+    jmp_child->operand = bench_vm_pc(ir);
+    pc_receive = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_TRECVMSG, 0);
+    bench_vm_ins(ir, OP_TYPEP, OBJECT_TYPE_NONE);
+    jmp_empty = bench_vm_ins(ir, OP_JMPC, 0);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, count, pc_receive);
+    bench_vm_ins(ir, OP_TEXIT, 0);
+    jmp_empty->operand = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_TYIELD, 0);
+    bench_vm_ins(ir, OP_JMP, pc_receive);
+
+    return ir;
+}
+
+/* Methods of a class invoked on an instance */
+static struct multiple_ir *bench_vm_build_method(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i0 = bench_vm_int(ir, 0), i1 = bench_vm_int(ir, 1);
+    uint32_t count = bench_vm_int(ir, BENCH_VM_METHOD_COUNT);
+    uint32_t i = bench_vm_id(ir, "i"), s = bench_vm_id(ir, "s"), o = bench_vm_id(ir, "o");
+    uint32_t self = bench_vm_id(ir, "self");
+    uint32_t type_name = bench_vm_id(ir, "Counter");
+    uint32_t method_name = bench_vm_id(ir, "step");
+    uint32_t def_name = bench_vm_id(ir, "Counter_step");
+    uint32_t module_name = bench_vm_id(ir, "bench");
+    uint32_t pc_loop;
+
+    bench_vm_export(ir, "Counter_step", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_ARG, self);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_RETURN, 0);
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, type_name);
+    bench_vm_ins(ir, OP_CLSTYPEREG, 0);
+    bench_vm_ins(ir, OP_PUSH, method_name);
+    bench_vm_ins(ir, OP_PUSH, type_name);
+    bench_vm_ins(ir, OP_PUSH, def_name);
+    bench_vm_ins(ir, OP_PUSH, module_name);
+    bench_vm_ins(ir, OP_DOMAIN, 0);
+    bench_vm_ins(ir, OP_CLSMADD, 0);
+    bench_vm_ins(ir, OP_PUSH, type_name);
+    bench_vm_ins(ir, OP_CLSINSTMK, 0);
+    bench_vm_ins(ir, OP_POP, o);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, s);
+    pc_loop = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, i0); /* Arguments count */
+    bench_vm_ins(ir, OP_PUSH, method_name);
+    bench_vm_ins(ir, OP_PUSH, o);
+    bench_vm_ins(ir, OP_CLSMINVOKE, 0);
+    bench_vm_ins(ir, OP_FUNCMK, 0);
+    bench_vm_ins(ir, OP_CALL, 0);
+    bench_vm_ins(ir, OP_PUSH, s);
+    bench_vm_ins(ir, OP_ADD, 0);
+    bench_vm_ins(ir, OP_POP, s);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, count, pc_loop);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+/* A closure made and called in every iteration */
+static struct multiple_ir *bench_vm_build_closure(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i0 = bench_vm_int(ir, 0), i1 = bench_vm_int(ir, 1);
+    uint32_t count = bench_vm_int(ir, BENCH_VM_CLOSURE_COUNT);
+    uint32_t i = bench_vm_id(ir, "i"), s = bench_vm_id(ir, "s"), f = bench_vm_id(ir, "f");
+    uint32_t k = bench_vm_id(ir, "k"), x = bench_vm_id(ir, "x");
+    uint32_t pc_adder, pc_lambda, pc_loop;
+
+    /* (lambda (x) (+ k x)) */
+    pc_lambda = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_ARGC, x);
+    bench_vm_ins(ir, OP_PUSH, k);
+    bench_vm_ins(ir, OP_PUSH, x);
+    bench_vm_ins(ir, OP_ADD, 0);
+    bench_vm_ins(ir, OP_RETURN, 0);
+
+    /* (define (make-adder k) (lambda ...)) */
+    pc_adder = bench_vm_pc(ir);
+    bench_vm_export(ir, "make_adder", pc_adder);
+    bench_vm_ins(ir, OP_ARGC, k);
+    bench_vm_ins(ir, OP_LAMBDAMK, pc_lambda);
+    bench_vm_ins(ir, OP_RETURN, 0);
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, i);
+    bench_vm_ins(ir, OP_PUSH, i0); bench_vm_ins(ir, OP_POP, s);
+    pc_loop = bench_vm_pc(ir);
+    bench_vm_ins(ir, OP_PUSH, i);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_NFUNCMK, pc_adder);
+    bench_vm_ins(ir, OP_CALLC, 0);
+    bench_vm_ins(ir, OP_POP, f);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_PUSH, i1);
+    bench_vm_ins(ir, OP_PUSH, f);
+    bench_vm_ins(ir, OP_FUNCMK, 0);
+    bench_vm_ins(ir, OP_CALLC, 0);
+    bench_vm_ins(ir, OP_PUSH, s);
+    bench_vm_ins(ir, OP_ADD, 0);
+    bench_vm_ins(ir, OP_POP, s);
+    bench_vm_inc(ir, i, i1);
+    bench_vm_loop(ir, i, count, pc_loop);
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+/* A module of many small exported functions, main returns at once */
+static struct multiple_ir *bench_vm_build_load(void)
+{
+    struct multiple_ir *ir = bench_vm_ir_new();
+    uint32_t i1 = bench_vm_int(ir, 1);
+    uint32_t a = bench_vm_id(ir, "a");
+    char name[32];
+    int idx;
+
+    for (idx = 0; idx != BENCH_VM_LOAD_FUNCTIONS; idx++)
+    {
+        sprintf(name, "f%d", idx);
+        bench_vm_export(ir, name, bench_vm_pc(ir));
+        bench_vm_ins(ir, OP_ARG, a);
+        bench_vm_ins(ir, OP_PUSH, a);
+        bench_vm_ins(ir, OP_PUSH, bench_vm_int(ir, idx));
+        bench_vm_ins(ir, OP_ADD, 0);
+        bench_vm_ins(ir, OP_PUSH, i1);
+        bench_vm_ins(ir, OP_SUB, 0);
+        bench_vm_ins(ir, OP_RETURN, 0);
+    }
+
+    bench_vm_export(ir, "main", bench_vm_pc(ir));
+    bench_vm_ins(ir, OP_RETNONE, 0);
+
+    return ir;
+}
+
+struct bench_vm_workload
+{
+    const char *name;
+    struct multiple_ir *(*build)(void);
+};
+
+static const struct bench_vm_workload bench_vm_workloads[] =
+{
+    {"numeric", bench_vm_build_numeric},
+    {"recursion", bench_vm_build_recursion},
+    {"string", bench_vm_build_string},
+    {"list", bench_vm_build_list},
+    {"hash", bench_vm_build_hash},
+    {"message", bench_vm_build_message},
+    {"method", bench_vm_build_method},
+    {"closure", bench_vm_build_closure},
+    {"load", bench_vm_build_load},
+};
+#define BENCH_VM_WORKLOADS_COUNT (sizeof(bench_vm_workloads) / sizeof(struct bench_vm_workload))
+
+
+/* Running */
+
+static int bench_vm_time_cmp(const void *a, const void *b)
+{
+    double time_a = *(const double *)a, time_b = *(const double *)b;
+
+    return (time_a < time_b) ? -1 : ((time_a > time_b) ? 1 : 0);
+}
+
+/* In the forked process */
+static int bench_vm_run_child(const struct bench_vm_workload *workload, int runs)
+{
+    struct multiple_error *err;
+    struct multiple_stub_function_list *external_functions;
+    struct vm_err r;
+    struct virtual_machine_startup startup;
+    struct multiple_ir *ir;
+    struct rusage usage;
+    double times[BENCH_VM_RUNS_MAX];
+    double time_start;
+    int idx;
+
+    for (idx = 0; idx != runs; idx++)
+    {
+        if ((err = multiple_error_new()) == NULL) return 1;
+        if ((external_functions = multiple_stub_function_list_new()) == NULL)
+        {
+            multiple_error_destroy(err);
+            return 1;
+        }
+        if ((ir = workload->build()) == NULL)
+        {
+            multiple_stub_function_list_destroy(external_functions);
+            multiple_error_destroy(err);
+            return 1;
+        }
+        virtual_machine_startup_init(&startup);
+        vm_err_clear(&r);
+
+        time_start = bench_vm_now();
+        vm_run(err, &r, ir, &startup, 0, external_functions);
+        times[idx] = bench_vm_now() - time_start;
+
+        multiple_ir_destroy(ir);
+        multiple_stub_function_list_destroy(external_functions);
+        if ((multiple_error_occurred(err) != 0) || (vm_err_occurred(&r) != 0))
+        {
+            fprintf(stderr, "error: workload \'%s\' failed\n", workload->name);
+            if (multiple_error_occurred(err) != 0) multiple_error_print(err);
+            if (vm_err_occurred(&r) != 0) vm_err_print(&r);
+            multiple_error_destroy(err);
+            return 1;
+        }
+        multiple_error_destroy(err);
+    }
+
+    qsort(times, (size_t)runs, sizeof(double), bench_vm_time_cmp);
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%-10s runs %3d  median %10.2f ms  min %10.2f ms  max %10.2f ms  peak %8ld KB\n", \
+            workload->name, runs, times[runs / 2], times[0], times[runs - 1], \
+            (long)usage.ru_maxrss);
+    fflush(stdout);
+
+    return 0;
+}
+
+static int bench_vm_run(const struct bench_vm_workload *workload, int runs)
+{
+    pid_t pid;
+    int status;
+
+    fflush(stdout);
+    if ((pid = fork()) < 0)
+    {
+        fprintf(stderr, "error: failed to fork\n");
+        return -1;
+    }
+    if (pid == 0)
+    {
+        exit(bench_vm_run_child(workload, runs));
+    }
+    if (waitpid(pid, &status, 0) != pid) return -1;
+    if ((WIFEXITED(status) == 0) || (WEXITSTATUS(status) != 0)) return -1;
+
+    return 0;
+}
+
+int main(int argc, const char *argv[])
+{
+    int runs = BENCH_VM_RUNS_DEFAULT;
+    int arg_idx = 1, arg_first;
+    int failed = 0, selected;
+    size_t idx;
+
+    g_argc = argc;
+    g_argv = argv;
+
+    if ((argc >= 3) && (strcmp(argv[1], "-n") == 0))
+    {
+        runs = atoi(argv[2]);
+        if ((runs <= 0) || (runs > BENCH_VM_RUNS_MAX))
+        {
+            fprintf(stderr, "error: runs should be between 1 and %d\n", BENCH_VM_RUNS_MAX);
+            return 1;
+        }
+        arg_idx = 3;
+    }
+    arg_first = arg_idx;
+
+    for (idx = 0; idx != BENCH_VM_WORKLOADS_COUNT; idx++)
+    {
+        /* All of them when none is named */
+        selected = (arg_first == argc) ? 1 : 0;
+        for (arg_idx = arg_first; arg_idx < argc; arg_idx++)
+        {
+            if (strcmp(argv[arg_idx], bench_vm_workloads[idx].name) == 0) selected = 1;
+        }
+        if (selected == 0) continue;
+
+        if (bench_vm_run(&bench_vm_workloads[idx], runs) != 0)
+        {
+            printf("%-10s failed\n", bench_vm_workloads[idx].name);
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
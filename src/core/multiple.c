@@ -22,10 +22,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
 
 #include "multiple.h"
 #include "multiple_tunnel.h"
 #include "multiple_ir.h"
+#include "multiple_ir_opt.h"
 #include "multiple_asm.h"
 #include "multiple_bytecode.h"
 #include "multiple_err.h"
@@ -494,6 +496,7 @@ int multiple_stub_optimize_set(struct multiple_error *err, struct multiple_stub
     }
 
     stub->optimize = optimize;
+    stub->startup.optimize = optimize;
     ret = stub->frontend->optimize_set(stub->sub_stub, optimize);
 
     return ret;
@@ -576,6 +579,9 @@ int multiple_stub_asm_code_gen(struct multiple_error *err, struct multiple_stub
     }
 
     update_icode_pathname(stub->ir, stub->pathname, stub->pathname_len);
+    /* optimize */
+    if (stub->optimize > MULTIPLE_IR_OPT_LEVEL_NONE)
+    { if ((ret = multiple_ir_optimize(err, stub->ir, stub->optimize, NULL)) != 0) return ret; }
     /* work */
     if ((ret = multiple_asm_code_gen(err, stub->fp_out, stub->ir)) != 0) return ret;
 
@@ -603,6 +609,9 @@ int multiple_stub_bytecode(struct multiple_error *err, struct multiple_stub *stu
     }
 
     update_icode_pathname(stub->ir, stub->pathname, stub->pathname_len);
+    /* optimize */
+    if (stub->optimize > MULTIPLE_IR_OPT_LEVEL_NONE)
+    { if ((ret = multiple_ir_optimize(err, stub->ir, stub->optimize, NULL)) != 0) return ret; }
     /* work */
     if ((ret = multiple_bytecode_gen(err, stub->fp_out, stub->ir)) != 0) return ret;
 
@@ -736,6 +745,126 @@ int multiple_stub_virtual_machine_memory_usage(struct multiple_error *err, struc
     return 0;
 }
 
+int multiple_stub_virtual_machine_workers(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *workers)
+{
+    if (virtual_machine_startup_workers(&stub->startup, workers) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid number of workers");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_time_slice(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *time_slice, const char *time_slice_max)
+{
+    if (virtual_machine_startup_time_slice(&stub->startup, time_slice, time_slice_max) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid time slice");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_priority(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *priority)
+{
+    if (virtual_machine_startup_priority(&stub->startup, priority) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid priority");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_gc_slice(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *gc_slice)
+{
+    if (virtual_machine_startup_gc_slice(&stub->startup, gc_slice) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid gc slice");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_gc_threads(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *gc_threads)
+{
+    if (virtual_machine_startup_gc_threads(&stub->startup, gc_threads) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid number of gc threads");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_gc(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *gc)
+{
+    if (virtual_machine_startup_gc(&stub->startup, gc) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid gc policy");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_gc_generational(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *eden, const char *promote_age, const char *old_growth)
+{
+    if (virtual_machine_startup_gc_generational(&stub->startup, eden, promote_age, old_growth) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid generational gc option");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_heap_limit(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *heap_limit)
+{
+    if (virtual_machine_startup_heap_limit(&stub->startup, heap_limit) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid heap limit");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_block_cache(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *block_cache)
+{
+    if (virtual_machine_startup_block_cache(&stub->startup, block_cache) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid block cache threshold");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
+int multiple_stub_virtual_machine_sample_interval(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *sample_interval)
+{
+    if (virtual_machine_startup_sample_interval(&stub->startup, sample_interval) != 0)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: invalid sampling interval");
+        return -MULTIPLE_ERR_STUB;
+    }
+
+    return 0;
+}
+
 int multiple_stub_register(struct multiple_error *err, \
         struct multiple_stub *stub, \
         char *func_name, \
@@ -797,8 +926,16 @@ int multiple_stub_args_get_int(struct multiple_stub_function_args *args, int *pt
         ret = -MULTIPLE_ERR_VM;
         goto fail;
     }
+    if ((((struct virtual_machine_object_int *)(object_solved_arg->ptr))->value > INT_MAX) || \
+            (((struct virtual_machine_object_int *)(object_solved_arg->ptr))->value < INT_MIN))
+    {
+        vm_err_update(args->rail, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: invalid operand, integer out of the range of C 'int'");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
     /* Pick out value */
-    *ptr = ((struct virtual_machine_object_int *)(object_solved_arg->ptr))->value;
+    *ptr = (int)((struct virtual_machine_object_int *)(object_solved_arg->ptr))->value;
     /* Pop argument */
     virtual_machine_computing_stack_pop(args->vm, args->frame->computing_stack);
 
@@ -909,6 +1046,56 @@ done:
     return ret;
 }
 
+int multiple_stub_args_get_buffer(struct multiple_stub_function_args *args, unsigned char **data_p, size_t *size)
+{
+    int ret = 0;
+    char *bad_type_name;
+    struct virtual_machine_object *object_solved_arg = NULL; 
+
+    if (args->frame->computing_stack->size == 0)
+    {
+        vm_err_update(args->rail, -VM_ERR_COMPUTING_STACK_EMPTY, \
+                "runtime error: computing stack empty");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    if ((ret = virtual_machine_variable_solve(&object_solved_arg, (struct virtual_machine_object *)args->frame->computing_stack->top, NULL, 1, args->vm)) != 0)
+    { goto fail; }
+    if (vm_err_occurred(args->rail) != 0)
+    { goto fail; }
+
+    if (object_solved_arg->type != OBJECT_TYPE_BUFFER)
+    {
+        ret = virtual_machine_object_id_to_type_name(&bad_type_name, NULL, object_solved_arg->type);
+        vm_err_update(args->rail, -VM_ERR_INVALID_OPERAND_TYPE, \
+                "runtime error: invalid operand type, 'buffer' is expected, but '%s' is given", \
+                ret == 0 ? bad_type_name : "undefined type");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    /* No copy, the bytes are kept by the garbage collector, 
+     * and pinned till the function returns even if GIL is given up */
+    if (virtual_machine_thread_pin(args->vm, args->vm->tp, object_solved_arg) != 0)
+    {
+        multiple_stub_error_malloc(args);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    virtual_machine_object_buffer_data(object_solved_arg, data_p, size);
+    object_solved_arg = NULL;
+    /* Pop argument */
+    virtual_machine_computing_stack_pop(args->vm, args->frame->computing_stack);
+
+    ret = 0;
+    goto done;
+fail:
+done:
+    if (object_solved_arg != NULL) virtual_machine_object_destroy(args->vm, object_solved_arg);
+    return ret;
+}
+
 int multiple_stub_args_get_bool(struct multiple_stub_function_args *args, int *ptr)
 {
     int ret = 0;
@@ -993,7 +1180,8 @@ done:
     return ret;
 }
 
-int multiple_stub_args_get_raw(struct multiple_stub_function_args *args, const char *name, const size_t len, void **ptr)
+static int _multiple_stub_args_get_raw(struct multiple_stub_function_args *args, const char *name, const size_t len, void **ptr, \
+        int copy)
 {
     int ret = 0;
     char *bad_type_name;
@@ -1033,15 +1221,31 @@ int multiple_stub_args_get_raw(struct multiple_stub_function_args *args, const c
         goto fail;
     }
 
-    /* Clone a raw object (if will be freed after pop) */
-    new_ptr = object_raw->func_clone(object_raw->ptr);
-    if (new_ptr == NULL)
+    if ((copy == 0) && (object_raw->ptr_internal != NULL))
     {
-        multiple_stub_error_malloc(args);
-        ret = -MULTIPLE_ERR_VM;
-        goto fail;
+        /* Shared payload, kept by the garbage collector, 
+         * and pinned till the function returns even if GIL is given up */
+        if (virtual_machine_thread_pin(args->vm, args->vm->tp, object_solved_arg) != 0)
+        {
+            multiple_stub_error_malloc(args);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+        *ptr = object_raw->ptr;
+        object_solved_arg = NULL;
+    }
+    else
+    {
+        /* Clone a raw object (if will be freed after pop) */
+        new_ptr = object_raw->func_clone(object_raw->ptr);
+        if (new_ptr == NULL)
+        {
+            multiple_stub_error_malloc(args);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+        *ptr = new_ptr; new_ptr = NULL;
     }
-    *ptr = new_ptr; new_ptr = NULL;
 
     /* Pop argument */
     virtual_machine_computing_stack_pop(args->vm, args->frame->computing_stack);
@@ -1051,13 +1255,23 @@ int multiple_stub_args_get_raw(struct multiple_stub_function_args *args, const c
 fail:
     if (new_ptr != NULL) 
     {
-        if (object_raw != NULL) object_raw->func_clone(new_ptr);
+        if (object_raw != NULL) object_raw->func_destroy(new_ptr);
     }
 done:
     if (object_solved_arg != NULL) virtual_machine_object_destroy(args->vm, object_solved_arg);
     return ret;
 }
 
+int multiple_stub_args_get_raw(struct multiple_stub_function_args *args, const char *name, const size_t len, void **ptr)
+{
+    return _multiple_stub_args_get_raw(args, name, len, ptr, 0);
+}
+
+int multiple_stub_args_get_raw_copy(struct multiple_stub_function_args *args, const char *name, const size_t len, void **ptr)
+{
+    return _multiple_stub_args_get_raw(args, name, len, ptr, 1);
+}
+
 int multiple_stub_args_get_any(struct multiple_stub_function_args *args, char **name, size_t *len, void **ptr)
 {
     int ret = 0;
@@ -1232,6 +1446,59 @@ done:
     return ret;
 }
 
+int multiple_stub_return_buffer_new(struct multiple_stub_function_args *args, unsigned char **data_p, size_t size)
+{
+    int ret = 0;
+    struct virtual_machine_object *new_object = NULL, *object_pinned = NULL;
+
+    *data_p = NULL;
+
+    if (args->return_value != NULL) 
+    {
+        virtual_machine_object_destroy(args->vm, args->return_value);
+        args->return_value = NULL;
+    }
+    /* Allocated in the heap of the virtual machine, and counted in it */
+    if (((new_object = virtual_machine_object_buffer_new_with_size(args->vm, size)) == NULL) || \
+            ((object_pinned = virtual_machine_object_clone(args->vm, new_object)) == NULL))
+    {
+        multiple_stub_error_malloc(args);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    /* Filled in place by the callee, 
+     * pinned till the function returns even if GIL is given up */
+    if (virtual_machine_thread_pin(args->vm, args->vm->tp, object_pinned) != 0)
+    {
+        multiple_stub_error_malloc(args);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    object_pinned = NULL;
+    virtual_machine_object_buffer_data(new_object, data_p, &size);
+    args->return_value = new_object; new_object = NULL;
+
+    ret = 0;
+    goto done;
+fail:
+done:
+    if (object_pinned != NULL) virtual_machine_object_destroy(args->vm, object_pinned);
+    if (new_object != NULL) virtual_machine_object_destroy(args->vm, new_object);
+    return ret;
+}
+
+int multiple_stub_return_buffer(struct multiple_stub_function_args *args, void *data, size_t size)
+{
+    int ret;
+    unsigned char *data_buffer;
+
+    if ((ret = multiple_stub_return_buffer_new(args, &data_buffer, size)) == 0)
+    { memcpy(data_buffer, data, size); }
+    free(data);
+
+    return ret;
+}
+
 int multiple_stub_return_bool(struct multiple_stub_function_args *args, int value)
 {
     int ret = 0;
@@ -1318,6 +1585,14 @@ int multiple_stub_return_raw(struct multiple_stub_function_args *args, const cha
     new_object_raw->func_clone = data_type_target->func_clone;
     new_object_raw->func_destroy = data_type_target->func_destroy;
     new_object_raw->func_print = data_type_target->func_print;
+    new_object_raw->shared = data_type_target->shared;
+    if ((new_object_raw->shared != 0) && \
+            (virtual_machine_object_raw_share(args->vm, new_object) != 0))
+    {
+        multiple_stub_error_malloc(args);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
 
     args->return_value = new_object;
 
@@ -1403,6 +1678,7 @@ int multiple_stub_external_event_arg_push_raw(struct virtual_machine *vm, \
     new_object_raw->func_clone = data_type_target->func_clone;
     new_object_raw->func_destroy = data_type_target->func_destroy;
     new_object_raw->func_print = data_type_target->func_print;
+    new_object_raw->shared = data_type_target->shared;
 
     external_event_target = virtual_machine_external_event_list_lookup(vm, vm->external_events, id);
     if (external_event_target == NULL)
@@ -1509,6 +1785,21 @@ int virtual_machine_semaphore_value(struct virtual_machine *vm, uint32_t semapho
 }
 
 
+/* GIL */
+void *multiple_stub_gil_release(struct multiple_stub_function_args *args)
+{
+    return virtual_machine_native_section_enter(args->vm);
+}
+
+int multiple_stub_gil_acquire(struct multiple_stub_function_args *args, void *state)
+{
+    if (state == NULL) return -MULTIPLE_ERR_NULL_PTR;
+
+    return virtual_machine_native_section_leave(args->vm, \
+            (struct virtual_machine_native_section *)state);
+}
+
+
 /* Error Reporting */
 int multiple_stub_error(struct multiple_stub_function_args *args, int number, const char *fmt, ...)
 {
@@ -1681,3 +1972,19 @@ int multiple_stub_data_callback_eq_set(struct multiple_stub_function_args *args,
     return multiple_stub_data_callback_func_set(args, name, len, MULTIPLE_STUB_DATA_CALLBACK_FUNC_SET_EQ, func_eq);
 }
 
+int multiple_stub_data_shared_set(struct multiple_stub_function_args *args, const char *name, const size_t len, \
+        int shared)
+{
+    struct virtual_machine_data_type *data_type_target;
+
+    if ((__virtual_machine_data_type_list_lookup(&data_type_target, args->vm->data_types, name, len)) != 0)
+    {
+        vm_err_update(args->rail, -VM_ERR_DEFAULT, \
+                "runtime error: invalid data type \'%s\'", name);
+        return -MULTIPLE_ERR_VM;
+    }
+    data_type_target->shared = shared;
+
+    return 0;
+}
+
@@ -142,6 +142,28 @@ int multiple_stub_list_frontends(struct multiple_error *err);
 
 int multiple_stub_virtual_machine_memory_usage(struct multiple_error *err, struct multiple_stub *stub, \
         const char *mem_item, const char *mem_type, const char *mem_size);
+int multiple_stub_virtual_machine_workers(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *workers);
+int multiple_stub_virtual_machine_time_slice(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *time_slice, const char *time_slice_max);
+int multiple_stub_virtual_machine_priority(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *priority);
+int multiple_stub_virtual_machine_gc_slice(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *gc_slice);
+int multiple_stub_virtual_machine_gc_threads(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *gc_threads);
+int multiple_stub_virtual_machine_gc(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *gc);
+int multiple_stub_virtual_machine_gc_generational(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *eden, const char *promote_age, const char *old_growth);
+int multiple_stub_virtual_machine_heap_limit(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *heap_limit);
+
+int multiple_stub_virtual_machine_block_cache(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *block_cache);
+
+int multiple_stub_virtual_machine_sample_interval(struct multiple_error *err, struct multiple_stub *stub, \
+        const char *sample_interval);
 
 int multiple_stub_register(struct multiple_error *err, \
         struct multiple_stub *stub, \
@@ -166,6 +188,11 @@ int multiple_stub_data_callback_print_set(struct multiple_stub_function_args *ar
 int multiple_stub_data_callback_eq_set(struct multiple_stub_function_args *args, const char *name, const size_t len, \
         int (*func_eq)(const void *ptr_left, const void *ptr_right));
 
+/* Share the payload between the objects read from the same value, 
+ * 'func_destroy' is called once by the garbage collector */
+int multiple_stub_data_shared_set(struct multiple_stub_function_args *args, const char *name, const size_t len, \
+        int shared);
+
 /* Object Operations */
 int virtual_machine_object_print(const struct virtual_machine_object *object);
 struct virtual_machine_object *virtual_machine_object_clone(struct virtual_machine *vm, const struct virtual_machine_object *obj);
@@ -178,9 +205,16 @@ int virtual_machine_object_to_type_name(char **str_out, size_t *len_out, const s
 int multiple_stub_args_get_int(struct multiple_stub_function_args *args, int *ptr);
 int multiple_stub_args_get_float(struct multiple_stub_function_args *args, double *ptr);
 int multiple_stub_args_get_str(struct multiple_stub_function_args *args, char **str_p, size_t *str_len);
+/* Bytes of the buffer itself, writable and valid until the function returns 
+ * (even across multiple_stub_gil_release()) */
+int multiple_stub_args_get_buffer(struct multiple_stub_function_args *args, unsigned char **data_p, size_t *size);
 int multiple_stub_args_get_bool(struct multiple_stub_function_args *args, int *ptr);
 int multiple_stub_args_get_none(struct multiple_stub_function_args *args);
+/* The payload of a shared data type is borrowed and stays valid until the function returns 
+ * (even across multiple_stub_gil_release()), others are cloned and should be destroyed by the callee */
 int multiple_stub_args_get_raw(struct multiple_stub_function_args *args, const char *name, const size_t len, void **ptr);
+/* Always a clone of the payload */
+int multiple_stub_args_get_raw_copy(struct multiple_stub_function_args *args, const char *name, const size_t len, void **ptr);
 int multiple_stub_args_get_any(struct multiple_stub_function_args *args, char **name, size_t *len, void **ptr);
 int multiple_stub_args_get_semaphore(struct multiple_stub_function_args *args, uint32_t *semaphore_id);
 
@@ -188,6 +222,13 @@ int multiple_stub_args_get_semaphore(struct multiple_stub_function_args *args, u
 int multiple_stub_return_int(struct multiple_stub_function_args *args, int value);
 int multiple_stub_return_float(struct multiple_stub_function_args *args, double value);
 int multiple_stub_return_str(struct multiple_stub_function_args *args, char *str_p, size_t str_len);
+/* A zeroed buffer of 'size' bytes allocated in the virtual machine to be 
+ * returned, '*data_p' is written by the callee till it returns 
+ * (even across multiple_stub_gil_release()), no copy is made */
+int multiple_stub_return_buffer_new(struct multiple_stub_function_args *args, unsigned char **data_p, size_t size);
+/* 'data' should be allocated with malloc(), it's copied into the buffer and freed, 
+ * for bytes which can't be produced in place with multiple_stub_return_buffer_new() */
+int multiple_stub_return_buffer(struct multiple_stub_function_args *args, void *data, size_t size);
 int multiple_stub_return_bool(struct multiple_stub_function_args *args, int value);
 int multiple_stub_return_none(struct multiple_stub_function_args *args);
 int multiple_stub_return_raw(struct multiple_stub_function_args *args, const char *name, const size_t len, void *ptr);
@@ -208,6 +249,11 @@ int virtual_machine_semaphore_value(struct virtual_machine *vm, uint32_t semapho
 /* GIL */
 int virtual_machine_gil_lock(struct virtual_machine *vm);
 int virtual_machine_gil_unlock(struct virtual_machine *vm);
+/* Give up GIL during a long native operation and let a spare worker 
+ * (--vm-workers) run the other threads, objects of the virtual machine must not be 
+ * touched until the GIL is acquired back */
+void *multiple_stub_gil_release(struct multiple_stub_function_args *args);
+int multiple_stub_gil_acquire(struct multiple_stub_function_args *args, void *state);
 
 /* Error Reporting */
 int multiple_stub_error(struct multiple_stub_function_args *args, int number, const char *fmt, ...);
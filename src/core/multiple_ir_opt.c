@@ -0,0 +1,938 @@
+/* Multiple : Intermediate Representation Optimizer
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include "selfcheck.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "multiple_ir.h"
+#include "multiple_err.h"
+
+#include "vm_opcode.h"
+#include "multiple_ir_opt.h"
+
+/* Rounds of all the passes, stops earlier once nothing changes */
+#define MULTIPLE_IR_OPT_ROUNDS_MAX 8
+
+/* Kinds of operand referencing an instrument */
+#define MULTIPLE_IR_OPT_OFFSET_NONE 0
+#define MULTIPLE_IR_OPT_OFFSET_ABSOLUTE 1
+#define MULTIPLE_IR_OPT_OFFSET_RELATIVE 2
+
+struct multiple_ir_opt_instrument
+{
+    struct multiple_ir_text_section_item *item;
+
+    /* Instrument number referenced by the operand, relative ones resolved */
+    uint32_t target;
+
+    int removed;
+    /* Entered from somewhere other than the previous instrument,
+     * nothing before it could be combined with it */
+    int leader;
+    int reachable;
+};
+
+struct multiple_ir_opt
+{
+    struct multiple_ir *ir;
+
+    struct multiple_ir_opt_instrument *instruments;
+    size_t size;
+    int changed;
+
+    /* Data section items sorted by id, the ones appended by
+     * folding are not in it and are searched from 'data_appended' */
+    struct multiple_ir_data_section_item **data_items;
+    size_t data_items_size;
+    struct multiple_ir_data_section_item *data_appended;
+    uint32_t data_id_next;
+    int data_id_exhausted;
+
+    struct multiple_ir_opt_stats *stats;
+};
+
+/* Literal operand of folding */
+struct multiple_ir_opt_literal
+{
+    enum multiple_ir_data_section_item_type type;
+    int value;
+};
+
+
+/* Signed number representations, the same as the assembler uses */
+
+/* Sign and Magnitude to Complement */
+static uint32_t multiple_ir_opt_sam_to_cmp(int32_t num)
+{
+    if (num >= 0) { return (uint32_t)num; }
+    else
+    {
+        return (((uint32_t)(~(-num)))|(1u<<31)) + 1;
+    }
+}
+
+/* Complement to Sign and Magnitude */
+static int32_t multiple_ir_opt_cmp_to_sam(uint32_t num)
+{
+    int sign = (int)(num >> 31);
+    if (sign == 0) return (int32_t)num;
+    else
+    {
+        return -(~((int32_t)(num - 1)));
+    }
+}
+
+static int multiple_ir_opt_offset_kind(uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case OP_JMP:
+        case OP_JMPC:
+        case OP_RETURNTO:
+        case OP_TRAPSET:
+        case OP_NFUNCMK:
+        case OP_LAMBDAMK:
+        case OP_PROMMK:
+        case OP_CONTMK:
+            return MULTIPLE_IR_OPT_OFFSET_ABSOLUTE;
+        case OP_JMPR:
+        case OP_JMPCR:
+            return MULTIPLE_IR_OPT_OFFSET_RELATIVE;
+        default:
+            return MULTIPLE_IR_OPT_OFFSET_NONE;
+    }
+}
+
+#define MULTIPLE_IR_OPT_IS_JMP(opcode) (((opcode) == OP_JMP) || ((opcode) == OP_JMPR))
+#define MULTIPLE_IR_OPT_IS_JMPC(opcode) (((opcode) == OP_JMPC) || ((opcode) == OP_JMPCR))
+
+/* Never continues with the next instrument */
+static int multiple_ir_opt_is_terminator(uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case OP_JMP:
+        case OP_JMPR:
+        case OP_HALT:
+        case OP_RETURN:
+        case OP_RETNONE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+#define OPCODE_OF(opt, idx) ((opt)->instruments[idx].item->opcode)
+
+static size_t multiple_ir_opt_next_live(struct multiple_ir_opt *opt, size_t idx)
+{
+    idx++;
+    while ((idx < opt->size) && (opt->instruments[idx].removed != 0)) idx++;
+    return idx;
+}
+
+/* The first live instrument at or after 'idx' */
+static size_t multiple_ir_opt_live_at(struct multiple_ir_opt *opt, size_t idx)
+{
+    while ((idx < opt->size) && (opt->instruments[idx].removed != 0)) idx++;
+    return idx;
+}
+
+static void multiple_ir_opt_remove(struct multiple_ir_opt *opt, size_t idx)
+{
+    size_t idx_next;
+
+    opt->instruments[idx].removed = 1;
+    opt->changed = 1;
+
+    /* Whatever entered the removed one enters the next now */
+    if (opt->instruments[idx].leader != 0)
+    {
+        idx_next = multiple_ir_opt_next_live(opt, idx);
+        if (idx_next < opt->size) opt->instruments[idx_next].leader = 1;
+    }
+}
+
+/* Point an operand to another instrument */
+static void multiple_ir_opt_retarget(struct multiple_ir_opt *opt, size_t idx, uint32_t target)
+{
+    opt->instruments[idx].target = target;
+    if (target < opt->size) opt->instruments[target].leader = 1;
+    opt->changed = 1;
+}
+
+static void multiple_ir_opt_leaders_mark(struct multiple_ir_opt *opt)
+{
+    struct multiple_ir_export_section_item *export_section_item_cur;
+    size_t idx;
+
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        opt->instruments[idx].leader = 0;
+    }
+    opt->instruments[0].leader = 1;
+
+    if (opt->ir->export_section != NULL)
+    {
+        for (export_section_item_cur = opt->ir->export_section->begin; \
+                export_section_item_cur != NULL; \
+                export_section_item_cur = export_section_item_cur->next)
+        {
+            if ((export_section_item_cur->blank == 0) && \
+                    (export_section_item_cur->instrument_number < opt->size))
+            { opt->instruments[export_section_item_cur->instrument_number].leader = 1; }
+        }
+    }
+
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        if (multiple_ir_opt_offset_kind(OPCODE_OF(opt, idx)) == MULTIPLE_IR_OPT_OFFSET_NONE) continue;
+        if (opt->instruments[idx].target < opt->size)
+        { opt->instruments[opt->instruments[idx].target].leader = 1; }
+    }
+}
+
+
+/* Data Section */
+
+static int multiple_ir_opt_data_item_cmp(const void *a, const void *b)
+{
+    const struct multiple_ir_data_section_item *item_a = *((struct multiple_ir_data_section_item * const *)a);
+    const struct multiple_ir_data_section_item *item_b = *((struct multiple_ir_data_section_item * const *)b);
+
+    if (item_a->id < item_b->id) return -1;
+    else if (item_a->id > item_b->id) return 1;
+    return 0;
+}
+
+static int multiple_ir_opt_data_items_sort(struct multiple_error *err, struct multiple_ir_opt *opt)
+{
+    int ret = 0;
+    struct multiple_ir_data_section_item *data_section_item_cur;
+    size_t idx;
+
+    opt->data_items_size = opt->ir->data_section->size;
+    if (opt->data_items_size == 0) goto done;
+
+    if ((opt->data_items = (struct multiple_ir_data_section_item **)malloc( \
+                    sizeof(struct multiple_ir_data_section_item *) * opt->data_items_size)) == NULL)
+    { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+
+    idx = 0;
+    for (data_section_item_cur = opt->ir->data_section->begin; \
+            (data_section_item_cur != NULL) && (idx != opt->data_items_size); \
+            data_section_item_cur = data_section_item_cur->next)
+    {
+        opt->data_items[idx++] = data_section_item_cur;
+        if (data_section_item_cur->id == UINT32_MAX)
+        { opt->data_id_exhausted = 1; }
+        else if (data_section_item_cur->id >= opt->data_id_next)
+        { opt->data_id_next = data_section_item_cur->id + 1; }
+    }
+    opt->data_items_size = idx;
+
+    qsort(opt->data_items, opt->data_items_size, \
+            sizeof(struct multiple_ir_data_section_item *), \
+            &multiple_ir_opt_data_item_cmp);
+
+    goto done;
+fail:
+done:
+    return ret;
+}
+
+static struct multiple_ir_data_section_item *multiple_ir_opt_data_item_lookup( \
+        struct multiple_ir_opt *opt, uint32_t id)
+{
+    struct multiple_ir_data_section_item *data_section_item_cur;
+    size_t low = 0, high = opt->data_items_size, mid;
+
+    while (low < high)
+    {
+        mid = low + (high - low) / 2;
+        if (opt->data_items[mid]->id == id) return opt->data_items[mid];
+        else if (opt->data_items[mid]->id < id) low = mid + 1;
+        else high = mid;
+    }
+
+    for (data_section_item_cur = opt->data_appended; \
+            data_section_item_cur != NULL; \
+            data_section_item_cur = data_section_item_cur->next)
+    {
+        if (data_section_item_cur->id == id) return data_section_item_cur;
+    }
+
+    return NULL;
+}
+
+/* Literal pushed by 'PUSH <id>', returns 0 if it is not one to fold */
+static int multiple_ir_opt_literal_get(struct multiple_ir_opt *opt, \
+        struct multiple_ir_opt_literal *literal, uint32_t id)
+{
+    struct multiple_ir_data_section_item *data_section_item;
+
+    if ((data_section_item = multiple_ir_opt_data_item_lookup(opt, id)) == NULL) return 0;
+
+    switch (data_section_item->type)
+    {
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT:
+            literal->type = data_section_item->type;
+            literal->value = data_section_item->u.value_int;
+            return 1;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL:
+            if ((data_section_item->u.value_bool != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL_FALSE) && \
+                    (data_section_item->u.value_bool != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL_TRUE))
+            { return 0; }
+            literal->type = data_section_item->type;
+            literal->value = data_section_item->u.value_bool;
+            return 1;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_UNKNOWN:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NONE:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_FLOAT:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_CHAR:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NAN:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INF:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_STR:
+            return 0;
+    }
+
+    return 0;
+}
+
+/* Id of the literal in the data section, appended if not there yet */
+static int multiple_ir_opt_literal_id(struct multiple_error *err, struct multiple_ir_opt *opt, \
+        uint32_t *id_out, struct multiple_ir_opt_literal *literal)
+{
+    int ret = 0;
+    struct multiple_ir_data_section_item *data_section_item_cur;
+    struct multiple_ir_data_section_item *new_item = NULL;
+
+    for (data_section_item_cur = opt->ir->data_section->begin; \
+            data_section_item_cur != NULL; \
+            data_section_item_cur = data_section_item_cur->next)
+    {
+        if (data_section_item_cur->type != literal->type) continue;
+        if (((literal->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT) && \
+                    (data_section_item_cur->u.value_int == literal->value)) || \
+                ((literal->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL) && \
+                 (data_section_item_cur->u.value_bool == literal->value)))
+        { *id_out = data_section_item_cur->id; goto done; }
+    }
+
+    if (opt->data_id_exhausted != 0) { ret = 1; goto done; }
+
+    if ((new_item = multiple_ir_data_section_item_new(literal->type)) == NULL)
+    { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+    new_item->id = opt->data_id_next;
+    new_item->size = sizeof(int);
+    if (literal->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT) new_item->u.value_int = literal->value;
+    else new_item->u.value_bool = literal->value;
+    multiple_ir_data_section_append(opt->ir->data_section, new_item);
+    if (opt->data_appended == NULL) opt->data_appended = new_item;
+
+    if (opt->data_id_next == UINT32_MAX) opt->data_id_exhausted = 1;
+    else opt->data_id_next++;
+
+    *id_out = new_item->id;
+
+    goto done;
+fail:
+done:
+    return ret;
+}
+
+
+/* Constant Folding */
+
+#define MULTIPLE_IR_OPT_INT_FITS(value) (((value) >= (long long)INT_MIN) && ((value) <= (long long)INT_MAX))
+#define MULTIPLE_IR_OPT_BOOL(cond) ((cond) ? MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL_TRUE : MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL_FALSE)
+
+/* Returns 1 with the result if the vm would give the same without an error,
+ * anything overflowing or undefined is left to the runtime */
+static int multiple_ir_opt_fold_binary(struct multiple_ir_opt_literal *result, \
+        struct multiple_ir_opt_literal *left, struct multiple_ir_opt_literal *right, \
+        uint32_t opcode)
+{
+    long long value_left = left->value, value_right = right->value, value;
+
+    if (left->type != right->type) return 0;
+
+    if (left->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL)
+    {
+        result->type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL;
+        switch (opcode)
+        {
+            case OP_ANDL: result->value = MULTIPLE_IR_OPT_BOOL((value_left != 0) && (value_right != 0)); return 1;
+            case OP_ORL: result->value = MULTIPLE_IR_OPT_BOOL((value_left != 0) || (value_right != 0)); return 1;
+            case OP_XORL: result->value = MULTIPLE_IR_OPT_BOOL((value_left != 0) != (value_right != 0)); return 1;
+            case OP_EQ: result->value = MULTIPLE_IR_OPT_BOOL(value_left == value_right); return 1;
+            case OP_NE: result->value = MULTIPLE_IR_OPT_BOOL(value_left != value_right); return 1;
+            default: return 0;
+        }
+    }
+
+    /* int */
+    result->type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL;
+    switch (opcode)
+    {
+        case OP_EQ: result->value = MULTIPLE_IR_OPT_BOOL(value_left == value_right); return 1;
+        case OP_NE: result->value = MULTIPLE_IR_OPT_BOOL(value_left != value_right); return 1;
+        case OP_L: result->value = MULTIPLE_IR_OPT_BOOL(value_left < value_right); return 1;
+        case OP_G: result->value = MULTIPLE_IR_OPT_BOOL(value_left > value_right); return 1;
+        case OP_LE: result->value = MULTIPLE_IR_OPT_BOOL(value_left <= value_right); return 1;
+        case OP_GE: result->value = MULTIPLE_IR_OPT_BOOL(value_left >= value_right); return 1;
+        default: break;
+    }
+
+    switch (opcode)
+    {
+        case OP_ADD: value = value_left + value_right; break;
+        case OP_SUB: value = value_left - value_right; break;
+        case OP_MUL: value = value_left * value_right; break;
+        case OP_DIV:
+        case OP_MOD:
+            if (value_right == 0) return 0;
+            value = (opcode == OP_DIV) ? (value_left / value_right) : (value_left % value_right);
+            break;
+        case OP_LSHIFT:
+            if ((value_left < 0) || (value_right < 0) || (value_right >= 31)) return 0;
+            value = value_left << value_right;
+            break;
+        case OP_RSHIFT:
+            if ((value_left < 0) || (value_right < 0) || (value_right >= 32)) return 0;
+            value = value_left >> value_right;
+            break;
+        case OP_ANDA: value = (long long)(left->value & right->value); break;
+        case OP_ORA: value = (long long)(left->value | right->value); break;
+        case OP_XORA: value = (long long)(left->value ^ right->value); break;
+        default: return 0;
+    }
+    if (!MULTIPLE_IR_OPT_INT_FITS(value)) return 0;
+
+    result->type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT;
+    result->value = (int)value;
+    return 1;
+}
+
+static int multiple_ir_opt_fold_unary(struct multiple_ir_opt_literal *result, \
+        struct multiple_ir_opt_literal *operand, uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case OP_NEG:
+            if ((operand->type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT) || (operand->value == INT_MIN)) return 0;
+            result->type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT;
+            result->value = -operand->value;
+            return 1;
+        case OP_NOTA:
+            if (operand->type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT) return 0;
+            result->type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT;
+            result->value = ~operand->value;
+            return 1;
+        case OP_NOTL:
+            if (operand->type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL) return 0;
+            result->type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL;
+            result->value = MULTIPLE_IR_OPT_BOOL(operand->value == 0);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static int multiple_ir_opt_is_binary(uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+        case OP_LSHIFT: case OP_RSHIFT:
+        case OP_ANDA: case OP_ORA: case OP_XORA:
+        case OP_ANDL: case OP_ORL: case OP_XORL:
+        case OP_EQ: case OP_NE:
+        case OP_L: case OP_G: case OP_LE: case OP_GE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* 'PUSH a; PUSH b; <op>' into 'PUSH c', 'PUSH a; <op>' into 'PUSH c',
+ * 'PUSH true; JMPC l' into 'JMP l' and 'PUSH false; JMPC l' into nothing */
+static int multiple_ir_opt_pass_fold(struct multiple_error *err, struct multiple_ir_opt *opt)
+{
+    int ret = 0;
+    struct multiple_ir_opt_literal left, right, result;
+    size_t idx, idx_second, idx_third;
+    uint32_t opcode_second, id;
+
+    idx = 0;
+    while (idx < opt->size)
+    {
+        if ((opt->instruments[idx].removed != 0) || (OPCODE_OF(opt, idx) != OP_PUSH) || \
+                (multiple_ir_opt_literal_get(opt, &left, opt->instruments[idx].item->operand) == 0))
+        { idx++; continue; }
+
+        idx_second = multiple_ir_opt_next_live(opt, idx);
+        if ((idx_second >= opt->size) || (opt->instruments[idx_second].leader != 0)) { idx++; continue; }
+        opcode_second = OPCODE_OF(opt, idx_second);
+
+        if (MULTIPLE_IR_OPT_IS_JMPC(opcode_second))
+        {
+            if (left.type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL) { idx++; continue; }
+            if (left.value == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL_TRUE)
+            {
+                opt->instruments[idx].item->opcode = OP_JMP;
+                multiple_ir_opt_retarget(opt, idx, opt->instruments[idx_second].target);
+                multiple_ir_opt_remove(opt, idx_second);
+            }
+            else
+            {
+                multiple_ir_opt_remove(opt, idx);
+                multiple_ir_opt_remove(opt, idx_second);
+            }
+            if (opt->stats != NULL) opt->stats->folded++;
+            idx = idx_second + 1;
+            continue;
+        }
+
+        if (multiple_ir_opt_fold_unary(&result, &left, opcode_second) != 0)
+        {
+            if ((ret = multiple_ir_opt_literal_id(err, opt, &id, &result)) < 0) goto fail;
+            if (ret != 0) { ret = 0; idx++; continue; }
+            opt->instruments[idx].item->operand = id;
+            multiple_ir_opt_remove(opt, idx_second);
+            if (opt->stats != NULL) opt->stats->folded++;
+            /* The result could be folded further */
+            continue;
+        }
+
+        if ((opcode_second != OP_PUSH) || \
+                (multiple_ir_opt_literal_get(opt, &right, opt->instruments[idx_second].item->operand) == 0))
+        { idx++; continue; }
+        idx_third = multiple_ir_opt_next_live(opt, idx_second);
+        if ((idx_third >= opt->size) || (opt->instruments[idx_third].leader != 0) || \
+                (multiple_ir_opt_is_binary(OPCODE_OF(opt, idx_third)) == 0) || \
+                (multiple_ir_opt_fold_binary(&result, &left, &right, OPCODE_OF(opt, idx_third)) == 0))
+        { idx++; continue; }
+
+        if ((ret = multiple_ir_opt_literal_id(err, opt, &id, &result)) < 0) goto fail;
+        if (ret != 0) { ret = 0; idx++; continue; }
+        opt->instruments[idx].item->operand = id;
+        multiple_ir_opt_remove(opt, idx_second);
+        multiple_ir_opt_remove(opt, idx_third);
+        if (opt->stats != NULL) opt->stats->folded++;
+    }
+
+    goto done;
+fail:
+done:
+    return ret;
+}
+
+
+/* Jumps */
+
+/* Where a jump to 'target' ends up, through nops and unconditional jumps */
+static uint32_t multiple_ir_opt_jump_resolve(struct multiple_ir_opt *opt, uint32_t target)
+{
+    size_t steps = 0;
+
+    while ((target < opt->size) && (steps++ <= opt->size))
+    {
+        if ((opt->instruments[target].removed != 0) || (OPCODE_OF(opt, target) == OP_NOP))
+        { target++; }
+        else if (MULTIPLE_IR_OPT_IS_JMP(OPCODE_OF(opt, target)) && \
+                (opt->instruments[target].target != target))
+        { target = opt->instruments[target].target; }
+        else
+        { break; }
+    }
+
+    return target;
+}
+
+/* Nops, jumps to jumps, jumps to returns and jumps to the next instrument */
+static int multiple_ir_opt_pass_jumps(struct multiple_ir_opt *opt)
+{
+    size_t idx;
+    uint32_t opcode, target, opcode_target;
+
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        if ((opt->instruments[idx].removed == 0) && (OPCODE_OF(opt, idx) == OP_NOP))
+        { multiple_ir_opt_remove(opt, idx); }
+    }
+
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        if (opt->instruments[idx].removed != 0) continue;
+        opcode = OPCODE_OF(opt, idx);
+        if (multiple_ir_opt_offset_kind(opcode) == MULTIPLE_IR_OPT_OFFSET_NONE) continue;
+
+        if ((MULTIPLE_IR_OPT_IS_JMP(opcode) == 0) && (MULTIPLE_IR_OPT_IS_JMPC(opcode) == 0))
+        {
+            /* Entrances only skip the removed ones */
+            target = (uint32_t)multiple_ir_opt_live_at(opt, opt->instruments[idx].target);
+            if (target != opt->instruments[idx].target) multiple_ir_opt_retarget(opt, idx, target);
+            continue;
+        }
+
+        target = multiple_ir_opt_jump_resolve(opt, opt->instruments[idx].target);
+        if (target != opt->instruments[idx].target)
+        {
+            multiple_ir_opt_retarget(opt, idx, target);
+            if (opt->stats != NULL) opt->stats->threaded++;
+        }
+
+        if (target == multiple_ir_opt_next_live(opt, idx))
+        {
+            /* Jumping to the next one */
+            if (MULTIPLE_IR_OPT_IS_JMP(opcode))
+            { multiple_ir_opt_remove(opt, idx); }
+            else
+            {
+                /* The condition still has to be popped */
+                opt->instruments[idx].item->opcode = OP_DROP;
+                opt->instruments[idx].item->operand = 0;
+                opt->changed = 1;
+            }
+            if (opt->stats != NULL) opt->stats->threaded++;
+        }
+        else if (MULTIPLE_IR_OPT_IS_JMP(opcode) && (target < opt->size))
+        {
+            /* Jumping to somewhere going back or stopping right away */
+            opcode_target = OPCODE_OF(opt, target);
+            if ((opcode_target == OP_RETURN) || (opcode_target == OP_RETNONE) || (opcode_target == OP_HALT))
+            {
+                opt->instruments[idx].item->opcode = opcode_target;
+                opt->instruments[idx].item->operand = 0;
+                opt->changed = 1;
+                if (opt->stats != NULL) opt->stats->threaded++;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+/* Pairs */
+
+/* Pushes dropped right away, with nothing jumping in between */
+static int multiple_ir_opt_pass_pairs(struct multiple_ir_opt *opt)
+{
+    size_t idx, idx_next;
+    uint32_t opcode;
+
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        if (opt->instruments[idx].removed != 0) continue;
+        opcode = OPCODE_OF(opt, idx);
+        if ((opcode != OP_PUSH) && (opcode != OP_PUSHG) && (opcode != OP_PUSHM) && (opcode != OP_DUP)) continue;
+
+        idx_next = multiple_ir_opt_next_live(opt, idx);
+        if ((idx_next >= opt->size) || (opt->instruments[idx_next].leader != 0) || \
+                (OPCODE_OF(opt, idx_next) != OP_DROP))
+        { continue; }
+
+        multiple_ir_opt_remove(opt, idx);
+        multiple_ir_opt_remove(opt, idx_next);
+        if (opt->stats != NULL) opt->stats->paired++;
+        idx = idx_next;
+    }
+
+    return 0;
+}
+
+
+/* Unreachable Instruments */
+
+static int multiple_ir_opt_pass_unreachable(struct multiple_error *err, struct multiple_ir_opt *opt)
+{
+    int ret = 0;
+    size_t *pending = NULL, pending_size = 0;
+    struct multiple_ir_export_section_item *export_section_item_cur;
+    size_t idx, idx_next;
+    uint32_t opcode;
+
+    if ((pending = (size_t *)malloc(sizeof(size_t) * (opt->size + 1))) == NULL)
+    { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        opt->instruments[idx].reachable = 0;
+    }
+
+#define MULTIPLE_IR_OPT_REACH(instrument_number) \
+    do { \
+        idx_next = multiple_ir_opt_live_at(opt, (instrument_number)); \
+        if ((idx_next < opt->size) && (opt->instruments[idx_next].reachable == 0)) \
+        { \
+            opt->instruments[idx_next].reachable = 1; \
+            pending[pending_size++] = idx_next; \
+        } \
+    } while (0)
+
+    MULTIPLE_IR_OPT_REACH(0);
+    if (opt->ir->export_section != NULL)
+    {
+        for (export_section_item_cur = opt->ir->export_section->begin; \
+                export_section_item_cur != NULL; \
+                export_section_item_cur = export_section_item_cur->next)
+        {
+            if (export_section_item_cur->blank == 0)
+            { MULTIPLE_IR_OPT_REACH(export_section_item_cur->instrument_number); }
+        }
+    }
+
+    while (pending_size != 0)
+    {
+        idx = pending[--pending_size];
+        opcode = OPCODE_OF(opt, idx);
+        if (multiple_ir_opt_offset_kind(opcode) != MULTIPLE_IR_OPT_OFFSET_NONE)
+        { MULTIPLE_IR_OPT_REACH(opt->instruments[idx].target); }
+        if (multiple_ir_opt_is_terminator(opcode) == 0)
+        { MULTIPLE_IR_OPT_REACH(idx + 1); }
+    }
+
+#undef MULTIPLE_IR_OPT_REACH
+
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        if ((opt->instruments[idx].removed == 0) && (opt->instruments[idx].reachable == 0))
+        {
+            multiple_ir_opt_remove(opt, idx);
+            if (opt->stats != NULL) opt->stats->unreachable++;
+        }
+    }
+
+    goto done;
+fail:
+done:
+    if (pending != NULL) free(pending);
+    return ret;
+}
+
+
+/* Drop the removed instruments, and renumber everything referencing them */
+static int multiple_ir_opt_compact(struct multiple_error *err, struct multiple_ir_opt *opt)
+{
+    int ret = 0;
+    uint32_t *map = NULL;
+    size_t idx, size_new;
+    struct multiple_ir_export_section_item *export_section_item_cur;
+    struct multiple_ir_debug_section_item *debug_section_item_cur, *debug_section_item_prev, *debug_section_item_next;
+
+    if ((map = (uint32_t *)malloc(sizeof(uint32_t) * (opt->size + 1))) == NULL)
+    { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+
+    /* Instruments removed take the number of the next one kept */
+    size_new = 0;
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        if (opt->instruments[idx].removed == 0) map[idx] = (uint32_t)(size_new++);
+    }
+    map[opt->size] = (uint32_t)size_new;
+    for (idx = opt->size; idx-- != 0;)
+    {
+        if (opt->instruments[idx].removed != 0) map[idx] = map[idx + 1];
+    }
+
+    if (opt->ir->export_section != NULL)
+    {
+        for (export_section_item_cur = opt->ir->export_section->begin; \
+                export_section_item_cur != NULL; \
+                export_section_item_cur = export_section_item_cur->next)
+        {
+            if ((export_section_item_cur->blank == 0) && \
+                    (export_section_item_cur->instrument_number <= opt->size))
+            { export_section_item_cur->instrument_number = map[export_section_item_cur->instrument_number]; }
+        }
+    }
+
+    if (opt->ir->debug_section != NULL)
+    {
+        debug_section_item_prev = NULL;
+        debug_section_item_cur = opt->ir->debug_section->begin;
+        while (debug_section_item_cur != NULL)
+        {
+            debug_section_item_next = debug_section_item_cur->next;
+            if ((debug_section_item_cur->line_number_asm < opt->size) && \
+                    (opt->instruments[debug_section_item_cur->line_number_asm].removed != 0))
+            {
+                if (debug_section_item_prev == NULL) opt->ir->debug_section->begin = debug_section_item_next;
+                else debug_section_item_prev->next = debug_section_item_next;
+                if (opt->ir->debug_section->end == debug_section_item_cur) opt->ir->debug_section->end = debug_section_item_prev;
+                opt->ir->debug_section->size--;
+                multiple_ir_debug_section_item_destroy(debug_section_item_cur);
+            }
+            else
+            {
+                if (debug_section_item_cur->line_number_asm <= opt->size)
+                { debug_section_item_cur->line_number_asm = map[debug_section_item_cur->line_number_asm]; }
+                debug_section_item_prev = debug_section_item_cur;
+            }
+            debug_section_item_cur = debug_section_item_next;
+        }
+    }
+
+    size_new = 0;
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        if (opt->instruments[idx].removed != 0)
+        {
+            multiple_ir_text_section_item_destroy(opt->instruments[idx].item);
+            continue;
+        }
+        if (multiple_ir_opt_offset_kind(OPCODE_OF(opt, idx)) != MULTIPLE_IR_OPT_OFFSET_NONE)
+        { opt->instruments[idx].target = map[opt->instruments[idx].target]; }
+        opt->instruments[size_new++] = opt->instruments[idx];
+    }
+    opt->size = size_new;
+
+    /* Write the operands back and relink the text section */
+    for (idx = 0; idx != opt->size; idx++)
+    {
+        switch (multiple_ir_opt_offset_kind(OPCODE_OF(opt, idx)))
+        {
+            case MULTIPLE_IR_OPT_OFFSET_ABSOLUTE:
+                opt->instruments[idx].item->operand = opt->instruments[idx].target;
+                break;
+            case MULTIPLE_IR_OPT_OFFSET_RELATIVE:
+                opt->instruments[idx].item->operand = multiple_ir_opt_sam_to_cmp( \
+                        (int32_t)opt->instruments[idx].target - (int32_t)idx);
+                break;
+            default:
+                break;
+        }
+        opt->instruments[idx].item->next = (idx + 1 != opt->size) ? opt->instruments[idx + 1].item : NULL;
+    }
+    opt->ir->text_section->begin = (opt->size != 0) ? opt->instruments[0].item : NULL;
+    opt->ir->text_section->end = (opt->size != 0) ? opt->instruments[opt->size - 1].item : NULL;
+    opt->ir->text_section->size = opt->size;
+
+    goto done;
+fail:
+done:
+    if (map != NULL) free(map);
+    return ret;
+}
+
+int multiple_ir_optimize(struct multiple_error *err, struct multiple_ir *ir, \
+        int level, struct multiple_ir_opt_stats *stats)
+{
+    int ret = 0;
+    struct multiple_ir_opt opt;
+    struct multiple_ir_text_section_item *text_section_item_cur;
+    size_t idx, round;
+    int kind;
+    int64_t target;
+
+    opt.ir = ir;
+    opt.instruments = NULL;
+    opt.size = 0;
+    opt.changed = 0;
+    opt.data_items = NULL;
+    opt.data_items_size = 0;
+    opt.data_appended = NULL;
+    opt.data_id_next = 0;
+    opt.data_id_exhausted = 0;
+    opt.stats = stats;
+
+    if ((ir == NULL) || (ir->text_section == NULL) || (ir->data_section == NULL))
+    { MULTIPLE_ERROR_NULL_PTR(); ret = -MULTIPLE_ERR_NULL_PTR; goto fail; }
+
+    if (stats != NULL)
+    {
+        stats->before = stats->after = ir->text_section->size;
+        stats->folded = stats->threaded = stats->paired = stats->unreachable = 0;
+    }
+    if ((level <= MULTIPLE_IR_OPT_LEVEL_NONE) || (ir->text_section->size == 0)) goto done;
+    /* Instrument numbers have to fit in operands */
+    if (ir->text_section->size >= (size_t)INT32_MAX) goto done;
+
+    if ((opt.instruments = (struct multiple_ir_opt_instrument *)malloc( \
+                    sizeof(struct multiple_ir_opt_instrument) * ir->text_section->size)) == NULL)
+    { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+
+    for (text_section_item_cur = ir->text_section->begin; \
+            (text_section_item_cur != NULL) && (opt.size != ir->text_section->size); \
+            text_section_item_cur = text_section_item_cur->next)
+    {
+        opt.instruments[opt.size].item = text_section_item_cur;
+        opt.instruments[opt.size].removed = 0;
+        opt.instruments[opt.size].leader = 0;
+        opt.instruments[opt.size].reachable = 0;
+        opt.instruments[opt.size].target = 0;
+        opt.size++;
+    }
+    if (opt.size != ir->text_section->size)
+    {
+        multiple_error_update(err, -MULTIPLE_ERR_INTERNAL, \
+                "error: text section of IR not properly generated");
+        ret = -MULTIPLE_ERR_INTERNAL;
+        goto fail;
+    }
+
+    /* Leave the code as it is if it jumps out of itself */
+    for (idx = 0; idx != opt.size; idx++)
+    {
+        kind = multiple_ir_opt_offset_kind(OPCODE_OF(&opt, idx));
+        if (kind == MULTIPLE_IR_OPT_OFFSET_NONE) continue;
+        if (kind == MULTIPLE_IR_OPT_OFFSET_ABSOLUTE)
+        { target = (int64_t)opt.instruments[idx].item->operand; }
+        else
+        { target = (int64_t)idx + (int64_t)multiple_ir_opt_cmp_to_sam(opt.instruments[idx].item->operand); }
+        if ((target < 0) || (target > (int64_t)opt.size)) goto done;
+        opt.instruments[idx].target = (uint32_t)target;
+    }
+
+    if ((ret = multiple_ir_opt_data_items_sort(err, &opt)) != 0) goto fail;
+
+    for (round = 0; round != MULTIPLE_IR_OPT_ROUNDS_MAX; round++)
+    {
+        opt.changed = 0;
+        multiple_ir_opt_leaders_mark(&opt);
+
+        if ((ret = multiple_ir_opt_pass_jumps(&opt)) != 0) goto fail;
+        if (level >= MULTIPLE_IR_OPT_LEVEL_FOLD)
+        {
+            if ((ret = multiple_ir_opt_pass_fold(err, &opt)) != 0) goto fail;
+        }
+        if ((ret = multiple_ir_opt_pass_pairs(&opt)) != 0) goto fail;
+        if ((ret = multiple_ir_opt_pass_unreachable(err, &opt)) != 0) goto fail;
+
+        if ((ret = multiple_ir_opt_compact(err, &opt)) != 0) goto fail;
+        if ((opt.changed == 0) || (opt.size == 0)) break;
+    }
+
+    if (stats != NULL) stats->after = opt.size;
+
+    goto done;
+fail:
+done:
+    if (opt.instruments != NULL) free(opt.instruments);
+    if (opt.data_items != NULL) free(opt.data_items);
+    return ret;
+}
+
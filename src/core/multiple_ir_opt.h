@@ -0,0 +1,59 @@
+/* Multiple : Intermediate Representation Optimizer
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef _MULTIPLE_IR_OPT_H_
+#define _MULTIPLE_IR_OPT_H_
+
+#include "selfcheck.h"
+
+#include <stdio.h>
+
+#include "multiple_err.h"
+#include "multiple_ir.h"
+
+/* Optimization Levels
+ * 1: nops, jumps to jumps, jumps to the next instrument, pushes dropped
+ *    right away and unreachable instruments
+ * 2: arithmetic and branches on literals folded as well */
+#define MULTIPLE_IR_OPT_LEVEL_NONE 0
+#define MULTIPLE_IR_OPT_LEVEL_BASIC 1
+#define MULTIPLE_IR_OPT_LEVEL_FOLD 2
+#define MULTIPLE_IR_OPT_LEVEL_MAX (MULTIPLE_IR_OPT_LEVEL_FOLD)
+
+struct multiple_ir_opt_stats
+{
+    /* Instruments of the text section */
+    size_t before;
+    size_t after;
+
+    /* Rewrites made by each pass */
+    size_t folded;
+    size_t threaded;
+    size_t paired;
+    size_t unreachable;
+};
+
+/* Optimize the text section in place, the export and debug sections
+ * follow the new instrument numbers and the constants folded are appended
+ * to the data section. 'stats' could be NULL. */
+int multiple_ir_optimize(struct multiple_error *err, struct multiple_ir *ir, \
+        int level, struct multiple_ir_opt_stats *stats);
+
+#endif
+
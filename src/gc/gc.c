@@ -20,9 +20,37 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "gc.h"
 
+/* Initial capacity of the mark stack */
+#define GC_MARK_STACK_CAPACITY_INIT 1024
+/* Larger stacks are released after draining */
+#define GC_MARK_STACK_CAPACITY_KEEP (64 * 1024)
+
+#ifdef __GNUC__
+#define GC_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define GC_PREFETCH(addr) ((void)(addr))
+#endif
+
+#if defined(_MSC_VER)
+#define GC_THREAD_LOCAL __declspec(thread)
+#else
+#define GC_THREAD_LOCAL __thread
+#endif
+
+/* Most items taken from another worker at a time */
+#define GC_PARALLEL_STEAL_MAX 256
+/* Pending items collected each time the sweeper takes the lock */
+#define GC_PARALLEL_SWEEP_BATCH 1024
+/* Milliseconds between two checks of exiting */
+#define GC_PARALLEL_WAIT_TIMEOUT 100
+
+/* Worker the current thread is marking for, NULL if not in parallel marking */
+static GC_THREAD_LOCAL struct gc_parallel_worker *gc_parallel_worker_current = NULL;
+
 
 /* Declarations */
 
@@ -36,6 +64,8 @@ static int gc_object_table_item_list_append(struct gc_object_table_item_list *li
 static int gc_object_table_item_list_marks_clear(struct gc_object_table_item_list *list);
 static int gc_object_table_item_list_remove_item(struct gc_object_table_item_list *list, \
         void *internal_object_ptr);
+static int gc_object_table_item_list_unlink(struct gc_object_table_item_list *list, \
+        struct gc_object_table_item *object_table_item);
 
 static struct gc_object_table *gc_object_table_new(void);
 static int gc_object_table_destroy(struct gc_object_table *table);
@@ -46,6 +76,11 @@ static int gc_object_table_remove_item(struct gc_object_table *object_table, voi
 int gc_object_table_transport_to_survivor(struct gc_object_table *table, \
         struct gc_object_table_item *object_table_item);
 
+static int gc_remembered_set_remove(gc_remembered_set_t *remembered, \
+        struct gc_object_table_item *object_table_item);
+
+static int gc_rescan_remove(gc_stub_t *gc_stub, struct gc_object_table_item *object_table_item);
+
 
 /* Object Table */
 
@@ -58,11 +93,15 @@ static struct gc_object_table_item *gc_object_table_item_new(void)
     { goto fail; }
     new_object_table_item->mark = 0;
     new_object_table_item->mark_count = 0;
+    new_object_table_item->remembered = 0;
+    new_object_table_item->untracked = 0;
+    new_object_table_item->tag = 0;
     new_object_table_item->type = GC_OBJECT_TABLE_ITEM_TYPE_EDEN;
     new_object_table_item->prev = new_object_table_item->next = NULL;
     new_object_table_item->internal_object_ptr = NULL;
     new_object_table_item->internal_marker = NULL;
     new_object_table_item->internal_collector = NULL;
+    new_object_table_item->gc_stub = NULL;
     goto done;
 fail:
     if (new_object_table_item != NULL)
@@ -76,6 +115,11 @@ done:
 
 static int gc_object_table_item_destroy(struct gc_object_table_item *object_table_item)
 {
+    if (object_table_item->remembered != 0)
+    { gc_remembered_set_remove(&object_table_item->gc_stub->remembered, object_table_item); }
+    if ((object_table_item->untracked != 0) && (object_table_item->mark != 0) && \
+            (object_table_item->gc_stub != NULL) && (object_table_item->gc_stub->phase == GC_PHASE_MARK))
+    { gc_rescan_remove(object_table_item->gc_stub, object_table_item); }
     free(object_table_item);
 
     return 0;
@@ -179,17 +223,33 @@ static int gc_object_table_item_list_remove_item(struct gc_object_table_item_lis
     return 0;
 }
 
+/* Take the item out of the list without destroying it */
+static int gc_object_table_item_list_unlink(struct gc_object_table_item_list *list, \
+        struct gc_object_table_item *object_table_item)
+{
+    if (object_table_item->prev == NULL) { list->begin = object_table_item->next; }
+    if (object_table_item->next == NULL) { list->end = object_table_item->prev; }
+    if (object_table_item->prev != NULL) { object_table_item->prev->next = object_table_item->next; }
+    if (object_table_item->next != NULL) { object_table_item->next->prev = object_table_item->prev; }
+    object_table_item->prev = object_table_item->next = NULL;
+    list->size -= 1;
+
+    return 0;
+}
+
 
 int gc_transport_to_survivor(gc_stub_t *gc_stub, \
         struct gc_object_table_item *object_table_item)
 {
-    int ret = 0;
-
-    ret = gc_object_table_item_list_remove_item(gc_stub->obj_tbl->eden, object_table_item->internal_object_ptr);
-    if (ret != 1) /* Did removing */
+    if (object_table_item->type != GC_OBJECT_TABLE_ITEM_TYPE_EDEN)
     { return -1; }
+    gc_object_table_item_list_unlink(gc_stub->obj_tbl->eden, object_table_item);
     gc_object_table_item_list_append(gc_stub->obj_tbl->survivor, object_table_item);
     object_table_item->type = GC_OBJECT_TABLE_ITEM_TYPE_SURVIVOR;
+    gc_stub->stats.promoted++;
+
+    /* What it references might be still young */
+    gc_remember(object_table_item);
 
     return 0;
 }
@@ -280,6 +340,27 @@ gc_stub_t *gc_stub_new(void)
 
     new_stub = (gc_stub_t *)malloc(sizeof(gc_stub_t));
     if (new_stub == NULL) { goto fail; }
+    new_stub->mark_stack.items = NULL;
+    new_stub->mark_stack.size = 0;
+    new_stub->mark_stack.capacity = 0;
+    new_stub->mark_stack.draining = 0;
+    new_stub->phase = GC_PHASE_IDLE;
+    new_stub->sweep_list = NULL;
+    new_stub->sweep_cursor = NULL;
+    new_stub->rescan.items = NULL;
+    new_stub->rescan.size = 0;
+    new_stub->rescan.capacity = 0;
+    new_stub->rescan.draining = 0;
+    new_stub->rescan_overflow = 0;
+    new_stub->work = 0;
+    new_stub->parallel = NULL;
+    new_stub->minor = 0;
+    new_stub->minor_young_reached = 0;
+    new_stub->remembered.items = NULL;
+    new_stub->remembered.size = 0;
+    new_stub->remembered.capacity = 0;
+    new_stub->remembered.overflow = 0;
+    memset(&new_stub->stats, 0, sizeof(gc_stats_t));
     new_stub->obj_tbl = gc_object_table_new();
     if (new_stub->obj_tbl == NULL) { goto fail; }
 
@@ -296,13 +377,40 @@ done:
 
 int gc_stub_destroy(gc_stub_t *gc_stub)
 {
+    if (gc_stub->parallel != NULL)
+    { gc_parallel_stop(gc_stub); }
     if (gc_stub->obj_tbl != NULL)
     { gc_object_table_destroy(gc_stub->obj_tbl); }
+    if (gc_stub->mark_stack.items != NULL)
+    { free(gc_stub->mark_stack.items); }
+    if (gc_stub->remembered.items != NULL)
+    { free(gc_stub->remembered.items); }
+    if (gc_stub->rescan.items != NULL)
+    { free(gc_stub->rescan.items); }
     free(gc_stub);
 
     return 0;
 }
 
+/* Keep an item joining the tables from the running collection */
+static int gc_object_table_item_color_new(gc_stub_t *gc_stub, \
+        gc_object_table_item_t *item)
+{
+    switch (gc_stub->phase)
+    {
+        case GC_PHASE_MARK:
+            gc_shade_slow(item);
+            break;
+        case GC_PHASE_SWEEP:
+            item->mark = 1;
+            break;
+        case GC_PHASE_IDLE:
+            break;
+    }
+
+    return 0;
+}
+
 /* Register new allocated reference object */
 int gc_reference_register( \
         gc_stub_t *gc_stub, \
@@ -322,9 +430,11 @@ int gc_reference_register( \
     new_object_table_item->internal_object_ptr = object_internal_ptr;
     new_object_table_item->internal_marker = internal_marker;
     new_object_table_item->internal_collector = internal_collector;
+    new_object_table_item->gc_stub = gc_stub;
     *target_object_table_item = new_object_table_item;
 
     gc_object_table_append(gc_stub->obj_tbl, new_object_table_item);
+    gc_object_table_item_color_new(gc_stub, new_object_table_item);
     new_object_table_item = NULL;
 
     goto done;
@@ -340,6 +450,10 @@ int gc_resource_reference_unregister( \
         gc_stub_t *gc_stub, \
         void *object_internal_ptr)
 {
+    /* Do not leave the lazy sweeping on a removed item */
+    if ((gc_stub->sweep_cursor != NULL) && \
+            (gc_stub->sweep_cursor->internal_object_ptr == object_internal_ptr))
+    { gc_stub->sweep_cursor = gc_stub->sweep_cursor->next; }
     gc_object_table_remove_item(gc_stub->obj_tbl, object_internal_ptr);
     return 0;
 }
@@ -350,16 +464,152 @@ int gc_begin(gc_stub_t *gc_stub)
     return gc_object_table_marks_clear(gc_stub->obj_tbl);
 }
 
+/* Mark Stack */
+
+static int gc_mark_stack_push(gc_mark_stack_t *mark_stack, \
+        gc_object_table_item_t *item)
+{
+    gc_object_table_item_t **new_items;
+    size_t new_capacity;
+
+    if (mark_stack->size == mark_stack->capacity)
+    {
+        new_capacity = (mark_stack->capacity == 0) ? GC_MARK_STACK_CAPACITY_INIT : mark_stack->capacity * 2;
+        new_items = (gc_object_table_item_t **)realloc(mark_stack->items, \
+                sizeof(gc_object_table_item_t *) * new_capacity);
+        if (new_items == NULL) { return -1; }
+        mark_stack->items = new_items;
+        mark_stack->capacity = new_capacity;
+    }
+    mark_stack->items[mark_stack->size++] = item;
+
+    /* The marker reads the internal object when the item is popped */
+    GC_PREFETCH(item->internal_object_ptr);
+
+    return 0;
+}
+
+static int gc_mark_stack_drain(gc_mark_stack_t *mark_stack)
+{
+    gc_object_table_item_t *item;
+
+    mark_stack->draining = 1;
+    while (mark_stack->size != 0)
+    {
+        item = mark_stack->items[--mark_stack->size];
+        if (mark_stack->size != 0)
+        { GC_PREFETCH(mark_stack->items[mark_stack->size - 1]); }
+
+        /* Children marked in here are pushed rather than traced */
+        item->internal_marker(item->internal_object_ptr);
+    }
+    mark_stack->draining = 0;
+
+    if (mark_stack->capacity > GC_MARK_STACK_CAPACITY_KEEP)
+    {
+        free(mark_stack->items);
+        mark_stack->items = NULL;
+        mark_stack->capacity = 0;
+    }
+
+    return 0;
+}
+
+static int gc_parallel_worker_push(struct gc_parallel_worker *worker, \
+        gc_object_table_item_t *item);
+
+/* Trace the children of a freshly marked item */
+static int gc_mark_trace(gc_object_table_item_t *item)
+{
+    gc_mark_stack_t *mark_stack = &item->gc_stub->mark_stack;
+
+    /* Marking in parallel, the worker drains its own stack */
+    if (gc_parallel_worker_current != NULL)
+    { return gc_parallel_worker_push(gc_parallel_worker_current, item); }
+
+    if (gc_mark_stack_push(mark_stack, item) != 0)
+    {
+        /* No room for the stack, trace in place */
+        item->internal_marker(item->internal_object_ptr);
+        return 0;
+    }
+    /* Incremental marking drains in slices */
+    if ((mark_stack->draining == 0) && (item->gc_stub->phase != GC_PHASE_MARK))
+    { gc_mark_stack_drain(mark_stack); }
+
+    return 0;
+}
+
+/* Untracked items marked while marking in slices could be stored into
+ * without barriers afterwards, they are traced again before finishing */
+static int gc_rescan_record(gc_object_table_item_t *item)
+{
+    gc_stub_t *gc_stub = item->gc_stub;
+
+    if ((item->untracked == 0) || (gc_stub->phase != GC_PHASE_MARK)) return 0;
+    if (gc_mark_stack_push(&gc_stub->rescan, item) != 0)
+    { gc_stub->rescan_overflow = 1; }
+
+    return 0;
+}
+
+static int gc_rescan_remove(gc_stub_t *gc_stub, struct gc_object_table_item *object_table_item)
+{
+    size_t idx;
+
+    for (idx = 0; idx != gc_stub->rescan.size; idx++)
+    {
+        if (gc_stub->rescan.items[idx] == object_table_item)
+        {
+            gc_stub->rescan.items[idx] = gc_stub->rescan.items[--gc_stub->rescan.size];
+            break;
+        }
+    }
+
+    return 0;
+}
+
+static int gc_rescan_clear(gc_stub_t *gc_stub)
+{
+    gc_stub->rescan.size = 0;
+    gc_stub->rescan_overflow = 0;
+    if (gc_stub->rescan.capacity > GC_MARK_STACK_CAPACITY_KEEP)
+    {
+        free(gc_stub->rescan.items);
+        gc_stub->rescan.items = NULL;
+        gc_stub->rescan.capacity = 0;
+    }
+
+    return 0;
+}
+
 /* Mark an item */
 int gc_mark_major(gc_object_table_item_t *item)
 {
     if (item == NULL) return 0;
 
+    /* Markers always ask for major marking */
+    if (item->gc_stub->minor != 0)
+    { return gc_mark_minor(item); }
+
+    if (gc_parallel_worker_current != NULL)
+    {
+        /* Other workers could reach the same item */
+        if ((item->mark == 0) && (atomic_cas((volatile int *)&item->mark, 0, 1) != 0))
+        {
+            item->mark_count++;
+            gc_mark_trace(item);
+        }
+        return 0;
+    }
+
+    item->gc_stub->work++;
     if (item->mark == 0)
     {
         item->mark = 1;
-        item->internal_marker(item->internal_object_ptr);
         item->mark_count++;
+        gc_rescan_record(item);
+        gc_mark_trace(item);
     }
     return 0;
 }
@@ -367,68 +617,830 @@ int gc_mark_minor(gc_object_table_item_t *item)
 {
     if (item == NULL) return 0;
 
+    /* Old items are not collected by minor GC, 
+     * what they reference is reached by gc_minor_mark_finish() */
+    if (item->type != GC_OBJECT_TABLE_ITEM_TYPE_EDEN) return 0;
+    item->gc_stub->minor_young_reached++;
+
     if (item->mark == 0)
     {
         item->mark = 1;
-        if (item->type == GC_OBJECT_TABLE_ITEM_TYPE_EDEN)
-        { item->internal_marker(item->internal_object_ptr); }
         item->mark_count++;
+        gc_mark_trace(item);
     }
     return 0;
 }
 
 
+/* Collect the item if unmarked, returns the next item */
+static gc_object_table_item_t *gc_object_table_item_list_sweep_item( \
+        gc_object_table_item_list_t *list, \
+        gc_object_table_item_t *table_item_cur)
+{
+    struct gc_object_table_item *table_item_next = table_item_cur->next;
+    int confirm;
+
+    if (table_item_cur->mark != 0) return table_item_next;
+
+    /* no marked, collect */
+    table_item_cur->internal_collector(table_item_cur->internal_object_ptr, &confirm);
+
+    /* Confirming if to remove the item */
+    if (confirm == GC_GARBAGE_COLLECT_CONFIRM)
+    {
+        /* Remove item */
+        if (table_item_cur->prev == NULL) { list->begin = table_item_cur->next; }
+        if (table_item_cur->next == NULL) { list->end = table_item_cur->prev; }
+        if (table_item_cur->prev != NULL) { table_item_cur->prev->next = table_item_cur->next; }
+        if (table_item_cur->next != NULL) { table_item_cur->next->prev = table_item_cur->prev; }
+
+        table_item_cur->gc_stub->stats.swept++;
+        gc_object_table_item_destroy(table_item_cur);
+        list->size -= 1;
+    }
+
+    return table_item_next;
+}
+
 static int gc_object_table_item_list_garbage_collect( \
         gc_object_table_item_list_t *list)
 {
-    struct gc_object_table_item *table_item_cur, *table_item_target;
-    int confirm;
+    struct gc_object_table_item *table_item_cur;
 
     table_item_cur = list->begin;
     while (table_item_cur != NULL)
     {
-        if (table_item_cur->mark == 0)
+        table_item_cur = gc_object_table_item_list_sweep_item(list, table_item_cur);
+    }
+
+    return 0;
+}
+
+static int gc_parallel_detach_unmarked_list(struct gc_parallel *parallel, \
+        gc_object_table_item_list_t *list);
+static int gc_parallel_detach_unmarked(gc_stub_t *gc_stub);
+static int gc_remembered_set_rebuild(gc_stub_t *gc_stub);
+
+int gc_collect(gc_stub_t *gc_stub)
+{
+    /* Leave the collectors to the sweeper */
+    if ((gc_stub->parallel != NULL) && (gc_stub->parallel->concurrent_sweep != 0))
+    {
+        gc_parallel_detach_unmarked(gc_stub);
+    }
+    else
+    {
+        gc_object_table_item_list_garbage_collect(gc_stub->obj_tbl->eden);
+        gc_object_table_item_list_garbage_collect(gc_stub->obj_tbl->survivor);
+        gc_object_table_item_list_garbage_collect(gc_stub->obj_tbl->permanent);
+    }
+
+    return 0;
+}
+
+
+/* Statistics */
+
+int gc_stats_pause(gc_stub_t *gc_stub, unsigned long long us)
+{
+    size_t bucket = 0;
+
+    while (((us >> bucket) != 0) && (bucket != GC_STATS_PAUSE_BUCKETS - 1))
+    { bucket++; }
+    gc_stub->stats.pauses[bucket]++;
+    gc_stub->stats.pause_total += us;
+    if (us > gc_stub->stats.pause_max) { gc_stub->stats.pause_max = us; }
+
+    return 0;
+}
+
+static int gc_stats_count_tags_list(gc_object_table_item_list_t *list, \
+        size_t *counts, size_t count)
+{
+    gc_object_table_item_t *table_item_cur;
+
+    table_item_cur = list->begin;
+    while (table_item_cur != NULL)
+    {
+        if ((table_item_cur->tag >= 0) && ((size_t)table_item_cur->tag < count))
+        { counts[table_item_cur->tag]++; }
+        table_item_cur = table_item_cur->next;
+    }
+
+    return 0;
+}
+
+int gc_stats_count_tags(gc_stub_t *gc_stub, size_t *counts, size_t count)
+{
+    memset(counts, 0, sizeof(size_t) * count);
+    gc_stats_count_tags_list(gc_stub->obj_tbl->eden, counts, count);
+    gc_stats_count_tags_list(gc_stub->obj_tbl->survivor, counts, count);
+    gc_stats_count_tags_list(gc_stub->obj_tbl->permanent, counts, count);
+
+    return 0;
+}
+
+
+/* Minor Collection */
+
+int gc_minor_begin(gc_stub_t *gc_stub)
+{
+    gc_object_table_item_list_marks_clear(gc_stub->obj_tbl->eden);
+    gc_stub->minor = 1;
+
+    return 0;
+}
+
+/* Take every item of the list as a root */
+static int gc_minor_mark_list(gc_object_table_item_list_t *list)
+{
+    gc_object_table_item_t *table_item_cur;
+
+    table_item_cur = list->begin;
+    while (table_item_cur != NULL)
+    {
+        /* Only eden items are marked (and traced) */
+        table_item_cur->internal_marker(table_item_cur->internal_object_ptr);
+        table_item_cur = table_item_cur->next;
+    }
+
+    return 0;
+}
+
+int gc_minor_mark_finish(gc_stub_t *gc_stub)
+{
+    gc_remembered_set_t *remembered = &gc_stub->remembered;
+    gc_object_table_item_t *item;
+    size_t idx, kept = 0;
+
+    if (remembered->overflow != 0)
+    {
+        gc_minor_mark_list(gc_stub->obj_tbl->survivor);
+        gc_minor_mark_list(gc_stub->obj_tbl->permanent);
+        gc_remembered_set_rebuild(gc_stub);
+    }
+    else
+    {
+        for (idx = 0; idx != remembered->size; idx++)
         {
-            /* no marked, collect */
-            table_item_cur->internal_collector(table_item_cur->internal_object_ptr, &confirm);
+            item = remembered->items[idx];
+            gc_stub->minor_young_reached = 0;
+            item->internal_marker(item->internal_object_ptr);
 
-            /* Confirming if to remove the item */
-            if (confirm == GC_GARBAGE_COLLECT_CONFIRM)
+            /* Nothing young inside, until stored into again */
+            if ((gc_stub->minor_young_reached == 0) && (item->untracked == 0))
+            { item->remembered = 0; }
+            else
             {
-                table_item_target = table_item_cur;
+                remembered->items[kept++] = item;
+                item->remembered = kept;
+            }
+        }
+        remembered->size = kept;
+    }
+    gc_stub->minor = 0;
+
+    return 0;
+}
+
+int gc_minor_promote(gc_stub_t *gc_stub, size_t age)
+{
+    gc_object_table_item_t *table_item_cur, *table_item_next;
+
+    table_item_cur = gc_stub->obj_tbl->eden->begin;
+    while (table_item_cur != NULL)
+    {
+        table_item_next = table_item_cur->next;
+        if ((table_item_cur->mark != 0) && (table_item_cur->mark_count >= age))
+        { gc_transport_to_survivor(gc_stub, table_item_cur); }
+        table_item_cur = table_item_next;
+    }
+
+    return 0;
+}
+
+int gc_minor_collect(gc_stub_t *gc_stub)
+{
+    /* Leave the collectors to the sweeper */
+    if ((gc_stub->parallel != NULL) && (gc_stub->parallel->concurrent_sweep != 0))
+    {
+        gc_parallel_detach_unmarked_list(gc_stub->parallel, gc_stub->obj_tbl->eden);
+        if (gc_stub->parallel->pending != NULL)
+        { thread_event_signal(&gc_stub->parallel->sweeper_event); }
+        return 0;
+    }
 
-                /* Remove item */
-                if (table_item_cur->prev == NULL) { list->begin = table_item_cur->next; }
-                if (table_item_cur->next == NULL) { list->end = table_item_cur->prev; }
-                if (table_item_cur->prev != NULL) { table_item_cur->prev->next = table_item_cur->next; }
-                if (table_item_cur->next != NULL) { table_item_cur->next->prev = table_item_cur->prev; }
+    gc_object_table_item_list_garbage_collect(gc_stub->obj_tbl->eden);
 
-                table_item_cur = table_item_target->next;
+    return 0;
+}
 
-                gc_object_table_item_destroy(table_item_target);
-                list->size -= 1;
+
+/* Incremental Collection */
+
+int gc_incremental_begin(gc_stub_t *gc_stub)
+{
+    gc_incremental_abort(gc_stub);
+    gc_object_table_marks_clear(gc_stub->obj_tbl);
+    gc_stub->phase = GC_PHASE_MARK;
+
+    return 0;
+}
+
+int gc_incremental_mark(gc_stub_t *gc_stub, size_t budget)
+{
+    gc_mark_stack_t *mark_stack = &gc_stub->mark_stack;
+    gc_object_table_item_t *item;
+    size_t work_start = gc_stub->work;
+
+    mark_stack->draining = 1;
+    while ((mark_stack->size != 0) && (gc_stub->work - work_start < budget))
+    {
+        item = mark_stack->items[--mark_stack->size];
+        if (mark_stack->size != 0)
+        { GC_PREFETCH(mark_stack->items[mark_stack->size - 1]); }
+
+        /* Turns black, children turn gray, every child counts */
+        item->internal_marker(item->internal_object_ptr);
+        gc_stub->work++;
+    }
+    mark_stack->draining = 0;
+
+    return (mark_stack->size == 0) ? 1 : 0;
+}
+
+int gc_incremental_rescan(gc_stub_t *gc_stub)
+{
+    gc_object_table_item_list_t *lists[3];
+    gc_object_table_item_t *item;
+    size_t idx, size = gc_stub->rescan.size;
+
+    /* Children turn gray, traced by gc_mark_finish() */
+    for (idx = 0; idx != size; idx++)
+    {
+        item = gc_stub->rescan.items[idx];
+        item->internal_marker(item->internal_object_ptr);
+    }
+
+    if (gc_stub->rescan_overflow != 0)
+    {
+        lists[0] = gc_stub->obj_tbl->eden;
+        lists[1] = gc_stub->obj_tbl->survivor;
+        lists[2] = gc_stub->obj_tbl->permanent;
+        for (idx = 0; idx != 3; idx++)
+        {
+            for (item = lists[idx]->begin; item != NULL; item = item->next)
+            {
+                if ((item->untracked != 0) && (item->mark != 0))
+                { item->internal_marker(item->internal_object_ptr); }
             }
+        }
+    }
+
+    gc_rescan_clear(gc_stub);
+
+    return 0;
+}
+
+int gc_incremental_sweep_begin(gc_stub_t *gc_stub)
+{
+    gc_stub->phase = GC_PHASE_SWEEP;
+    gc_stub->sweep_list = gc_stub->obj_tbl->eden;
+    gc_stub->sweep_cursor = gc_stub->sweep_list->begin;
+
+    return 0;
+}
+
+int gc_incremental_sweep(gc_stub_t *gc_stub, size_t budget)
+{
+    gc_object_table_t *obj_tbl = gc_stub->obj_tbl;
+
+    while (budget != 0)
+    {
+        if (gc_stub->sweep_cursor == NULL)
+        {
+            /* Next table */
+            if (gc_stub->sweep_list == obj_tbl->eden) 
+            { gc_stub->sweep_list = obj_tbl->survivor; }
+            else if (gc_stub->sweep_list == obj_tbl->survivor) 
+            { gc_stub->sweep_list = obj_tbl->permanent; }
             else
             {
-                /* Skip to next item only when current item not been collected */
-                table_item_cur = table_item_cur->next;
+                gc_stub->phase = GC_PHASE_IDLE;
+                gc_stub->sweep_list = NULL;
+                return 1;
             }
+            gc_stub->sweep_cursor = gc_stub->sweep_list->begin;
+            continue;
+        }
+        gc_stub->sweep_cursor = gc_object_table_item_list_sweep_item( \
+                gc_stub->sweep_list, gc_stub->sweep_cursor);
+        budget--;
+    }
+
+    return 0;
+}
+
+int gc_incremental_abort(gc_stub_t *gc_stub)
+{
+    gc_stub->phase = GC_PHASE_IDLE;
+    gc_stub->mark_stack.size = 0;
+    gc_rescan_clear(gc_stub);
+    gc_stub->sweep_list = NULL;
+    gc_stub->sweep_cursor = NULL;
+
+    return 0;
+}
+
+int gc_shade_slow(gc_object_table_item_t *item)
+{
+    if (item->mark == 0)
+    {
+        item->mark = 1;
+        item->mark_count++;
+        gc_rescan_record(item);
+        if (gc_mark_stack_push(&item->gc_stub->mark_stack, item) != 0)
+        {
+            /* No room for the stack, trace in place */
+            item->internal_marker(item->internal_object_ptr);
+        }
+    }
+
+    return 0;
+}
+
+static int gc_parallel_mark(gc_stub_t *gc_stub);
+
+int gc_mark_finish(gc_stub_t *gc_stub)
+{
+    if (gc_stub->parallel != NULL)
+    { gc_parallel_mark(gc_stub); }
+    /* Whatever the helpers could not take */
+    gc_incremental_mark(gc_stub, (size_t)(-1));
+    gc_stub->phase = GC_PHASE_IDLE;
+    gc_rescan_clear(gc_stub);
+
+    return 0;
+}
+
+
+/* Parallel Collection */
+
+static int gc_parallel_worker_push(struct gc_parallel_worker *worker, \
+        gc_object_table_item_t *item)
+{
+    int ret;
+
+    thread_mutex_lock(&worker->lock);
+    ret = gc_mark_stack_push(&worker->mark_stack, item);
+    thread_mutex_unlock(&worker->lock);
+    if (ret != 0)
+    {
+        /* No room for the stack, trace in place */
+        item->internal_marker(item->internal_object_ptr);
+    }
+
+    return 0;
+}
+
+static gc_object_table_item_t *gc_parallel_worker_pop(struct gc_parallel_worker *worker)
+{
+    gc_object_table_item_t *item = NULL;
+
+    thread_mutex_lock(&worker->lock);
+    if (worker->mark_stack.size != 0)
+    {
+        item = worker->mark_stack.items[--worker->mark_stack.size];
+        if (worker->mark_stack.size != 0)
+        { GC_PREFETCH(worker->mark_stack.items[worker->mark_stack.size - 1]); }
+    }
+    thread_mutex_unlock(&worker->lock);
+
+    return item;
+}
+
+/* Take half of the items of another worker, returns non-zero if got some */
+static int gc_parallel_worker_steal(struct gc_parallel_worker *worker)
+{
+    struct gc_parallel *parallel = worker->parallel;
+    struct gc_parallel_worker *victim;
+    gc_object_table_item_t *stolen[GC_PARALLEL_STEAL_MAX];
+    size_t stolen_count = 0;
+    size_t idx, offset;
+
+    for (offset = 1; (offset != parallel->workers_count) && (stolen_count == 0); offset++)
+    {
+        victim = &parallel->workers[(size_t)(worker - parallel->workers + (long)offset) % parallel->workers_count];
+        if (*((volatile size_t *)&victim->mark_stack.size) < 2) continue;
+
+        thread_mutex_lock(&victim->lock);
+        stolen_count = victim->mark_stack.size / 2;
+        if (stolen_count > GC_PARALLEL_STEAL_MAX) stolen_count = GC_PARALLEL_STEAL_MAX;
+        victim->mark_stack.size -= stolen_count;
+        for (idx = 0; idx != stolen_count; idx++)
+        { stolen[idx] = victim->mark_stack.items[victim->mark_stack.size + idx]; }
+        thread_mutex_unlock(&victim->lock);
+    }
+
+    /* Not holding two locks at once */
+    for (idx = 0; idx != stolen_count; idx++)
+    { gc_parallel_worker_push(worker, stolen[idx]); }
+
+    return (stolen_count != 0) ? 1 : 0;
+}
+
+static int gc_parallel_work_available(struct gc_parallel *parallel)
+{
+    size_t idx;
+
+    for (idx = 0; idx != parallel->workers_count; idx++)
+    {
+        if (*((volatile size_t *)&parallel->workers[idx].mark_stack.size) != 0) return 1;
+    }
+
+    return 0;
+}
+
+static int gc_parallel_worker_mark(struct gc_parallel_worker *worker)
+{
+    struct gc_parallel *parallel = worker->parallel;
+    gc_object_table_item_t *item;
+    unsigned int round;
+
+    gc_parallel_worker_current = worker;
+    for (;;)
+    {
+        while ((item = gc_parallel_worker_pop(worker)) != NULL)
+        { item->internal_marker(item->internal_object_ptr); }
+        if (gc_parallel_worker_steal(worker) != 0) continue;
+
+        /* Only workers with items push more, 
+         * so nothing remains once everyone is idle */
+        atomic_inc(&parallel->idle);
+        for (round = 0; (parallel->idle != (int)parallel->workers_count) && \
+                (gc_parallel_work_available(parallel) == 0); round++)
+        { thread_pause(round); }
+        if (parallel->idle == (int)parallel->workers_count) break;
+        atomic_dec(&parallel->idle);
+    }
+    gc_parallel_worker_current = NULL;
+
+    return 0;
+}
+
+static void *gc_parallel_helper_routine(void *arg)
+{
+    struct gc_parallel_worker *worker = arg;
+    struct gc_parallel *parallel = worker->parallel;
+
+    for (;;)
+    {
+        thread_event_wait(&worker->event, GC_PARALLEL_WAIT_TIMEOUT);
+        if (parallel->exiting != 0) break;
+        if (worker->generation == parallel->generation) continue;
+        worker->generation = parallel->generation;
+
+        gc_parallel_worker_mark(worker);
+
+        atomic_inc(&parallel->finished);
+        thread_event_signal(&parallel->event_finished);
+    }
+
+    return NULL;
+}
+
+/* Trace the gray items of the stub with all the workers */
+static int gc_parallel_mark(gc_stub_t *gc_stub)
+{
+    struct gc_parallel *parallel = gc_stub->parallel;
+    gc_mark_stack_t *mark_stack = &gc_stub->mark_stack;
+    size_t helpers_count = parallel->workers_count - 1;
+    size_t idx;
+
+    if ((helpers_count == 0) || (mark_stack->size == 0)) return 0;
+
+    /* Deal the gray items out, the rest stays for the calling thread */
+    idx = 0;
+    while (mark_stack->size != 0)
+    {
+        if (gc_mark_stack_push(&parallel->workers[idx % parallel->workers_count].mark_stack, \
+                    mark_stack->items[mark_stack->size - 1]) != 0)
+        { break; }
+        mark_stack->size--;
+        idx++;
+    }
+
+    parallel->idle = 0;
+    parallel->finished = 0;
+    atomic_inc(&parallel->generation);
+    for (idx = 1; idx != parallel->workers_count; idx++)
+    { thread_event_signal(&parallel->workers[idx].event); }
+
+    gc_parallel_worker_mark(&parallel->workers[0]);
+
+    while (parallel->finished != (int)helpers_count)
+    { thread_event_wait(&parallel->event_finished, GC_PARALLEL_WAIT_TIMEOUT); }
+
+    return 0;
+}
+
+/* Move the unmarked items to the pending list of the sweeper, out of 
+ * the remembered set, which a minor collection traces before they are 
+ * swept */
+static int gc_parallel_detach_unmarked_list(struct gc_parallel *parallel, \
+        gc_object_table_item_list_t *list)
+{
+    gc_object_table_item_t *table_item_cur, *table_item_next;
+
+    table_item_cur = list->begin;
+    while (table_item_cur != NULL)
+    {
+        table_item_next = table_item_cur->next;
+        if (table_item_cur->mark == 0)
+        {
+            if (table_item_cur->remembered != 0)
+            { gc_remembered_set_remove(&parallel->gc_stub->remembered, table_item_cur); }
+            gc_object_table_item_list_unlink(list, table_item_cur);
+            table_item_cur->next = parallel->pending;
+            parallel->pending = table_item_cur;
+        }
+        table_item_cur = table_item_next;
+    }
+
+    return 0;
+}
+
+static int gc_parallel_detach_unmarked(gc_stub_t *gc_stub)
+{
+    struct gc_parallel *parallel = gc_stub->parallel;
+
+    gc_parallel_detach_unmarked_list(parallel, gc_stub->obj_tbl->eden);
+    gc_parallel_detach_unmarked_list(parallel, gc_stub->obj_tbl->survivor);
+    gc_parallel_detach_unmarked_list(parallel, gc_stub->obj_tbl->permanent);
+    if (parallel->pending != NULL)
+    { thread_event_signal(&parallel->sweeper_event); }
+
+    return 0;
+}
+
+/* Collect at most 'budget' pending items, with the lock held */
+static int gc_parallel_sweep_pending(struct gc_parallel *parallel, size_t budget)
+{
+    gc_object_table_item_t *table_item_cur;
+    int confirm;
+
+    while ((parallel->pending != NULL) && (budget != 0))
+    {
+        table_item_cur = parallel->pending;
+        parallel->pending = table_item_cur->next;
+        table_item_cur->next = NULL;
+
+        table_item_cur->internal_collector(table_item_cur->internal_object_ptr, &confirm);
+        if (confirm == GC_GARBAGE_COLLECT_CONFIRM)
+        {
+            gc_object_table_item_destroy(table_item_cur);
+            parallel->gc_stub->stats.swept++;
         }
         else
         {
-            /* Skip to next item only when current item not been collected */
-            table_item_cur = table_item_cur->next;
+            /* Postponed (by a destructor), back to the tables */
+            table_item_cur->mark = 0;
+            if (table_item_cur->remembered != 0)
+            { gc_remembered_set_remove(&parallel->gc_stub->remembered, table_item_cur); }
+            table_item_cur->type = GC_OBJECT_TABLE_ITEM_TYPE_EDEN;
+            gc_object_table_append(parallel->gc_stub->obj_tbl, table_item_cur);
+            gc_object_table_item_color_new(parallel->gc_stub, table_item_cur);
         }
+        budget--;
     }
 
     return 0;
 }
 
-int gc_collect(gc_stub_t *gc_stub)
+static void *gc_parallel_sweeper_routine(void *arg)
 {
-    gc_object_table_item_list_garbage_collect(gc_stub->obj_tbl->eden);
-    gc_object_table_item_list_garbage_collect(gc_stub->obj_tbl->survivor);
-    gc_object_table_item_list_garbage_collect(gc_stub->obj_tbl->permanent);
+    struct gc_parallel *parallel = arg;
+
+    for (;;)
+    {
+        thread_event_wait(&parallel->sweeper_event, GC_PARALLEL_WAIT_TIMEOUT);
+        if (parallel->exiting != 0) break;
+
+        /* A batch at a time, the lock is wanted by the running program */
+        while ((*((gc_object_table_item_t * volatile *)&parallel->pending) != NULL) && \
+                (parallel->exiting == 0))
+        {
+            parallel->lock(parallel->lock_data);
+            gc_parallel_sweep_pending(parallel, GC_PARALLEL_SWEEP_BATCH);
+            parallel->unlock(parallel->lock_data);
+        }
+    }
+
+    return NULL;
+}
+
+int gc_parallel_start(gc_stub_t *gc_stub, size_t threads, int concurrent_sweep, \
+        int (*lock)(void *data), int (*unlock)(void *data), void *lock_data)
+{
+    struct gc_parallel *new_parallel = NULL;
+    struct gc_parallel_worker *worker;
+    size_t idx;
+
+    if (gc_stub->parallel != NULL) return 0;
+    if (threads == 0) threads = 1;
+    if ((lock == NULL) || (unlock == NULL)) concurrent_sweep = 0;
+    if ((threads == 1) && (concurrent_sweep == 0)) return 0;
+
+    if ((new_parallel = (struct gc_parallel *)malloc(sizeof(struct gc_parallel))) == NULL)
+    { return -1; }
+    new_parallel->gc_stub = gc_stub;
+    new_parallel->workers_count = 0;
+    new_parallel->generation = 0;
+    new_parallel->exiting = 0;
+    new_parallel->idle = 0;
+    new_parallel->finished = 0;
+    new_parallel->concurrent_sweep = 0;
+    new_parallel->pending = NULL;
+    new_parallel->lock = lock;
+    new_parallel->unlock = unlock;
+    new_parallel->lock_data = lock_data;
+    thread_event_init(&new_parallel->event_finished);
+    thread_event_init(&new_parallel->sweeper_event);
+    if ((new_parallel->workers = (struct gc_parallel_worker *)malloc( \
+                    sizeof(struct gc_parallel_worker) * threads)) == NULL)
+    {
+        thread_event_uninit(&new_parallel->event_finished);
+        thread_event_uninit(&new_parallel->sweeper_event);
+        free(new_parallel);
+        return -1;
+    }
+    gc_stub->parallel = new_parallel;
+
+    /* The collecting thread is the first worker, 
+     * fewer helpers if the system refuses more threads */
+    for (idx = 0; idx != threads; idx++)
+    {
+        worker = &new_parallel->workers[idx];
+        worker->parallel = new_parallel;
+        worker->mark_stack.items = NULL;
+        worker->mark_stack.size = 0;
+        worker->mark_stack.capacity = 0;
+        worker->mark_stack.draining = 0;
+        worker->generation = 0;
+        thread_mutex_init(&worker->lock);
+        thread_event_init(&worker->event);
+        if (idx != 0)
+        {
+            if (thread_create(&worker->handle, gc_parallel_helper_routine, worker) != 0)
+            {
+                thread_mutex_uninit(&worker->lock);
+                thread_event_uninit(&worker->event);
+                break;
+            }
+        }
+        new_parallel->workers_count++;
+    }
+
+    if (concurrent_sweep != 0)
+    {
+        if (thread_create(&new_parallel->sweeper_handle, gc_parallel_sweeper_routine, new_parallel) == 0)
+        { new_parallel->concurrent_sweep = 1; }
+    }
+
+    return 0;
+}
+
+int gc_parallel_stop(gc_stub_t *gc_stub)
+{
+    struct gc_parallel *parallel = gc_stub->parallel;
+    struct gc_parallel_worker *worker;
+    size_t idx;
+
+    if (parallel == NULL) return 0;
+
+    parallel->exiting = 1;
+    for (idx = 0; idx != parallel->workers_count; idx++)
+    {
+        worker = &parallel->workers[idx];
+        if (idx != 0)
+        {
+            thread_event_signal(&worker->event);
+            thread_join(&worker->handle);
+        }
+        thread_mutex_uninit(&worker->lock);
+        thread_event_uninit(&worker->event);
+        if (worker->mark_stack.items != NULL) free(worker->mark_stack.items);
+    }
+    if (parallel->concurrent_sweep != 0)
+    {
+        thread_event_signal(&parallel->sweeper_event);
+        thread_join(&parallel->sweeper_handle);
+    }
+
+    /* Nobody else is running now */
+    gc_parallel_sweep_pending(parallel, (size_t)(-1));
+
+    gc_stub->parallel = NULL;
+    thread_event_uninit(&parallel->event_finished);
+    thread_event_uninit(&parallel->sweeper_event);
+    free(parallel->workers);
+    free(parallel);
+
+    return 0;
+}
+
+int gc_parallel_sweep_now(gc_stub_t *gc_stub)
+{
+    if (gc_stub->parallel == NULL) return 0;
+
+    return gc_parallel_sweep_pending(gc_stub->parallel, (size_t)(-1));
+}
+
+
+/* Remembered Set */
+
+static int gc_remembered_set_push(gc_remembered_set_t *remembered, \
+        gc_object_table_item_t *item)
+{
+    gc_object_table_item_t **new_items;
+    size_t new_capacity;
+
+    if (remembered->size == remembered->capacity)
+    {
+        new_capacity = (remembered->capacity == 0) ? GC_MARK_STACK_CAPACITY_INIT : remembered->capacity * 2;
+        new_items = (gc_object_table_item_t **)realloc(remembered->items, \
+                sizeof(gc_object_table_item_t *) * new_capacity);
+        if (new_items == NULL) 
+        {
+            remembered->overflow = 1;
+            return -1;
+        }
+        remembered->items = new_items;
+        remembered->capacity = new_capacity;
+    }
+    remembered->items[remembered->size++] = item;
+    item->remembered = remembered->size;
+
+    return 0;
+}
+
+static int gc_remembered_set_remove(gc_remembered_set_t *remembered, \
+        struct gc_object_table_item *object_table_item)
+{
+    size_t idx = object_table_item->remembered - 1;
+
+    /* The last one takes the place */
+    remembered->items[idx] = remembered->items[--remembered->size];
+    remembered->items[idx]->remembered = idx + 1;
+    object_table_item->remembered = 0;
+
+    return 0;
+}
+
+static int gc_remembered_set_rebuild_list(gc_remembered_set_t *remembered, \
+        gc_object_table_item_list_t *list)
+{
+    gc_object_table_item_t *table_item_cur;
+
+    table_item_cur = list->begin;
+    while (table_item_cur != NULL)
+    {
+        gc_remembered_set_push(remembered, table_item_cur);
+        table_item_cur = table_item_cur->next;
+    }
+
+    return 0;
+}
+
+/* Stores were missed while the set could not grow, so every old item 
+ * is remembered, the next minor collection drops those without young ones */
+static int gc_remembered_set_rebuild(gc_stub_t *gc_stub)
+{
+    gc_remembered_set_t *remembered = &gc_stub->remembered;
+    size_t idx;
+
+    for (idx = 0; idx != remembered->size; idx++)
+    { remembered->items[idx]->remembered = 0; }
+    remembered->size = 0;
+    remembered->overflow = 0;
+    gc_remembered_set_rebuild_list(remembered, gc_stub->obj_tbl->survivor);
+    gc_remembered_set_rebuild_list(remembered, gc_stub->obj_tbl->permanent);
+
+    return 0;
+}
+
+int gc_remember(gc_object_table_item_t *item)
+{
+    gc_remembered_set_push(&item->gc_stub->remembered, item);
+
+    return 0;
+}
+
+int gc_untrack(gc_object_table_item_t *item)
+{
+    item->untracked = 1;
+    /* Already shaded by the running marking */
+    if (item->mark != 0) gc_rescan_record(item);
 
     return 0;
 }
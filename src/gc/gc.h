@@ -22,6 +22,8 @@
 
 #include <stdio.h>
 
+#include "spinlock.h"
+
 
 /* Object Item Type */
 enum gc_object_table_item_type
@@ -48,11 +50,24 @@ struct gc_object_table_item
 	gc_object_table_item_type_t type;
 	size_t mark_count;
 
+	/* Position in the remembered set of the stub plus one, 0 if not in */
+	size_t remembered;
+	/* Stores into it are not caught by gc_write_barrier(), 
+	 * stays remembered as long as it is old, and is traced again 
+	 * at the end of incremental marking (gc_untrack()) */
+	int untracked;
+
+	/* Kind of the object, given by the user of the stub for statistics */
+	int tag;
+
 	void *internal_object_ptr;
 
 	int (*internal_marker)(void *internal_object_ptr);
 	int (*internal_collector)(void *internal_object_ptr, int *confirm);
 
+	/* The stub the item registered to */
+	struct gc_stub *gc_stub;
+
     struct gc_object_table_item *next;
     struct gc_object_table_item *prev;
 };
@@ -78,10 +93,144 @@ struct gc_object_table
 typedef struct gc_object_table gc_object_table_t;
 
 
+/* Mark Stack */
+
+/* Marked items whose children have not been marked yet */
+struct gc_mark_stack
+{
+    struct gc_object_table_item **items;
+    size_t size;
+    size_t capacity;
+
+    /* Set while draining, marks made by markers only push */
+    int draining;
+};
+typedef struct gc_mark_stack gc_mark_stack_t;
+
+
+/* Remembered Set */
+
+/* Old items that might reference eden items, roots of minor GC */
+struct gc_remembered_set
+{
+    struct gc_object_table_item **items;
+    size_t size;
+    size_t capacity;
+
+    /* Failed to grow, every old item is a root until rebuilt */
+    int overflow;
+};
+typedef struct gc_remembered_set gc_remembered_set_t;
+
+
+/* Parallel Collection */
+
+struct gc_parallel;
+
+/* A helper thread, the first one is the collecting thread itself */
+struct gc_parallel_worker
+{
+    struct gc_parallel *parallel;
+
+    gc_mark_stack_t mark_stack;
+    /* Guards the mark stack against other workers stealing */
+    mutex_t lock;
+
+    thread_handle_t handle;
+    thread_event_t event;
+    int generation;
+};
+
+struct gc_parallel
+{
+    struct gc_stub *gc_stub;
+
+    struct gc_parallel_worker *workers;
+    size_t workers_count;
+
+    /* A new round of marking is published by bumping the generation */
+    volatile int generation;
+    volatile int exiting;
+    volatile int idle;
+    volatile int finished;
+    thread_event_t event_finished;
+
+    /* Concurrent sweeping 
+     * Unmarked items are detached from the tables during the pause and
+     * collected by the sweeper later, with the lock (GIL) held */
+    int concurrent_sweep;
+    struct gc_object_table_item *pending;
+    thread_handle_t sweeper_handle;
+    thread_event_t sweeper_event;
+    int (*lock)(void *data);
+    int (*unlock)(void *data);
+    void *lock_data;
+};
+typedef struct gc_parallel gc_parallel_t;
+
+
+/* Phase of an incremental collection */
+enum gc_phase
+{
+    GC_PHASE_IDLE = 0,
+    /* Tracing in slices, marked items on the mark stack are gray */
+    GC_PHASE_MARK,
+    /* Collecting unmarked items in slices */
+    GC_PHASE_SWEEP,
+};
+typedef enum gc_phase gc_phase_t;
+
 /* Data structure that maintains things been used on GC */
+/* Statistics */
+
+/* Pauses by powers of two microseconds, bucket 0 for less than 1us,
+ * bucket n for [2^(n-1), 2^n), the last one takes all the longer */
+#define GC_STATS_PAUSE_BUCKETS 24
+
+struct gc_stats
+{
+    /* Collections finished, and incremental slices run */
+    size_t major;
+    size_t minor;
+    size_t slices;
+
+    /* Items collected, and moved from eden to survivor */
+    size_t swept;
+    size_t promoted;
+
+    /* Pauses of the program, in microseconds */
+    size_t pauses[GC_STATS_PAUSE_BUCKETS];
+    unsigned long long pause_total;
+    unsigned long long pause_max;
+};
+typedef struct gc_stats gc_stats_t;
+
 struct gc_stub
 {
     gc_object_table_t *obj_tbl;
+    gc_mark_stack_t mark_stack;
+
+    /* Incremental collection */
+    gc_phase_t phase;
+    gc_object_table_item_list_t *sweep_list;
+    gc_object_table_item_t *sweep_cursor;
+    /* Untracked items marked in the current incremental marking */
+    gc_mark_stack_t rescan;
+    /* Failed to grow, every marked untracked item is traced again */
+    int rescan_overflow;
+    /* Items traced and references scanned, the budget of marking slices */
+    size_t work;
+
+    /* Helper threads, NULL for collecting on the calling thread only */
+    gc_parallel_t *parallel;
+
+    /* Set while marking for a minor collection */
+    int minor;
+    /* Eden items reached, counted while marking for a minor collection */
+    size_t minor_young_reached;
+    gc_remembered_set_t remembered;
+
+    gc_stats_t stats;
 };
 typedef struct gc_stub gc_stub_t;
 
@@ -114,6 +263,82 @@ int gc_transport_to_survivor(gc_stub_t *gc_stub, \
 
 /* Collect */
 int gc_collect(gc_stub_t *gc_stub);
+
+/* Record a pause of 'us' microseconds */
+int gc_stats_pause(gc_stub_t *gc_stub, unsigned long long us);
+/* Count items of each tag below 'count' in all the tables */
+int gc_stats_count_tags(gc_stub_t *gc_stub, size_t *counts, size_t count);
+
+/* Minor Collection 
+ * Only eden items are marked and collected. Old items in the remembered
+ * set are taken as roots, their children are marked but nothing old is
+ * traced any further. An old item gets into the set when promoted 
+ * and when stored into (gc_write_barrier()), and leaves it once it is
+ * found referencing no eden item. */
+int gc_minor_begin(gc_stub_t *gc_stub);
+/* Mark from the remembered set after the roots, and end marking */
+int gc_minor_mark_finish(gc_stub_t *gc_stub);
+/* Move marked eden items survived 'age' collections to survivor */
+int gc_minor_promote(gc_stub_t *gc_stub, size_t age);
+/* Collect unmarked eden items */
+int gc_minor_collect(gc_stub_t *gc_stub);
+
+/* Incremental Collection 
+ * While marking, gc_mark_major() only shades items, the tracing is done
+ * by gc_incremental_mark() in slices of 'budget' units of work, an item 
+ * traced and a reference scanned are one unit each. The mutator keeps the
+ * invariant by shading every reference stored into an item (Dijkstra's 
+ * barrier in gc_write_barrier()). References held by the roots and the 
+ * untracked items are not caught, so the roots are marked again and the 
+ * untracked items are traced again (gc_incremental_rescan()) before 
+ * finishing. Items registered while marking start gray and those 
+ * registered while sweeping start black. */
+int gc_incremental_begin(gc_stub_t *gc_stub);
+/* Returns 1 if there is nothing gray remaining */
+int gc_incremental_mark(gc_stub_t *gc_stub, size_t budget);
+/* Trace the untracked items marked so far again, before gc_mark_finish() */
+int gc_incremental_rescan(gc_stub_t *gc_stub);
+int gc_incremental_sweep_begin(gc_stub_t *gc_stub);
+/* Returns 1 if all the tables have been swept */
+int gc_incremental_sweep(gc_stub_t *gc_stub, size_t budget);
+/* Give up the current collection (before a complete one) */
+int gc_incremental_abort(gc_stub_t *gc_stub);
+
+/* Barrier */
+#define gc_shade(item) \
+    do { \
+        if (((item) != NULL) && ((item)->gc_stub->phase == GC_PHASE_MARK)) \
+        { gc_shade_slow(item); } \
+    } while (0)
+int gc_shade_slow(gc_object_table_item_t *item);
+
+/* Barrier, before storing a reference to 'value' into the item, 
+ * remembers an old item for minor GC and shades 'value' while marking */
+#define gc_write_barrier(item, value) \
+    do { \
+        if (((item) != NULL) && ((item)->type != GC_OBJECT_TABLE_ITEM_TYPE_EDEN) && \
+                ((item)->remembered == 0)) \
+        { gc_remember(item); } \
+        gc_shade(value); \
+    } while (0)
+int gc_remember(gc_object_table_item_t *item);
+
+/* Stores into the item are not caught by gc_write_barrier() */
+int gc_untrack(gc_object_table_item_t *item);
+
+/* Trace everything gray (with the helpers if any) and end marking */
+int gc_mark_finish(gc_stub_t *gc_stub);
+
+/* Parallel Collection 
+ * 'threads' in total including the collecting thread, 
+ * 'lock' and 'unlock' are needed by concurrent sweeping only */
+int gc_parallel_start(gc_stub_t *gc_stub, size_t threads, int concurrent_sweep, \
+        int (*lock)(void *data), int (*unlock)(void *data), void *lock_data);
+/* Join the helpers and collect the pending items */
+int gc_parallel_stop(gc_stub_t *gc_stub);
+/* Collect the items left to the sweeper on the calling thread, 
+ * which holds the lock */
+int gc_parallel_sweep_now(gc_stub_t *gc_stub);
 /*int gc_perform_major(gc_stub_t *gc_stub);*/
 /*int gc_perform_major_feedback(gc_stub_t *gc_stub);*/
 /*int gc_perform_minor(gc_stub_t *gc_stub);*/
@@ -23,6 +23,11 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <time.h>
+
+#if defined(WINDOWS)
+#include <windows.h>
+#endif
 
 #include "multiple_ir.h"
 #include "multiple_err.h"
@@ -39,6 +44,25 @@
 #include "gc.h"
 
 
+/* Monotonic clock in microseconds */
+static unsigned long long virtual_machine_gc_clock_us(void)
+{
+#if defined(WINDOWS)
+    LARGE_INTEGER frequency, counter;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (unsigned long long)(counter.QuadPart / frequency.QuadPart) * 1000000ULL + \
+        (unsigned long long)(counter.QuadPart % frequency.QuadPart) * 1000000ULL / (unsigned long long)frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+#endif
+}
+
+
 /* Register Reference Type Object */
 
 int virtual_machine_resource_reference_register( \
@@ -60,6 +84,19 @@ int virtual_machine_resource_reference_register( \
     { return ret; }
 
     object_src->object_table_item_ptr = target_object_table_item;
+    target_object_table_item->tag = (int)object_src->type;
+
+    /* Hold running stack frames, which are stored into without barriers */
+    switch (object_src->type)
+    {
+        case OBJECT_TYPE_FUNCTION:
+        case OBJECT_TYPE_ENV:
+        case OBJECT_TYPE_ENV_ENT:
+            gc_untrack(target_object_table_item);
+            break;
+        default:
+            break;
+    }
 
     return 0;
 }
@@ -164,10 +201,38 @@ int virtual_machine_marks_environment_stack(struct virtual_machine_environment_s
     return 0;
 }
 
+/* Generators suspended by the frame are marked with it, 
+ * including the ones suspended by the generators */
+static int virtual_machine_marks_running_stack_frame(struct virtual_machine_running_stack_frame *running_stack_frame, int type)
+{
+    struct virtual_machine_running_stack_frame *generator_running_stack_frame_cur;
+
+    /* Variables and computing stack */
+    virtual_machine_marks_variable_list(running_stack_frame->variables, type);
+    virtual_machine_marks_computing_stack(running_stack_frame->computing_stack, type);
+    virtual_machine_marks_computing_stack(running_stack_frame->arguments, type);
+
+    /* Environment */
+    if (running_stack_frame->environment_entrance != NULL)
+    {
+        virtual_machine_marks_object(running_stack_frame->environment_entrance, type);
+    }
+
+    /* Generators */
+    generator_running_stack_frame_cur = running_stack_frame->generators->begin;
+    while (generator_running_stack_frame_cur != NULL)
+    {
+        virtual_machine_marks_running_stack_frame(generator_running_stack_frame_cur, type);
+        generator_running_stack_frame_cur = generator_running_stack_frame_cur->next;
+    }
+
+    return 0;
+}
+
 int virtual_machine_marks_thread(struct virtual_machine_thread *thread, int type)
 {
     struct virtual_machine_message *message_cur;
-    struct virtual_machine_running_stack_frame *running_stack_frame_cur, *generator_running_stack_frame_cur;
+    struct virtual_machine_running_stack_frame *running_stack_frame_cur;
 
     /* Messages */
     message_cur = thread->messages->begin;
@@ -181,53 +246,24 @@ int virtual_machine_marks_thread(struct virtual_machine_thread *thread, int type
     running_stack_frame_cur = thread->running_stack->bottom;
     while (running_stack_frame_cur != NULL)
     {
-
-        /* Variables and computing stack */
-        virtual_machine_marks_variable_list(running_stack_frame_cur->variables, type);
-        virtual_machine_marks_computing_stack(running_stack_frame_cur->computing_stack, type);
-        virtual_machine_marks_computing_stack(running_stack_frame_cur->arguments, type);
-
-        /* Environment */
-        virtual_machine_marks_object(running_stack_frame_cur->environment_entrance, type);
-
-        /* Generators */
-        generator_running_stack_frame_cur = running_stack_frame_cur->generators->begin;
-        while (generator_running_stack_frame_cur != NULL)
-        {
-            /* Variables and computing stack */
-            virtual_machine_marks_variable_list(generator_running_stack_frame_cur->variables, \
-                    type);
-            virtual_machine_marks_computing_stack(generator_running_stack_frame_cur->computing_stack, \
-                    type);
-            virtual_machine_marks_computing_stack(generator_running_stack_frame_cur->arguments, \
-                    type);
-            if (generator_running_stack_frame_cur->environment_entrance != NULL)
-            {
-                virtual_machine_marks_object(generator_running_stack_frame_cur->environment_entrance, type);
-            }
-
-            generator_running_stack_frame_cur = generator_running_stack_frame_cur->next;
-        }
-
+        virtual_machine_marks_running_stack_frame(running_stack_frame_cur, type);
         running_stack_frame_cur = running_stack_frame_cur->next;
     }
 
+    /* Borrowed by native code */
+    if (thread->pinned != NULL)
+    { virtual_machine_marks_computing_stack(thread->pinned, type); }
+
     return 0;
 }
 
-static int virtual_machine_garbage_collect_raw(struct virtual_machine *vm, int type)
+static int virtual_machine_marks_roots(struct virtual_machine *vm, int type)
 {
-    int ret = 0;
-
     struct virtual_machine_module *module_cur;
     struct virtual_machine_thread *thread_cur;
 
     struct virtual_machine_external_event *external_event_cur; 
 
-    /* Clear marks */
-    if ((ret = virtual_machine_marks_clear(vm)) != 0)
-    { goto fail; }
-
     /* External Events */
     thread_mutex_lock(&vm->external_events->lock);
     external_event_cur = vm->external_events->begin;
@@ -261,42 +297,32 @@ static int virtual_machine_garbage_collect_raw(struct virtual_machine *vm, int t
         thread_cur = thread_cur->next;
     }
 
-    goto done;
-fail:
-done:
-    return ret;
+    return 0;
 }
 
-static int virtual_machine_garbage_collect_minor_survivor(struct virtual_machine *vm)
+static int virtual_machine_garbage_collect_raw(struct virtual_machine *vm, int type)
 {
     int ret = 0;
-    struct gc_object_table_item *table_item_cur, *table_item_target;
 
-    (void)vm;
+    /* A complete collection takes over the incremental one */
+    gc_incremental_abort(vm->gc_stub);
 
-    table_item_cur = vm->gc_stub->obj_tbl->eden->begin;
-    while (table_item_cur != NULL)
+    if ((type == VIRTUAL_MACHINE_GARBAGE_COLLECT_MAJOR) && (vm->gc_stub->parallel != NULL))
     {
-        if (table_item_cur->mark == 1)
-        {
-            if (table_item_cur->mark_count >= VIRTUAL_MACHINE_SURVIVOR_THRESHOLD)
-            {
-                table_item_target = table_item_cur;
-                table_item_cur = table_item_cur->next;
-
-                ret = gc_transport_to_survivor( \
-                        vm->gc_stub, \
-                        table_item_target);
-                if (ret != 0) { goto fail; }
-            }
-        }
-        else
-        {
-            /* Skip to next item only when current item not been collected */
-            table_item_cur = table_item_cur->next;
-        }
+        /* Gather the roots gray, then trace them with all the helpers */
+        gc_incremental_begin(vm->gc_stub);
+        if ((ret = virtual_machine_marks_roots(vm, type)) != 0)
+        { goto fail; }
+        ret = gc_mark_finish(vm->gc_stub);
+        goto fail;
     }
 
+    /* Clear marks */
+    if ((ret = virtual_machine_marks_clear(vm)) != 0)
+    { goto fail; }
+
+    ret = virtual_machine_marks_roots(vm, type);
+
 fail:
     return ret;
 }
@@ -304,6 +330,7 @@ fail:
 int virtual_machine_garbage_collect(struct virtual_machine *vm)
 {
     int ret = 0;
+    unsigned long long time_start = virtual_machine_gc_clock_us();
 
     /*
     static unsigned int gc_time = 0;
@@ -315,12 +342,91 @@ int virtual_machine_garbage_collect(struct virtual_machine *vm)
 
     /* Collect unmarked objects */
     gc_collect(vm->gc_stub);
+
+    vm->gc_stub->stats.major++;
+    gc_stats_pause(vm->gc_stub, virtual_machine_gc_clock_us() - time_start);
 fail:
     return ret;
 }
 
+/* Next major GC when the old tables have grown by vm->gc_old_growth percent */
+static int virtual_machine_garbage_collect_old_limit_update(struct virtual_machine *vm)
+{
+    size_t old_size = vm->gc_stub->obj_tbl->survivor->size + vm->gc_stub->obj_tbl->permanent->size;
+
+    vm->gc_old_limit = old_size + old_size / 100 * vm->gc_old_growth;
+    if (vm->gc_old_limit < vm->gc_eden_limit) { vm->gc_old_limit = vm->gc_eden_limit; }
+
+    return 0;
+}
+
+static int virtual_machine_garbage_collect_generational(struct virtual_machine *vm)
+{
+    gc_object_table_t *obj_tbl = vm->gc_stub->obj_tbl;
+    int lack = virtual_machine_resource_lack(vm->resource);
+
+    /* Most garbage dies young */
+    if ((obj_tbl->eden->size >= vm->gc_eden_limit) || (lack != 0))
+    { virtual_machine_garbage_collect_minor(vm); }
+
+    /* The old tables grown, or the young garbage is not enough */
+    if ((obj_tbl->survivor->size + obj_tbl->permanent->size >= vm->gc_old_limit) || \
+            ((lack != 0) && (virtual_machine_resource_lack(vm->resource) != 0)))
+    {
+        if ((vm->gc_slice_work != 0) || (vm->gc_slice_us != 0))
+        {
+            /* Carried on in slices, the limit is updated when finished */
+            virtual_machine_garbage_collect_incremental(vm);
+            return 0;
+        }
+        virtual_machine_garbage_collect(vm);
+        virtual_machine_garbage_collect_old_limit_update(vm);
+    }
+
+    if (lack != 0)
+    { virtual_machine_resource_feedback(vm->resource); }
+
+    return 0;
+}
+
+/* Over the heap limit, collect everything before giving up */
+static int virtual_machine_garbage_collect_heap_exceeded(struct virtual_machine *vm)
+{
+    virtual_machine_garbage_collect(vm);
+    gc_parallel_sweep_now(vm->gc_stub);
+    virtual_machine_resource_feedback(vm->resource);
+    if (vm->gc_generational != 0)
+    { virtual_machine_garbage_collect_old_limit_update(vm); }
+
+    if (virtual_machine_resource_heap_exceeded(vm->resource) != 0)
+    {
+        vm_err_update(vm->r, -VM_ERR_OUT_OF_MEMORY, \
+                "runtime error: out of memory, heap limit of %lu bytes exceeded", \
+                (unsigned long)vm->resource->heap_limit);
+        return -MULTIPLE_ERR_VM;
+    }
+
+    return 0;
+}
+
 int virtual_machine_garbage_collect_and_feedback(struct virtual_machine *vm)
 {
+    vm->resource->heap_pressure = 0;
+    if (virtual_machine_resource_heap_exceeded(vm->resource) != 0)
+    { return virtual_machine_garbage_collect_heap_exceeded(vm); }
+
+    if ((vm->gc_generational != 0) && (vm->gc_stub->phase == GC_PHASE_IDLE))
+    { return virtual_machine_garbage_collect_generational(vm); }
+
+    if ((vm->gc_slice_work != 0) || (vm->gc_slice_us != 0))
+    {
+        /* Carry on the running collection, or start one when needed */
+        if ((vm->gc_stub->phase != GC_PHASE_IDLE) || \
+                virtual_machine_resource_lack(vm->resource))
+        { virtual_machine_garbage_collect_incremental(vm); }
+        return 0;
+    }
+
     if (virtual_machine_resource_lack(vm->resource))
     {
         virtual_machine_garbage_collect(vm);
@@ -332,24 +438,136 @@ int virtual_machine_garbage_collect_and_feedback(struct virtual_machine *vm)
 
 int virtual_machine_garbage_collect_minor(struct virtual_machine *vm)
 {
-    int ret = 0;
+    unsigned long long time_start;
 
-    ret = virtual_machine_garbage_collect_raw(vm, VIRTUAL_MACHINE_GARBAGE_COLLECT_MINOR);
-    if (ret != 0) goto fail;
+    /* Not in the middle of an incremental major GC */
+    if (vm->gc_stub->phase != GC_PHASE_IDLE) return 0;
+
+    time_start = virtual_machine_gc_clock_us();
+
+    gc_minor_begin(vm->gc_stub);
+    virtual_machine_marks_roots(vm, VIRTUAL_MACHINE_GARBAGE_COLLECT_MINOR);
+    gc_minor_mark_finish(vm->gc_stub);
 
     /* Lock */
     thread_mutex_lock(&vm->external_events->lock);
 
     /* Move aged objects from youth to survivors */
-    virtual_machine_garbage_collect_minor_survivor(vm);
+    gc_minor_promote(vm->gc_stub, vm->gc_promote_age);
 
     /* Collect unmarked objects */
-    gc_collect(vm->gc_stub);
+    gc_minor_collect(vm->gc_stub);
 
     /* Unlock */
     thread_mutex_unlock(&vm->external_events->lock);
 
-fail:
+    vm->gc_stub->stats.minor++;
+    gc_stats_pause(vm->gc_stub, virtual_machine_gc_clock_us() - time_start);
+
+    return 0;
+}
+
+
+/* Incremental GC */
+
+/* Work done between two checks of the clock */
+#define VIRTUAL_MACHINE_GC_SLICE_CHUNK 256
+
+/* Run marking or sweeping within the budget, returns 1 when finished */
+static int virtual_machine_garbage_collect_incremental_run(struct virtual_machine *vm, \
+        int (*func)(gc_stub_t *gc_stub, size_t budget))
+{
+    unsigned long long deadline;
+    int finished;
+
+    if (vm->gc_slice_us == 0)
+    { return func(vm->gc_stub, vm->gc_slice_work); }
+
+    deadline = virtual_machine_gc_clock_us() + vm->gc_slice_us;
+    do
+    {
+        finished = func(vm->gc_stub, VIRTUAL_MACHINE_GC_SLICE_CHUNK);
+    } while ((finished == 0) && (virtual_machine_gc_clock_us() < deadline));
+
+    return finished;
+}
+
+int virtual_machine_garbage_collect_incremental(struct virtual_machine *vm)
+{
+    gc_stub_t *gc_stub = vm->gc_stub;
+    unsigned long long time_start = virtual_machine_gc_clock_us();
+
+    switch (gc_stub->phase)
+    {
+        case GC_PHASE_IDLE:
+            /* Shade the roots, tracing starts from the next slice */
+            gc_incremental_begin(gc_stub);
+            virtual_machine_marks_roots(vm, VIRTUAL_MACHINE_GARBAGE_COLLECT_MAJOR);
+            break;
+
+        case GC_PHASE_MARK:
+            if (virtual_machine_garbage_collect_incremental_run(vm, &gc_incremental_mark) != 0)
+            {
+                /* Roots and untracked items have changed without barriers
+                 * since shaded, finish with them at once */
+                virtual_machine_marks_roots(vm, VIRTUAL_MACHINE_GARBAGE_COLLECT_MAJOR);
+                gc_incremental_rescan(gc_stub);
+                gc_mark_finish(gc_stub);
+                gc_incremental_sweep_begin(gc_stub);
+            }
+            break;
+
+        case GC_PHASE_SWEEP:
+            if (virtual_machine_garbage_collect_incremental_run(vm, &gc_incremental_sweep) != 0)
+            {
+                gc_stub->stats.major++;
+                virtual_machine_resource_feedback(vm->resource);
+                if (vm->gc_generational != 0)
+                { virtual_machine_garbage_collect_old_limit_update(vm); }
+            }
+            break;
+    }
+
+    gc_stub->stats.slices++;
+    gc_stats_pause(gc_stub, virtual_machine_gc_clock_us() - time_start);
+
+    return 0;
+}
+
+
+/* GC Helper Threads */
+
+static int virtual_machine_garbage_collect_gil_lock(void *data)
+{
+    return virtual_machine_gil_lock((struct virtual_machine *)data);
+}
+
+static int virtual_machine_garbage_collect_gil_unlock(void *data)
+{
+    return virtual_machine_gil_unlock((struct virtual_machine *)data);
+}
+
+int virtual_machine_garbage_collect_helpers_start(struct virtual_machine *vm)
+{
+    int ret = 0;
+
+    if ((vm->gc_threads <= 1) && (vm->gc_concurrent_sweep == 0)) return 0;
+
+    /* The sweeper runs collectors, only while holding the GIL */
+    if (gc_parallel_start(vm->gc_stub, vm->gc_threads, vm->gc_concurrent_sweep, \
+                &virtual_machine_garbage_collect_gil_lock, \
+                &virtual_machine_garbage_collect_gil_unlock, \
+                vm) != 0)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+    }
+
     return ret;
 }
 
+int virtual_machine_garbage_collect_helpers_stop(struct virtual_machine *vm)
+{
+    return gc_parallel_stop(vm->gc_stub);
+}
+
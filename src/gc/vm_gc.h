@@ -28,8 +28,6 @@
 #define VIRTUAL_MACHINE_GARBAGE_COLLECT_MINOR 0
 #define VIRTUAL_MACHINE_GARBAGE_COLLECT_MAJOR 1
 
-#define VIRTUAL_MACHINE_SURVIVOR_THRESHOLD 10
-
 /* Register Reference Type Object */
 int virtual_machine_resource_reference_register( \
         gc_stub_t *gc_stub, \
@@ -45,12 +43,20 @@ int virtual_machine_resource_reference_unregister( \
 int virtual_machine_garbage_collect(struct virtual_machine *vm);
 int virtual_machine_garbage_collect_and_feedback(struct virtual_machine *vm);
 
+/* Do a slice of incremental marking or sweeping 
+ * (budget in vm->gc_slice_work or vm->gc_slice_us) */
+int virtual_machine_garbage_collect_incremental(struct virtual_machine *vm);
+
+/* Start and stop the marking helpers and the concurrent sweeper 
+ * (vm->gc_threads, vm->gc_concurrent_sweep) */
+int virtual_machine_garbage_collect_helpers_start(struct virtual_machine *vm);
+int virtual_machine_garbage_collect_helpers_stop(struct virtual_machine *vm);
+
 /* Do minor GC
- * 1: Mark objects (only in youth age)
+ * 1: Mark objects (only in youth age) from the roots and the old objects
  * 2: Increase 'age' of the marked objects
- * 3: Sweep the rest objects
- * 4: Move objects which of threshold age to survivor items
- * 5: Maintain a table which record objects referenced by survivors
+ * 3: Move objects of vm->gc_promote_age to survivor items
+ * 4: Sweep the rest objects in youth age
  */
 int virtual_machine_garbage_collect_minor(struct virtual_machine *vm);
 
@@ -29,6 +29,11 @@
 #include "multiple_err.h"
 
 
+/* Heap Limit : GC at 75% of the limit, 1/8 of it reserved beyond */
+#define VIRTUAL_MACHINE_RESOURCE_HEAP_TRIGGER(limit) (((limit) >> 1) + ((limit) >> 2))
+#define VIRTUAL_MACHINE_RESOURCE_HEAP_RESERVE_DIV 8
+
+
 /* Write Barriers */
 struct virtual_machine_write_barrier *virtual_machine_write_barrier_new(void)
 {
@@ -191,6 +196,7 @@ struct virtual_machine_resource_source *virtual_machine_resource_source_new(\
         int (*pool_free)(void *pool_ptr, void *ptr),
         int (*lack)(void *pool_ptr),
         int (*feedback)(void *pool_ptr),
+        int (*stat)(void *pool_ptr, size_t *size_used, size_t *size_total, size_t *size_extra),
         size_t size)
 {
     struct virtual_machine_resource_source *new_resource_source = NULL;
@@ -203,6 +209,10 @@ struct virtual_machine_resource_source *virtual_machine_resource_source_new(\
     new_resource_source->free = pool_free;
     new_resource_source->lack = lack;
     new_resource_source->feedback = feedback;
+    new_resource_source->stat = stat;
+    new_resource_source->allocated = 0;
+    new_resource_source->allocations = 0;
+    new_resource_source->frees = 0;
     new_resource_source->pool = (new_resource_source->init)(size);
     goto done;
 fail:
@@ -227,6 +237,7 @@ static struct virtual_machine_resource_source *virtual_machine_resource_source_n
                     &virtual_machine_resource_pool_plain_free, 
                     &virtual_machine_resource_pool_plain_lack, 
                     NULL, 
+                    NULL, 
                     size);
         case VIRTUAL_MACHINE_STARTUP_MEM_TYPE_PAGED_FALLBACK:
             return virtual_machine_resource_source_new(\
@@ -236,6 +247,7 @@ static struct virtual_machine_resource_source *virtual_machine_resource_source_n
                     &virtual_machine_resource_pool_page_free, 
                     &virtual_machine_resource_pool_page_lack, 
                     NULL, 
+                    &virtual_machine_resource_pool_page_stat, 
                     size);
         case VIRTUAL_MACHINE_STARTUP_MEM_TYPE_PAGED_64B_FALLBACK:
             return virtual_machine_resource_source_new(\
@@ -245,6 +257,7 @@ static struct virtual_machine_resource_source *virtual_machine_resource_source_n
                     &virtual_machine_resource_pool_page_free, 
                     &virtual_machine_resource_pool_page_lack, 
                     NULL, 
+                    &virtual_machine_resource_pool_page_stat, 
                     size);
         case VIRTUAL_MACHINE_STARTUP_MEM_TYPE_PAGED_128B_FALLBACK:
             return virtual_machine_resource_source_new(\
@@ -254,6 +267,7 @@ static struct virtual_machine_resource_source *virtual_machine_resource_source_n
                     &virtual_machine_resource_pool_page_free, 
                     &virtual_machine_resource_pool_page_lack, 
                     NULL,
+                    &virtual_machine_resource_pool_page_stat, 
                     size);
         case VIRTUAL_MACHINE_STARTUP_MEM_TYPE_LINKED_FALLBACK:
             return virtual_machine_resource_source_new(\
@@ -263,6 +277,7 @@ static struct virtual_machine_resource_source *virtual_machine_resource_source_n
                     &virtual_machine_resource_pool_linked_free, 
                     &virtual_machine_resource_pool_linked_lack, 
                     &virtual_machine_resource_pool_linked_feedback, 
+                    &virtual_machine_resource_pool_linked_stat, 
                     size);
         case VIRTUAL_MACHINE_STARTUP_MEM_TYPE_LINKED_64B_FALLBACK:
             return virtual_machine_resource_source_new(\
@@ -272,6 +287,7 @@ static struct virtual_machine_resource_source *virtual_machine_resource_source_n
                     &virtual_machine_resource_pool_linked_free, 
                     &virtual_machine_resource_pool_linked_lack, 
                     &virtual_machine_resource_pool_linked_feedback, 
+                    &virtual_machine_resource_pool_linked_stat, 
                     size);
         case VIRTUAL_MACHINE_STARTUP_MEM_TYPE_LINKED_128B_FALLBACK:
             return virtual_machine_resource_source_new(\
@@ -281,6 +297,7 @@ static struct virtual_machine_resource_source *virtual_machine_resource_source_n
                     &virtual_machine_resource_pool_linked_free, 
                     &virtual_machine_resource_pool_linked_lack, 
                     &virtual_machine_resource_pool_linked_feedback, 
+                    &virtual_machine_resource_pool_linked_stat, 
                     size);
         default:
             return NULL;
@@ -307,6 +324,12 @@ struct virtual_machine_resource *virtual_machine_resource_new(struct virtual_mac
 
     for (idx = 0; idx != VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT; idx++)
     { new_resource->sources[idx] = NULL; }
+    new_resource->heap_limit = (startup != NULL) ? startup->heap_limit : 0;
+    new_resource->heap_reserve = new_resource->heap_limit / VIRTUAL_MACHINE_RESOURCE_HEAP_RESERVE_DIV;
+    new_resource->heap_trigger = VIRTUAL_MACHINE_RESOURCE_HEAP_TRIGGER(new_resource->heap_limit);
+    new_resource->heap_used = 0;
+    new_resource->heap_pressure = 0;
+    new_resource->r = NULL;
 
     if (startup == NULL)
     {
@@ -318,6 +341,7 @@ struct virtual_machine_resource *virtual_machine_resource_new(struct virtual_mac
                 &virtual_machine_resource_pool_plain_free, 
                 &virtual_machine_resource_pool_plain_lack, 
                 NULL, 
+                NULL, 
                 0);
         new_resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE] = virtual_machine_resource_source_new(\
                 &virtual_machine_resource_pool_plain_init, 
@@ -326,6 +350,7 @@ struct virtual_machine_resource *virtual_machine_resource_new(struct virtual_mac
                 &virtual_machine_resource_pool_plain_free, 
                 &virtual_machine_resource_pool_plain_lack, 
                 NULL,
+                NULL, 
                 0);
         new_resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE] = virtual_machine_resource_source_new(\
                 &virtual_machine_resource_pool_plain_init, 
@@ -334,6 +359,7 @@ struct virtual_machine_resource *virtual_machine_resource_new(struct virtual_mac
                 &virtual_machine_resource_pool_plain_free, 
                 &virtual_machine_resource_pool_plain_lack, 
                 NULL,
+                NULL, 
                 0);
     }
     else
@@ -387,34 +413,116 @@ int virtual_machine_resource_destroy(struct virtual_machine_resource *resource)
     return 0;
 }
 
+/* Heap Limit */
+
+/* Kept in front of each block while the heap is limited, 
+ * aligned for whatever stored after it */
+union virtual_machine_resource_header
+{
+    size_t size;
+    void *ptr;
+    double number;
+};
+#define VIRTUAL_MACHINE_RESOURCE_HEADER_SIZE (sizeof(union virtual_machine_resource_header))
+
+static void *virtual_machine_resource_heap_malloc(struct virtual_machine_resource *resource, \
+        struct virtual_machine_resource_source *source, size_t size)
+{
+    union virtual_machine_resource_header *header;
+    size_t block_size = size + VIRTUAL_MACHINE_RESOURCE_HEADER_SIZE;
+
+    if ((block_size < size) || \
+            (resource->heap_used + block_size > resource->heap_limit + resource->heap_reserve))
+    {
+        if (resource->r != NULL)
+        {
+            vm_err_update(resource->r, -VM_ERR_OUT_OF_MEMORY, \
+                    "runtime error: out of memory, heap limit of %lu bytes exceeded", \
+                    (unsigned long)resource->heap_limit);
+        }
+        return NULL;
+    }
+
+    if ((header = source->malloc(source->pool, block_size)) == NULL) return NULL;
+    header->size = block_size;
+
+    /* Ask for a collection at the next chance */
+    if ((resource->heap_used < resource->heap_trigger) && \
+            (resource->heap_used + block_size >= resource->heap_trigger))
+    { resource->heap_pressure = 1; }
+    resource->heap_used += block_size;
+
+    return header + 1;
+}
+
+static int virtual_machine_resource_heap_free(struct virtual_machine_resource *resource, \
+        struct virtual_machine_resource_source *source, void *ptr)
+{
+    union virtual_machine_resource_header *header;
+
+    if (ptr == NULL) return 0;
+    header = (union virtual_machine_resource_header *)ptr - 1;
+    resource->heap_used -= header->size;
+
+    return source->free(source->pool, header);
+}
+
+int virtual_machine_resource_heap_exceeded(struct virtual_machine_resource *resource)
+{
+    return ((resource->heap_limit != 0) && (resource->heap_used > resource->heap_limit)) ? 1 : 0;
+}
+
+static void *virtual_machine_resource_source_malloc(struct virtual_machine_resource *resource, \
+        int source_idx, size_t size)
+{
+    struct virtual_machine_resource_source *source = resource->sources[source_idx];
+
+    source->allocated += size;
+    source->allocations++;
+    if (resource->heap_limit != 0)
+    { return virtual_machine_resource_heap_malloc(resource, source, size); }
+    return source->malloc(source->pool, size);
+}
+
+static int virtual_machine_resource_source_free(struct virtual_machine_resource *resource, \
+        int source_idx, void *ptr)
+{
+    struct virtual_machine_resource_source *source = resource->sources[source_idx];
+
+    source->frees++;
+    if (resource->heap_limit != 0)
+    { return virtual_machine_resource_heap_free(resource, source, ptr); }
+    return source->free(source->pool, ptr);
+}
+
 void *virtual_machine_resource_malloc(struct virtual_machine_resource *resource, size_t size)
 {
-    return resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_INFRASTRUCTURE]->malloc(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_INFRASTRUCTURE]->pool, size);
+    return virtual_machine_resource_source_malloc(resource, VIRTUAL_MACHINE_RESOURCE_SOURCE_INFRASTRUCTURE, size);
 }
 
 int virtual_machine_resource_free(struct virtual_machine_resource *resource, void *ptr)
 {
-    return resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_INFRASTRUCTURE]->free(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_INFRASTRUCTURE]->pool, ptr);
+    return virtual_machine_resource_source_free(resource, VIRTUAL_MACHINE_RESOURCE_SOURCE_INFRASTRUCTURE, ptr);
 }
 
 void *virtual_machine_resource_malloc_primitive(struct virtual_machine_resource *resource, size_t size)
 {
-    return resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->malloc(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->pool, size);
+    return virtual_machine_resource_source_malloc(resource, VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE, size);
 }
 
 int virtual_machine_resource_free_primitive(struct virtual_machine_resource *resource, void *ptr)
 {
-    return resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->free(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->pool, ptr);
+    return virtual_machine_resource_source_free(resource, VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE, ptr);
 }
 
 void *virtual_machine_resource_malloc_reference(struct virtual_machine_resource *resource, size_t size)
 {
-    return resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE]->malloc(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE]->pool, size);
+    return virtual_machine_resource_source_malloc(resource, VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE, size);
 }
 
 int virtual_machine_resource_free_reference(struct virtual_machine_resource *resource, void *ptr)
 {
-    return resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE]->free(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE]->pool, ptr);
+    return virtual_machine_resource_source_free(resource, VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE, ptr);
 }
 
 
@@ -422,6 +530,8 @@ int virtual_machine_resource_free_reference(struct virtual_machine_resource *res
 
 int virtual_machine_resource_lack(struct virtual_machine_resource *resource)
 {
+    if ((resource->heap_limit != 0) && (resource->heap_used >= resource->heap_trigger))
+    { return 1; }
     if (resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->lack(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->pool) != 0)
     { return 1; }
     if (resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE]->lack(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_REFERENCE]->pool) != 0)
@@ -431,6 +541,17 @@ int virtual_machine_resource_lack(struct virtual_machine_resource *resource)
 
 int virtual_machine_resource_feedback(struct virtual_machine_resource *resource)
 {
+    /* Collect more often as the heap fills up */
+    if (resource->heap_limit != 0)
+    {
+        resource->heap_trigger = VIRTUAL_MACHINE_RESOURCE_HEAP_TRIGGER(resource->heap_limit);
+        if (resource->heap_used >= resource->heap_trigger)
+        {
+            resource->heap_trigger = (resource->heap_used < resource->heap_limit) ? \
+                                     resource->heap_used + (resource->heap_limit - resource->heap_used) / 2 : \
+                                     resource->heap_limit;
+        }
+    }
     if (resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->feedback != NULL)
     {
         resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->feedback(resource->sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_PRIMITIVE]->pool);
@@ -442,3 +563,28 @@ int virtual_machine_resource_feedback(struct virtual_machine_resource *resource)
     return 0;
 }
 
+
+/* Statistics */
+
+int virtual_machine_resource_stats_get(struct virtual_machine_resource *resource, \
+        int source, struct virtual_machine_resource_stats *stats)
+{
+    struct virtual_machine_resource_source *resource_source;
+
+    if ((source < 0) || (source >= VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT)) return -MULTIPLE_ERR_NULL_PTR;
+    resource_source = resource->sources[source];
+
+    /* Counted without locking, could be a little behind */
+    stats->allocated = resource_source->allocated;
+    stats->allocations = resource_source->allocations;
+    stats->frees = resource_source->frees;
+
+    stats->pool_used = stats->pool_total = stats->pool_extra = 0;
+    if (resource_source->stat != NULL)
+    {
+        resource_source->stat(resource_source->pool, \
+                &stats->pool_used, &stats->pool_total, &stats->pool_extra);
+    }
+
+    return 0;
+}
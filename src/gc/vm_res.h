@@ -42,6 +42,13 @@ struct virtual_machine_resource_source
     int (*lack)(void *pool_ptr);
     /* Feedback */
     int (*feedback)(void *pool_ptr);
+    /* Statistics of the pool, NULL for none */
+    int (*stat)(void *pool_ptr, size_t *size_used, size_t *size_total, size_t *size_extra);
+
+    /* Counted on each call */
+    size_t allocated;
+    size_t allocations;
+    size_t frees;
 };
 struct virtual_machine_resource_source *virtual_machine_resource_source_new(\
         void *(*init)(size_t size), \
@@ -50,6 +57,7 @@ struct virtual_machine_resource_source *virtual_machine_resource_source_new(\
         int (*pool_free)(void *pool_ptr, void *ptr), \
         int (*lack)(void *pool_ptr), \
         int (*feedback)(void *pool_ptr), \
+        int (*stat)(void *pool_ptr, size_t *size_used, size_t *size_total, size_t *size_extra), \
         size_t size);
 int virtual_machine_resource_source_destroy(struct virtual_machine_resource_source *source);
 
@@ -94,6 +102,8 @@ enum
 };
 #define VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT 3
 
+struct vm_err;
+
 /* Main Data Structure of Resource Management */
 struct virtual_machine_resource
 {
@@ -102,6 +112,20 @@ struct virtual_machine_resource
 
     /* Sources */
     struct virtual_machine_resource_source *sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT];
+
+    /* Heap limit over all the sources in bytes, 0 for unlimited.
+     * Blocks get a header recording their sizes when limited.
+     * GC is requested ('heap_pressure') once 'heap_used' crosses 
+     * 'heap_trigger', allocations beyond the limit are allowed up to
+     * 'heap_reserve' more bytes for the program to be stopped safely */
+    size_t heap_limit;
+    size_t heap_reserve;
+    size_t heap_trigger;
+    size_t heap_used;
+    int heap_pressure;
+
+    /* Where the out of memory error goes */
+    struct vm_err *r;
 };
 
 struct virtual_machine_resource *virtual_machine_resource_new(struct virtual_machine_startup *startup);
@@ -122,6 +146,25 @@ int virtual_machine_resource_free_reference(struct virtual_machine_resource *res
 /* GC Interface */
 int virtual_machine_resource_lack(struct virtual_machine_resource *resource);
 int virtual_machine_resource_feedback(struct virtual_machine_resource *resource);
+/* Used more than the heap limit */
+int virtual_machine_resource_heap_exceeded(struct virtual_machine_resource *resource);
+
+/* Statistics of a source */
+struct virtual_machine_resource_stats
+{
+    /* Bytes requested, calls of malloc and free */
+    size_t allocated;
+    size_t allocations;
+    size_t frees;
+
+    /* Bytes used and held by the pool, and allocated beside it, 
+     * all 0 for the C Standard Library */
+    size_t pool_used;
+    size_t pool_total;
+    size_t pool_extra;
+};
+int virtual_machine_resource_stats_get(struct virtual_machine_resource *resource, \
+        int source, struct virtual_machine_resource_stats *stats);
 
 #endif
 
@@ -0,0 +1,461 @@
+/* Virtual Machine : Statistics
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ */
+
+#include "selfcheck.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+
+#include "multiple_err.h"
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "vm_types.h"
+#include "vm_res.h"
+#include "vm_err.h"
+#include "vm_stats.h"
+#include "vm_cpu_fused.h"
+
+#include "gc.h"
+
+
+int virtual_machine_stats_get(struct virtual_machine *vm, \
+        struct virtual_machine_stats *stats)
+{
+    gc_stub_t *gc_stub = vm->gc_stub;
+    int idx;
+
+    stats->eden = gc_stub->obj_tbl->eden->size;
+    stats->survivor = gc_stub->obj_tbl->survivor->size;
+    stats->permanent = gc_stub->obj_tbl->permanent->size;
+    stats->remembered = gc_stub->remembered.size;
+    stats->heap_limit = vm->resource->heap_limit;
+    stats->heap_used = vm->resource->heap_used;
+
+    gc_stats_count_tags(gc_stub, stats->objects, OBJECT_TYPE_FINAL);
+
+    for (idx = 0; idx != VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT; idx++)
+    { virtual_machine_resource_stats_get(vm->resource, idx, &stats->sources[idx]); }
+
+    memcpy(&stats->gc, &gc_stub->stats, sizeof(gc_stats_t));
+    memcpy(&stats->optimize, &vm->optimize_stats, sizeof(struct multiple_ir_opt_stats));
+    memcpy(stats->fused, vm->fused, sizeof(vm->fused));
+    memcpy(stats->fused_executed, vm->fused_executed, sizeof(vm->fused_executed));
+    memcpy(&stats->block_cache, &vm->block_cache_stats, sizeof(struct virtual_machine_block_cache_stats));
+
+    return 0;
+}
+
+
+/* Walking */
+
+struct virtual_machine_stats_visitor
+{
+    int (*section_begin)(void *data, const char *name);
+    int (*section_end)(void *data);
+    int (*value)(void *data, const char *name, size_t value);
+};
+
+static const char *virtual_machine_stats_source_names[VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT] = 
+{
+    "infrastructure", "primitive", "reference",
+};
+
+#define VIRTUAL_MACHINE_STATS_NAME_LEN_MAX 32
+
+static int virtual_machine_stats_walk(struct virtual_machine_stats *stats, \
+        struct virtual_machine_stats_visitor *visitor, void *data)
+{
+    int ret = 0;
+    int idx;
+    char *type_name;
+    char bucket_name[VIRTUAL_MACHINE_STATS_NAME_LEN_MAX];
+    struct virtual_machine_resource_stats *source;
+
+#define VISIT_BEGIN(name) do { if ((ret = visitor->section_begin(data, name)) != 0) goto fail; } while (0)
+#define VISIT_END() do { if ((ret = visitor->section_end(data)) != 0) goto fail; } while (0)
+#define VISIT(name, number) do { if ((ret = visitor->value(data, name, number)) != 0) goto fail; } while (0)
+
+    VISIT_BEGIN("heap");
+    VISIT("eden", stats->eden);
+    VISIT("survivor", stats->survivor);
+    VISIT("permanent", stats->permanent);
+    VISIT("remembered", stats->remembered);
+    VISIT("limit", stats->heap_limit);
+    VISIT("used", stats->heap_used);
+    VISIT_END();
+
+    VISIT_BEGIN("memory");
+    for (idx = 0; idx != VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT; idx++)
+    {
+        source = &stats->sources[idx];
+        VISIT_BEGIN(virtual_machine_stats_source_names[idx]);
+        VISIT("allocated", source->allocated);
+        VISIT("allocations", source->allocations);
+        VISIT("frees", source->frees);
+        VISIT("pool_used", source->pool_used);
+        VISIT("pool_total", source->pool_total);
+        VISIT("pool_extra", source->pool_extra);
+        VISIT_END();
+    }
+    VISIT_END();
+
+    VISIT_BEGIN("objects");
+    for (idx = OBJECT_TYPE_FIRST; idx != OBJECT_TYPE_FINAL; idx++)
+    {
+        if (stats->objects[idx] == 0) continue;
+        if ((virtual_machine_object_id_to_type_name(&type_name, NULL, \
+                        (enum virtual_machine_object_type_id)idx) != 0) || (type_name == NULL))
+        { continue; }
+        VISIT(type_name, stats->objects[idx]);
+    }
+    VISIT_END();
+
+    VISIT_BEGIN("gc");
+    VISIT("major", stats->gc.major);
+    VISIT("minor", stats->gc.minor);
+    VISIT("slices", stats->gc.slices);
+    VISIT("swept", stats->gc.swept);
+    VISIT("promoted", stats->gc.promoted);
+    VISIT("pause_total_us", (size_t)stats->gc.pause_total);
+    VISIT("pause_max_us", (size_t)stats->gc.pause_max);
+    VISIT_BEGIN("pauses");
+    for (idx = 0; idx != GC_STATS_PAUSE_BUCKETS; idx++)
+    {
+        if (stats->gc.pauses[idx] == 0) continue;
+        if (idx == GC_STATS_PAUSE_BUCKETS - 1)
+        { snprintf(bucket_name, VIRTUAL_MACHINE_STATS_NAME_LEN_MAX, "more"); }
+        else
+        { snprintf(bucket_name, VIRTUAL_MACHINE_STATS_NAME_LEN_MAX, "%luus", 1UL << idx); }
+        VISIT(bucket_name, stats->gc.pauses[idx]);
+    }
+    VISIT_END();
+    VISIT_END();
+
+    VISIT_BEGIN("optimizer");
+    VISIT("instruments_before", stats->optimize.before);
+    VISIT("instruments_after", stats->optimize.after);
+    VISIT("folded", stats->optimize.folded);
+    VISIT("threaded", stats->optimize.threaded);
+    VISIT("paired", stats->optimize.paired);
+    VISIT("unreachable", stats->optimize.unreachable);
+    VISIT_END();
+
+    VISIT_BEGIN("superinstructions");
+    VISIT_BEGIN("fused");
+    for (idx = OP_FUSED_NONE + 1; idx != OP_FUSED_COUNT; idx++)
+    { VISIT(virtual_machine_fused_name((uint32_t)idx), stats->fused[idx]); }
+    VISIT_END();
+    VISIT_BEGIN("executed");
+    for (idx = OP_FUSED_NONE + 1; idx != OP_FUSED_COUNT; idx++)
+    { VISIT(virtual_machine_fused_name((uint32_t)idx), stats->fused_executed[idx]); }
+    VISIT_END();
+    VISIT_END();
+
+    VISIT_BEGIN("block_cache");
+    VISIT("blocks", stats->block_cache.blocks);
+    VISIT("instruments", stats->block_cache.instruments);
+    VISIT("runs", stats->block_cache.runs);
+    VISIT("exits", stats->block_cache.exits);
+    VISIT("unboxed", stats->block_cache.unboxed);
+    VISIT("guards", stats->block_cache.guards);
+    VISIT_END();
+
+#undef VISIT_BEGIN
+#undef VISIT_END
+#undef VISIT
+
+fail:
+    return ret;
+}
+
+
+/* Text */
+
+struct virtual_machine_stats_print_state
+{
+    FILE *fp;
+    int depth;
+};
+
+static int virtual_machine_stats_print_section_begin(void *data, const char *name)
+{
+    struct virtual_machine_stats_print_state *state = data;
+
+    fprintf(state->fp, "%*s%s:\n", state->depth * 2, "", name);
+    state->depth++;
+
+    return 0;
+}
+
+static int virtual_machine_stats_print_section_end(void *data)
+{
+    struct virtual_machine_stats_print_state *state = data;
+
+    state->depth--;
+
+    return 0;
+}
+
+static int virtual_machine_stats_print_value(void *data, const char *name, size_t value)
+{
+    struct virtual_machine_stats_print_state *state = data;
+
+    fprintf(state->fp, "%*s%-*s %lu\n", state->depth * 2, "", \
+            24 - state->depth * 2, name, (unsigned long)value);
+
+    return 0;
+}
+
+int virtual_machine_stats_print(struct virtual_machine *vm, FILE *fp)
+{
+    struct virtual_machine_stats stats;
+    struct virtual_machine_stats_print_state state;
+    struct virtual_machine_stats_visitor visitor = 
+    {
+        &virtual_machine_stats_print_section_begin,
+        &virtual_machine_stats_print_section_end,
+        &virtual_machine_stats_print_value,
+    };
+
+    virtual_machine_stats_get(vm, &stats);
+    state.fp = fp;
+    state.depth = 0;
+
+    return virtual_machine_stats_walk(&stats, &visitor, &state);
+}
+
+
+/* JSON */
+
+#define VIRTUAL_MACHINE_STATS_JSON_DEPTH_MAX 8
+
+struct virtual_machine_stats_json_state
+{
+    FILE *fp;
+    int depth;
+    /* Nothing written at the level yet */
+    int first[VIRTUAL_MACHINE_STATS_JSON_DEPTH_MAX];
+};
+
+static int virtual_machine_stats_json_key(struct virtual_machine_stats_json_state *state, \
+        const char *name)
+{
+    fprintf(state->fp, "%s\n%*s\"%s\": ", state->first[state->depth] != 0 ? "" : ",", \
+            (state->depth + 1) * 2, "", name);
+    state->first[state->depth] = 0;
+
+    return 0;
+}
+
+static int virtual_machine_stats_json_section_begin(void *data, const char *name)
+{
+    struct virtual_machine_stats_json_state *state = data;
+
+    if (state->depth + 1 == VIRTUAL_MACHINE_STATS_JSON_DEPTH_MAX) return -MULTIPLE_ERR_INTERNAL;
+    virtual_machine_stats_json_key(state, name);
+    fputc('{', state->fp);
+    state->depth++;
+    state->first[state->depth] = 1;
+
+    return 0;
+}
+
+static int virtual_machine_stats_json_section_end(void *data)
+{
+    struct virtual_machine_stats_json_state *state = data;
+
+    if (state->first[state->depth] == 0)
+    { fprintf(state->fp, "\n%*s", state->depth * 2, ""); }
+    fputc('}', state->fp);
+    state->depth--;
+
+    return 0;
+}
+
+static int virtual_machine_stats_json_value(void *data, const char *name, size_t value)
+{
+    struct virtual_machine_stats_json_state *state = data;
+
+    virtual_machine_stats_json_key(state, name);
+    fprintf(state->fp, "%lu", (unsigned long)value);
+
+    return 0;
+}
+
+int virtual_machine_stats_write_json(struct virtual_machine *vm, const char *pathname)
+{
+    int ret = 0;
+    FILE *fp = NULL;
+    struct virtual_machine_stats stats;
+    struct virtual_machine_stats_json_state state;
+    struct virtual_machine_stats_visitor visitor = 
+    {
+        &virtual_machine_stats_json_section_begin,
+        &virtual_machine_stats_json_section_end,
+        &virtual_machine_stats_json_value,
+    };
+
+    if ((fp = fopen(pathname, "wb")) == NULL)
+    { ret = -MULTIPLE_ERR_STUB; goto fail; }
+
+    virtual_machine_stats_get(vm, &stats);
+    state.fp = fp;
+    state.depth = 0;
+    state.first[0] = 1;
+
+    fputc('{', fp);
+    if ((ret = virtual_machine_stats_walk(&stats, &visitor, &state)) != 0)
+    { goto fail; }
+    fputs("\n}\n", fp);
+
+    if (ferror(fp) != 0)
+    { ret = -MULTIPLE_ERR_STUB; goto fail; }
+
+fail:
+    if (fp != NULL)
+    {
+        if ((fclose(fp) != 0) && (ret == 0)) ret = -MULTIPLE_ERR_STUB;
+    }
+    return ret;
+}
+
+
+/* Object */
+
+struct virtual_machine_stats_object_state
+{
+    struct virtual_machine *vm;
+    int depth;
+    /* Hashes being filled and their names, the outermost first */
+    struct virtual_machine_object *hashes[VIRTUAL_MACHINE_STATS_JSON_DEPTH_MAX];
+    const char *names[VIRTUAL_MACHINE_STATS_JSON_DEPTH_MAX];
+};
+
+/* Append a value to the innermost hash, 'object_value' is taken over */
+static int virtual_machine_stats_object_append(struct virtual_machine_stats_object_state *state, \
+        const char *name, struct virtual_machine_object *object_value)
+{
+    int ret = 0;
+    struct virtual_machine *vm = state->vm;
+    struct virtual_machine_object *new_object_key = NULL;
+
+    if ((new_object_key = virtual_machine_object_str_new_with_value(vm, name, strlen(name))) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    if ((ret = virtual_machine_object_hash_append(vm, \
+                    state->hashes[state->depth], new_object_key, object_value)) != 0)
+    { goto fail; }
+    new_object_key = NULL;
+    object_value = NULL;
+
+fail:
+    if (new_object_key != NULL) virtual_machine_object_destroy(vm, new_object_key);
+    if (object_value != NULL) virtual_machine_object_destroy(vm, object_value);
+    return ret;
+}
+
+static int virtual_machine_stats_object_section_begin(void *data, const char *name)
+{
+    struct virtual_machine_stats_object_state *state = data;
+    struct virtual_machine_object *new_object_hash = NULL;
+
+    if (state->depth + 1 == VIRTUAL_MACHINE_STATS_JSON_DEPTH_MAX) return -MULTIPLE_ERR_INTERNAL;
+    if ((new_object_hash = virtual_machine_object_hash_new(state->vm)) == NULL)
+    {
+        VM_ERR_MALLOC(state->vm->r);
+        return -MULTIPLE_ERR_VM;
+    }
+    state->depth++;
+    state->hashes[state->depth] = new_object_hash;
+    state->names[state->depth] = name;
+
+    return 0;
+}
+
+static int virtual_machine_stats_object_section_end(void *data)
+{
+    struct virtual_machine_stats_object_state *state = data;
+    struct virtual_machine_object *object_hash = state->hashes[state->depth];
+    const char *name = state->names[state->depth];
+
+    state->depth--;
+    return virtual_machine_stats_object_append(state, name, object_hash);
+}
+
+static int virtual_machine_stats_object_value(void *data, const char *name, size_t value)
+{
+    struct virtual_machine_stats_object_state *state = data;
+    struct virtual_machine_object *new_object_int = NULL;
+
+    /* Saturated to fit in an integer object */
+    if ((new_object_int = virtual_machine_object_int_new_with_value(state->vm, \
+                    value > (size_t)INT_MAX ? INT_MAX : (int)value)) == NULL)
+    {
+        VM_ERR_MALLOC(state->vm->r);
+        return -MULTIPLE_ERR_VM;
+    }
+
+    return virtual_machine_stats_object_append(state, name, new_object_int);
+}
+
+int virtual_machine_stats_to_object(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out)
+{
+    int ret = 0;
+    struct virtual_machine_stats stats;
+    struct virtual_machine_stats_object_state state;
+    struct virtual_machine_stats_visitor visitor = 
+    {
+        &virtual_machine_stats_object_section_begin,
+        &virtual_machine_stats_object_section_end,
+        &virtual_machine_stats_object_value,
+    };
+
+    *object_out = NULL;
+
+    state.vm = vm;
+    state.depth = 0;
+    if ((state.hashes[0] = virtual_machine_object_hash_new(vm)) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    virtual_machine_stats_get(vm, &stats);
+    if ((ret = virtual_machine_stats_walk(&stats, &visitor, &state)) != 0)
+    { goto fail; }
+
+    *object_out = state.hashes[0];
+    state.hashes[0] = NULL;
+
+fail:
+    /* Hashes not yet appended to their parents */
+    while (state.depth >= 0)
+    {
+        if (state.hashes[state.depth] != NULL) virtual_machine_object_destroy(vm, state.hashes[state.depth]);
+        state.depth--;
+    }
+    return ret;
+}
@@ -0,0 +1,80 @@
+/* Virtual Machine : Statistics
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+ */
+
+#ifndef _VM_STATS_H_
+#define _VM_STATS_H_
+
+#include <stdio.h>
+
+#include "vm_types.h"
+#include "vm_infrastructure.h"
+#include "vm_res.h"
+#include "gc.h"
+#include "multiple_ir_opt.h"
+
+/* Snapshot of the collector and the memory sources */
+struct virtual_machine_stats
+{
+    /* Items in the tables of the collector */
+    size_t eden;
+    size_t survivor;
+    size_t permanent;
+    size_t remembered;
+
+    /* Bytes under the heap limit, 0 for unlimited */
+    size_t heap_limit;
+    size_t heap_used;
+
+    /* Reference objects alive, indexed by OBJECT_TYPE_* */
+    size_t objects[OBJECT_TYPE_FINAL];
+
+    /* Indexed by VIRTUAL_MACHINE_RESOURCE_SOURCE_* */
+    struct virtual_machine_resource_stats sources[VIRTUAL_MACHINE_RESOURCE_SOURCE_COUNT];
+
+    gc_stats_t gc;
+
+    /* Instruments of all the modules loaded, before and after optimized */
+    struct multiple_ir_opt_stats optimize;
+
+    /* Superinstruments fused and executed, indexed by OP_FUSED_* */
+    size_t fused[OP_FUSED_COUNT];
+    size_t fused_executed[OP_FUSED_COUNT];
+
+    struct virtual_machine_block_cache_stats block_cache;
+};
+
+int virtual_machine_stats_get(struct virtual_machine *vm, \
+        struct virtual_machine_stats *stats);
+
+/* Sections "heap", "memory", "objects", "gc", "optimizer", 
+ * "superinstructions" (fused on loading and executed) and "block_cache",
+ * the pause histogram in "gc"/"pauses" is keyed by the exclusive upper bound of the bucket
+ * ("1us", "2us", "4us", ...) and "more" for the last one. Empty buckets
+ * and object types not alive are left out. */
+
+/* Text, for reading */
+int virtual_machine_stats_print(struct virtual_machine *vm, FILE *fp);
+/* JSON file */
+int virtual_machine_stats_write_json(struct virtual_machine *vm, const char *pathname);
+/* Hash of hashes, for the running program */
+int virtual_machine_stats_to_object(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out);
+
+#endif
+
@@ -558,7 +558,10 @@ int linked_mem_pool_lack(linked_mem_pool_t *pool)
 int linked_mem_pool_feedback(linked_mem_pool_t *pool)
 {
     thread_mutex_lock(&pool->lock);
-    if (pool->size_used_prev - pool->size_used < pool->size_total >> 2)
+    /* An incremental collection could end with more in use than it 
+     * started with, since the program allocates between the slices */
+    if ((pool->size_used >= pool->size_used_prev) || \
+            (pool->size_used_prev - pool->size_used < pool->size_total >> 2))
     {
         linked_mem_pool_extend(pool);
     }
@@ -567,3 +570,14 @@ int linked_mem_pool_feedback(linked_mem_pool_t *pool)
     return 0;
 }
 
+int linked_mem_pool_stat(linked_mem_pool_t *pool, \
+        size_t *size_used, size_t *size_total, size_t *size_used_extra)
+{
+    thread_mutex_lock(&pool->lock);
+    *size_used = pool->size_used;
+    *size_total = pool->size_total;
+    *size_used_extra = pool->size_used_extra;
+    thread_mutex_unlock(&pool->lock);
+
+    return 0;
+}
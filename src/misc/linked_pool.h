@@ -134,5 +134,9 @@ int linked_mem_pool_free(linked_mem_pool_t *pool, void *ptr);
 int linked_mem_pool_lack(linked_mem_pool_t *pool);
 int linked_mem_pool_feedback(linked_mem_pool_t *pool);
 
+/* Statistics, in bytes */
+int linked_mem_pool_stat(linked_mem_pool_t *pool, \
+        size_t *size_used, size_t *size_total, size_t *size_used_extra);
+
 #endif
 
@@ -326,3 +326,11 @@ int paged_mem_pool_free(paged_mem_pool_t *pool, void *ptr)
 }
 
 
+
+int paged_mem_pool_stat(paged_mem_pool_t *pool, size_t *size_used, size_t *size_total)
+{
+    *size_used = pool->size_used;
+    *size_total = pool->size_total;
+
+    return 0;
+}
@@ -80,5 +80,8 @@ int paged_mem_pool_destroy(paged_mem_pool_t *pool);
 void *paged_mem_pool_malloc(paged_mem_pool_t *pool, size_t size);
 int paged_mem_pool_free(paged_mem_pool_t *pool, void *ptr);
 
+/* Statistics, in bytes */
+int paged_mem_pool_stat(paged_mem_pool_t *pool, size_t *size_used, size_t *size_total);
+
 #endif
 
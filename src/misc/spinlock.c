@@ -18,6 +18,7 @@
  */
 
 #include <stdio.h>
+#include <time.h>
 
 #ifndef UNIX
 #ifndef WINDOWS
@@ -32,6 +33,7 @@
 /* Multiple-Threading */
 #if defined(UNIX)
 #include <pthread.h>
+#include <sched.h>
 #elif defined(WINDOWS)
 #include <windows.h>
 #include <process.h>
@@ -39,6 +41,10 @@
 
 #include "spinlock.h"
 
+/* Rounds of spinning before giving up the CPU, 
+ * the pauses are doubled every round till then */
+#define THREAD_PAUSE_SPIN_ROUNDS 10
+
 /* Initialize Mutex */
 #if defined(WINDOWS)
 int thread_mutex_init(CRITICAL_SECTION *mutex)
@@ -122,6 +128,79 @@ int thread_mutex_unlock(int *lock)
 #endif
 
 
+/* Lock */
+
+#if defined(UNIX)
+int thread_lock_init(thread_lock_t *lock)
+{
+    return pthread_mutex_init(lock, NULL);
+}
+
+int thread_lock_lock(thread_lock_t *lock)
+{
+    return pthread_mutex_lock(lock);
+}
+
+int thread_lock_unlock(thread_lock_t *lock)
+{
+    return pthread_mutex_unlock(lock);
+}
+
+int thread_lock_uninit(thread_lock_t *lock)
+{
+    return pthread_mutex_destroy(lock);
+}
+#elif defined(WINDOWS)
+int thread_lock_init(thread_lock_t *lock)
+{
+    InitializeCriticalSection(lock);
+    return 0;
+}
+
+int thread_lock_lock(thread_lock_t *lock)
+{
+    EnterCriticalSection(lock);
+    return 0;
+}
+
+int thread_lock_unlock(thread_lock_t *lock)
+{
+    LeaveCriticalSection(lock);
+    return 0;
+}
+
+int thread_lock_uninit(thread_lock_t *lock)
+{
+    DeleteCriticalSection(lock);
+    return 0;
+}
+#else
+int thread_lock_init(thread_lock_t *lock)
+{
+    *lock = 0;
+    return 0;
+}
+
+int thread_lock_lock(thread_lock_t *lock)
+{
+    *lock = 1;
+    return 0;
+}
+
+int thread_lock_unlock(thread_lock_t *lock)
+{
+    *lock = 0;
+    return 0;
+}
+
+int thread_lock_uninit(thread_lock_t *lock)
+{
+    (void)lock;
+    return 0;
+}
+#endif
+
+
 /* Atomic */
 
 void atomic_inc(volatile int *num)
@@ -143,3 +222,233 @@ void atomic_dec(volatile int *num)
 #endif
 }
 
+int atomic_cas(volatile int *num, int old_value, int new_value)
+{
+#if defined(__GNUC__)
+    return __sync_bool_compare_and_swap(num, old_value, new_value) ? 1 : 0;
+#elif defined(WINDOWS)
+    return (InterlockedCompareExchange((volatile LONG *)num, new_value, old_value) == old_value) ? 1 : 0;
+#else
+    if (*num != old_value) return 0;
+    *num = new_value;
+    return 1;
+#endif
+}
+
+/* Pause */
+static void thread_cpu_relax(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+    __asm__ __volatile__ ("yield");
+#elif defined(WINDOWS)
+    YieldProcessor();
+#endif
+}
+
+void thread_yield(void)
+{
+#if defined(UNIX)
+    sched_yield();
+#elif defined(WINDOWS)
+    SwitchToThread();
+#endif
+}
+
+void thread_pause(unsigned int round)
+{
+    unsigned int count;
+
+    if (round >= THREAD_PAUSE_SPIN_ROUNDS)
+    {
+        thread_yield();
+        return;
+    }
+    for (count = 1u << round; count != 0; count--)
+    { thread_cpu_relax(); }
+}
+
+
+/* Event */
+
+#if defined(UNIX)
+int thread_event_init(thread_event_t *event)
+{
+    event->signalled = 0;
+    if (pthread_mutex_init(&event->mutex, NULL) != 0) return -1;
+    if (pthread_cond_init(&event->cond, NULL) != 0)
+    {
+        pthread_mutex_destroy(&event->mutex);
+        return -1;
+    }
+    return 0;
+}
+
+int thread_event_uninit(thread_event_t *event)
+{
+    pthread_cond_destroy(&event->cond);
+    pthread_mutex_destroy(&event->mutex);
+    return 0;
+}
+
+int thread_event_signal(thread_event_t *event)
+{
+    pthread_mutex_lock(&event->mutex);
+    event->signalled = 1;
+    pthread_cond_signal(&event->cond);
+    pthread_mutex_unlock(&event->mutex);
+    return 0;
+}
+
+int thread_event_wait(thread_event_t *event, unsigned int timeout)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(timeout / 1000);
+    deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec += 1;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&event->mutex);
+    while (event->signalled == 0)
+    {
+        if (pthread_cond_timedwait(&event->cond, &event->mutex, &deadline) != 0) break;
+    }
+    event->signalled = 0;
+    pthread_mutex_unlock(&event->mutex);
+    return 0;
+}
+#elif defined(WINDOWS)
+int thread_event_init(thread_event_t *event)
+{
+    event->signalled = 0;
+    InitializeCriticalSection(&event->mutex);
+    InitializeConditionVariable(&event->cond);
+    return 0;
+}
+
+int thread_event_uninit(thread_event_t *event)
+{
+    DeleteCriticalSection(&event->mutex);
+    return 0;
+}
+
+int thread_event_signal(thread_event_t *event)
+{
+    EnterCriticalSection(&event->mutex);
+    event->signalled = 1;
+    WakeConditionVariable(&event->cond);
+    LeaveCriticalSection(&event->mutex);
+    return 0;
+}
+
+int thread_event_wait(thread_event_t *event, unsigned int timeout)
+{
+    EnterCriticalSection(&event->mutex);
+    while (event->signalled == 0)
+    {
+        if (SleepConditionVariableCS(&event->cond, &event->mutex, timeout) == FALSE) break;
+    }
+    event->signalled = 0;
+    LeaveCriticalSection(&event->mutex);
+    return 0;
+}
+#else
+int thread_event_init(thread_event_t *event)
+{
+    event->signalled = 0;
+    return 0;
+}
+
+int thread_event_uninit(thread_event_t *event)
+{
+    (void)event;
+    return 0;
+}
+
+int thread_event_signal(thread_event_t *event)
+{
+    event->signalled = 1;
+    return 0;
+}
+
+int thread_event_wait(thread_event_t *event, unsigned int timeout)
+{
+    /* No way to block here, the caller polls */
+    (void)timeout;
+    event->signalled = 0;
+    return 0;
+}
+#endif
+
+
+/* Thread */
+
+#if defined(UNIX)
+int thread_create(thread_handle_t *thread, void *(*routine)(void *), void *arg)
+{
+    return pthread_create(thread, NULL, routine, arg);
+}
+
+int thread_join(thread_handle_t *thread)
+{
+    return pthread_join(*thread, NULL);
+}
+#elif defined(WINDOWS)
+struct thread_start
+{
+    void *(*routine)(void *);
+    void *arg;
+};
+
+static DWORD WINAPI thread_start_routine(LPVOID param)
+{
+    struct thread_start start = *((struct thread_start *)param);
+
+    HeapFree(GetProcessHeap(), 0, param);
+    start.routine(start.arg);
+    return 0;
+}
+
+int thread_create(thread_handle_t *thread, void *(*routine)(void *), void *arg)
+{
+    struct thread_start *start;
+
+    start = (struct thread_start *)HeapAlloc(GetProcessHeap(), 0, sizeof(struct thread_start));
+    if (start == NULL) return -1;
+    start->routine = routine;
+    start->arg = arg;
+    if ((*thread = CreateThread(NULL, 0, thread_start_routine, start, 0, NULL)) == NULL)
+    {
+        HeapFree(GetProcessHeap(), 0, start);
+        return -1;
+    }
+    return 0;
+}
+
+int thread_join(thread_handle_t *thread)
+{
+    WaitForSingleObject(*thread, INFINITE);
+    CloseHandle(*thread);
+    return 0;
+}
+#else
+int thread_create(thread_handle_t *thread, void *(*routine)(void *), void *arg)
+{
+    (void)thread;
+    (void)routine;
+    (void)arg;
+    return -1;
+}
+
+int thread_join(thread_handle_t *thread)
+{
+    (void)thread;
+    return 0;
+}
+#endif
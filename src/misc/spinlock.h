@@ -43,9 +43,75 @@ int thread_mutex_lock(mutex_t *lock);
 int thread_mutex_unlock(mutex_t *lock);
 int thread_mutex_uninit(mutex_t *mutex);
 
+/* Lock 
+ * Blocks instead of spinning, for locks that could be held for long */
+#if defined(UNIX)
+typedef pthread_mutex_t thread_lock_t;
+#elif defined(WINDOWS)
+typedef CRITICAL_SECTION thread_lock_t;
+#else 
+typedef int thread_lock_t;
+#endif
+
+int thread_lock_init(thread_lock_t *lock);
+int thread_lock_lock(thread_lock_t *lock);
+int thread_lock_unlock(thread_lock_t *lock);
+int thread_lock_uninit(thread_lock_t *lock);
+
 /* Atomic */
 void atomic_inc(volatile int *num);
 void atomic_dec(volatile int *num);
+/* Replace 'old_value' with 'new_value', returns non-zero if replaced */
+int atomic_cas(volatile int *num, int old_value, int new_value);
+
+/* Pause 
+ * For spin-wait loops, 'round' counts the rounds waited so far, 
+ * the pause grows with it and gives up the CPU in the end */
+void thread_pause(unsigned int round);
+void thread_yield(void);
+
+/* Event 
+ * An auto-reset event, a signal raised while nobody waiting 
+ * is kept until the next wait */
+#if defined(UNIX)
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int signalled;
+} thread_event_t;
+#elif defined(WINDOWS)
+typedef struct
+{
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE cond;
+    int signalled;
+} thread_event_t;
+#else
+typedef struct
+{
+    int signalled;
+} thread_event_t;
+#endif
+
+int thread_event_init(thread_event_t *event);
+int thread_event_uninit(thread_event_t *event);
+int thread_event_signal(thread_event_t *event);
+/* Wait until signalled or timeout (in milliseconds) */
+int thread_event_wait(thread_event_t *event, unsigned int timeout);
+
+/* Thread */
+#if defined(UNIX)
+typedef pthread_t thread_handle_t;
+#elif defined(WINDOWS)
+typedef HANDLE thread_handle_t;
+#else
+typedef int thread_handle_t;
+#endif
+
+/* Return non-zero if creating thread is not supported */
+int thread_create(thread_handle_t *thread, void *(*routine)(void *), void *arg);
+int thread_join(thread_handle_t *thread);
 
 #endif
 
@@ -86,13 +86,48 @@ static int show_help(void)
     "  -S                            Assembly language\n"
     "  -d, --debug                   Debugger\n"
     "Optimization Options:\n"
-    "  -O<num>                       Enable Optimization\n"
+    "  -O<num>                       Enable Optimization (-O for -O1)\n"
+    "                                1: jumps, push and drop pairs, unreachable code,\n"
+    "                                   superinstructions on loading\n"
+    "                                2: constant folding as well\n"
     "Virtual Machine Options:\n"
     "  Memory Usage:\n"
     "      --vm-mem <item> <type> <size>\n"
     "        item: [infrastructure|primitive|reference]\n"
     "        type: [default|libc|4k|64b|128b]\n"
     "        size: (0 for unlimited)\n"
+    "      --vm-heap-limit <size>    Bytes of all the items in total, with k, m or g\n"
+    "                                (default: unlimited)\n"
+    "  Scheduler:\n"
+    "      --vm-workers <num>        OS threads running the scheduler, the spare ones\n"
+    "                                run threads while others are in native\n"
+    "                                sections, bytecode still runs on one core\n"
+    "                                at a time (default:1)\n"
+    "      --vm-time-slice <num>     Minimum time slice in instruments (default:100)\n"
+    "      --vm-time-slice-max <num> Maximum time slice of CPU-bound threads (default:3200)\n"
+    "      --vm-priority <num>       Priority of the main thread, 0 to 2 (default:1)\n"
+    "  Garbage Collection:\n"
+    "      --vm-gc-slice <num>[us]   Incremental GC in slices of work (objects and references) or microseconds\n"
+    "      --vm-gc-threads <num>     Threads marking a major GC (default:1)\n"
+    "      --vm-gc-concurrent-sweep  Sweep in a background thread\n"
+    "      --vm-gc <policy>          [major|generational] (default:major)\n"
+    "      --vm-gc-eden <num>        Minor GC every <num> new objects (default:10000)\n"
+    "      --vm-gc-promote-age <num> Minor GCs survived before promotion (default:10)\n"
+    "      --vm-gc-old-growth <num>  Major GC when old objects grow by <num>% (default:100)\n"
+    "  Block Cache:\n"
+    "      --vm-block-cache <num>    Decode the blocks entered <num> times into\n"
+    "                                templates run without dispatching, still\n"
+    "                                interpreted, no native code (default:off)\n"
+    "  Statistics:\n"
+    "      --vm-stats                Print GC and memory statistics on exit\n"
+    "      --vm-stats-json <file>    Write the statistics on exit as JSON\n"
+    "  Profiling:\n"
+    "      --vm-prof                 Print the hot opcodes, opcode pairs, functions\n"
+    "                                and lines on exit\n"
+    "      --vm-prof-json <file>     Write the profile on exit as JSON\n"
+    "      --vm-sample <file>        Sample the running stacks of all the threads,\n"
+    "                                write them folded for flame graphs on exit\n"
+    "      --vm-sample-interval <ms> Milliseconds between the samples (default:1)\n"
     "Additions:\n"
     "  --completion <cmd>            Completion\n"
     "\n"
@@ -147,6 +182,26 @@ int main(int argc, const char *argv[])
     char *mem_type;
     char *mem_size;
 
+    char *vm_heap_limit = NULL;
+    char *vm_workers = NULL;
+    char *vm_time_slice = NULL;
+    char *vm_time_slice_max = NULL;
+    char *vm_priority = NULL;
+    char *vm_gc_slice = NULL;
+    char *vm_gc_threads = NULL;
+    int opt_vm_gc_concurrent_sweep = 0;
+    char *vm_gc = NULL;
+    char *vm_gc_eden = NULL;
+    char *vm_gc_promote_age = NULL;
+    char *vm_gc_old_growth = NULL;
+    int opt_vm_stats = 0;
+    char *vm_block_cache = NULL;
+    char *vm_stats_json = NULL;
+    int opt_vm_prof = 0;
+    char *vm_prof_json = NULL;
+    char *vm_sample = NULL;
+    char *vm_sample_interval = NULL;
+
     char *completion_cmd = NULL;
 
     /* Arguments */
@@ -252,6 +307,8 @@ int main(int argc, const char *argv[])
             }
             else if ((!strcmp(arg_p, "-O")) || (!strcmp(arg_p, "--optimize")))
             { opt_optimize = 1; }
+            else if ((!strncmp(arg_p, "-O", 2)) && (arg_p[2] >= '0') && (arg_p[2] <= '9') && (arg_p[3] == '\0'))
+            { opt_optimize = arg_p[2] - '0'; }
             else if ((!strcmp(arg_p, "--vm-mem")) || (!strcmp(arg_p, "-m")))
             {
                 if (argsparse_request(argc, argv, &arg_idx, &mem_item) != 0)
@@ -264,6 +321,92 @@ int main(int argc, const char *argv[])
                 if ((ret = multiple_stub_virtual_machine_memory_usage(err, stub, mem_item, mem_type, mem_size)) != 0)
                 { goto fail; }
             }
+            else if (!strcmp(arg_p, "--vm-heap-limit"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_heap_limit) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-workers"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_workers) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-time-slice"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_time_slice) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-time-slice-max"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_time_slice_max) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-priority"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_priority) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-gc-slice"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_gc_slice) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-gc-threads"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_gc_threads) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-gc-concurrent-sweep"))
+            { opt_vm_gc_concurrent_sweep = 1; }
+            else if (!strcmp(arg_p, "--vm-gc"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_gc) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-gc-eden"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_gc_eden) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-gc-promote-age"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_gc_promote_age) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-gc-old-growth"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_gc_old_growth) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-block-cache"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_block_cache) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-stats"))
+            { opt_vm_stats = 1; }
+            else if (!strcmp(arg_p, "--vm-stats-json"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_stats_json) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-prof"))
+            { opt_vm_prof = 1; }
+            else if (!strcmp(arg_p, "--vm-prof-json"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_prof_json) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-sample"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_sample) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
+            else if (!strcmp(arg_p, "--vm-sample-interval"))
+            {
+                if (argsparse_request(argc, argv, &arg_idx, &vm_sample_interval) != 0)
+                { multiple_error_update(err, -MULTIPLE_ERR_INVALID_ARG, "error: invalid argument"); goto fail; }
+            }
             else if (is_file_exists(arg_p))
             {
                 /* Source code file ? */
@@ -335,6 +478,81 @@ int main(int argc, const char *argv[])
     {
         stub->startup.keep_dll = 1;
     }
+    /* Heap Limit */
+    if (vm_heap_limit != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_heap_limit(err, stub, vm_heap_limit)) != 0) { goto fail; }
+    }
+    /* Workers */
+    if (vm_workers != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_workers(err, stub, vm_workers)) != 0) { goto fail; }
+    }
+    /* Time Slice */
+    if ((vm_time_slice != NULL) || (vm_time_slice_max != NULL))
+    {
+        if ((ret = multiple_stub_virtual_machine_time_slice(err, stub, vm_time_slice, vm_time_slice_max)) != 0) { goto fail; }
+    }
+    /* Priority */
+    if (vm_priority != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_priority(err, stub, vm_priority)) != 0) { goto fail; }
+    }
+    /* Incremental GC */
+    if (vm_gc_slice != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_gc_slice(err, stub, vm_gc_slice)) != 0) { goto fail; }
+    }
+    /* Parallel GC */
+    if (vm_gc_threads != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_gc_threads(err, stub, vm_gc_threads)) != 0) { goto fail; }
+    }
+    if (opt_vm_gc_concurrent_sweep)
+    {
+        stub->startup.gc_concurrent_sweep = 1;
+    }
+    /* GC Policy */
+    if (vm_gc != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_gc(err, stub, vm_gc)) != 0) { goto fail; }
+    }
+    if ((vm_gc_eden != NULL) || (vm_gc_promote_age != NULL) || (vm_gc_old_growth != NULL))
+    {
+        if ((ret = multiple_stub_virtual_machine_gc_generational(err, stub, \
+                        vm_gc_eden, vm_gc_promote_age, vm_gc_old_growth)) != 0) { goto fail; }
+    }
+    /* Block Cache */
+    if (vm_block_cache != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_block_cache(err, stub, vm_block_cache)) != 0) { goto fail; }
+    }
+    /* Statistics */
+    if (opt_vm_stats)
+    {
+        stub->startup.stats = 1;
+    }
+    if (vm_stats_json != NULL)
+    {
+        stub->startup.stats_json = vm_stats_json;
+    }
+    /* Profiling */
+    if (opt_vm_prof)
+    {
+        stub->startup.prof = 1;
+    }
+    if (vm_prof_json != NULL)
+    {
+        stub->startup.prof_json = vm_prof_json;
+    }
+    if (vm_sample != NULL)
+    {
+        stub->startup.sample = vm_sample;
+    }
+    if (vm_sample_interval != NULL)
+    {
+        if ((ret = multiple_stub_virtual_machine_sample_interval(err, stub, vm_sample_interval)) != 0) { goto fail; }
+    }
 
     switch (opt_working_mode)
     {
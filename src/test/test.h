@@ -0,0 +1,98 @@
+/* Test : Harness
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Every test is a program of its own, made of cases returning non-zero
+ * on failure and ended by TEST_MAIN over the table of them. The program
+ * runs the cases named on the command line, or all of them, prints a
+ * line for each and returns non-zero if any failed.
+ *
+ * Usage: test_<name> [<case> ...] */
+
+#ifndef _TEST_H_
+#define _TEST_H_
+
+#include <stdio.h>
+#include <string.h>
+
+/* Fails the current case,
+ * which has an 'int ret' and a 'fail' label to clean up from */
+#define TEST_CHECK(cond) \
+    do { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ret = -1; goto fail; \
+        } \
+    } while (0)
+
+struct test_case
+{
+    const char *name;
+    int (*func)(void);
+};
+
+static int test_selected(const char *name, int argc, const char *argv[])
+{
+    int idx;
+
+    if (argc <= 1) return 1;
+    for (idx = 1; idx != argc; idx++)
+    {
+        if (strcmp(argv[idx], name) == 0) return 1;
+    }
+
+    return 0;
+}
+
+static int test_run(const struct test_case *cases, size_t count, \
+        int argc, const char *argv[])
+{
+    size_t idx;
+    int failed = 0;
+
+    for (idx = 0; idx != count; idx++)
+    {
+        if (test_selected(cases[idx].name, argc, argv) == 0) continue;
+        if (cases[idx].func() != 0)
+        {
+            printf("%-24s failed\n", cases[idx].name);
+            failed = 1;
+        }
+        else
+        {
+            printf("%-24s ok\n", cases[idx].name);
+        }
+    }
+
+    return failed;
+}
+
+/* The arguments are kept for the virtual machine as the launcher does */
+#define TEST_MAIN(cases) \
+    const char **g_argv; \
+    int g_argc; \
+    int main(int argc, const char *argv[]) \
+    { \
+        g_argc = argc; \
+        g_argv = argv; \
+        return test_run(cases, sizeof(cases) / sizeof(struct test_case), argc, argv); \
+    }
+
+#endif
+
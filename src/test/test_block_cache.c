@@ -0,0 +1,241 @@
+/* Test : Template Block Cache
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Runs programs assembled directly into IR with the block cache on,
+ * through both the 'int' sequences done on the values and the
+ * interpreter they fall back to. The programs check their own results, a wrong
+ * one ends in a runtime error.
+ *
+ * Usage: test_block_cache [<case> ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "multiple_err.h"
+#include "multiple_ir.h"
+#include "vm_opcode.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm.h"
+#include "test.h"
+#include "test_ir.h"
+
+#define TEST_BLOCK_CACHE_LOOP_COUNT 1000
+#define TEST_BLOCK_CACHE_MUL_COUNT 40
+#define TEST_BLOCK_CACHE_INT_MAX 2147483647
+#define TEST_BLOCK_CACHE_STATS_LEN 8192
+
+
+/* Running */
+
+/* The value of 'name' in the "block_cache" section of the statistics */
+static int test_block_cache_stats_value(size_t *value_out, const char *stats, const char *name)
+{
+    char key[64];
+    const char *p;
+
+    if ((p = strstr(stats, "\"block_cache\"")) == NULL) return -1;
+    snprintf(key, sizeof(key), "\"%s\": ", name);
+    if ((p = strstr(p, key)) == NULL) return -1;
+    *value_out = (size_t)strtoul(p + strlen(key), NULL, 10);
+
+    return 0;
+}
+
+/* Run 'ir' with the blocks decoded on the second entry, the statistics
+ * are read back from the JSON written on exit, and 'r' is finalized as
+ * the interpreter leaves it */
+static int test_block_cache_run(struct multiple_ir *ir, int optimize, \
+        struct vm_err *r, size_t *unboxed, size_t *guards)
+{
+    int ret = 0;
+    struct virtual_machine_startup startup;
+    char pathname[] = "/tmp/test_block_cache_XXXXXX";
+    char stats[TEST_BLOCK_CACHE_STATS_LEN];
+    FILE *fp = NULL;
+    size_t len;
+    int fd;
+
+    if ((fd = mkstemp(pathname)) < 0) return -1;
+    close(fd);
+
+    virtual_machine_startup_init(&startup);
+    startup.optimize = optimize;
+    startup.block_cache = 2;
+    startup.stats_json = pathname;
+    TEST_CHECK(test_ir_run(ir, &startup, r) == 0);
+
+    TEST_CHECK((fp = fopen(pathname, "r")) != NULL);
+    len = fread(stats, 1, sizeof(stats) - 1, fp);
+    stats[len] = '\0';
+    TEST_CHECK(test_block_cache_stats_value(unboxed, stats, "unboxed") == 0);
+    TEST_CHECK(test_block_cache_stats_value(guards, stats, "guards") == 0);
+
+    goto done;
+fail:
+done:
+    if (fp != NULL) fclose(fp);
+    remove(pathname);
+    return ret;
+}
+
+
+/* Cases */
+
+/* Counting and summing, every sequence in the loop on the values */
+static int test_block_cache_int_loop(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct vm_err r;
+    uint32_t i0, i1, count, sum, i, s, pc_loop;
+    size_t unboxed, guards;
+    int optimize;
+
+    vm_err_init(&r);
+
+    /* Superinstruments are fused from level 1, the sequences are taken first */
+    for (optimize = 0; optimize != 2; optimize++)
+    {
+        TEST_CHECK((ir = test_ir_new()) != NULL);
+        i0 = test_ir_int(ir, 0); i1 = test_ir_int(ir, 1);
+        count = test_ir_int(ir, TEST_BLOCK_CACHE_LOOP_COUNT);
+        sum = test_ir_int(ir, TEST_BLOCK_CACHE_LOOP_COUNT * (TEST_BLOCK_CACHE_LOOP_COUNT + 1) / 2);
+        i = test_ir_id(ir, "i"); s = test_ir_id(ir, "s");
+
+        test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_POP, i);
+        test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_POP, s);
+        pc_loop = test_ir_pc(ir);
+        test_ir_binary(ir, i, i, i1, OP_ADD);
+        test_ir_binary(ir, s, s, i, OP_ADD);
+        test_ir_branch(ir, i, count, OP_L, pc_loop);
+        test_ir_expect(ir, s, sum);
+
+        TEST_CHECK(test_block_cache_run(ir, optimize, &r, &unboxed, &guards) == 0);
+        TEST_CHECK(vm_err_occurred(&r) == 0);
+        TEST_CHECK(unboxed >= 3 * (TEST_BLOCK_CACHE_LOOP_COUNT - 2));
+        TEST_CHECK(guards == 0);
+        multiple_ir_destroy(ir); ir = NULL;
+    }
+
+    goto done;
+fail:
+    if (vm_err_occurred(&r) != 0) vm_err_print(&r);
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+/* Multiplied into 'bigint' and divided back, the sequences after the
+ * overflow are left to the interpreter */
+static int test_block_cache_overflow(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct vm_err r;
+    uint32_t i0, i1, i3, count, max, i, s, pc_loop;
+    size_t unboxed, guards;
+
+    vm_err_init(&r);
+
+    TEST_CHECK((ir = test_ir_new()) != NULL);
+    i0 = test_ir_int(ir, 0); i1 = test_ir_int(ir, 1); i3 = test_ir_int(ir, 3);
+    count = test_ir_int(ir, TEST_BLOCK_CACHE_MUL_COUNT);
+    max = test_ir_int(ir, TEST_BLOCK_CACHE_INT_MAX);
+    i = test_ir_id(ir, "i"); s = test_ir_id(ir, "s");
+
+    test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_POP, i);
+    test_ir_ins(ir, OP_PUSH, max); test_ir_ins(ir, OP_POP, s);
+    pc_loop = test_ir_pc(ir);
+    test_ir_binary(ir, s, s, i3, OP_MUL);
+    test_ir_binary(ir, i, i, i1, OP_ADD);
+    test_ir_branch(ir, i, count, OP_L, pc_loop);
+    pc_loop = test_ir_pc(ir);
+    test_ir_binary(ir, s, s, i3, OP_DIV);
+    test_ir_binary(ir, i, i, i1, OP_SUB);
+    test_ir_branch(ir, i0, i, OP_L, pc_loop);
+    test_ir_expect(ir, s, max);
+
+    TEST_CHECK(test_block_cache_run(ir, 0, &r, &unboxed, &guards) == 0);
+    TEST_CHECK(vm_err_occurred(&r) == 0);
+    TEST_CHECK(unboxed != 0);
+    TEST_CHECK(guards != 0);
+
+    goto done;
+fail:
+    if (vm_err_occurred(&r) != 0) vm_err_print(&r);
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+/* A cached block entered again with a 'str', the error is raised
+ * by the interpreter on the arithmetic instrument */
+static int test_block_cache_guard_error(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct vm_err r;
+    uint32_t i0, i1, count, str, i, s, pc_loop, pc_add;
+    size_t unboxed, guards;
+
+    vm_err_init(&r);
+
+    TEST_CHECK((ir = test_ir_new()) != NULL);
+    i0 = test_ir_int(ir, 0); i1 = test_ir_int(ir, 1);
+    count = test_ir_int(ir, TEST_BLOCK_CACHE_LOOP_COUNT);
+    str = test_ir_str(ir, "str");
+    i = test_ir_id(ir, "i"); s = test_ir_id(ir, "s");
+
+    test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_POP, i);
+    test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_POP, s);
+    pc_loop = test_ir_pc(ir);
+    pc_add = pc_loop + 2;
+    test_ir_binary(ir, s, s, i1, OP_ADD);
+    test_ir_binary(ir, i, i, i1, OP_ADD);
+    test_ir_branch(ir, i, count, OP_L, pc_loop);
+    test_ir_ins(ir, OP_PUSH, str); test_ir_ins(ir, OP_POP, s);
+    test_ir_ins(ir, OP_JMP, pc_loop);
+
+    TEST_CHECK(test_block_cache_run(ir, 0, &r, &unboxed, &guards) == 0);
+    TEST_CHECK(vm_err_occurred(&r) != 0);
+    TEST_CHECK(r.number == -VM_ERR_UNSUPPORTED_OPERAND_TYPE);
+    TEST_CHECK(r.pc == pc_add);
+    TEST_CHECK(r.opcode == OP_ADD);
+    TEST_CHECK(unboxed != 0);
+    TEST_CHECK(guards == 1);
+
+    goto done;
+fail:
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+static const struct test_case test_block_cache_cases[] =
+{
+    {"int_loop", test_block_cache_int_loop},
+    {"overflow", test_block_cache_overflow},
+    {"guard_error", test_block_cache_guard_error},
+};
+
+TEST_MAIN(test_block_cache_cases)
+
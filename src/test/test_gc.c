@@ -0,0 +1,183 @@
+/* Test : Garbage Collection
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Drives the collector of a virtual machine directly, without running
+ * any program.
+ *
+ * Usage: test_gc [<case> ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "multiple_err.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "vm_gc.h"
+#include "gc.h"
+#include "test.h"
+#include "test_vm.h"
+#include "test_global.h"
+
+#define TEST_GC_OLD_ITEMS 1000
+
+static int test_gc_list_contains(gc_object_table_item_list_t *list, \
+        gc_object_table_item_t *item)
+{
+    gc_object_table_item_t *item_cur;
+
+    for (item_cur = list->begin; item_cur != NULL; item_cur = item_cur->next)
+    {
+        if (item_cur == item) return 1;
+    }
+
+    return 0;
+}
+
+/* Every remembered item is an old one still in the tables */
+static int test_gc_remembered_consistent(gc_stub_t *gc_stub)
+{
+    gc_object_table_item_t *item;
+    size_t idx;
+
+    for (idx = 0; idx != gc_stub->remembered.size; idx++)
+    {
+        item = gc_stub->remembered.items[idx];
+        if (item->remembered != idx + 1) return 0;
+        if ((test_gc_list_contains(gc_stub->obj_tbl->survivor, item) == 0) && \
+                (test_gc_list_contains(gc_stub->obj_tbl->permanent, item) == 0))
+        { return 0; }
+    }
+
+    return 1;
+}
+
+/* A list of 'count' lists of one int each */
+static struct virtual_machine_object *test_gc_lists_new(struct virtual_machine *vm, int count)
+{
+    struct virtual_machine_object *new_object = NULL, *object_sub, *object_int;
+    int idx;
+
+    if ((new_object = virtual_machine_object_list_new(vm)) == NULL) return NULL;
+    for (idx = 0; idx != count; idx++)
+    {
+        /* Appending takes the element once done */
+        object_sub = NULL;
+        if (((object_int = virtual_machine_object_int_new_with_value(vm, idx)) == NULL) || \
+                ((object_sub = virtual_machine_object_list_new(vm)) == NULL) || \
+                (virtual_machine_object_list_append(vm, object_sub, object_int) != 0))
+        {
+            if (object_int != NULL) virtual_machine_object_destroy(vm, object_int);
+            goto fail;
+        }
+        if (virtual_machine_object_list_append(vm, new_object, object_sub) != 0) goto fail;
+    }
+
+    return new_object;
+fail:
+    if (object_sub != NULL) virtual_machine_object_destroy(vm, object_sub);
+    virtual_machine_object_destroy(vm, new_object);
+    return NULL;
+}
+
+/* Old items dropped by a major collection wait for the concurrent
+ * sweeper, a minor collection in the meantime must not trace them
+ * through the remembered set */
+static int test_gc_minor_while_sweeping(void)
+{
+    int ret = 0;
+    struct virtual_machine_startup startup;
+    struct test_vm env;
+    struct virtual_machine *vm = NULL;
+    struct virtual_machine_object *object_old = NULL, *object_young = NULL;
+    struct virtual_machine_object *object_global;
+    int helpers = 0, locked = 0, round;
+    size_t swept;
+
+    virtual_machine_startup_init(&startup);
+    startup.gc_generational = 1;
+    startup.gc_concurrent_sweep = 1;
+    startup.gc_promote_age = 1;
+
+    TEST_CHECK(test_vm_init(&env, &startup) == 0);
+    vm = env.vm;
+    TEST_CHECK(virtual_machine_garbage_collect_helpers_start(vm) == 0);
+    helpers = 1;
+
+    for (round = 0; round != 4; round++)
+    {
+        /* The sweeper waits for the GIL, the pending items stay */
+        virtual_machine_gil_lock(vm); locked = 1;
+
+        /* Old lists, each one remembered for a young list stored into it */
+        TEST_CHECK((object_old = test_gc_lists_new(vm, TEST_GC_OLD_ITEMS)) != NULL);
+        TEST_CHECK((object_global = test_global_set(&env, (uint32_t)round, object_old)) != NULL);
+        virtual_machine_object_destroy(vm, object_old); object_old = NULL;
+        virtual_machine_garbage_collect_minor(vm);
+        virtual_machine_garbage_collect_minor(vm);
+        TEST_CHECK(vm->gc_stub->obj_tbl->survivor->size >= TEST_GC_OLD_ITEMS);
+
+        TEST_CHECK((object_young = test_gc_lists_new(vm, 1)) != NULL);
+        TEST_CHECK(virtual_machine_object_list_append(vm, object_global, object_young) == 0);
+        object_young = NULL;
+        TEST_CHECK(vm->gc_stub->remembered.size != 0);
+
+        /* Unreachable, then detached for the sweeper */
+        TEST_CHECK(test_global_clear(&env, (uint32_t)round) == 0);
+        swept = vm->gc_stub->stats.swept;
+        virtual_machine_garbage_collect(vm);
+        TEST_CHECK(vm->gc_stub->stats.swept == swept);
+        TEST_CHECK(test_gc_remembered_consistent(vm->gc_stub) != 0);
+
+        /* Minor collections with the items still pending */
+        TEST_CHECK((object_young = test_gc_lists_new(vm, TEST_GC_OLD_ITEMS)) != NULL);
+        virtual_machine_object_destroy(vm, object_young); object_young = NULL;
+        virtual_machine_garbage_collect_minor(vm);
+        TEST_CHECK(test_gc_remembered_consistent(vm->gc_stub) != 0);
+
+        /* Let the sweeper free a part of them, then collect again */
+        virtual_machine_gil_unlock(vm); locked = 0;
+        virtual_machine_gil_lock(vm); locked = 1;
+        virtual_machine_garbage_collect_minor(vm);
+        TEST_CHECK(test_gc_remembered_consistent(vm->gc_stub) != 0);
+
+        gc_parallel_sweep_now(vm->gc_stub);
+        TEST_CHECK(vm->gc_stub->stats.swept > swept);
+        virtual_machine_gil_unlock(vm); locked = 0;
+    }
+
+    goto done;
+fail:
+    if (object_old != NULL) virtual_machine_object_destroy(vm, object_old);
+    if (object_young != NULL) virtual_machine_object_destroy(vm, object_young);
+done:
+    if (locked != 0) virtual_machine_gil_unlock(vm);
+    if (helpers != 0) virtual_machine_garbage_collect_helpers_stop(vm);
+    test_vm_final(&env);
+    return ret;
+}
+
+static const struct test_case test_gc_cases[] =
+{
+    {"minor_while_sweeping", test_gc_minor_while_sweeping},
+};
+
+TEST_MAIN(test_gc_cases)
+
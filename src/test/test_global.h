@@ -0,0 +1,60 @@
+/* Test : Global Variables
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Objects kept in the global variables of a test virtual machine,
+ * where the collector finds them as a program's would be */
+
+#ifndef _TEST_GLOBAL_H_
+#define _TEST_GLOBAL_H_
+
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "test_vm.h"
+
+/* Global variable 'id' set to a clone of 'object', the clone is returned */
+static struct virtual_machine_object *test_global_set(struct test_vm *env, \
+        uint32_t id, struct virtual_machine_object *object)
+{
+    struct virtual_machine_variable *variable;
+
+    if (virtual_machine_variable_list_update_with_configure(env->vm, \
+                env->vm->variables_global, 0, id, object) != 0) return NULL;
+    if (virtual_machine_variable_list_lookup(&variable, \
+                env->vm->variables_global, 0, id) != LOOKUP_FOUND) return NULL;
+
+    return variable->ptr;
+}
+
+/* Global variable 'id' set to 'none',
+ * what it held is left to the next collection */
+static int test_global_clear(struct test_vm *env, uint32_t id)
+{
+    int ret;
+    struct virtual_machine_object *object_none;
+
+    if ((object_none = virtual_machine_object_none_new(env->vm)) == NULL) return -1;
+    ret = virtual_machine_variable_list_update_with_configure(env->vm, \
+            env->vm->variables_global, 0, id, object_none);
+    virtual_machine_object_destroy(env->vm, object_none);
+
+    return ret;
+}
+
+#endif
+
@@ -0,0 +1,182 @@
+/* Test : Integer Arithmetic
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Operates on 'int' and 'bigint' objects of a virtual machine directly,
+ * the cases a CPU traps on included, and on programs taking counts
+ * from them.
+ *
+ * Usage: test_int [<case> ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "test.h"
+#include "test_vm.h"
+#include "test_ir.h"
+
+/* 'left' <opcode> 'right', the error is left in 'env->r' */
+static int test_int_operate(struct test_vm *env, \
+        struct virtual_machine_object **object_out, \
+        struct virtual_machine_object *object_left, struct virtual_machine_object *object_right, \
+        uint32_t opcode)
+{
+    vm_err_clear(&env->r);
+    *object_out = NULL;
+    return virtual_machine_object_binary_operate(object_out, object_left, object_right, opcode, env->vm);
+}
+
+/* Division and modulo by zero are runtime errors, on both types */
+static int test_int_divide_by_zero(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_zero = NULL, *object_int = NULL, *object_bigint = NULL;
+    struct virtual_machine_object *object_out = NULL;
+    uint32_t opcodes[2] = {OP_DIV, OP_MOD};
+    int idx;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+    TEST_CHECK((object_zero = virtual_machine_object_int_new_with_value(env.vm, 0)) != NULL);
+    TEST_CHECK((object_int = virtual_machine_object_int_new_with_value(env.vm, INT64_MAX)) != NULL);
+    TEST_CHECK(test_int_operate(&env, &object_bigint, object_int, object_int, OP_ADD) == 0);
+    TEST_CHECK(object_bigint->type == OBJECT_TYPE_BIGINT);
+
+    for (idx = 0; idx != 2; idx++)
+    {
+        TEST_CHECK(test_int_operate(&env, &object_out, object_int, object_zero, opcodes[idx]) == -MULTIPLE_ERR_VM);
+        TEST_CHECK(object_out == NULL);
+        TEST_CHECK(vm_err_occurred(&env.r) != 0);
+        TEST_CHECK(env.r.number == -VM_ERR_DIVIDE_BY_ZERO);
+
+        TEST_CHECK(test_int_operate(&env, &object_out, object_bigint, object_zero, opcodes[idx]) == -MULTIPLE_ERR_VM);
+        TEST_CHECK(object_out == NULL);
+        TEST_CHECK(vm_err_occurred(&env.r) != 0);
+        TEST_CHECK(env.r.number == -VM_ERR_DIVIDE_BY_ZERO);
+    }
+
+    goto done;
+fail:
+done:
+    if (object_out != NULL) virtual_machine_object_destroy(env.vm, object_out);
+    if (object_zero != NULL) virtual_machine_object_destroy(env.vm, object_zero);
+    if (object_int != NULL) virtual_machine_object_destroy(env.vm, object_int);
+    if (object_bigint != NULL) virtual_machine_object_destroy(env.vm, object_bigint);
+    test_vm_final(&env);
+    return ret;
+}
+
+/* INT64_MIN / -1 overflows into 'bigint', INT64_MIN % -1 is 0,
+ * neither of them traps */
+static int test_int_min_by_minus_one(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_min = NULL, *object_minus_one = NULL;
+    struct virtual_machine_object *object_out = NULL;
+    struct virtual_machine_object_bigint *bigint;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+    TEST_CHECK((object_min = virtual_machine_object_int_new_with_value(env.vm, INT64_MIN)) != NULL);
+    TEST_CHECK((object_minus_one = virtual_machine_object_int_new_with_value(env.vm, -1)) != NULL);
+
+    /* 2^63 */
+    TEST_CHECK(test_int_operate(&env, &object_out, object_min, object_minus_one, OP_DIV) == 0);
+    TEST_CHECK(object_out->type == OBJECT_TYPE_BIGINT);
+    bigint = (struct virtual_machine_object_bigint *)object_out->ptr;
+    TEST_CHECK((bigint->sign == 0) && (bigint->size == 2));
+    TEST_CHECK((bigint->digits[0] == 0) && (bigint->digits[1] == 0x80000000u));
+    virtual_machine_object_destroy(env.vm, object_out); object_out = NULL;
+
+    TEST_CHECK(test_int_operate(&env, &object_out, object_min, object_minus_one, OP_MOD) == 0);
+    TEST_CHECK(object_out->type == OBJECT_TYPE_INT);
+    TEST_CHECK(virtual_machine_object_int_get_primitive_value(object_out) == 0);
+
+    goto done;
+fail:
+done:
+    if (object_out != NULL) virtual_machine_object_destroy(env.vm, object_out);
+    if (object_min != NULL) virtual_machine_object_destroy(env.vm, object_min);
+    if (object_minus_one != NULL) virtual_machine_object_destroy(env.vm, object_minus_one);
+    test_vm_final(&env);
+    return ret;
+}
+
+/* Counts of stack items out of the stack are runtime errors of the
+ * instrument taking them, instead of wrapping around as sizes */
+static int test_int_count_bounds(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct vm_err r;
+    uint32_t opcodes[3] = {OP_PICK, OP_INSERT, OP_REVERSE};
+    int counts[2] = {-1, 3};
+    uint32_t i1, count, x, pc_count;
+    int idx, idx_count;
+
+    vm_err_init(&r);
+
+    for (idx = 0; idx != 3; idx++)
+    {
+        for (idx_count = 0; idx_count != 2; idx_count++)
+        {
+            /* 2 items under the count */
+            TEST_CHECK((ir = test_ir_new()) != NULL);
+            i1 = test_ir_int(ir, 1);
+            count = test_ir_int(ir, counts[idx_count]);
+            x = test_ir_id(ir, "x");
+            test_ir_binary(ir, x, i1, i1, OP_ADD);
+            test_ir_ins(ir, OP_PUSH, i1); test_ir_ins(ir, OP_PUSH, x);
+            test_ir_ins(ir, OP_PUSH, count);
+            pc_count = test_ir_pc(ir);
+            test_ir_ins(ir, opcodes[idx], 0);
+            test_ir_expect(ir, x, i1);
+
+            TEST_CHECK(test_ir_run(ir, NULL, &r) == 0);
+            TEST_CHECK(vm_err_occurred(&r) != 0);
+            TEST_CHECK(r.number == -VM_ERR_INVALID_OPERAND);
+            TEST_CHECK(r.pc == pc_count);
+            multiple_ir_destroy(ir); ir = NULL;
+        }
+    }
+
+    goto done;
+fail:
+    if (vm_err_occurred(&r) != 0) vm_err_print(&r);
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+static const struct test_case test_int_cases[] =
+{
+    {"divide_by_zero", test_int_divide_by_zero},
+    {"min_by_minus_one", test_int_min_by_minus_one},
+    {"count_bounds", test_int_count_bounds},
+};
+
+TEST_MAIN(test_int_cases)
+
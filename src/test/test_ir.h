@@ -0,0 +1,179 @@
+/* Test : Intermediate Representation
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Assembling programs directly into IR, without any frontend, and
+ * running them. Every instrument gets a line of its own in the debug
+ * section, the programs check their own results */
+
+#ifndef _TEST_IR_H_
+#define _TEST_IR_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+#include "multiple_ir.h"
+#include "vm_opcode.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm.h"
+
+static uint32_t test_ir_data(struct multiple_ir *ir, \
+        enum multiple_ir_data_section_item_type type, int value, const char *str)
+{
+    struct multiple_ir_data_section_item *new_item;
+
+    new_item = multiple_ir_data_section_item_new(type);
+    new_item->id = (uint32_t)ir->data_section->size;
+    if (str != NULL)
+    {
+        new_item->u.value_str.len = strlen(str);
+        new_item->u.value_str.str = (char *)malloc(sizeof(char) * (strlen(str) + 1));
+        memcpy(new_item->u.value_str.str, str, strlen(str) + 1);
+        new_item->size = (uint32_t)strlen(str);
+    }
+    else
+    {
+        new_item->u.value_int = value;
+        new_item->size = sizeof(int);
+    }
+    multiple_ir_data_section_append(ir->data_section, new_item);
+
+    return new_item->id;
+}
+
+static uint32_t test_ir_int(struct multiple_ir *ir, int value)
+{ return test_ir_data(ir, MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT, value, NULL); }
+
+static uint32_t test_ir_id(struct multiple_ir *ir, const char *name)
+{ return test_ir_data(ir, MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER, 0, name); }
+
+static uint32_t test_ir_str(struct multiple_ir *ir, const char *str)
+{ return test_ir_data(ir, MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_STR, 0, str); }
+
+static uint32_t test_ir_pc(struct multiple_ir *ir)
+{ return (uint32_t)ir->text_section->size; }
+
+/* The returned instrument is for patching forward jumps */
+static struct multiple_ir_text_section_item *test_ir_ins(struct multiple_ir *ir, \
+        uint32_t opcode, uint32_t operand)
+{
+    struct multiple_ir_text_section_item *new_item;
+    struct multiple_ir_debug_section_item *new_debug_item;
+
+    new_debug_item = multiple_ir_debug_section_item_new();
+    new_debug_item->line_number_asm = test_ir_pc(ir);
+    new_debug_item->line_number_source_start = test_ir_pc(ir) + 1;
+    new_debug_item->line_number_source_end = test_ir_pc(ir) + 1;
+    multiple_ir_debug_section_append(ir->debug_section, new_debug_item);
+
+    new_item = multiple_ir_text_section_item_new();
+    new_item->opcode = opcode;
+    new_item->operand = operand;
+    multiple_ir_text_section_append(ir->text_section, new_item);
+
+    return new_item;
+}
+
+/* dst = left <opcode> right */
+static void test_ir_binary(struct multiple_ir *ir, uint32_t dst, \
+        uint32_t left, uint32_t right, uint32_t opcode)
+{
+    test_ir_ins(ir, OP_PUSH, left);
+    test_ir_ins(ir, OP_PUSH, right);
+    test_ir_ins(ir, opcode, 0);
+    test_ir_ins(ir, OP_POP, dst);
+}
+
+/* Jumps to 'pc' when left <opcode> right */
+static struct multiple_ir_text_section_item *test_ir_branch(struct multiple_ir *ir, \
+        uint32_t left, uint32_t right, uint32_t opcode, uint32_t pc)
+{
+    test_ir_ins(ir, OP_PUSH, left);
+    test_ir_ins(ir, OP_PUSH, right);
+    test_ir_ins(ir, opcode, 0);
+    return test_ir_ins(ir, OP_JMPC, pc);
+}
+
+/* Goes on when var == expected, or ends in a runtime error */
+static void test_ir_check(struct multiple_ir *ir, uint32_t var, uint32_t expected)
+{
+    struct multiple_ir_text_section_item *jump;
+    uint32_t str = test_ir_str(ir, "unexpected");
+
+    jump = test_ir_branch(ir, var, expected, OP_EQ, 0);
+    test_ir_ins(ir, OP_PUSH, str);
+    test_ir_ins(ir, OP_PUSH, expected);
+    test_ir_ins(ir, OP_SUB, 0);
+    jump->operand = test_ir_pc(ir);
+}
+
+/* Returns when var == expected, or ends in a runtime error */
+static void test_ir_expect(struct multiple_ir *ir, uint32_t var, uint32_t expected)
+{
+    test_ir_check(ir, var, expected);
+    test_ir_ins(ir, OP_RETNONE, 0);
+}
+
+static struct multiple_ir *test_ir_new(void)
+{
+    struct multiple_ir *ir = multiple_ir_new();
+    struct multiple_ir_export_section_item *new_item;
+
+    ir->filename_len = strlen("test.mp");
+    ir->filename = (char *)malloc(sizeof(char) * (ir->filename_len + 1));
+    memcpy(ir->filename, "test.mp", ir->filename_len + 1);
+    ir->module_section->name = test_ir_id(ir, "test");
+    ir->module_section->enabled = 1;
+
+    new_item = multiple_ir_export_section_item_new();
+    new_item->name = test_ir_id(ir, "main");
+    new_item->instrument_number = 0;
+    multiple_ir_export_section_append(ir->export_section, new_item);
+
+    return ir;
+}
+
+/* Run 'ir' from "main" with 'startup' or the defaults, an error of the
+ * program is left in 'r', which is finalized as the interpreter leaves it */
+static int test_ir_run(struct multiple_ir *ir, \
+        struct virtual_machine_startup *startup, struct vm_err *r)
+{
+    int ret = 0;
+    struct multiple_error *err = NULL;
+    struct virtual_machine_startup startup_default;
+
+    if ((err = multiple_error_new()) == NULL) return -1;
+    if (startup == NULL)
+    {
+        virtual_machine_startup_init(&startup_default);
+        startup = &startup_default;
+    }
+    vm_err_init(r);
+
+    vm_run(err, r, ir, startup, 0, NULL);
+    if (multiple_error_occurred(err) != 0) ret = -1;
+
+    multiple_error_destroy(err);
+    return ret;
+}
+
+#endif
+
@@ -0,0 +1,297 @@
+/* Test : IR Optimizer
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Optimizes programs assembled directly into IR and compares the text,
+ * export and debug sections with the ones expected, then runs one
+ * optimized on loading.
+ *
+ * Usage: test_ir_opt [<case> ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+#include "multiple_ir.h"
+#include "multiple_ir_opt.h"
+#include "vm_opcode.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "test.h"
+#include "test_ir.h"
+
+#define TEST_IR_OPT_INT_MAX 2147483647
+
+/* An instrument expected */
+struct test_ir_opt_instrument
+{
+    uint32_t opcode;
+    uint32_t operand;
+};
+
+
+/* Optimizing */
+
+static int test_ir_opt_optimize(struct multiple_ir *ir, int level, \
+        struct multiple_ir_opt_stats *stats)
+{
+    int ret;
+    struct multiple_error *err;
+
+    if ((err = multiple_error_new()) == NULL) return -1;
+    ret = multiple_ir_optimize(err, ir, level, stats);
+    if (multiple_error_occurred(err) != 0) ret = -1;
+    multiple_error_destroy(err);
+
+    return ret;
+}
+
+/* 0 if the text section is 'expected' */
+static int test_ir_opt_text_cmp(struct multiple_ir *ir, \
+        const struct test_ir_opt_instrument *expected, size_t size)
+{
+    struct multiple_ir_text_section_item *text_section_item_cur;
+    size_t idx = 0;
+
+    if (ir->text_section->size != size) return -1;
+    for (text_section_item_cur = ir->text_section->begin; \
+            text_section_item_cur != NULL; \
+            text_section_item_cur = text_section_item_cur->next)
+    {
+        if ((idx == size) || \
+                (text_section_item_cur->opcode != expected[idx].opcode) || \
+                (text_section_item_cur->operand != expected[idx].operand))
+        {
+            fprintf(stderr, "instrument %u differs\n", (unsigned int)idx);
+            return -1;
+        }
+        idx++;
+    }
+
+    return (idx == size) ? 0 : -1;
+}
+
+static struct multiple_ir_export_section_item *test_ir_opt_export(struct multiple_ir *ir, \
+        uint32_t name, uint32_t instrument_number)
+{
+    struct multiple_ir_export_section_item *new_item;
+
+    new_item = multiple_ir_export_section_item_new();
+    new_item->name = name;
+    new_item->instrument_number = instrument_number;
+    multiple_ir_export_section_append(ir->export_section, new_item);
+
+    return new_item;
+}
+
+
+/* Cases */
+
+/* Jumps threaded through jumps and into returns, then the instruments
+ * left unreachable and the pushes dropped right away removed, with the
+ * jumps, exports and debug lines following the new numbers */
+static int test_ir_opt_jumps(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct multiple_ir_opt_stats stats;
+    struct multiple_ir_export_section_item *export_main, *export_f;
+    struct multiple_ir_debug_section_item *debug_section_item_cur;
+    uint32_t i0, i1, i3, x;
+    uint32_t lines[12] = {1, 2, 3, 4, 5, 6, 7, 12, 13, 14, 15, 16};
+    size_t idx;
+
+    TEST_CHECK((ir = test_ir_new()) != NULL);
+    i0 = test_ir_int(ir, 0); i1 = test_ir_int(ir, 1); i3 = test_ir_int(ir, 3);
+    x = test_ir_id(ir, "x");
+    export_main = ir->export_section->begin;
+    export_f = test_ir_opt_export(ir, test_ir_id(ir, "f"), 9);
+
+    test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_POP, x);
+    /* 2 */
+    test_ir_ins(ir, OP_PUSH, x); test_ir_ins(ir, OP_PUSH, i3); test_ir_ins(ir, OP_L, 0);
+    test_ir_ins(ir, OP_JMPC, 8);
+    test_ir_ins(ir, OP_JMP, 16);
+    test_ir_ins(ir, OP_NOP, 0);
+    /* 8 */
+    test_ir_ins(ir, OP_JMP, 11);
+    test_ir_ins(ir, OP_PUSH, i1); test_ir_ins(ir, OP_DROP, 0);
+    /* 11 */
+    test_ir_binary(ir, x, x, i1, OP_ADD);
+    test_ir_ins(ir, OP_JMP, 2);
+    /* 16 */
+    test_ir_ins(ir, OP_RETNONE, 0);
+
+    {
+        const struct test_ir_opt_instrument expected[] =
+        {
+            {OP_PUSH, i0}, {OP_POP, x},
+            {OP_PUSH, x}, {OP_PUSH, i3}, {OP_L, 0},
+            {OP_JMPC, 7},
+            {OP_RETNONE, 0},
+            {OP_PUSH, x}, {OP_PUSH, i1}, {OP_ADD, 0}, {OP_POP, x},
+            {OP_JMP, 2},
+        };
+
+        TEST_CHECK(test_ir_opt_optimize(ir, MULTIPLE_IR_OPT_LEVEL_BASIC, &stats) == 0);
+        TEST_CHECK(test_ir_opt_text_cmp(ir, expected, sizeof(expected) / sizeof(expected[0])) == 0);
+    }
+
+    TEST_CHECK((stats.before == 17) && (stats.after == 12));
+    TEST_CHECK(stats.threaded == 2);
+    TEST_CHECK(stats.paired == 1);
+    TEST_CHECK(stats.unreachable == 2);
+    TEST_CHECK(stats.folded == 0);
+
+    /* An entrance into the instruments removed moves to the next kept */
+    TEST_CHECK(export_main->instrument_number == 0);
+    TEST_CHECK(export_f->instrument_number == 7);
+
+    /* The lines of the ones kept, renumbered */
+    TEST_CHECK(ir->debug_section->size == 12);
+    idx = 0;
+    for (debug_section_item_cur = ir->debug_section->begin; \
+            debug_section_item_cur != NULL; \
+            debug_section_item_cur = debug_section_item_cur->next)
+    {
+        TEST_CHECK(idx != 12);
+        TEST_CHECK(debug_section_item_cur->line_number_asm == idx);
+        TEST_CHECK(debug_section_item_cur->line_number_source_start == lines[idx]);
+        idx++;
+    }
+    TEST_CHECK(idx == 12);
+
+    goto done;
+fail:
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+/* Arithmetic on literals folded into a push of the result, reusing the
+ * literal if the data section has it already, while variables and the
+ * results the vm would give otherwise are left as they are */
+static int test_ir_opt_fold(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct multiple_ir_opt_stats stats;
+    struct multiple_ir_data_section_item *data_section_item;
+    uint32_t i0, i1, i3, i5, max, x;
+    size_t data_size;
+
+    TEST_CHECK((ir = test_ir_new()) != NULL);
+    i0 = test_ir_int(ir, 0); i1 = test_ir_int(ir, 1); i3 = test_ir_int(ir, 3);
+    i5 = test_ir_int(ir, 5); max = test_ir_int(ir, TEST_IR_OPT_INT_MAX);
+    x = test_ir_id(ir, "x");
+    data_size = ir->data_section->size;
+
+    /* Folded */
+    test_ir_binary(ir, x, i5, i0, OP_ADD);
+    /* A variable */
+    test_ir_binary(ir, x, x, i3, OP_ADD);
+    /* Overflowing into 'bigint' */
+    test_ir_binary(ir, x, max, i1, OP_ADD);
+    test_ir_binary(ir, x, max, max, OP_MUL);
+    /* Divided by zero */
+    test_ir_binary(ir, x, i1, i0, OP_DIV);
+    /* Folded into a new literal */
+    test_ir_binary(ir, x, i3, i5, OP_MUL);
+    test_ir_ins(ir, OP_RETNONE, 0);
+
+    TEST_CHECK(test_ir_opt_optimize(ir, MULTIPLE_IR_OPT_LEVEL_FOLD, &stats) == 0);
+    TEST_CHECK(stats.folded == 2);
+    TEST_CHECK(ir->data_section->size == data_size + 1);
+    data_section_item = ir->data_section->end;
+    TEST_CHECK(data_section_item->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT);
+    TEST_CHECK(data_section_item->u.value_int == 15);
+
+    {
+        const struct test_ir_opt_instrument expected[] =
+        {
+            {OP_PUSH, i5}, {OP_POP, x},
+            {OP_PUSH, x}, {OP_PUSH, i3}, {OP_ADD, 0}, {OP_POP, x},
+            {OP_PUSH, max}, {OP_PUSH, i1}, {OP_ADD, 0}, {OP_POP, x},
+            {OP_PUSH, max}, {OP_PUSH, max}, {OP_MUL, 0}, {OP_POP, x},
+            {OP_PUSH, i1}, {OP_PUSH, i0}, {OP_DIV, 0}, {OP_POP, x},
+            {OP_PUSH, data_section_item->id}, {OP_POP, x},
+            {OP_RETNONE, 0},
+        };
+
+        TEST_CHECK(test_ir_opt_text_cmp(ir, expected, sizeof(expected) / sizeof(expected[0])) == 0);
+    }
+
+    goto done;
+fail:
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+/* The results of a program optimized on loading, folded or not */
+static int test_ir_opt_run(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct virtual_machine_startup startup;
+    struct vm_err r;
+    uint32_t i1, i3, i4, i5, max, x, y, pc_loop;
+
+    vm_err_init(&r);
+
+    TEST_CHECK((ir = test_ir_new()) != NULL);
+    i1 = test_ir_int(ir, 1); i3 = test_ir_int(ir, 3);
+    i4 = test_ir_int(ir, 4); i5 = test_ir_int(ir, 5);
+    max = test_ir_int(ir, TEST_IR_OPT_INT_MAX);
+    x = test_ir_id(ir, "x"); y = test_ir_id(ir, "y");
+
+    test_ir_binary(ir, x, i1, i4, OP_ADD);
+    test_ir_check(ir, x, i5);
+    test_ir_binary(ir, y, max, i1, OP_ADD);
+    test_ir_binary(ir, y, y, i1, OP_SUB);
+    test_ir_check(ir, y, max);
+
+    /* x from 5 down to 3 */
+    pc_loop = test_ir_pc(ir);
+    test_ir_binary(ir, x, x, i1, OP_SUB);
+    test_ir_branch(ir, i3, x, OP_L, pc_loop);
+    test_ir_expect(ir, x, i3);
+
+    virtual_machine_startup_init(&startup);
+    startup.optimize = MULTIPLE_IR_OPT_LEVEL_FOLD;
+    TEST_CHECK(test_ir_run(ir, &startup, &r) == 0);
+    TEST_CHECK(vm_err_occurred(&r) == 0);
+
+    goto done;
+fail:
+    if (vm_err_occurred(&r) != 0) vm_err_print(&r);
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+static const struct test_case test_ir_opt_cases[] =
+{
+    {"jumps", test_ir_opt_jumps},
+    {"fold", test_ir_opt_fold},
+    {"run", test_ir_opt_run},
+};
+
+TEST_MAIN(test_ir_opt_cases)
+
@@ -0,0 +1,276 @@
+/* Test : List
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Lists sharing their tails, the nodes are copied on write while
+ * another list still uses them, and taken over by the last one.
+ *
+ * Usage: test_list [<case> ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "vm_gc.h"
+#include "test.h"
+#include "test_vm.h"
+#include "test_global.h"
+#include "test_ir.h"
+
+#define TEST_LIST_SIZE 4
+
+
+/* Operating */
+
+/* [0, 1, ..., count - 1], kept in global variable 'id' */
+static struct virtual_machine_object *test_list_new(struct test_vm *env, \
+        uint32_t id, int count)
+{
+    struct virtual_machine_object *new_object, *object_int, *object_global;
+    int idx;
+
+    if ((new_object = virtual_machine_object_list_new(env->vm)) == NULL) return NULL;
+    for (idx = 0; idx != count; idx++)
+    {
+        /* Appending takes the element */
+        if (((object_int = virtual_machine_object_int_new_with_value(env->vm, idx)) == NULL) || \
+                (virtual_machine_object_list_append(env->vm, new_object, object_int) != 0))
+        {
+            virtual_machine_object_destroy(env->vm, new_object);
+            return NULL;
+        }
+    }
+
+    object_global = test_global_set(env, id, new_object);
+    virtual_machine_object_destroy(env->vm, new_object);
+
+    return object_global;
+}
+
+/* The tail of 'object_list', kept in global variable 'id' */
+static struct virtual_machine_object *test_list_cdr(struct test_vm *env, \
+        uint32_t id, struct virtual_machine_object *object_list)
+{
+    struct virtual_machine_object *new_object, *object_global;
+
+    if (virtual_machine_object_list_cdr(env->vm, &new_object, object_list) != 0) return NULL;
+    object_global = test_global_set(env, id, new_object);
+    virtual_machine_object_destroy(env->vm, new_object);
+
+    return object_global;
+}
+
+static struct virtual_machine_object_list_internal *test_list_internal( \
+        struct virtual_machine_object *object_list)
+{
+    return ((struct virtual_machine_object_list *)object_list->ptr)->ptr_internal;
+}
+
+static int test_list_set(struct test_vm *env, \
+        struct virtual_machine_object *object_list, int idx, int value)
+{
+    int ret;
+    struct virtual_machine_object *object_idx, *object_value, *object_out = NULL;
+
+    object_idx = virtual_machine_object_int_new_with_value(env->vm, idx);
+    object_value = virtual_machine_object_int_new_with_value(env->vm, value);
+    if ((object_idx == NULL) || (object_value == NULL)) ret = -1;
+    else ret = virtual_machine_object_list_ref_set(env->vm, &object_out, object_list, object_idx, object_value);
+
+    if (object_idx != NULL) virtual_machine_object_destroy(env->vm, object_idx);
+    if (object_value != NULL) virtual_machine_object_destroy(env->vm, object_value);
+    if (object_out != NULL) virtual_machine_object_destroy(env->vm, object_out);
+    return ret;
+}
+
+/* Element 'idx', or -1 */
+static int64_t test_list_get(struct test_vm *env, \
+        struct virtual_machine_object *object_list, int idx)
+{
+    int64_t value = -1;
+    struct virtual_machine_object *object_idx, *object_out = NULL;
+
+    if ((object_idx = virtual_machine_object_int_new_with_value(env->vm, idx)) == NULL) return -1;
+    if ((virtual_machine_object_list_ref_get(env->vm, &object_out, object_list, object_idx) == 0) && \
+            (object_out->type == OBJECT_TYPE_INT))
+    { value = virtual_machine_object_int_get_primitive_value(object_out); }
+
+    virtual_machine_object_destroy(env->vm, object_idx);
+    if (object_out != NULL) virtual_machine_object_destroy(env->vm, object_out);
+    return value;
+}
+
+
+/* Cases */
+
+/* A cdr sees no change made to its source afterwards, nor the source
+ * any change made to the cdr */
+static int test_list_cdr_isolated(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_list, *object_cdr, *object_cddr, *object_int;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+    TEST_CHECK((object_list = test_list_new(&env, 0, TEST_LIST_SIZE)) != NULL);
+    TEST_CHECK((object_cdr = test_list_cdr(&env, 1, object_list)) != NULL);
+    TEST_CHECK((object_cddr = test_list_cdr(&env, 2, object_cdr)) != NULL);
+    TEST_CHECK(test_list_internal(object_cdr)->begin == test_list_internal(object_list)->begin->next);
+
+    /* Source to view */
+    TEST_CHECK(test_list_set(&env, object_list, 2, 99) == 0);
+    TEST_CHECK(test_list_get(&env, object_list, 2) == 99);
+    TEST_CHECK(test_list_get(&env, object_cdr, 1) == 2);
+    TEST_CHECK(test_list_get(&env, object_cddr, 0) == 2);
+
+    /* View to source, and to the view taken from it */
+    TEST_CHECK(test_list_set(&env, object_cdr, 1, 77) == 0);
+    TEST_CHECK(test_list_get(&env, object_cdr, 1) == 77);
+    TEST_CHECK(test_list_get(&env, object_cddr, 0) == 2);
+    TEST_CHECK(test_list_get(&env, object_list, 2) == 99);
+
+    /* Appending */
+    TEST_CHECK((object_int = virtual_machine_object_int_new_with_value(env.vm, TEST_LIST_SIZE)) != NULL);
+    TEST_CHECK(virtual_machine_object_list_append(env.vm, object_cddr, object_int) == 0);
+    TEST_CHECK(test_list_internal(object_cddr)->size == TEST_LIST_SIZE - 1);
+    TEST_CHECK(test_list_internal(object_cdr)->size == TEST_LIST_SIZE - 1);
+    TEST_CHECK(test_list_internal(object_list)->size == TEST_LIST_SIZE);
+
+    goto done;
+fail:
+done:
+    test_vm_final(&env);
+    return ret;
+}
+
+/* Once the other lists are collected, the one left writes into the
+ * nodes instead of copying them, whether it is a cdr or the source */
+static int test_list_last_owner(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_list, *object_cdr, *object_last;
+    struct virtual_machine_object_list_internal_node *begin;
+    int last;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+
+    for (last = 0; last != 2; last++)
+    {
+        TEST_CHECK((object_list = test_list_new(&env, 0, TEST_LIST_SIZE)) != NULL);
+        TEST_CHECK((object_cdr = test_list_cdr(&env, 1, object_list)) != NULL);
+        TEST_CHECK(test_list_internal(object_cdr)->begin->refcount == 2);
+
+        /* Drop the source, or the cdr */
+        TEST_CHECK(test_global_clear(&env, (uint32_t)(1 - last)) == 0);
+        object_last = (last == 0) ? object_list : object_cdr;
+        virtual_machine_garbage_collect(env.vm);
+        begin = test_list_internal(object_last)->begin;
+        TEST_CHECK(begin->next->refcount == 1);
+
+        TEST_CHECK(test_list_set(&env, object_last, 0, 42) == 0);
+        TEST_CHECK(test_list_internal(object_last)->begin == begin);
+        TEST_CHECK(test_list_internal(object_last)->shared == 0);
+        TEST_CHECK(begin->prev == NULL);
+        TEST_CHECK(test_list_get(&env, object_last, 0) == 42);
+        TEST_CHECK(test_list_get(&env, object_last, 1) == 1 + last);
+
+        TEST_CHECK(test_global_clear(&env, 0) == 0);
+        TEST_CHECK(test_global_clear(&env, 1) == 0);
+    }
+
+    goto done;
+fail:
+done:
+    test_vm_final(&env);
+    return ret;
+}
+
+/* LSTCDRSET makes a list of the car of one and the nodes of another,
+ * which stay shared and are copied on write */
+static int test_list_cdr_set(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct vm_err r;
+    uint32_t i0, i1, i2, i3, i7, i8, i9, a, b, c, x;
+
+    vm_err_init(&r);
+
+    TEST_CHECK((ir = test_ir_new()) != NULL);
+    i0 = test_ir_int(ir, 0); i1 = test_ir_int(ir, 1); i2 = test_ir_int(ir, 2);
+    i3 = test_ir_int(ir, 3); i7 = test_ir_int(ir, 7); i8 = test_ir_int(ir, 8);
+    i9 = test_ir_int(ir, 9);
+    a = test_ir_id(ir, "a"); b = test_ir_id(ir, "b");
+    c = test_ir_id(ir, "c"); x = test_ir_id(ir, "x");
+
+    /* a = [1, 2, 3], b = [7, 8] */
+    test_ir_ins(ir, OP_PUSH, i3); test_ir_ins(ir, OP_PUSH, i2); test_ir_ins(ir, OP_PUSH, i1);
+    test_ir_ins(ir, OP_LSTMK, 3); test_ir_ins(ir, OP_POP, a);
+    test_ir_ins(ir, OP_PUSH, i8); test_ir_ins(ir, OP_PUSH, i7);
+    test_ir_ins(ir, OP_LSTMK, 2); test_ir_ins(ir, OP_POP, b);
+
+    /* c = [1, 7, 8] */
+    test_ir_ins(ir, OP_PUSH, b); test_ir_ins(ir, OP_PUSH, a);
+    test_ir_ins(ir, OP_LSTCDRSET, 0); test_ir_ins(ir, OP_POP, c);
+    test_ir_ins(ir, OP_PUSH, c); test_ir_ins(ir, OP_LSTCAR, 0); test_ir_ins(ir, OP_POP, x);
+    test_ir_check(ir, x, i1);
+    test_ir_binary(ir, x, i2, c, OP_REFGET);
+    test_ir_check(ir, x, i8);
+
+    /* b[0] = 9 is not seen by c, c[1] = 0 is not seen by b */
+    test_ir_ins(ir, OP_PUSH, i9); test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_PUSH, b);
+    test_ir_ins(ir, OP_REFSET, 0); test_ir_ins(ir, OP_POP, b);
+    test_ir_binary(ir, x, i1, c, OP_REFGET);
+    test_ir_check(ir, x, i7);
+    test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_PUSH, i1); test_ir_ins(ir, OP_PUSH, c);
+    test_ir_ins(ir, OP_REFSET, 0); test_ir_ins(ir, OP_POP, c);
+    test_ir_binary(ir, x, i0, b, OP_REFGET);
+    test_ir_check(ir, x, i9);
+    test_ir_binary(ir, x, i1, b, OP_REFGET);
+    test_ir_check(ir, x, i8);
+    test_ir_binary(ir, x, i1, c, OP_REFGET);
+    test_ir_expect(ir, x, i0);
+
+    TEST_CHECK(test_ir_run(ir, NULL, &r) == 0);
+    TEST_CHECK(vm_err_occurred(&r) == 0);
+
+    goto done;
+fail:
+    if (vm_err_occurred(&r) != 0) vm_err_print(&r);
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+static const struct test_case test_list_cases[] =
+{
+    {"cdr_isolated", test_list_cdr_isolated},
+    {"last_owner", test_list_last_owner},
+    {"cdr_set", test_list_cdr_set},
+};
+
+TEST_MAIN(test_list_cases)
+
@@ -0,0 +1,425 @@
+/* Test : Slice
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Array slices sharing the node buffer of their source, and tuples
+ * sharing their nodes with clones and cdrs. Either is copied on write
+ * while shared, and taken over by the last one using it.
+ *
+ * Usage: test_slice [<case> ...] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "vm_gc.h"
+#include "test.h"
+#include "test_vm.h"
+#include "test_global.h"
+#include "test_ir.h"
+
+#define TEST_SLICE_SIZE 6
+
+
+/* Operating */
+
+/* (0, 1, ..., count - 1) */
+static struct virtual_machine_object *test_slice_tuple_new(struct test_vm *env, int count)
+{
+    struct virtual_machine_object *new_object, *object_int;
+    int idx;
+
+    if ((new_object = virtual_machine_object_tuple_new(env->vm)) == NULL) return NULL;
+    for (idx = 0; idx != count; idx++)
+    {
+        /* Appending takes the element */
+        if (((object_int = virtual_machine_object_int_new_with_value(env->vm, idx)) == NULL) || \
+                (virtual_machine_object_tuple_append(new_object, object_int, env->vm) != 0))
+        {
+            virtual_machine_object_destroy(env->vm, new_object);
+            return NULL;
+        }
+    }
+
+    return new_object;
+}
+
+/* [0, 1, ..., count - 1], kept in global variable 'id' */
+static struct virtual_machine_object *test_slice_array_new(struct test_vm *env, \
+        uint32_t id, int count)
+{
+    struct virtual_machine_object *new_object, *object_int, *object_global;
+    int idx;
+
+    if ((new_object = virtual_machine_object_array_new(env->vm)) == NULL) return NULL;
+    for (idx = 0; idx != count; idx++)
+    {
+        if (((object_int = virtual_machine_object_int_new_with_value(env->vm, idx)) == NULL) || \
+                (virtual_machine_object_array_append(env->vm, new_object, object_int) != 0))
+        {
+            virtual_machine_object_destroy(env->vm, new_object);
+            return NULL;
+        }
+    }
+    object_global = test_global_set(env, id, new_object);
+    virtual_machine_object_destroy(env->vm, new_object);
+
+    return object_global;
+}
+
+/* 'length' elements of 'object_array' from 'offset',
+ * kept in global variable 'id' */
+static struct virtual_machine_object *test_slice_array_slice(struct test_vm *env, \
+        uint32_t id, struct virtual_machine_object *object_array, size_t offset, size_t length)
+{
+    struct virtual_machine_object *new_object, *object_global;
+
+    if (virtual_machine_object_array_slice(env->vm, &new_object, object_array, offset, length) != 0) return NULL;
+    object_global = test_global_set(env, id, new_object);
+    virtual_machine_object_destroy(env->vm, new_object);
+
+    return object_global;
+}
+
+static struct virtual_machine_object_array_internal *test_slice_array_internal( \
+        struct virtual_machine_object *object_array)
+{
+    return ((struct virtual_machine_object_array *)object_array->ptr)->ptr_internal;
+}
+
+static struct virtual_machine_object_tuple *test_slice_tuple(struct virtual_machine_object *object_tuple)
+{
+    return (struct virtual_machine_object_tuple *)object_tuple->ptr;
+}
+
+/* Element 'idx' of an array or a tuple set to 'value', the array is
+ * modified, the tuple modified is put into 'object_out' */
+static int test_slice_set(struct test_vm *env, struct virtual_machine_object **object_out, \
+        struct virtual_machine_object *object_src, int idx, int value)
+{
+    int ret;
+    struct virtual_machine_object *object_idx, *object_value, *new_object = NULL;
+
+    object_idx = virtual_machine_object_int_new_with_value(env->vm, idx);
+    object_value = virtual_machine_object_int_new_with_value(env->vm, value);
+    if ((object_idx == NULL) || (object_value == NULL)) ret = -1;
+    else if (object_src->type == OBJECT_TYPE_ARRAY)
+    { ret = virtual_machine_object_array_ref_set(env->vm, &new_object, object_src, object_idx, object_value); }
+    else
+    { ret = virtual_machine_object_tuple_ref_set(env->vm, &new_object, object_src, object_idx, object_value); }
+
+    if (object_idx != NULL) virtual_machine_object_destroy(env->vm, object_idx);
+    if (object_value != NULL) virtual_machine_object_destroy(env->vm, object_value);
+    if (object_out != NULL) { *object_out = new_object; new_object = NULL; }
+    if (new_object != NULL) virtual_machine_object_destroy(env->vm, new_object);
+    return ret;
+}
+
+/* Element 'idx' of an array or a tuple, or -1 */
+static int64_t test_slice_get(struct test_vm *env, \
+        struct virtual_machine_object *object_src, int idx)
+{
+    int ret;
+    int64_t value = -1;
+    struct virtual_machine_object *object_idx, *object_out = NULL;
+
+    if ((object_idx = virtual_machine_object_int_new_with_value(env->vm, idx)) == NULL) return -1;
+    if (object_src->type == OBJECT_TYPE_ARRAY)
+    { ret = virtual_machine_object_array_ref_get(env->vm, &object_out, object_src, object_idx); }
+    else
+    { ret = virtual_machine_object_tuple_ref_get(env->vm, &object_out, object_src, object_idx); }
+    if ((ret == 0) && (object_out->type == OBJECT_TYPE_INT))
+    { value = virtual_machine_object_int_get_primitive_value(object_out); }
+
+    virtual_machine_object_destroy(env->vm, object_idx);
+    if (object_out != NULL) virtual_machine_object_destroy(env->vm, object_out);
+    return value;
+}
+
+
+/* Cases */
+
+/* A slice sees no change made to its source afterwards, nor the source
+ * any change made to the slice */
+static int test_slice_array_isolated(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_array, *object_slice, *object_cdr, *object_int;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+
+    /* [0 .. 5], [1, 2, 3], [2, 3] */
+    TEST_CHECK((object_array = test_slice_array_new(&env, 0, TEST_SLICE_SIZE)) != NULL);
+    TEST_CHECK((object_slice = test_slice_array_slice(&env, 1, object_array, 1, 3)) != NULL);
+    TEST_CHECK((object_cdr = test_slice_array_slice(&env, 2, object_slice, 1, 2)) != NULL);
+    TEST_CHECK(test_slice_array_internal(object_slice)->nodes == test_slice_array_internal(object_array)->nodes);
+    TEST_CHECK(test_slice_array_internal(object_cdr)->shared->refcount == 3);
+
+    /* Source to view */
+    TEST_CHECK(test_slice_set(&env, NULL, object_array, 2, 99) == 0);
+    TEST_CHECK(test_slice_get(&env, object_array, 2) == 99);
+    TEST_CHECK(test_slice_get(&env, object_slice, 1) == 2);
+    TEST_CHECK(test_slice_get(&env, object_cdr, 0) == 2);
+
+    /* View to source, and to the view taken from it */
+    TEST_CHECK(test_slice_set(&env, NULL, object_slice, 0, 77) == 0);
+    TEST_CHECK(test_slice_get(&env, object_slice, 0) == 77);
+    TEST_CHECK(test_slice_get(&env, object_array, 1) == 1);
+    TEST_CHECK(test_slice_get(&env, object_cdr, 0) == 2);
+
+    /* Appending, into the slot after the view in the buffer */
+    TEST_CHECK((object_int = virtual_machine_object_int_new_with_value(env.vm, TEST_SLICE_SIZE)) != NULL);
+    TEST_CHECK(virtual_machine_object_array_append(env.vm, object_cdr, object_int) == 0);
+    TEST_CHECK(test_slice_array_internal(object_cdr)->size == 3);
+    TEST_CHECK(test_slice_get(&env, object_cdr, 2) == TEST_SLICE_SIZE);
+    TEST_CHECK(test_slice_array_internal(object_slice)->size == 3);
+    TEST_CHECK(test_slice_get(&env, object_array, 4) == 4);
+
+    goto done;
+fail:
+done:
+    test_vm_final(&env);
+    return ret;
+}
+
+/* Once the other arrays are collected, the one left writes into the
+ * buffer instead of copying it, whether it is the slice or the source */
+static int test_slice_array_last_owner(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_array, *object_slice, *object_last;
+    struct virtual_machine_object_array_internal_node *nodes;
+    int last;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+
+    for (last = 0; last != 2; last++)
+    {
+        TEST_CHECK((object_array = test_slice_array_new(&env, 0, TEST_SLICE_SIZE)) != NULL);
+        TEST_CHECK((object_slice = test_slice_array_slice(&env, 1, object_array, 1, TEST_SLICE_SIZE - 2)) != NULL);
+
+        /* Drop the slice, or the source */
+        TEST_CHECK(test_global_clear(&env, (uint32_t)(1 - last)) == 0);
+        object_last = (last == 0) ? object_array : object_slice;
+        virtual_machine_garbage_collect(env.vm);
+        TEST_CHECK(test_slice_array_internal(object_last)->shared->refcount == 1);
+        nodes = test_slice_array_internal(object_last)->nodes;
+
+        TEST_CHECK(test_slice_set(&env, NULL, object_last, 0, 42) == 0);
+        TEST_CHECK(test_slice_array_internal(object_last)->nodes == nodes);
+        TEST_CHECK(test_slice_array_internal(object_last)->shared == NULL);
+        TEST_CHECK(test_slice_get(&env, object_last, 0) == 42);
+        TEST_CHECK(test_slice_get(&env, object_last, 1) == 1 + last);
+
+        TEST_CHECK(test_global_clear(&env, 0) == 0);
+        TEST_CHECK(test_global_clear(&env, 1) == 0);
+    }
+
+    goto done;
+fail:
+done:
+    test_vm_final(&env);
+    return ret;
+}
+
+/* Tuples are values, setting an element makes another tuple, the clones
+ * and cdrs of the one set keep the nodes they share */
+static int test_slice_tuple_isolated(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_tuple = NULL, *object_clone = NULL, *object_cdr = NULL;
+    struct virtual_machine_object *object_set = NULL, *object_int;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+
+    TEST_CHECK((object_tuple = test_slice_tuple_new(&env, TEST_SLICE_SIZE)) != NULL);
+    TEST_CHECK((object_clone = virtual_machine_object_tuple_clone(env.vm, object_tuple)) != NULL);
+    TEST_CHECK(virtual_machine_object_tuple_cdr(env.vm, &object_cdr, object_tuple) == 0);
+    TEST_CHECK(test_slice_tuple(object_cdr)->begin == test_slice_tuple(object_tuple)->begin->next);
+
+    /* Source to views */
+    TEST_CHECK(test_slice_set(&env, &object_set, object_tuple, 2, 99) == 0);
+    TEST_CHECK(test_slice_get(&env, object_set, 2) == 99);
+    TEST_CHECK(test_slice_get(&env, object_tuple, 2) == 2);
+    TEST_CHECK(test_slice_get(&env, object_clone, 2) == 2);
+    TEST_CHECK(test_slice_get(&env, object_cdr, 1) == 2);
+    virtual_machine_object_destroy(env.vm, object_set); object_set = NULL;
+
+    /* View to source */
+    TEST_CHECK(test_slice_set(&env, &object_set, object_cdr, 0, 77) == 0);
+    TEST_CHECK(test_slice_get(&env, object_set, 0) == 77);
+    TEST_CHECK(test_slice_get(&env, object_tuple, 1) == 1);
+    TEST_CHECK(test_slice_get(&env, object_clone, 1) == 1);
+
+    /* Appending in place */
+    TEST_CHECK((object_int = virtual_machine_object_int_new_with_value(env.vm, TEST_SLICE_SIZE)) != NULL);
+    TEST_CHECK(virtual_machine_object_tuple_append(object_cdr, object_int, env.vm) == 0);
+    TEST_CHECK(test_slice_tuple(object_cdr)->begin != test_slice_tuple(object_tuple)->begin->next);
+    TEST_CHECK(test_slice_tuple(object_cdr)->size == TEST_SLICE_SIZE);
+    TEST_CHECK(test_slice_tuple(object_tuple)->size == TEST_SLICE_SIZE);
+    TEST_CHECK(test_slice_tuple(object_clone)->size == TEST_SLICE_SIZE);
+
+    goto done;
+fail:
+done:
+    if (object_set != NULL) virtual_machine_object_destroy(env.vm, object_set);
+    if (object_cdr != NULL) virtual_machine_object_destroy(env.vm, object_cdr);
+    if (object_clone != NULL) virtual_machine_object_destroy(env.vm, object_clone);
+    if (object_tuple != NULL) virtual_machine_object_destroy(env.vm, object_tuple);
+    test_vm_final(&env);
+    return ret;
+}
+
+/* Once the other tuple is destroyed, the one left appends to the nodes
+ * instead of copying them, whether it is the cdr or the source */
+static int test_slice_tuple_last_owner(void)
+{
+    int ret = 0;
+    struct test_vm env;
+    struct virtual_machine_object *object_tuple = NULL, *object_cdr = NULL, *object_int;
+    struct virtual_machine_object *object_last;
+    struct virtual_machine_object_tuple_node *begin;
+    int last;
+
+    TEST_CHECK(test_vm_init(&env, NULL) == 0);
+
+    for (last = 0; last != 2; last++)
+    {
+        TEST_CHECK((object_tuple = test_slice_tuple_new(&env, TEST_SLICE_SIZE)) != NULL);
+        TEST_CHECK(virtual_machine_object_tuple_cdr(env.vm, &object_cdr, object_tuple) == 0);
+        TEST_CHECK(test_slice_tuple(object_cdr)->begin->refcount == 2);
+
+        /* Drop the cdr, or the source */
+        if (last == 0)
+        {
+            virtual_machine_object_destroy(env.vm, object_cdr); object_cdr = NULL;
+            object_last = object_tuple;
+        }
+        else
+        {
+            virtual_machine_object_destroy(env.vm, object_tuple); object_tuple = NULL;
+            object_last = object_cdr;
+        }
+        begin = test_slice_tuple(object_last)->begin;
+        TEST_CHECK(begin->next->refcount == 1);
+
+        TEST_CHECK((object_int = virtual_machine_object_int_new_with_value(env.vm, TEST_SLICE_SIZE)) != NULL);
+        TEST_CHECK(virtual_machine_object_tuple_append(object_last, object_int, env.vm) == 0);
+        TEST_CHECK(test_slice_tuple(object_last)->begin == begin);
+        TEST_CHECK(test_slice_get(&env, object_last, 0) == last);
+        TEST_CHECK(test_slice_get(&env, object_last, TEST_SLICE_SIZE - last) == TEST_SLICE_SIZE);
+
+        virtual_machine_object_destroy(env.vm, object_last);
+        object_tuple = object_cdr = NULL;
+    }
+
+    goto done;
+fail:
+done:
+    if (object_cdr != NULL) virtual_machine_object_destroy(env.vm, object_cdr);
+    if (object_tuple != NULL) virtual_machine_object_destroy(env.vm, object_tuple);
+    test_vm_final(&env);
+    return ret;
+}
+
+/* TUPCAR, TUPCDR and ARRCDR on programs, the results set with REFSET
+ * apart from their sources */
+static int test_slice_cdr_program(void)
+{
+    int ret = 0;
+    struct multiple_ir *ir = NULL;
+    struct vm_err r;
+    uint32_t i0, i1, i2, i3, i9, t, c, a, d, x;
+    uint32_t opcodes_make[2] = {OP_TUPMK, OP_ARRMK};
+    uint32_t opcodes_cdr[2] = {OP_TUPCDR, OP_ARRCDR};
+    int idx;
+
+    vm_err_init(&r);
+
+    TEST_CHECK((ir = test_ir_new()) != NULL);
+    i0 = test_ir_int(ir, 0); i1 = test_ir_int(ir, 1); i2 = test_ir_int(ir, 2);
+    i3 = test_ir_int(ir, 3); i9 = test_ir_int(ir, 9);
+    t = test_ir_id(ir, "t"); c = test_ir_id(ir, "c");
+    a = test_ir_id(ir, "a"); d = test_ir_id(ir, "d");
+    x = test_ir_id(ir, "x");
+
+    /* t = (1, 2, 3), c = cdr(t), then the same on a = [1, 2, 3] */
+    for (idx = 0; idx != 2; idx++)
+    {
+        test_ir_ins(ir, OP_PUSH, i3); test_ir_ins(ir, OP_PUSH, i2); test_ir_ins(ir, OP_PUSH, i1);
+        test_ir_ins(ir, opcodes_make[idx], 3); test_ir_ins(ir, OP_POP, idx == 0 ? t : a);
+        test_ir_ins(ir, OP_PUSH, idx == 0 ? t : a); test_ir_ins(ir, opcodes_cdr[idx], 0);
+        test_ir_ins(ir, OP_POP, idx == 0 ? c : d);
+    }
+    test_ir_ins(ir, OP_PUSH, c); test_ir_ins(ir, OP_TUPCAR, 0); test_ir_ins(ir, OP_POP, x);
+    test_ir_check(ir, x, i2);
+
+    /* t[1] = 9 is not seen by c, c[0] = 0 is not seen by t */
+    test_ir_ins(ir, OP_PUSH, i9); test_ir_ins(ir, OP_PUSH, i1); test_ir_ins(ir, OP_PUSH, t);
+    test_ir_ins(ir, OP_REFSET, 0); test_ir_ins(ir, OP_POP, t);
+    test_ir_binary(ir, x, i0, c, OP_REFGET);
+    test_ir_check(ir, x, i2);
+    test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_PUSH, i0); test_ir_ins(ir, OP_PUSH, c);
+    test_ir_ins(ir, OP_REFSET, 0); test_ir_ins(ir, OP_POP, c);
+    test_ir_binary(ir, x, i1, t, OP_REFGET);
+    test_ir_check(ir, x, i9);
+    test_ir_binary(ir, x, i2, t, OP_REFGET);
+    test_ir_check(ir, x, i3);
+    test_ir_binary(ir, x, i0, c, OP_REFGET);
+    test_ir_check(ir, x, i0);
+
+    /* a[1] = 9 is not seen by d */
+    test_ir_ins(ir, OP_PUSH, i9); test_ir_ins(ir, OP_PUSH, i1); test_ir_ins(ir, OP_PUSH, a);
+    test_ir_ins(ir, OP_REFSET, 0); test_ir_ins(ir, OP_POP, a);
+    test_ir_binary(ir, x, i0, d, OP_REFGET);
+    test_ir_check(ir, x, i2);
+    test_ir_binary(ir, x, i1, a, OP_REFGET);
+    test_ir_expect(ir, x, i9);
+
+    TEST_CHECK(test_ir_run(ir, NULL, &r) == 0);
+    TEST_CHECK(vm_err_occurred(&r) == 0);
+
+    goto done;
+fail:
+    if (vm_err_occurred(&r) != 0) vm_err_print(&r);
+done:
+    if (ir != NULL) multiple_ir_destroy(ir);
+    return ret;
+}
+
+static const struct test_case test_slice_cases[] =
+{
+    {"array_isolated", test_slice_array_isolated},
+    {"array_last_owner", test_slice_array_last_owner},
+    {"tuple_isolated", test_slice_tuple_isolated},
+    {"tuple_last_owner", test_slice_tuple_last_owner},
+    {"cdr_program", test_slice_cdr_program},
+};
+
+TEST_MAIN(test_slice_cases)
+
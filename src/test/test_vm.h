@@ -0,0 +1,72 @@
+/* Test : Virtual Machine
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* A virtual machine with a current thread and no program,
+ * for the tests operating on its objects and collector directly */
+
+#ifndef _TEST_VM_H_
+#define _TEST_VM_H_
+
+#include "multiple_err.h"
+#include "vm_startup.h"
+#include "vm_err.h"
+#include "vm_infrastructure.h"
+
+struct test_vm
+{
+    struct vm_err r;
+    struct virtual_machine *vm;
+};
+
+/* 'startup' could be NULL for the defaults */
+static int test_vm_init(struct test_vm *env, struct virtual_machine_startup *startup)
+{
+    struct virtual_machine_startup startup_default;
+    struct virtual_machine_thread *new_thread;
+
+    env->vm = NULL;
+    vm_err_init(&env->r);
+    if (startup == NULL)
+    {
+        virtual_machine_startup_init(&startup_default);
+        startup = &startup_default;
+    }
+    if ((env->vm = virtual_machine_new(startup, &env->r)) == NULL) return -1;
+
+    /* Solving operands and collecting look at the current thread */
+    if ((new_thread = virtual_machine_thread_new(env->vm)) == NULL) return -1;
+    if (virtual_machine_thread_list_append(env->vm, env->vm->threads, new_thread) != 0)
+    {
+        virtual_machine_thread_destroy(env->vm, new_thread);
+        return -1;
+    }
+    env->vm->tp = new_thread;
+
+    return 0;
+}
+
+static void test_vm_final(struct test_vm *env)
+{
+    if (env->vm != NULL) virtual_machine_destroy(env->vm, 0);
+    env->vm = NULL;
+    vm_err_final(&env->r);
+}
+
+#endif
+
@@ -43,15 +43,199 @@ struct multiply_resource_id_pool *multiply_resource_id_pool_new(void)
                     sizeof(struct multiply_resource_id_pool))) == NULL)
     { return NULL; }
     new_resource_id_pool->id = MULTIPLY_RESOURCE_ID_POOL_START;
+    new_resource_id_pool->ir = NULL;
+    new_resource_id_pool->indexed_last = NULL;
+    new_resource_id_pool->indexed_count = 0;
+    new_resource_id_pool->index = NULL;
+    new_resource_id_pool->index_size = 0;
+    new_resource_id_pool->index_used = 0;
     return new_resource_id_pool;
 }
 
 int multiply_resource_id_pool_destroy(struct multiply_resource_id_pool *id)
 {
+    if (id->index != NULL) free(id->index);
     free(id);
     return 0;
 }
 
+int multiply_resource_id_pool_bind(struct multiply_resource_id_pool *res_id, \
+        struct multiple_ir *ir)
+{
+    size_t idx;
+
+    for (idx = 0; idx != res_id->index_size; idx++) res_id->index[idx] = NULL;
+    res_id->index_used = 0;
+    res_id->ir = ir;
+    res_id->indexed_last = NULL;
+    res_id->indexed_count = 0;
+
+    return 0;
+}
+
+
+/* Resource Index */
+
+/* Bytes of the value, -1 for the items never deduplicated */
+static int multiply_resource_key(const void **key_out, size_t *key_len_out, \
+        const struct multiple_ir_data_section_item *item)
+{
+    switch (item->type)
+    {
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NONE:
+            *key_out = NULL; *key_len_out = 0; break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT:
+            *key_out = &item->u.value_int; *key_len_out = sizeof(int); break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_FLOAT:
+            *key_out = &item->u.value_float; *key_len_out = sizeof(double); break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_CHAR:
+            *key_out = &item->u.value_char; *key_len_out = sizeof(uint32_t); break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL:
+            *key_out = &item->u.value_bool; *key_len_out = sizeof(int); break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NAN:
+            *key_out = &item->u.signed_nan; *key_len_out = sizeof(int); break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INF:
+            *key_out = &item->u.signed_inf; *key_len_out = sizeof(int); break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER:
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_STR:
+            *key_out = item->u.value_str.str; *key_len_out = item->u.value_str.len; break;
+        case MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_UNKNOWN:
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+/* FNV-1a over the type and the value */
+static size_t multiply_resource_hash(const struct multiple_ir_data_section_item *item)
+{
+    uint32_t hash = 2166136261u;
+    const unsigned char *p;
+    const void *key;
+    size_t key_len;
+
+    hash = (hash ^ (uint32_t)item->type) * 16777619u;
+    if (multiply_resource_key(&key, &key_len, item) != 0) return (size_t)hash;
+    for (p = (const unsigned char *)key; key_len-- != 0; p++)
+    { hash = (hash ^ (uint32_t)(*p)) * 16777619u; }
+
+    return (size_t)hash;
+}
+
+static int multiply_resource_equal(const struct multiple_ir_data_section_item *item1, \
+        const struct multiple_ir_data_section_item *item2)
+{
+    const void *key1, *key2;
+    size_t key1_len, key2_len;
+
+    if (item1->type != item2->type) return 0;
+    if (multiply_resource_key(&key1, &key1_len, item1) != 0) return 0;
+    if (multiply_resource_key(&key2, &key2_len, item2) != 0) return 0;
+    if (key1_len != key2_len) return 0;
+    return ((key1_len == 0) || (memcmp(key1, key2, key1_len) == 0)) ? 1 : 0;
+}
+
+static struct multiple_ir_data_section_item **multiply_resource_index_slot( \
+        struct multiply_resource_id_pool *res_id, \
+        const struct multiple_ir_data_section_item *item)
+{
+    size_t mask = res_id->index_size - 1;
+    size_t idx = multiply_resource_hash(item) & mask;
+
+    while ((res_id->index[idx] != NULL) && \
+            (multiply_resource_equal(res_id->index[idx], item) == 0))
+    { idx = (idx + 1) & mask; }
+
+    return &res_id->index[idx];
+}
+
+static int multiply_resource_index_grow(struct multiply_resource_id_pool *res_id)
+{
+    struct multiple_ir_data_section_item **index_old = res_id->index;
+    size_t index_size_old = res_id->index_size;
+    size_t idx;
+
+    res_id->index_size = (index_size_old == 0) ? MULTIPLY_RESOURCE_INDEX_SIZE_INIT : index_size_old * 2;
+    if ((res_id->index = (struct multiple_ir_data_section_item **)calloc( \
+                    res_id->index_size, sizeof(struct multiple_ir_data_section_item *))) == NULL)
+    {
+        res_id->index = index_old;
+        res_id->index_size = index_size_old;
+        return -MULTIPLE_ERR_MALLOC;
+    }
+
+    for (idx = 0; idx != index_size_old; idx++)
+    {
+        if (index_old[idx] != NULL)
+        { *multiply_resource_index_slot(res_id, index_old[idx]) = index_old[idx]; }
+    }
+    if (index_old != NULL) free(index_old);
+
+    return 0;
+}
+
+/* Index the items appended since the last time, the first one of the
+ * same value stays in the index */
+static int multiply_resource_index_sync(struct multiply_resource_id_pool *res_id, \
+        struct multiple_ir *ir)
+{
+    int ret;
+    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item **slot;
+    const void *key;
+    size_t key_len;
+
+    /* Used with another IR without being bound to it */
+    if ((res_id->ir != ir) || (ir->data_section->size < res_id->indexed_count))
+    { multiply_resource_id_pool_bind(res_id, ir); }
+
+    item_cur = (res_id->indexed_last == NULL) ? ir->data_section->begin : res_id->indexed_last->next;
+    while (item_cur != NULL)
+    {
+        if (multiply_resource_key(&key, &key_len, item_cur) == 0)
+        {
+            if ((res_id->index_used + 1) * 4 > res_id->index_size * 3)
+            {
+                if ((ret = multiply_resource_index_grow(res_id)) != 0)
+                { return ret; }
+            }
+            slot = multiply_resource_index_slot(res_id, item_cur);
+            if (*slot == NULL)
+            {
+                *slot = item_cur;
+                res_id->index_used++;
+            }
+        }
+        res_id->indexed_last = item_cur;
+        res_id->indexed_count++;
+        item_cur = item_cur->next;
+    }
+
+    return 0;
+}
+
+/* Item with the same type and value as 'key', NULL for none */
+static int multiply_resource_lookup( \
+        struct multiple_error *err, struct multiple_ir *ir, struct multiply_resource_id_pool *res_id, \
+        struct multiple_ir_data_section_item **item_out, \
+        const struct multiple_ir_data_section_item *key)
+{
+    int ret = 0;
+
+    *item_out = NULL;
+
+    if ((ret = multiply_resource_index_sync(res_id, ir)) != 0)
+    { MULTIPLE_ERROR_MALLOC(); goto fail; }
+    if (res_id->index_size == 0) goto done;
+
+    *item_out = *multiply_resource_index_slot(res_id, key);
+
+    goto done;
+fail:
+done:
+    return ret;
+}
+
 
 /* Low-level */
 
@@ -63,15 +247,14 @@ int multiply_resource_get_none( \
         uint32_t *id_out)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NONE)
-        { *id_out = item_cur->id; return 0; }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NONE;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NONE)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -94,18 +277,15 @@ int multiply_resource_get_int( \
         int value)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT)
-        {
-            if (item_cur->u.value_int == value)
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT;
+    key.u.value_int = value;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -123,27 +303,21 @@ fail:
 }
 
 /* float */
-#ifndef DBL_EPSILON
-#define DBL_EPSILON 0.00001
-#endif
 int multiply_resource_get_float( \
         struct multiple_error *err, struct multiple_ir *ir, struct multiply_resource_id_pool *res_id, \
         uint32_t *id_out, \
         double value)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_FLOAT)
-        {
-            if (item_cur->u.value_float - value <= DBL_EPSILON)
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_FLOAT;
+    key.u.value_float = value;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_FLOAT)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -167,18 +341,15 @@ int multiply_resource_get_char( \
         uint32_t value)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_CHAR)
-        {
-            if (item_cur->u.value_char == value)
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_CHAR;
+    key.u.value_char = value;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_CHAR)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -204,18 +375,15 @@ int multiply_resource_get_bool( \
         int value)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL)
-        {
-            if (item_cur->u.value_bool == value)
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL;
+    key.u.value_bool = value;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_BOOL)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -257,18 +425,15 @@ int multiply_resource_get_nan( \
         int is_negative)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NAN)
-        {
-            if (item_cur->u.signed_nan == is_negative)
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NAN;
+    key.u.signed_nan = is_negative;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_NAN)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -292,18 +457,15 @@ int multiply_resource_get_inf( \
         int is_negative)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INF)
-        {
-            if (item_cur->u.signed_inf == is_negative)
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INF;
+    key.u.signed_inf = is_negative;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INF)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -327,19 +489,16 @@ int multiply_resource_get_id( \
         const char *str, const size_t len)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER)
-        {
-            if ((item_cur->u.value_str.len == len) && \
-                    (strncmp(item_cur->u.value_str.str, str, len) == 0))
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER;
+    key.u.value_str.str = (char *)str;
+    key.u.value_str.len = len;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -375,19 +534,16 @@ int multiply_resource_get_str( \
         const char *str, const size_t len)
 {
     int ret = 0;
-    struct multiple_ir_data_section_item *item_cur;
+    struct multiple_ir_data_section_item key, *item_found;
     struct multiple_ir_data_section_item *new_item;
     uint32_t id;
 
-    for (item_cur = ir->data_section->begin; item_cur != NULL; item_cur = item_cur->next)
-    {
-        if (item_cur->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_STR)
-        {
-            if ((item_cur->u.value_str.len == len) && \
-                    (strncmp(item_cur->u.value_str.str, str, len) == 0))
-            { *id_out = item_cur->id; return 0; }
-        }
-    }
+    key.type = MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_STR;
+    key.u.value_str.str = (char *)str;
+    key.u.value_str.len = len;
+    if ((ret = multiply_resource_lookup(err, ir, res_id, &item_found, &key)) != 0)
+    { return ret; }
+    if (item_found != NULL) { *id_out = item_found->id; return 0; }
 
     if ((new_item = multiple_ir_data_section_item_new(MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_STR)) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
@@ -34,12 +34,28 @@
 /* Resource ID Pool */
 
 #define MULTIPLY_RESOURCE_ID_POOL_START 1024
+#define MULTIPLY_RESOURCE_INDEX_SIZE_INIT 64
 struct multiply_resource_id_pool
 {
     uint32_t id;
+
+    /* Index of the data section items of 'ir' keyed by type and value, 
+     * open addressing with the size in power of 2. Items appended since 
+     * the last lookup are indexed on the next one, all of them are 
+     * dropped when the pool is bound to another IR. */
+    struct multiple_ir *ir;
+    struct multiple_ir_data_section_item *indexed_last;
+    size_t indexed_count;
+    struct multiple_ir_data_section_item **index;
+    size_t index_size;
+    size_t index_used;
 };
 struct multiply_resource_id_pool *multiply_resource_id_pool_new(void);
 int multiply_resource_id_pool_destroy(struct multiply_resource_id_pool *id);
+/* Drop the index and use the pool with 'ir' from now on, needed whenever 
+ * the IR is a new one, which could be at the address of a destroyed one */
+int multiply_resource_id_pool_bind(struct multiply_resource_id_pool *res_id, \
+        struct multiple_ir *ir);
 
 
 /* Low-level */
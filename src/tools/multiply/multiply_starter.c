@@ -120,7 +120,8 @@ int multiply_starter_generate_ir( \
     if ((new_ir = multiple_ir_new()) == NULL)
     { MULTIPLE_ERROR_MALLOC(); ret = -MULTIPLE_ERR_MALLOC; goto fail; }
 
-    (void)starter;
+    /* Nothing indexed is in the new IR */
+    multiply_resource_id_pool_bind(starter->res_id, new_ir);
 
     *ir_out = new_ir;
 
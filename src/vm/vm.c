@@ -24,6 +24,7 @@
 
 #include "multiple.h"
 #include "multiple_ir.h"
+#include "multiple_ir_opt.h"
 #include "multiple_err.h"
 #include "multiple_misc.h"
 #include "multiple_prelude.h"
@@ -34,7 +35,12 @@
 #include "vm_infrastructure.h"
 #include "vm_object_aio.h"
 #include "vm_gc.h"
+#include "vm_stats.h"
 #include "vm_cpu.h"
+#include "vm_cpu_fused.h"
+#include "vm_block_cache.h"
+#include "vm_prof.h"
+#include "vm_sampler.h"
 #include "vm.h"
 #include "vm_dynlib.h"
 #include "vm_err.h"
@@ -365,6 +371,7 @@ static int virtual_machine_text_section_new_from_ir( \
         new_virtual_machine_text_section->instruments[index].opcode = text_section_item_cur->opcode;
         new_virtual_machine_text_section->instruments[index].operand = text_section_item_cur->operand;
         new_virtual_machine_text_section->instruments[index].data_id = 0;
+        new_virtual_machine_text_section->instruments[index].fused = OP_FUSED_NONE;
 
         virtual_machine_instrument_to_operand_type(&operand_type, text_section_item_cur->opcode);
 
@@ -491,10 +498,23 @@ static int virtual_machine_module_load_ir( \
         struct virtual_machine_ir_loading_queue *loading_queue)
 {
     int ret = 0;
+    struct multiple_ir_opt_stats optimize_stats;
 
     if ((module == NULL) || (ir == NULL))
     { MULTIPLE_ERROR_NULL_PTR(); ret = -MULTIPLE_ERR_NULL_PTR; goto fail; }
 
+    if (vm->optimize > MULTIPLE_IR_OPT_LEVEL_NONE)
+    {
+        if ((ret = multiple_ir_optimize(err, ir, vm->optimize, &optimize_stats)) != 0)
+        { goto fail; }
+        vm->optimize_stats.before += optimize_stats.before;
+        vm->optimize_stats.after += optimize_stats.after;
+        vm->optimize_stats.folded += optimize_stats.folded;
+        vm->optimize_stats.threaded += optimize_stats.threaded;
+        vm->optimize_stats.paired += optimize_stats.paired;
+        vm->optimize_stats.unreachable += optimize_stats.unreachable;
+    }
+
     if ((ret = virtual_machine_data_section_new_from_ir(err, vm, ir, \
                     &module->data_section, module)) != 0)
     { goto fail; }
@@ -507,6 +527,12 @@ static int virtual_machine_module_load_ir( \
                     &module->export_section)) != 0)
     { goto fail; }
 
+    if (vm->optimize > MULTIPLE_IR_OPT_LEVEL_NONE)
+    {
+        if ((ret = virtual_machine_text_section_fuse(vm, module)) != 0)
+        { goto fail; }
+    }
+
     if ((ret = virtual_machine_debug_section_new_from_ir(err, vm, ir, \
                     &module->debug_section)) != 0)
     { goto fail; }
@@ -723,6 +749,7 @@ static int virtual_machine_external_event_process(struct multiple_error *err, \
     struct virtual_machine_module *module_target;
     uint32_t function_instrument_number;
     struct virtual_machine_thread *new_thread = NULL;
+    struct virtual_machine_object *object_arg_cur;
     size_t args_count;
 
     (void)err;
@@ -764,6 +791,23 @@ static int virtual_machine_external_event_process(struct multiple_error *err, \
             ret = -MULTIPLE_ERR_MALLOC; goto fail; 
         }
 
+        /* Raw arguments were pushed without GIL, 
+         * hand the shared payloads over to the collector before cloning them */
+        object_arg_cur = external_event_target->args->bottom;
+        while (object_arg_cur != NULL)
+        {
+            if ((object_arg_cur->type == OBJECT_TYPE_RAW) && \
+                    (((struct virtual_machine_object_raw *)object_arg_cur->ptr)->shared != 0))
+            {
+                if ((ret = virtual_machine_object_raw_share(vm, object_arg_cur)) != 0)
+                {
+                    thread_mutex_unlock(&vm->external_events->lock);
+                    goto fail; 
+                }
+            }
+            object_arg_cur = object_arg_cur->next;
+        }
+
         ret = virtual_machine_computing_stack_transport_reversely( \
                 vm, \
                 new_thread->running_stack->top->arguments, \
@@ -784,7 +828,7 @@ static int virtual_machine_external_event_process(struct multiple_error *err, \
             }
             args_count--;
         }
-        if ((ret = virtual_machine_thread_list_append(vm->threads, new_thread)) != 0)
+        if ((ret = virtual_machine_thread_list_append(vm, vm->threads, new_thread)) != 0)
         {
             thread_mutex_unlock(&vm->external_events->lock);
             goto fail; 
@@ -806,65 +850,101 @@ fail:
 static int virtual_machine_next_thread( \
         struct virtual_machine *vm)
 {
-    struct virtual_machine_thread *old_thread;
+    struct virtual_machine_thread_queue *runnable;
+    int type, priority, priority_lower;
 
-    /* Prevent NULL Current Thread Pointer */
-    if (vm->tp == NULL) { vm->tp = vm->threads->begin; }
+    type = (vm->debug_mode == 0) ? \
+           VIRTUAL_MACHINE_THREAD_TYPE_NORMAL : VIRTUAL_MACHINE_THREAD_TYPE_DEBUGGER;
 
-    /* Only One Thread */
-    if (vm->threads->size == 1) 
+    /* The highest priority with runnable threads */
+    for (priority = VIRTUAL_MACHINE_THREAD_PRIORITY_COUNT - 1; priority >= 0; priority--)
     {
-        if ((vm->debug_mode == 0) && \
-                (vm->tp->type == VIRTUAL_MACHINE_THREAD_TYPE_NORMAL)) return 0;
-        else if ((vm->debug_mode == 1) && \
-                (vm->tp->type == VIRTUAL_MACHINE_THREAD_TYPE_DEBUGGER)) return 0;
-        return VIRTUAL_MACHINE_NEXT_THREAD_SLEEP; 
+        if (vm->threads->runnable[type][priority].size != 0) break;
     }
 
-    /* Multiple Threads */
-    old_thread = vm->tp;
-    /* Next thread */
-    vm->tp = (vm->tp->next != NULL) ? vm->tp->next : vm->threads->begin;
+    /* No runnable thread */
+    if (priority < 0) return VIRTUAL_MACHINE_NEXT_THREAD_SLEEP;
 
-    for (;;)
+    /* Busy threads of higher priority should not starve lower ones */
+    for (priority_lower = priority - 1; priority_lower >= 0; priority_lower--)
+    {
+        if (vm->threads->runnable[type][priority_lower].size != 0) break;
+    }
+    if (priority_lower < 0)
+    { vm->threads->starving = 0; }
+    else if (++vm->threads->starving > VIRTUAL_MACHINE_THREAD_PRIORITY_AGING)
     {
-        if ((vm->debug_mode == 0) && \
-                (vm->tp->type == VIRTUAL_MACHINE_THREAD_TYPE_NORMAL)) return 0;
-        else if ((vm->debug_mode == 1) && \
-                (vm->tp->type == VIRTUAL_MACHINE_THREAD_TYPE_DEBUGGER)) return 0;
-        /* Next thread */
-        vm->tp = (vm->tp->next != NULL) ? vm->tp->next : vm->threads->begin;
-        /* Duplicate */
-        if (vm->tp == old_thread) { return VIRTUAL_MACHINE_NEXT_THREAD_SLEEP; }
+        vm->threads->starving = 0;
+        priority = priority_lower;
     }
+    runnable = &vm->threads->runnable[type][priority];
+
+    /* Round-robin in the run queue, 
+     * take the one after current thread */
+    if ((vm->tp != NULL) && \
+            (vm->tp->state == VIRTUAL_MACHINE_THREAD_STATE_NORMAL) && \
+            (vm->tp->type == type) && \
+            (vm->tp->priority == priority) && \
+            (vm->tp->queue_next != NULL))
+    { vm->tp = vm->tp->queue_next; }
+    else
+    { vm->tp = runnable->begin; }
 
+    return 0;
 }
 
-static int virtual_machine_module_run_function(struct multiple_error *err, \
-        struct virtual_machine *vm, \
-        struct virtual_machine_module *module, \
-        uint32_t function_instrument_number, \
-        size_t args_count) /* Arguments passed in */
+/* Workers 
+ * Threads are not scheduled M:N, all of them stay in the one set of run 
+ * queues and every instrument runs with GIL held, so there is no work 
+ * stealing and no safe point protocol for the GC. The first worker runs 
+ * the threads, a spare one only stands in for an OS thread busy inside 
+ * a native section, which keeps the other threads going meanwhile */
+
+/* Arguments of a worker */
+struct virtual_machine_worker
 {
-    int ret = 0;
-    struct virtual_machine_module *init_module;
-    struct virtual_machine_thread *thread_to_kill;
+    struct multiple_error *err;
+    struct virtual_machine *vm;
+    struct virtual_machine_module *module;
+    uint32_t function_instrument_number;
+    size_t args_count;
 
-    init_module = module;
+    /* Only runs threads while others are inside native sections */
+    int spare;
 
-    /* Create the initial thread */
-    if ((ret = virtual_machine_thread_list_append_with_configure(vm, vm->threads, \
-                    init_module, function_instrument_number, 
-                    args_count)) != 0)
-    { goto fail; }
+    thread_handle_t handle;
+    int ret;
+};
 
-    /* Set the current thread pointer */
-    vm->tp = vm->threads->begin;
+/* Scheduler loop of a worker, 
+ * takes GIL at the beginning of every time slice and gives it up at the end */
+static int virtual_machine_worker_run(struct virtual_machine_worker *worker)
+{
+    int ret = 0;
+    struct multiple_error *err = worker->err;
+    struct virtual_machine *vm = worker->vm;
+    struct virtual_machine_thread *thread_to_kill;
+    int finished = 0;
 
     for (;;)
     {
         /* GIL Lock */
-        thread_mutex_lock(&vm->gil);
+        thread_lock_lock(&vm->gil);
+
+        /* Other workers finished the job */
+        if (vm->workers_exit != 0) 
+        {
+            thread_lock_unlock(&vm->gil);
+            break;
+        }
+
+        /* No OS thread is busy in native code, nothing to take over */
+        if ((worker->spare != 0) && (vm->native_sections == 0))
+        {
+            thread_lock_unlock(&vm->gil);
+            virtual_machine_scheduler_spare_idle(vm);
+            continue;
+        }
 
         /* External Event */
         if ((virtual_machine_external_event_process(err, vm)) != 0)
@@ -872,31 +952,65 @@ static int virtual_machine_module_run_function(struct multiple_error *err, \
         if (vm_err_occurred(vm->r) != 0) 
         { goto fail_and_unlock_gil; }
 
-        if (vm->tp->state == VIRTUAL_MACHINE_THREAD_STATE_SUSPENDED)
+        /* Threads woken up by semaphores */
+        virtual_machine_semaphore_list_resume_woken(vm, vm->semaphores);
+
+        /* Current thread blocked, switch to a runnable one */
+        if ((vm->tp == NULL) || \
+                (vm->tp->state != VIRTUAL_MACHINE_THREAD_STATE_NORMAL) || \
+                (vm->tp->detached != 0))
         {
-            /* Skip suspended thread */
-            do_rest();
-            virtual_machine_next_thread(vm);
+            if (virtual_machine_next_thread(vm) == VIRTUAL_MACHINE_NEXT_THREAD_SLEEP)
+            {
+                /* Nothing to run, sleep until some thread 
+                 * becomes runnable or an external event raised */
+                thread_lock_unlock(&vm->gil);
+                if (worker->spare != 0) { virtual_machine_scheduler_spare_idle(vm); }
+                else { virtual_machine_scheduler_idle(vm); }
+                continue;
+            }
+            vm->step_in_time_slice = 0;
+            vm->yielded = 0;
         }
-        else if (vm->tp->state == VIRTUAL_MACHINE_THREAD_STATE_NORMAL)
+
+        /* Run till the end of time slice */
+        for (;;)
         {
             /* Debug Info */
             if (vm->debug_info != 0)
-            { virtual_machine_module_run_function_debug_info(err, vm, module, function_instrument_number, args_count); }
+            { 
+                virtual_machine_module_run_function_debug_info(err, vm, \
+                        worker->module, worker->function_instrument_number, worker->args_count); 
+            }
 
-            /* Execute an instrument */
-            if ((ret = virtual_machine_thread_step(err, vm)) != 0)
+            /* Execute an instrument, or a block cached */
+            if ((ret = ((vm->prof != NULL) ? \
+                            virtual_machine_prof_step(err, vm) : \
+                            (vm->block_cache != 0) ? \
+                            virtual_machine_block_cache_step(err, vm) : \
+                            virtual_machine_thread_step(err, vm))) != 0)
             { goto fail_and_unlock_gil; }
             if (vm_err_occurred(vm->r) != 0) 
             { goto fail_and_unlock_gil; }
 
+            /* Sample the running stacks when the timer asks */
+            if ((vm->sampler != NULL) && (vm->sampler->pending != 0))
+            {
+                if (virtual_machine_sampler_take(vm) != 0)
+                {
+                    VM_ERR_MALLOC(vm->r);
+                    ret = -MULTIPLE_ERR_VM;
+                    goto fail_and_unlock_gil;
+                }
+            }
+
             /* No living thread, exit */
             if (vm->tp == NULL) {
                 virtual_machine_garbage_collect(vm);
                 vm->tp = vm->threads->begin;
                 if (vm->tp == NULL) 
                 {
-                    thread_mutex_unlock(&vm->gil);
+                    finished = 1;
                     break;
                 }
             }
@@ -905,8 +1019,8 @@ static int virtual_machine_module_run_function(struct multiple_error *err, \
             {
                 thread_to_kill = vm->tp;
                 /* Next Thread */
-                if (virtual_machine_next_thread(vm) == VIRTUAL_MACHINE_NEXT_THREAD_SLEEP)
-                { do_rest(); }
+                virtual_machine_next_thread(vm);
+                if (vm->tp == thread_to_kill) { vm->tp = NULL; }
                 virtual_machine_thread_list_remove(vm, vm->threads, thread_to_kill);
                 if (vm->threads->size == 0)
                 {
@@ -918,32 +1032,50 @@ static int virtual_machine_module_run_function(struct multiple_error *err, \
                     }
                     else 
                     {
-                        thread_mutex_unlock(&vm->gil);
+                        finished = 1;
                         break; 
                     }
                 }
             }
 
+            /* Garbage Collection 
+             * (on its own interval, a short time slice should not make it more frequent, 
+             * or at once when the heap limit is approached) */
+            if ((vm->step_since_gc >= vm->gc_interval) || (vm->resource->heap_pressure != 0))
+            {
+                if ((vm->interrupt_enabled & VIRTUAL_MACHINE_IE_GC) != 0)
+                {
+                    virtual_machine_garbage_collect_and_feedback(vm); 
+                    if (vm_err_occurred(vm->r) != 0) 
+                    { goto fail_and_unlock_gil; }
+                }
+                vm->step_since_gc = 0;
+            }
+
             /* Locked */
             if (vm->locked != 0)
             {
                 /* Next Thread */
-                if (virtual_machine_next_thread(vm) == VIRTUAL_MACHINE_NEXT_THREAD_SLEEP)
-                { do_rest(); }
+                virtual_machine_next_thread(vm);
                 vm->locked = 0;
+                break;
             }
             /* Our of time slice */
-            else if (vm->step_in_time_slice >= vm->time_slice)
+            else if ((vm->yielded != 0) || \
+                    ((vm->tp != NULL) && (vm->step_in_time_slice >= vm->tp->time_slice)))
             {
+                /* CPU-bound, run longer next time */
+                if (vm->yielded == 0)
+                { virtual_machine_thread_time_slice_grow(vm, vm->tp); }
+                vm->yielded = 0;
+                /* A slice of the running incremental collection in between */
+                if ((vm->gc_stub->phase != GC_PHASE_IDLE) && \
+                        ((vm->interrupt_enabled & VIRTUAL_MACHINE_IE_GC) != 0))
+                { virtual_machine_garbage_collect_incremental(vm); }
                 /* Next Thread */
-                if (virtual_machine_next_thread(vm) == VIRTUAL_MACHINE_NEXT_THREAD_SLEEP)
-                { do_rest(); }
-                /* Garbage Collection */
-                if ((vm->interrupt_enabled & VIRTUAL_MACHINE_IE_GC) != 0)
-                {
-                    virtual_machine_garbage_collect_and_feedback(vm); 
-                }
+                virtual_machine_next_thread(vm);
                 vm->step_in_time_slice = 0;
+                break;
             }
             /* Running Stack Overflow */
             if ((vm->tp != NULL) && (vm->tp->running_stack->size > vm->stack_size))
@@ -961,18 +1093,115 @@ static int virtual_machine_module_run_function(struct multiple_error *err, \
                 ret = -VM_ERR_STACK_OVERFLOW;
                 goto fail_and_unlock_gil;
             }
+            /* Blocked */
+            if ((vm->tp == NULL) || (vm->tp->state != VIRTUAL_MACHINE_THREAD_STATE_NORMAL))
+            { break; }
+        }
+
+        if (finished != 0)
+        {
+            vm->workers_exit = 1;
+            thread_lock_unlock(&vm->gil);
+            break;
         }
 
         /* GIL Unlock */
-        thread_mutex_unlock(&vm->gil);
+        thread_lock_unlock(&vm->gil);
     }
 
     ret = 0;
     goto done;
 fail_and_unlock_gil:
-    thread_mutex_unlock(&vm->gil);
+    vm->workers_exit = 1;
+    thread_lock_unlock(&vm->gil);
+done:
+    /* Pass the exit on to the next sleeping workers */
+    thread_event_signal(&vm->idle_event);
+    thread_event_signal(&vm->spare_event);
+    return ret;
+}
+
+static void *virtual_machine_worker_routine(void *arg)
+{
+    struct virtual_machine_worker *worker = arg;
+
+    worker->ret = virtual_machine_worker_run(worker);
+
+    return NULL;
+}
+
+static int virtual_machine_module_run_function(struct multiple_error *err, \
+        struct virtual_machine *vm, \
+        struct virtual_machine_module *module, \
+        uint32_t function_instrument_number, \
+        size_t args_count) /* Arguments passed in */
+{
+    int ret = 0;
+    struct virtual_machine_module *init_module;
+    struct virtual_machine_worker *workers = NULL;
+    size_t workers_count = 0;
+    size_t idx;
+
+    init_module = module;
+
+    /* Create the initial thread */
+    if ((ret = virtual_machine_thread_list_append_with_configure(vm, vm->threads, \
+                    init_module, function_instrument_number, 
+                    args_count)) != 0)
+    { goto fail; }
+
+    /* Set the current thread pointer */
+    vm->tp = vm->threads->begin;
+
+    /* Workers */
+    if ((workers = (struct virtual_machine_worker *)malloc( \
+                    sizeof(struct virtual_machine_worker) * vm->workers_count)) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    vm->workers_exit = 0;
+    for (idx = 0; idx != vm->workers_count; idx++)
+    {
+        workers[idx].err = err;
+        workers[idx].vm = vm;
+        workers[idx].module = module;
+        workers[idx].function_instrument_number = function_instrument_number;
+        workers[idx].args_count = args_count;
+        workers[idx].spare = (idx != 0) ? 1 : 0;
+        workers[idx].ret = 0;
+    }
+
+    /* Marking helpers and the sweeper, if asked for */
+    if ((ret = virtual_machine_garbage_collect_helpers_start(vm)) != 0)
+    { goto fail; }
+
+    /* Timer of the sampler */
+    if (vm->sampler != NULL) virtual_machine_sampler_start(vm->sampler);
+
+    /* The current OS thread is the first worker */
+    for (workers_count = 1; workers_count < vm->workers_count; workers_count++)
+    {
+        if (thread_create(&workers[workers_count].handle, \
+                    virtual_machine_worker_routine, &workers[workers_count]) != 0)
+        { break; }
+    }
+    ret = virtual_machine_worker_run(&workers[0]);
+    for (idx = 1; idx < workers_count; idx++)
+    {
+        thread_join(&workers[idx].handle);
+        if (ret == 0) ret = workers[idx].ret;
+    }
+    virtual_machine_garbage_collect_helpers_stop(vm);
+    if (vm->sampler != NULL) virtual_machine_sampler_stop(vm->sampler);
+    if (ret != 0) { goto fail; }
+
+    ret = 0;
+    goto done;
 fail:
 done:
+    if (workers != NULL) free(workers);
     return ret;
 }
 
@@ -1332,6 +1561,34 @@ fail:
 done:
     if (vm != NULL)
     {
+        /* Statistics, before everything is collected */
+        if (vm->stats != 0) virtual_machine_stats_print(vm, stderr);
+        if ((vm->stats_json != NULL) && (virtual_machine_stats_write_json(vm, vm->stats_json) != 0))
+        {
+            if (ret == 0)
+            {
+                multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: can not write statistics to %s", vm->stats_json);
+                ret = -MULTIPLE_ERR_STUB;
+            }
+        }
+        if (vm->prof_print != 0) virtual_machine_prof_print(vm, stderr);
+        if ((vm->prof_json != NULL) && (virtual_machine_prof_write_json(vm, vm->prof_json) != 0))
+        {
+            if (ret == 0)
+            {
+                multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: can not write profile to %s", vm->prof_json);
+                ret = -MULTIPLE_ERR_STUB;
+            }
+        }
+        if ((vm->sample != NULL) && (virtual_machine_sampler_write(vm, vm->sample) != 0))
+        {
+            if (ret == 0)
+            {
+                multiple_error_update(err, -MULTIPLE_ERR_STUB, "error: can not write samples to %s", vm->sample);
+                ret = -MULTIPLE_ERR_STUB;
+            }
+        }
+
         /* Garbage Collection */
         virtual_machine_garbage_collect(vm);
 
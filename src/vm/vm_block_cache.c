@@ -0,0 +1,701 @@
+/* Virtual Machine : Template Block Cache
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include "selfcheck.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_object_aio.h"
+#include "vm_infrastructure.h"
+#include "vm_cpu.h"
+#include "vm_cpu_fused.h"
+#include "vm_block_cache.h"
+#include "vm_err.h"
+
+
+/* Templates */
+
+/* What the interpreter does before every instrument */
+static int virtual_machine_block_cache_op_prologue(struct virtual_machine *vm, \
+        struct virtual_machine_block_cache_op *op)
+{
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+
+    vm->step_in_time_slice += 1;
+    vm->step_since_gc += 1;
+
+    vm->r->opcode = op->opcode;
+    vm->r->operand = op->operand;
+    vm->r->pc = op->pc;
+    vm->r->module = current_frame->module;
+
+    if (virtual_machine_computing_stack_check(op->opcode, current_frame->computing_stack->size) != 0)
+    {
+        vm_err_update(vm->r, -VM_ERR_COMPUTING_STACK_EMPTY, \
+                "runtime error: computing stack empty");
+        return -MULTIPLE_ERR_VM;
+    }
+
+    return 0;
+}
+
+/* The thread left the frame, or something else has to run now */
+static int virtual_machine_block_cache_left(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread, \
+        struct virtual_machine_running_stack_frame *current_frame)
+{
+    if ((vm->tp != thread) || \
+            (thread->running_stack->top != current_frame) || \
+            (thread->state != VIRTUAL_MACHINE_THREAD_STATE_NORMAL) || \
+            (vm->locked != 0) || (vm->yielded != 0) || \
+            (vm->debug_mode != 0) || \
+            (vm_err_occurred(vm->r) != 0))
+    { return 1; }
+
+    return 0;
+}
+
+/* Any instrument, through the interpreter */
+static int virtual_machine_block_cache_op_generic(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    struct virtual_machine_thread *thread = vm->tp;
+    struct virtual_machine_running_stack_frame *current_frame = thread->running_stack->top;
+
+    if ((ret = virtual_machine_thread_step(err, vm)) != 0)
+    { return ret; }
+    if (op->last != 0) return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+
+    /* Anything other than going on to the next instrument
+     * leaves the block */
+    if ((virtual_machine_block_cache_left(vm, thread, current_frame) != 0) || \
+            (current_frame->pc != op->pc + op->length))
+    { return VIRTUAL_MACHINE_BLOCK_CACHE_EXIT; }
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+/* The instruments of an 'int' sequence through the interpreter, 
+ * for operands of other types and results out of the range */
+static int virtual_machine_block_cache_op_interpret(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    struct virtual_machine_thread *thread = vm->tp;
+    struct virtual_machine_running_stack_frame *current_frame = thread->running_stack->top;
+    uint32_t pc_prev;
+
+    vm->block_cache_stats.guards += 1;
+
+    do
+    {
+        pc_prev = current_frame->pc;
+        if ((ret = virtual_machine_thread_step(err, vm)) != 0)
+        { return ret; }
+        if (virtual_machine_block_cache_left(vm, thread, current_frame) != 0)
+        { return op->last != 0 ? VIRTUAL_MACHINE_BLOCK_CACHE_NEXT : VIRTUAL_MACHINE_BLOCK_CACHE_EXIT; }
+    } while ((current_frame->pc > pc_prev) && (current_frame->pc < op->pc + op->length));
+
+    /* Branches taken leave the block */
+    if ((op->last == 0) && (current_frame->pc != op->pc + op->length))
+    { return VIRTUAL_MACHINE_BLOCK_CACHE_EXIT; }
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+static int virtual_machine_block_cache_op_fused(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    int handled;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+
+    vm->r->opcode = op->opcode;
+    vm->r->operand = op->operand;
+    vm->r->pc = op->pc;
+    vm->r->module = current_frame->module;
+
+    if ((ret = virtual_machine_thread_step_fused(vm, op->fused, &handled)) != 0)
+    { return ret; }
+    if (handled == 0)
+    { return virtual_machine_block_cache_op_generic(err, vm, op); }
+    vm->step_in_time_slice += 1;
+    vm->step_since_gc += 1;
+
+    /* Branches taken leave the block */
+    if ((op->last == 0) && (current_frame->pc != op->pc + op->length))
+    { return VIRTUAL_MACHINE_BLOCK_CACHE_EXIT; }
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+static int virtual_machine_block_cache_op_nop(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+
+    (void)err;
+
+    if ((ret = virtual_machine_block_cache_op_prologue(vm, op)) != 0) return ret;
+
+    /* Update PC */
+    vm->tp->running_stack->top->pc++;
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+static int virtual_machine_block_cache_op_push(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+    struct virtual_machine_object *new_object;
+
+    (void)err;
+
+    if ((ret = virtual_machine_block_cache_op_prologue(vm, op)) != 0) return ret;
+
+    if ((new_object = virtual_machine_object_new_from_data_section_item(vm, op->item)) == NULL)
+    { VM_ERR_MALLOC(vm->r); return -MULTIPLE_ERR_VM; }
+    if ((ret = virtual_machine_computing_stack_push(current_frame->computing_stack, new_object)) != 0)
+    {
+        _virtual_machine_object_destroy(vm, new_object);
+        VM_ERR_INTERNAL(vm->r);
+        return -MULTIPLE_ERR_VM;
+    }
+
+    /* Update PC */
+    current_frame->pc++;
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+static int virtual_machine_block_cache_op_dup(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+    struct virtual_machine_computing_stack *current_computing_stack = current_frame->computing_stack;
+    struct virtual_machine_object *new_object;
+
+    (void)err;
+
+    if ((ret = virtual_machine_block_cache_op_prologue(vm, op)) != 0) return ret;
+    if (current_computing_stack->size == 0)
+    {
+        vm_err_update(vm->r, -VM_ERR_COMPUTING_STACK_EMPTY, \
+                "runtime error: computing stack empty");
+        return -MULTIPLE_ERR_VM;
+    }
+
+    if ((new_object = virtual_machine_object_clone(vm, current_computing_stack->top)) == NULL)
+    { VM_ERR_MALLOC(vm->r); return -MULTIPLE_ERR_VM; }
+    if ((ret = virtual_machine_computing_stack_push(current_computing_stack, new_object)) != 0)
+    {
+        _virtual_machine_object_destroy(vm, new_object);
+        return ret;
+    }
+
+    /* Update PC */
+    current_frame->pc++;
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+static int virtual_machine_block_cache_op_drop(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+
+    (void)err;
+
+    if ((ret = virtual_machine_block_cache_op_prologue(vm, op)) != 0) return ret;
+
+    if ((ret = virtual_machine_computing_stack_pop(vm, current_frame->computing_stack)) != 0)
+    { return ret; }
+
+    /* Update PC */
+    current_frame->pc++;
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+static int virtual_machine_block_cache_op_binary(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+    struct virtual_machine_computing_stack *current_computing_stack = current_frame->computing_stack;
+    struct virtual_machine_object *new_object = NULL;
+
+    (void)err;
+
+    if ((ret = virtual_machine_block_cache_op_prologue(vm, op)) != 0) return ret;
+    if (current_computing_stack->size < 2)
+    {
+        vm_err_update(vm->r, -VM_ERR_COMPUTING_STACK_EMPTY, \
+                "runtime error: computing stack empty");
+        return -MULTIPLE_ERR_VM;
+    }
+
+    if ((ret = virtual_machine_object_binary_operate(&new_object, \
+                    current_computing_stack->top->prev, current_computing_stack->top, \
+                    op->opcode, vm)) != 0)
+    { goto fail; }
+
+    /* Pop the top 2 elements */
+    if ((ret = virtual_machine_computing_stack_pop(vm, current_computing_stack)) != 0)
+    { goto fail; }
+    if ((ret = virtual_machine_computing_stack_pop(vm, current_computing_stack)) != 0)
+    { goto fail; }
+
+    /* Push the result object into computing stack */
+    if ((ret = virtual_machine_computing_stack_push(current_computing_stack, new_object)) != 0)
+    { goto fail; }
+    new_object = NULL;
+
+    /* Update PC */
+    current_frame->pc++;
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+fail:
+    if (new_object != NULL) _virtual_machine_object_destroy(vm, new_object);
+    return ret;
+}
+
+/* The value an operand 'item' pushes gives when solved, for an 'int' 
+ * or a local variable holding one, non-zero for anything else */
+static int virtual_machine_block_cache_int_operand(int64_t *value_out, \
+        struct virtual_machine_running_stack_frame *current_frame, \
+        const struct virtual_machine_data_section_item *item)
+{
+    struct virtual_machine_variable *var;
+
+    if (item->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT)
+    {
+        *value_out = (int64_t)(*((int *)item->ptr));
+        return 0;
+    }
+    if ((item->type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER) && \
+            (virtual_machine_variable_list_lookup(&var, current_frame->variables, \
+                                                  item->module->id, item->id) == LOOKUP_FOUND) && \
+            (var->ptr->type == OBJECT_TYPE_INT))
+    {
+        *value_out = virtual_machine_object_int_get_primitive_value(var->ptr);
+        return 0;
+    }
+
+    return -1;
+}
+
+/* An 'int' sequence on the values, the objects of the operands are 
+ * never made, nor the 'bool' of a comparison taken by the jump */
+static int virtual_machine_block_cache_op_int(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op)
+{
+    int ret;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+    struct virtual_machine_object *new_object;
+    int64_t value_left, value_right, value_result = 0;
+    int value = 0, compare = 1;
+
+    /* Guards */
+    if ((virtual_machine_block_cache_int_operand(&value_left, current_frame, op->item) != 0) || \
+            (virtual_machine_block_cache_int_operand(&value_right, current_frame, op->item_right) != 0))
+    { return virtual_machine_block_cache_op_interpret(err, vm, op); }
+
+    switch (op->opcode_int)
+    {
+        case OP_EQ: value = (value_left == value_right) ? 1 : 0; break;
+        case OP_NE: value = (value_left != value_right) ? 1 : 0; break;
+        case OP_L: value = (value_left < value_right) ? 1 : 0; break;
+        case OP_G: value = (value_left > value_right) ? 1 : 0; break;
+        case OP_LE: value = (value_left <= value_right) ? 1 : 0; break;
+        case OP_GE: value = (value_left >= value_right) ? 1 : 0; break;
+        default:
+            /* The interpreter promotes the overflowed ones to 'bigint' */
+            if (virtual_machine_object_int_arithmetic_value(&value_result, \
+                        value_left, value_right, op->opcode_int) != 0)
+            { return virtual_machine_block_cache_op_interpret(err, vm, op); }
+            compare = 0;
+            break;
+    }
+
+    vm->step_in_time_slice += (size_t)op->length;
+    vm->step_since_gc += (size_t)op->length;
+    vm->block_cache_stats.unboxed += 1;
+
+    if (op->jump != 0)
+    {
+        /* Update PC, as the jump instrument does */
+        current_frame->pc = (value != 0) ? op->target : op->pc + op->length;
+
+        /* Branches taken leave the block */
+        if ((op->last == 0) && (current_frame->pc != op->pc + op->length))
+        { return VIRTUAL_MACHINE_BLOCK_CACHE_EXIT; }
+        return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+    }
+
+    vm->r->opcode = op->opcode_int;
+    vm->r->operand = 0;
+    vm->r->pc = op->pc + 2;
+    vm->r->module = current_frame->module;
+
+    if (compare != 0)
+    { new_object = virtual_machine_object_bool_new_with_value(vm, TO_BOOL_VALUE(value)); }
+    else
+    { new_object = virtual_machine_object_int_new_with_value(vm, value_result); }
+    if (new_object == NULL)
+    { VM_ERR_MALLOC(vm->r); return -MULTIPLE_ERR_VM; }
+    if ((ret = virtual_machine_computing_stack_push(current_frame->computing_stack, new_object)) != 0)
+    {
+        _virtual_machine_object_destroy(vm, new_object);
+        VM_ERR_INTERNAL(vm->r);
+        return -MULTIPLE_ERR_VM;
+    }
+
+    /* Update PC */
+    current_frame->pc += op->length;
+
+    return VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+}
+
+static virtual_machine_block_cache_template_t virtual_machine_block_cache_template(uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case OP_NOP:
+        case OP_DEF:
+            return virtual_machine_block_cache_op_nop;
+        case OP_PUSH:
+        case OP_PUSHG:
+        case OP_PUSHM:
+            return virtual_machine_block_cache_op_push;
+        case OP_DUP:
+            return virtual_machine_block_cache_op_dup;
+        case OP_DROP:
+            return virtual_machine_block_cache_op_drop;
+        case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: case OP_MOD:
+        case OP_LSHIFT: case OP_RSHIFT:
+        case OP_ANDA: case OP_ORA: case OP_XORA:
+        case OP_ANDL: case OP_ORL: case OP_XORL:
+        case OP_EQ: case OP_NE:
+        case OP_L: case OP_G: case OP_LE: case OP_GE:
+            return virtual_machine_block_cache_op_binary;
+        default:
+            return virtual_machine_block_cache_op_generic;
+    }
+}
+
+/* Never goes on to the next instrument */
+static int virtual_machine_block_cache_is_terminator(uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case OP_JMP:
+        case OP_JMPR:
+        case OP_RETURN:
+        case OP_RETNONE:
+        case OP_HALT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+
+/* Blocks */
+
+/* Instruments in the 'int' sequence at 'idx', 0 for none, 
+ * and the fields of 'op' for it if given */
+static uint32_t virtual_machine_block_cache_int_sequence(struct virtual_machine_block_cache_op *op, \
+        struct virtual_machine_module *module, size_t idx)
+{
+    struct virtual_machine_text_section *text_section = module->text_section;
+    struct virtual_machine_text_section_instrument *instrument = text_section->instruments + idx;
+    struct virtual_machine_data_section_item *item_left, *item_right;
+    int jump;
+
+    if ((idx + 3 > text_section->size) || \
+            (instrument[0].opcode != OP_PUSH) || (instrument[1].opcode != OP_PUSH))
+    { return 0; }
+    item_left = module->data_section->items + instrument[0].data_id;
+    item_right = module->data_section->items + instrument[1].data_id;
+    if (((item_left->type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT) && \
+                (item_left->type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER)) || \
+            ((item_right->type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_INT) && \
+             (item_right->type != MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER)))
+    { return 0; }
+
+    switch (instrument[2].opcode)
+    {
+        case OP_ADD: case OP_SUB: case OP_MUL:
+        case OP_ANDA: case OP_ORA: case OP_XORA:
+            jump = 0;
+            break;
+        case OP_EQ: case OP_NE:
+        case OP_L: case OP_G: case OP_LE: case OP_GE:
+            jump = ((idx + 4 <= text_section->size) && \
+                    ((instrument[3].opcode == OP_JMPC) || (instrument[3].opcode == OP_JMPCR))) ? 1 : 0;
+            break;
+        default:
+            return 0;
+    }
+
+    if (op != NULL)
+    {
+        op->item = item_left;
+        op->item_right = item_right;
+        op->opcode_int = instrument[2].opcode;
+        op->jump = jump;
+        op->target = (jump != 0) ? \
+                     (uint32_t)virtual_machine_text_section_target(text_section, idx + 3) : 0;
+    }
+
+    return jump != 0 ? 4 : 3;
+}
+
+/* Instruments covered by the op at 'idx' */
+static uint32_t virtual_machine_block_cache_op_length(struct virtual_machine_module *module, size_t idx)
+{
+    uint32_t length;
+
+    if ((length = virtual_machine_block_cache_int_sequence(NULL, module, idx)) != 0) return length;
+
+    return virtual_machine_fused_length(module->text_section->instruments[idx].fused);
+}
+
+static int virtual_machine_block_cache_block_destroy(struct virtual_machine *vm, \
+        struct virtual_machine_block_cache_block *block)
+{
+    if (block->ops != NULL) virtual_machine_resource_free(vm->resource, block->ops);
+    virtual_machine_resource_free(vm->resource, block);
+
+    return 0;
+}
+
+/* NULL for nothing worth decoding */
+static struct virtual_machine_block_cache_block *virtual_machine_block_cache_block_new(struct virtual_machine *vm, \
+        struct virtual_machine_module *module, uint32_t pc)
+{
+    struct virtual_machine_block_cache_block *new_block = NULL;
+    struct virtual_machine_text_section *text_section = module->text_section;
+    struct virtual_machine_text_section_instrument *instrument;
+    struct virtual_machine_block_cache_op *op;
+    size_t idx, size = 0;
+    uint32_t length;
+
+    /* Ops till the end of the block */
+    idx = (size_t)pc;
+    while ((idx < text_section->size) && (size != VIRTUAL_MACHINE_BLOCK_CACHE_BLOCK_LEN_MAX))
+    {
+        instrument = text_section->instruments + idx;
+        size++;
+        if (virtual_machine_block_cache_is_terminator(instrument->opcode) != 0) break;
+        idx += (size_t)virtual_machine_block_cache_op_length(module, idx);
+    }
+    if (size < 2) return NULL;
+
+    if ((new_block = (struct virtual_machine_block_cache_block *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_block_cache_block))) == NULL)
+    { goto fail; }
+    new_block->ops = NULL;
+    new_block->size = size;
+    if ((new_block->ops = (struct virtual_machine_block_cache_op *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_block_cache_op) * size)) == NULL)
+    { goto fail; }
+
+    idx = (size_t)pc;
+    for (op = new_block->ops; op != new_block->ops + size; op++)
+    {
+        instrument = text_section->instruments + idx;
+        op->pc = (uint32_t)idx;
+        op->opcode = instrument->opcode;
+        op->operand = instrument->operand;
+        op->fused = instrument->fused;
+        op->length = virtual_machine_fused_length(instrument->fused);
+        op->item = NULL;
+        op->item_right = NULL;
+        op->opcode_int = OP_NOP;
+        op->jump = 0;
+        op->target = 0;
+        op->last = 0;
+        if ((length = virtual_machine_block_cache_int_sequence(op, module, idx)) != 0)
+        {
+            op->template_func = virtual_machine_block_cache_op_int;
+            op->length = length;
+        }
+        else if (instrument->fused != OP_FUSED_NONE)
+        {
+            op->template_func = virtual_machine_block_cache_op_fused;
+        }
+        else
+        {
+            op->template_func = virtual_machine_block_cache_template(instrument->opcode);
+            if (op->template_func == virtual_machine_block_cache_op_push)
+            { op->item = module->data_section->items + instrument->data_id; }
+        }
+        idx += (size_t)op->length;
+    }
+    new_block->ops[size - 1].last = 1;
+
+    vm->block_cache_stats.blocks += 1;
+    vm->block_cache_stats.instruments += idx - (size_t)pc;
+
+    goto done;
+fail:
+    if (new_block != NULL)
+    {
+        virtual_machine_block_cache_block_destroy(vm, new_block);
+        new_block = NULL;
+    }
+done:
+    return new_block;
+}
+
+static int virtual_machine_block_cache_block_run(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_block *block)
+{
+    int ret = VIRTUAL_MACHINE_BLOCK_CACHE_NEXT;
+    size_t idx;
+
+    vm->block_cache_stats.runs += 1;
+
+    for (idx = 0; idx != block->size; idx++)
+    {
+        ret = block->ops[idx].template_func(err, vm, block->ops + idx);
+        if (ret != VIRTUAL_MACHINE_BLOCK_CACHE_NEXT) break;
+    }
+
+    if (ret < 0) return ret;
+    if (ret == VIRTUAL_MACHINE_BLOCK_CACHE_EXIT) vm->block_cache_stats.exits += 1;
+
+    return 0;
+}
+
+
+/* Sections */
+
+static struct virtual_machine_block_cache_section *virtual_machine_block_cache_section_new(struct virtual_machine *vm, \
+        size_t size)
+{
+    struct virtual_machine_block_cache_section *new_cache_section = NULL;
+    size_t idx;
+
+    if ((new_cache_section = (struct virtual_machine_block_cache_section *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_block_cache_section))) == NULL)
+    { goto fail; }
+    new_cache_section->size = size;
+    new_cache_section->blocks = NULL;
+    if ((new_cache_section->counters = (size_t *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(size_t) * size)) == NULL)
+    { goto fail; }
+    if ((new_cache_section->blocks = (struct virtual_machine_block_cache_block **)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_block_cache_block *) * size)) == NULL)
+    { goto fail; }
+    for (idx = 0; idx != size; idx++)
+    {
+        new_cache_section->counters[idx] = 0;
+        new_cache_section->blocks[idx] = NULL;
+    }
+
+    goto done;
+fail:
+    if (new_cache_section != NULL)
+    {
+        if (new_cache_section->counters != NULL) virtual_machine_resource_free(vm->resource, new_cache_section->counters);
+        virtual_machine_resource_free(vm->resource, new_cache_section);
+        new_cache_section = NULL;
+    }
+done:
+    return new_cache_section;
+}
+
+int virtual_machine_block_cache_section_destroy(struct virtual_machine *vm, \
+        struct virtual_machine_block_cache_section *cache_section)
+{
+    size_t idx;
+
+    for (idx = 0; idx != cache_section->size; idx++)
+    {
+        if (cache_section->blocks[idx] != NULL)
+        { virtual_machine_block_cache_block_destroy(vm, cache_section->blocks[idx]); }
+    }
+    virtual_machine_resource_free(vm->resource, cache_section->blocks);
+    virtual_machine_resource_free(vm->resource, cache_section->counters);
+    virtual_machine_resource_free(vm->resource, cache_section);
+
+    return 0;
+}
+
+
+/* Stepping */
+
+int virtual_machine_block_cache_step(struct multiple_error *err, struct virtual_machine *vm)
+{
+    struct virtual_machine_running_stack_frame *current_frame;
+    struct virtual_machine_text_section *text_section;
+    struct virtual_machine_block_cache_section *cache_section;
+    struct virtual_machine_block_cache_block *block;
+    size_t pc;
+
+    /* The interpreter takes the rest */
+    if ((vm->tp == NULL) || (vm->debug_mode != 0) || (vm->debug_info != 0))
+    { return virtual_machine_thread_step(err, vm); }
+    if ((current_frame = vm->tp->running_stack->top) == NULL)
+    { return virtual_machine_thread_step(err, vm); }
+    text_section = current_frame->module->text_section;
+    pc = (size_t)current_frame->pc;
+    if (pc >= text_section->size)
+    { return virtual_machine_thread_step(err, vm); }
+
+    if ((cache_section = text_section->block_cache) == NULL)
+    {
+        /* Interpreting only when failed */
+        if ((cache_section = virtual_machine_block_cache_section_new(vm, text_section->size)) == NULL)
+        { return virtual_machine_thread_step(err, vm); }
+        text_section->block_cache = cache_section;
+    }
+
+    if ((block = cache_section->blocks[pc]) == NULL)
+    {
+        /* Decoded once, blocks not worth decoding are never retried */
+        if (cache_section->counters[pc] < vm->block_cache)
+        {
+            cache_section->counters[pc] += 1;
+            if (cache_section->counters[pc] == vm->block_cache)
+            {
+                block = virtual_machine_block_cache_block_new(vm, current_frame->module, (uint32_t)pc);
+                cache_section->blocks[pc] = block;
+            }
+        }
+        if (block == NULL)
+        { return virtual_machine_thread_step(err, vm); }
+    }
+
+    return virtual_machine_block_cache_block_run(err, vm, block);
+}
+
@@ -0,0 +1,93 @@
+/* Virtual Machine : Template Block Cache
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef _VM_BLOCK_CACHE_H_
+#define _VM_BLOCK_CACHE_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+#include "vm_infrastructure.h"
+
+/* Hot blocks of instruments decoded into arrays of templates, the C
+ * functions doing each instrument, run one after another without the
+ * dispatch of the interpreter. No native code is generated, 'int'
+ * arithmetic and comparisons are done on the values when the operands
+ * allow it and left to the interpreter otherwise. */
+
+/* A block is the run of instruments from where it is entered,
+ * to an unconditional jump, a return or the maximum length */
+#define VIRTUAL_MACHINE_BLOCK_CACHE_BLOCK_LEN_MAX 256
+
+/* Results of the templates, errors are negative */
+#define VIRTUAL_MACHINE_BLOCK_CACHE_NEXT 0
+#define VIRTUAL_MACHINE_BLOCK_CACHE_EXIT 1
+
+struct virtual_machine_block_cache_op;
+typedef int (*virtual_machine_block_cache_template_t)(struct multiple_error *err, \
+        struct virtual_machine *vm, struct virtual_machine_block_cache_op *op);
+
+/* An instrument (or a superinstrument) decoded */
+struct virtual_machine_block_cache_op
+{
+    virtual_machine_block_cache_template_t template_func;
+
+    uint32_t pc;
+    uint32_t opcode;
+    uint32_t operand;
+    uint32_t fused;
+    uint32_t length; /* instruments covered */
+    struct virtual_machine_data_section_item *item;
+
+    /* 'push', 'push', an arithmetic or a comparison of 'int's,
+     * with the conditional jump after the comparison if any */
+    struct virtual_machine_data_section_item *item_right;
+    uint32_t opcode_int;
+    int jump;
+    uint32_t target;
+
+    int last;
+};
+
+struct virtual_machine_block_cache_block
+{
+    struct virtual_machine_block_cache_op *ops;
+    size_t size;
+};
+
+struct virtual_machine_block_cache_section
+{
+    size_t *counters;
+    struct virtual_machine_block_cache_block **blocks;
+    size_t size;
+};
+
+int virtual_machine_block_cache_section_destroy(struct virtual_machine *vm, \
+        struct virtual_machine_block_cache_section *cache_section);
+
+/* Execute the current thread as virtual_machine_thread_step() does,
+ * through the block starting at the pc if there is one. Blocks are
+ * decoded on the 'vm->block_cache'th entry and left at anything other
+ * than going on to the next instrument, the frames stay as the
+ * interpreter keeps them for continuations, generators and the debugger. */
+int virtual_machine_block_cache_step(struct multiple_error *err, struct virtual_machine *vm);
+
+#endif
+
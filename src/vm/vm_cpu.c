@@ -40,6 +40,7 @@
 #include "vm_cpu_func.h"
 #include "vm_cpu_int.h"
 #include "vm_cpu_class.h"
+#include "vm_cpu_fused.h"
 
 #include "vm_err.h"
 
@@ -257,7 +258,8 @@ int virtual_machine_thread_step(struct multiple_error *err, struct virtual_machi
     int ret = 0;
 
     struct virtual_machine_thread *thread;
-    uint32_t opcode, operand, data_id;
+    uint32_t opcode, operand, data_id, fused;
+    int fused_handled;
 
     struct virtual_machine_running_stack *current_running_stack;
     struct virtual_machine_running_stack_frame *current_frame;
@@ -312,11 +314,13 @@ int virtual_machine_thread_step(struct multiple_error *err, struct virtual_machi
 
     /* Record step */
     vm->step_in_time_slice += 1;
+    vm->step_since_gc += 1;
 
     /* Fetch instrument */
     opcode = vm->tp->running_stack->top->module->text_section->instruments[(size_t)current_frame->pc].opcode;
     operand = vm->tp->running_stack->top->module->text_section->instruments[(size_t)current_frame->pc].operand;
     data_id = vm->tp->running_stack->top->module->text_section->instruments[(size_t)current_frame->pc].data_id;
+    fused = vm->tp->running_stack->top->module->text_section->instruments[(size_t)current_frame->pc].fused;
 
     /* Error passing */
     vm->r->opcode = opcode;
@@ -324,6 +328,14 @@ int virtual_machine_thread_step(struct multiple_error *err, struct virtual_machi
     vm->r->pc = current_frame->pc;
     vm->r->module = current_module;
 
+    /* Superinstrument, not while debugging or profiling instrument by instrument */
+    if ((fused != OP_FUSED_NONE) && (vm->debug_mode == 0) && (vm->debug_info == 0) && (vm->prof == NULL))
+    {
+        if ((ret = virtual_machine_thread_step_fused(vm, fused, &fused_handled)) != 0)
+        { goto fail; }
+        if (fused_handled != 0) { goto done; }
+    }
+
     /* Checking Computing Stack */
     if (virtual_machine_computing_stack_check(opcode, current_frame->computing_stack->size) != 0)
     {
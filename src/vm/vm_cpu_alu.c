@@ -383,11 +383,13 @@ int virtual_machine_thread_step_alu(struct virtual_machine *vm)
                 ret = -MULTIPLE_ERR_VM;
                 goto fail; 
             }
-            /* Extract argument count */
-            args_count = (size_t)virtual_machine_object_int_get_primitive_value(object_solved);
+            /* Extract argument count, no more than the items under it */
+            ret = virtual_machine_object_int_get_count(vm, &args_count, \
+                    object_solved, current_computing_stack->size - 1);
             /* Release solved argument count object */
             virtual_machine_object_destroy(vm, object_solved);
             object_solved = NULL;
+            if (ret != 0) { goto fail; }
             /* Pop the argument count object */
             ret = virtual_machine_computing_stack_pop(vm, current_computing_stack);
             if (ret != 0) { goto fail; }
@@ -478,11 +480,13 @@ int virtual_machine_thread_step_alu(struct virtual_machine *vm)
                 ret = -MULTIPLE_ERR_VM;
                 goto fail; 
             }
-            /* Extract argument count */
-            args_count = (size_t)virtual_machine_object_int_get_primitive_value(object_solved);
+            /* Extract argument count, no more than the items under it */
+            ret = virtual_machine_object_int_get_count(vm, &args_count, \
+                    object_solved, current_computing_stack->size - 1);
             /* Release solved argument count object */
             virtual_machine_object_destroy(vm, object_solved);
             object_solved = NULL;
+            if (ret != 0) { goto fail; }
             /* Pop the argument count object */
             ret = virtual_machine_computing_stack_pop(vm, current_computing_stack);
             if (ret != 0) { goto fail; }
@@ -331,7 +331,7 @@ int virtual_machine_thread_step_class(struct virtual_machine *vm)
                 ret = -MULTIPLE_ERR_VM;
                 goto fail;
             }
-            args_count = ((struct virtual_machine_object_int *)(current_computing_stack->top->prev->prev->ptr))->value;
+            args_count = virtual_machine_object_int_get_primitive_value_saturated(current_computing_stack->top->prev->prev);
             if (args_count < 0)
             {
                 vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
@@ -214,6 +214,12 @@ int virtual_machine_thread_step_composite_ds(struct virtual_machine *vm)
                 case OP_ARRCDR:
                     ret = virtual_machine_object_array_cdr(vm, &new_object, object_solved);
                     break;
+                case OP_TUPCAR:
+                    ret = virtual_machine_object_tuple_car(vm, &new_object, object_solved);
+                    break;
+                case OP_TUPCDR:
+                    ret = virtual_machine_object_tuple_cdr(vm, &new_object, object_solved);
+                    break;
             }
             if (ret != 0) { goto fail; }
 
@@ -276,6 +282,13 @@ int virtual_machine_thread_step_composite_ds(struct virtual_machine *vm)
                                     current_computing_stack->top->prev)) != 0)
                     { goto fail; }
                     break;
+                case OBJECT_TYPE_BUFFER:
+                    if ((ret = virtual_machine_object_buffer_ref_get(vm, \
+                                    &new_object, \
+                                    object_solved, \
+                                    current_computing_stack->top->prev)) != 0)
+                    { goto fail; }
+                    break;
                 default:
                     vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
                             "runtime error: invalid operand, composite type expected");
@@ -345,6 +358,13 @@ int virtual_machine_thread_step_composite_ds(struct virtual_machine *vm)
                                     current_computing_stack->top->prev->prev)) != 0)
                     { goto fail; }
                     break;
+                case OBJECT_TYPE_BUFFER:
+                    if ((ret = virtual_machine_object_buffer_ref_set(vm, \
+                                    object_solved, \
+                                    current_computing_stack->top->prev, \
+                                    current_computing_stack->top->prev->prev)) != 0)
+                    { goto fail; }
+                    break;
                 default:
                     vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
                             "runtime error: invalid operand, composite type expected");
@@ -361,8 +381,10 @@ int virtual_machine_thread_step_composite_ds(struct virtual_machine *vm)
             ret = virtual_machine_computing_stack_pop(vm, current_computing_stack);
             if (ret != 0) { goto fail; }
 
-            /* Push the result object into computing stack */
-            ret = virtual_machine_computing_stack_push(current_computing_stack, object_solved);
+            /* Push the result object into computing stack, 
+             * a tuple set is another one than the source */
+            if (new_object == NULL) { new_object = object_solved; object_solved = NULL; }
+            ret = virtual_machine_computing_stack_push(current_computing_stack, new_object);
             if (ret != 0) { goto fail; }
             new_object = NULL;
 
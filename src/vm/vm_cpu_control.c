@@ -136,9 +136,13 @@ int virtual_machine_thread_step_control(struct virtual_machine *vm)
                     current_frame->pc += 1;
                     current_running_stack->top = current_frame->prev;
                     current_frame->next = current_frame->prev = NULL;
-                    if ((ret = virtual_machine_running_stack_frame_list_append(previous_frame->generators, current_frame)) != 0)
+                    if ((ret = virtual_machine_running_stack_frame_list_append_generator(vm, \
+                                    previous_frame->generators, current_frame)) != 0)
                     {
-                        VM_ERR_INTERNAL(vm->r);
+                        /* Put it back */
+                        current_frame->prev = previous_frame;
+                        current_running_stack->top = current_frame;
+                        VM_ERR_MALLOC(vm->r);
                         ret = -MULTIPLE_ERR_VM;
                         goto fail; 
                     }
@@ -341,7 +345,10 @@ int virtual_machine_thread_step_control(struct virtual_machine *vm)
                 ret = -MULTIPLE_ERR_VM;
                 goto fail;
             }
-            args_count = (size_t)virtual_machine_object_int_get_primitive_value(current_computing_stack->top->prev);
+            /* No more than the items under the function and the count */
+            if ((ret = virtual_machine_object_int_get_count(vm, &args_count, \
+                            current_computing_stack->top->prev, current_computing_stack->size - 2)) != 0)
+            { goto fail; }
 
             /* Pop the function name and arguments count */
             ret = virtual_machine_computing_stack_pop(vm, current_computing_stack); /* Function */
@@ -363,6 +370,7 @@ int virtual_machine_thread_step_control(struct virtual_machine *vm)
                 extern_func_args->vm = vm;
                 /* Execute function */
                 func_ret_code = (*extern_func)(extern_func_args);
+                virtual_machine_thread_unpin(vm, current_thread);
                 if (vm_err_occurred(vm->r)) { goto fail; }
 
                 /* Return Value */
@@ -433,24 +441,13 @@ int virtual_machine_thread_step_control(struct virtual_machine *vm)
                 else
                 {
                     /* Pick generator out and push onto stack */
-                    if (generator_frame->prev != NULL)
-                    {
-                        generator_frame->prev->next = generator_frame->next;
-                    }
-                    else
-                    {
-                        current_frame->generators->begin = generator_frame->next;
-                    }
-                    if (generator_frame->next != NULL)
-                    {
-                        generator_frame->next->prev = generator_frame->prev;
-                    }
-                    else
+                    if ((ret = virtual_machine_running_stack_frame_list_remove_generator( \
+                                    current_frame->generators, generator_frame)) != 0)
                     {
-                        current_frame->generators->end = generator_frame->prev;
+                        VM_ERR_INTERNAL(vm->r);
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail;
                     }
-                    current_frame->generators->size -= 1;
-                    generator_frame->next = generator_frame->prev = NULL;
 
                     /* Reset argument count */
                     generator_frame->args_count = args_count;
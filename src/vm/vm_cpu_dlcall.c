@@ -130,6 +130,7 @@ int virtual_machine_thread_step_dlcall(struct virtual_machine *vm)
 
             /* Invoke external function */
             ret = virtual_machine_dynlib_invoke(vm, function_args, name_lib, name_func);
+            virtual_machine_thread_unpin(vm, current_thread);
             if (ret != 0) { goto fail; }
 
             /* Return Value */
@@ -42,13 +42,25 @@
 #define ABS(x) ((x)>0?(x):(-(x)))
 #endif
 
+/* Square root of a perfect square, otherwise -1 */
+static int64_t fastlib_int_sqrt_exact(const uint64_t value)
+{
+    uint64_t root = (uint64_t)umath_double_sqrt((double)value);
+
+    /* Correct the rounding of double */
+    while (root * root > value) root--;
+    while ((root + 1) * (root + 1) <= value) root++;
+
+    return root * root == value ? (int64_t)root : -1;
+}
+
 static int fastlib_putchar(struct virtual_machine *vm, \
         struct virtual_machine_running_stack_frame *target_frame, \
         struct virtual_machine_object *object_src)
 {
     int ret = 0;
     struct virtual_machine_object *object_src_solved = NULL;
-    int value_int;
+    int64_t value_int;
 
     if ((ret = virtual_machine_variable_solve(&object_src_solved, object_src, target_frame, 1, vm)) != 0)
     { goto fail; }
@@ -56,7 +68,7 @@ static int fastlib_putchar(struct virtual_machine *vm, \
     if (object_src_solved->type == OBJECT_TYPE_INT)
     {
         value_int = virtual_machine_object_int_get_primitive_value(object_src_solved);
-        putchar(value_int);
+        putchar((int)value_int);
     }
 
 fail:
@@ -97,7 +109,7 @@ static int fastlib_abs(struct virtual_machine *vm, \
 {
     int ret = 0;
     struct virtual_machine_object *object_src_solved = NULL;
-    int value_int;
+    int64_t value_int;
     double value_float;
 
     *object_dst = NULL;
@@ -108,7 +120,14 @@ static int fastlib_abs(struct virtual_machine *vm, \
     if (object_src_solved->type == OBJECT_TYPE_INT)
     {
         value_int = virtual_machine_object_int_get_primitive_value(object_src_solved);
-        value_int = umath_int_abs(value_int);
+        if (value_int == INT64_MIN)
+        {
+            /* Out of 'int' */
+            ret = virtual_machine_object_bigint_unary(vm, object_dst, object_src_solved, OP_NEG);
+            virtual_machine_object_destroy(vm, object_src_solved);
+            return ret;
+        }
+        value_int = value_int < 0 ? -value_int : value_int;
         virtual_machine_object_int_set_primitive_value(object_src_solved, value_int);
     }
     else if (object_src_solved->type == OBJECT_TYPE_FLOAT)
@@ -138,7 +157,7 @@ static int fastlib_sqrt(struct virtual_machine *vm, \
     int ret = 0;
     struct virtual_machine_object *object_src_solved = NULL;
     struct virtual_machine_object *new_object = NULL;
-    int value_int, value_int_result;
+    int64_t value_int, value_int_result;
     double value_float, value_float_result;
 
     *object_dst = NULL;
@@ -152,8 +171,8 @@ static int fastlib_sqrt(struct virtual_machine *vm, \
         if (value_int >= 0)
         {
             value_float_result = umath_double_sqrt((double)value_int);
-            value_int_result = umath_int_sqrt(value_int);
-            if (ABS((double)value_int_result - value_float_result) < DBL_EPSILON)
+            value_int_result = fastlib_int_sqrt_exact((uint64_t)value_int);
+            if (value_int_result >= 0)
             {
                 /* Integer */
                 virtual_machine_object_int_set_primitive_value(object_src_solved, value_int_result);
@@ -171,13 +190,13 @@ static int fastlib_sqrt(struct virtual_machine *vm, \
         else
         {
             value_float_result = umath_double_sqrt(-(double)value_int);
-            value_int_result = umath_int_sqrt(-value_int);
-            if (ABS((double)value_int_result - value_float_result) < DBL_EPSILON)
+            value_int_result = fastlib_int_sqrt_exact((uint64_t)0 - (uint64_t)value_int);
+            if (value_int_result >= 0)
             {
                 /* Rational in Image Part */
                 if ((new_object = virtual_machine_object_complex_new_with_rr(vm, \
                                 0, 0, 1, \
-                                0, (unsigned int)value_int_result, 1)) == NULL)
+                                0, (uint64_t)value_int_result, 1)) == NULL)
                 { goto fail; }
                 *object_dst = new_object; new_object = NULL;
             }
@@ -234,7 +253,7 @@ static int fastlib_exp(struct virtual_machine *vm, \
     int ret = 0;
     struct virtual_machine_object *object_src_solved = NULL;
     struct virtual_machine_object *new_object = NULL;
-    int value_int;
+    int64_t value_int;
     double value_float, value_float_result;
 
     *object_dst = NULL;
@@ -279,7 +298,7 @@ static int fastlib_log(struct virtual_machine *vm, \
     int ret = 0;
     struct virtual_machine_object *object_src_solved = NULL;
     struct virtual_machine_object *new_object = NULL;
-    int value_int;
+    int64_t value_int;
     double value_float, value_float_result;
 
     *object_dst = NULL;
@@ -325,7 +344,7 @@ static int fastlib_triangle(struct virtual_machine *vm, \
     int ret = 0;
     struct virtual_machine_object *object_src_solved = NULL;
     struct virtual_machine_object *new_object = NULL;
-    int value_int;
+    int64_t value_int;
     double value_float, value_float_result = 0.0;
 
     *object_dst = NULL;
@@ -412,7 +431,10 @@ static int fastlib_case_cast(struct virtual_machine *vm, \
 {
     int ret = 0;
     struct virtual_machine_object *object_src_solved = NULL;
+    struct virtual_machine_object *new_object = NULL;
     uint32_t value, value_out = 0;
+    char *str, *new_str = NULL;
+    size_t str_len, new_str_len = 0;
 
     *object_dst = NULL;
 
@@ -445,6 +467,41 @@ static int fastlib_case_cast(struct virtual_machine *vm, \
         }
         virtual_machine_object_char_set_primitive_value(object_src_solved, value_out);
     }
+    else if (object_src_solved->type == OBJECT_TYPE_STR)
+    {
+        virtual_machine_object_str_extract(&str, &str_len, object_src_solved);
+        if ((new_str = (char *)virtual_machine_resource_malloc(vm->resource, \
+                        sizeof(char) * VM_CPU_FASTLIB_CASE_STR_LEN_MAX(str_len))) == NULL)
+        {
+            VM_ERR_MALLOC(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+        switch (opcode)
+        {
+            case OP_FASTLIB_UPCASE:
+                ret = vm_cpu_fastlib_case_upcase_str(new_str, &new_str_len, str, str_len);
+                break;
+            case OP_FASTLIB_DOWNCASE:
+                ret = vm_cpu_fastlib_case_downcase_str(new_str, &new_str_len, str, str_len);
+                break;
+        }
+        if (ret != 0)
+        {
+            vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                    "runtime error: convert failed");
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+        if ((new_object = virtual_machine_object_str_new_with_value(vm, new_str, new_str_len)) == NULL)
+        {
+            VM_ERR_MALLOC(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+        virtual_machine_object_destroy(vm, object_src_solved);
+        object_src_solved = new_object; new_object = NULL;
+    }
     else
     {
         vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
@@ -455,6 +512,338 @@ static int fastlib_case_cast(struct virtual_machine *vm, \
 
     *object_dst = object_src_solved;
 fail:
+    if (new_str != NULL) virtual_machine_resource_free(vm->resource, new_str);
+    return ret;
+}
+
+/* Buffer 
+ * Arguments are on the computing stack with the first one on the top, 
+ * in the way of 'refget' and 'refset': 
+ *   buffer_new      size                          -> buffer 
+ *   buffer_get      buffer offset format          -> int or float 
+ *   buffer_set      buffer offset format value    -> (nothing) 
+ *   buffer_slice    buffer offset length          -> buffer 
+ *   buffer_find     buffer needle from            -> offset, -1 for not found 
+ *   buffer_compare  buffer buffer                 -> -1, 0 or 1 
+ * 'format' is a string of an optional byte order ('<' for little endian, 
+ * the default, or '>' for big endian) and a type: 'b', 'h', 'i', 'q' for 
+ * signed integers of 1, 2, 4 and 8 bytes, 'B', 'H', 'I', 'Q' for unsigned 
+ * ones, 'f' and 'd' for floats of 4 and 8 bytes. Integers are truncated 
+ * to the width when stored */
+
+#define FASTLIB_BUFFER_ARGC_MAX 4
+
+#define FASTLIB_BUFFER_KIND_SIGNED 0
+#define FASTLIB_BUFFER_KIND_UNSIGNED 1
+#define FASTLIB_BUFFER_KIND_FLOAT 2
+
+static size_t fastlib_buffer_argc(uint32_t operand)
+{
+    switch (operand)
+    {
+        case OP_FASTLIB_BUFFER_NEW: return 1;
+        case OP_FASTLIB_BUFFER_GET: return 3;
+        case OP_FASTLIB_BUFFER_SET: return 4;
+        case OP_FASTLIB_BUFFER_SLICE: return 3;
+        case OP_FASTLIB_BUFFER_FIND: return 3;
+        case OP_FASTLIB_BUFFER_COMPARE: return 2;
+    }
+    return 0;
+}
+
+static int fastlib_buffer_arg_buffer(struct virtual_machine *vm, \
+        const struct virtual_machine_object *object_arg)
+{
+    if (object_arg->type != OBJECT_TYPE_BUFFER)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type, \'buffer\' is expected");
+        return -MULTIPLE_ERR_VM;
+    }
+    return 0;
+}
+
+static int fastlib_buffer_arg_size(struct virtual_machine *vm, \
+        size_t *size_out, \
+        const struct virtual_machine_object *object_arg)
+{
+    int64_t value_int;
+
+    if (object_arg->type != OBJECT_TYPE_INT)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type, \'int\' is expected");
+        return -MULTIPLE_ERR_VM;
+    }
+    value_int = virtual_machine_object_int_get_primitive_value(object_arg);
+    if (value_int < 0)
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: invalid operand, \'%lld\' is negative", (long long)value_int);
+        return -MULTIPLE_ERR_VM;
+    }
+    *size_out = (size_t)value_int;
+    return 0;
+}
+
+static int fastlib_buffer_arg_format(struct virtual_machine *vm, \
+        size_t *width_out, int *order_out, int *kind_out, \
+        struct virtual_machine_object *object_arg)
+{
+    char *str;
+    size_t str_len;
+
+    if (object_arg->type != OBJECT_TYPE_STR)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type, \'str\' is expected");
+        return -MULTIPLE_ERR_VM;
+    }
+    virtual_machine_object_str_extract(&str, &str_len, object_arg);
+
+    *order_out = VIRTUAL_MACHINE_OBJECT_BUFFER_ORDER_LITTLE;
+    if ((str_len == 2) && ((str[0] == '<') || (str[0] == '>')))
+    {
+        if (str[0] == '>') *order_out = VIRTUAL_MACHINE_OBJECT_BUFFER_ORDER_BIG;
+        str++; str_len--;
+    }
+    if (str_len != 1) goto fail;
+
+    switch (str[0])
+    {
+        case 'b': *width_out = 1; *kind_out = FASTLIB_BUFFER_KIND_SIGNED; break;
+        case 'h': *width_out = 2; *kind_out = FASTLIB_BUFFER_KIND_SIGNED; break;
+        case 'i': *width_out = 4; *kind_out = FASTLIB_BUFFER_KIND_SIGNED; break;
+        case 'q': *width_out = 8; *kind_out = FASTLIB_BUFFER_KIND_SIGNED; break;
+        case 'B': *width_out = 1; *kind_out = FASTLIB_BUFFER_KIND_UNSIGNED; break;
+        case 'H': *width_out = 2; *kind_out = FASTLIB_BUFFER_KIND_UNSIGNED; break;
+        case 'I': *width_out = 4; *kind_out = FASTLIB_BUFFER_KIND_UNSIGNED; break;
+        case 'Q': *width_out = 8; *kind_out = FASTLIB_BUFFER_KIND_UNSIGNED; break;
+        case 'f': *width_out = 4; *kind_out = FASTLIB_BUFFER_KIND_FLOAT; break;
+        case 'd': *width_out = 8; *kind_out = FASTLIB_BUFFER_KIND_FLOAT; break;
+        default: goto fail;
+    }
+    return 0;
+fail:
+    vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+            "runtime error: invalid operand, unknown buffer format");
+    return -MULTIPLE_ERR_VM;
+}
+
+/* Integer read in the format */
+static int fastlib_buffer_int_new(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_dst, \
+        uint64_t bits, size_t width, int kind)
+{
+    uint32_t digits[2];
+
+    if ((kind == FASTLIB_BUFFER_KIND_SIGNED) && (width < sizeof(uint64_t)) && \
+            ((bits >> (8 * width - 1)) & 1))
+    {
+        /* Sign extension */
+        bits |= ~(uint64_t)0 << (8 * width);
+    }
+
+    if ((kind == FASTLIB_BUFFER_KIND_UNSIGNED) && (bits > (uint64_t)INT64_MAX))
+    {
+        /* Out of 'int' */
+        digits[0] = (uint32_t)bits;
+        digits[1] = (uint32_t)(bits >> 32);
+        *object_dst = virtual_machine_object_bigint_new_with_value(vm, 0, digits, 2);
+    }
+    else
+    {
+        *object_dst = virtual_machine_object_int_new_with_value(vm, (int64_t)bits);
+    }
+    if (*object_dst == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        return -MULTIPLE_ERR_VM;
+    }
+    return 0;
+}
+
+/* Integer to store, the lowest 64 bits in two's complement */
+static int fastlib_buffer_int_bits(struct virtual_machine *vm, \
+        uint64_t *bits_out, \
+        const struct virtual_machine_object *object_value)
+{
+    struct virtual_machine_object_bigint *object_bigint;
+    uint64_t bits;
+
+    if (object_value->type == OBJECT_TYPE_INT)
+    {
+        *bits_out = (uint64_t)virtual_machine_object_int_get_primitive_value(object_value);
+        return 0;
+    }
+    else if (object_value->type == OBJECT_TYPE_BIGINT)
+    {
+        object_bigint = object_value->ptr;
+        bits = object_bigint->digits[0];
+        if (object_bigint->size > 1) bits |= (uint64_t)object_bigint->digits[1] << 32;
+        *bits_out = object_bigint->sign != 0 ? ~bits + 1 : bits;
+        return 0;
+    }
+
+    vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+            "runtime error: unsupported operand type, \'int\' is expected");
+    return -MULTIPLE_ERR_VM;
+}
+
+static int fastlib_buffer(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack_frame *target_frame, \
+        struct virtual_machine_object **object_dst, \
+        struct virtual_machine_object *object_top, \
+        uint32_t operand)
+{
+    int ret = 0;
+    struct virtual_machine_object *args[FASTLIB_BUFFER_ARGC_MAX];
+    struct virtual_machine_object *new_object = NULL;
+    size_t argc = fastlib_buffer_argc(operand), idx;
+    size_t offset = 0, length = 0, width = 0, pos = 0;
+    int order = 0, kind = 0;
+    uint64_t bits;
+    double value_float;
+    unsigned char *needle = NULL;
+    char *needle_str = NULL;
+    size_t needle_len = 0;
+    int64_t result = 0;
+
+    *object_dst = NULL;
+
+    for (idx = 0; idx != FASTLIB_BUFFER_ARGC_MAX; idx++) args[idx] = NULL;
+    for (idx = 0; idx != argc; idx++)
+    {
+        if ((ret = virtual_machine_variable_solve(&args[idx], object_top, target_frame, 1, vm)) != 0)
+        { goto fail; }
+        object_top = object_top->prev;
+    }
+
+    switch (operand)
+    {
+        case OP_FASTLIB_BUFFER_NEW:
+            if ((ret = fastlib_buffer_arg_size(vm, &length, args[0])) != 0) goto fail;
+            if ((new_object = virtual_machine_object_buffer_new_with_size(vm, length)) == NULL)
+            {
+                VM_ERR_MALLOC(vm->r);
+                ret = -MULTIPLE_ERR_VM;
+                goto fail;
+            }
+            break;
+
+        case OP_FASTLIB_BUFFER_GET:
+        case OP_FASTLIB_BUFFER_SET:
+            if ((ret = fastlib_buffer_arg_buffer(vm, args[0])) != 0) goto fail;
+            if ((ret = fastlib_buffer_arg_size(vm, &offset, args[1])) != 0) goto fail;
+            if ((ret = fastlib_buffer_arg_format(vm, &width, &order, &kind, args[2])) != 0) goto fail;
+            if ((operand == OP_FASTLIB_BUFFER_GET) && (kind == FASTLIB_BUFFER_KIND_FLOAT))
+            {
+                if ((ret = virtual_machine_object_buffer_get_float(vm, &value_float, \
+                                args[0], offset, width, order)) != 0)
+                { goto fail; }
+                if ((new_object = virtual_machine_object_float_new_with_value(vm, value_float)) == NULL)
+                {
+                    VM_ERR_MALLOC(vm->r);
+                    ret = -MULTIPLE_ERR_VM;
+                    goto fail;
+                }
+            }
+            else if (operand == OP_FASTLIB_BUFFER_GET)
+            {
+                if ((ret = virtual_machine_object_buffer_get_uint(vm, &bits, \
+                                args[0], offset, width, order)) != 0)
+                { goto fail; }
+                if ((ret = fastlib_buffer_int_new(vm, &new_object, bits, width, kind)) != 0)
+                { goto fail; }
+            }
+            else if (kind == FASTLIB_BUFFER_KIND_FLOAT)
+            {
+                if (args[3]->type == OBJECT_TYPE_FLOAT)
+                { value_float = virtual_machine_object_float_get_primitive_value(args[3]); }
+                else if (args[3]->type == OBJECT_TYPE_INT)
+                { value_float = (double)virtual_machine_object_int_get_primitive_value(args[3]); }
+                else
+                {
+                    vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                            "runtime error: unsupported operand type, \'float\' is expected");
+                    ret = -MULTIPLE_ERR_VM;
+                    goto fail;
+                }
+                if ((ret = virtual_machine_object_buffer_set_float(vm, \
+                                args[0], offset, width, order, value_float)) != 0)
+                { goto fail; }
+            }
+            else
+            {
+                if ((ret = fastlib_buffer_int_bits(vm, &bits, args[3])) != 0) goto fail;
+                if ((ret = virtual_machine_object_buffer_set_uint(vm, \
+                                args[0], offset, width, order, bits)) != 0)
+                { goto fail; }
+            }
+            break;
+
+        case OP_FASTLIB_BUFFER_SLICE:
+            if ((ret = fastlib_buffer_arg_buffer(vm, args[0])) != 0) goto fail;
+            if ((ret = fastlib_buffer_arg_size(vm, &offset, args[1])) != 0) goto fail;
+            if ((ret = fastlib_buffer_arg_size(vm, &length, args[2])) != 0) goto fail;
+            if ((ret = virtual_machine_object_buffer_slice(vm, &new_object, args[0], offset, length)) != 0)
+            { goto fail; }
+            break;
+
+        case OP_FASTLIB_BUFFER_FIND:
+            if ((ret = fastlib_buffer_arg_buffer(vm, args[0])) != 0) goto fail;
+            if (args[1]->type == OBJECT_TYPE_BUFFER)
+            {
+                virtual_machine_object_buffer_data(args[1], &needle, &needle_len);
+            }
+            else if (args[1]->type == OBJECT_TYPE_STR)
+            {
+                virtual_machine_object_str_extract(&needle_str, &needle_len, args[1]);
+                needle = (unsigned char *)needle_str;
+            }
+            else
+            {
+                vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                        "runtime error: unsupported operand type, \'buffer\' or \'str\' is expected");
+                ret = -MULTIPLE_ERR_VM;
+                goto fail;
+            }
+            if ((ret = fastlib_buffer_arg_size(vm, &offset, args[2])) != 0) goto fail;
+            result = virtual_machine_object_buffer_find(args[0], &pos, offset, needle, needle_len) != 0 ? \
+                     (int64_t)pos : -1;
+            if ((new_object = virtual_machine_object_int_new_with_value(vm, result)) == NULL)
+            {
+                VM_ERR_MALLOC(vm->r);
+                ret = -MULTIPLE_ERR_VM;
+                goto fail;
+            }
+            break;
+
+        case OP_FASTLIB_BUFFER_COMPARE:
+            if ((ret = fastlib_buffer_arg_buffer(vm, args[0])) != 0) goto fail;
+            if ((ret = fastlib_buffer_arg_buffer(vm, args[1])) != 0) goto fail;
+            result = virtual_machine_object_buffer_compare(args[0], args[1]);
+            if ((new_object = virtual_machine_object_int_new_with_value(vm, result)) == NULL)
+            {
+                VM_ERR_MALLOC(vm->r);
+                ret = -MULTIPLE_ERR_VM;
+                goto fail;
+            }
+            break;
+
+        default:
+            VM_ERR_INTERNAL(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+    }
+
+    *object_dst = new_object; new_object = NULL;
+fail:
+    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
+    for (idx = 0; idx != argc; idx++)
+    {
+        if (args[idx] != NULL) virtual_machine_object_destroy(vm, args[idx]);
+    }
     return ret;
 }
 
@@ -469,6 +858,7 @@ int virtual_machine_thread_step_fastlib(struct virtual_machine *vm)
     struct virtual_machine_computing_stack *current_computing_stack;
     struct virtual_machine_object *new_object = NULL;
     struct virtual_machine_object *object_solved = NULL;
+    size_t argc, idx;
 
     current_running_stack = current_thread->running_stack;
     current_frame = current_running_stack->top;
@@ -625,6 +1015,44 @@ int virtual_machine_thread_step_fastlib(struct virtual_machine *vm)
             thread->running_stack->top->pc++;
             break;
 
+        case OP_FASTLIB_BUFFER_NEW:
+        case OP_FASTLIB_BUFFER_GET:
+        case OP_FASTLIB_BUFFER_SET:
+        case OP_FASTLIB_BUFFER_SLICE:
+        case OP_FASTLIB_BUFFER_FIND:
+        case OP_FASTLIB_BUFFER_COMPARE:
+
+            argc = fastlib_buffer_argc(operand);
+            if (current_computing_stack->size < argc)
+            {
+                vm_err_update(vm->r, -VM_ERR_COMPUTING_STACK_EMPTY, \
+                        "runtime error: computing stack empty");
+                ret = -MULTIPLE_ERR_VM;
+                goto fail;
+            }
+
+            if ((ret = fastlib_buffer(vm, current_frame, &new_object, current_computing_stack->top, operand)) != 0)
+            { goto fail; }
+
+            /* Pop the arguments */
+            for (idx = 0; idx != argc; idx++)
+            {
+                ret = virtual_machine_computing_stack_pop(vm, current_computing_stack);
+                if (ret != 0) { goto fail; }
+            }
+
+            /* Push the result object into computing stack */
+            if (new_object != NULL)
+            {
+                ret = virtual_machine_computing_stack_push(current_computing_stack, new_object);
+                if (ret != 0) { goto fail; }
+                new_object = NULL;
+            }
+
+            /* Update PC */
+            thread->running_stack->top->pc++;
+            break;
+
         default:
 
             VM_ERR_INTERNAL(vm->r);
@@ -21,9 +21,19 @@
 #define _VM_CPU_FASTLIB_CASE_H_
 
 #include <stdint.h>
+#include <stddef.h>
 
 int vm_cpu_fastlib_case_upcase_char(uint32_t *code_out, uint32_t code_in);
 int vm_cpu_fastlib_case_downcase_char(uint32_t *code_out, uint32_t code_in);
 
+/* Converting a UTF-8 string may turn a 2 bytes sequence into a 3 bytes one,
+ * the output buffer should be at least this size */
+#define VM_CPU_FASTLIB_CASE_STR_LEN_MAX(len) ((len) + ((len) >> 1) + 1)
+
+int vm_cpu_fastlib_case_upcase_str(char *str_out, size_t *str_out_len, \
+        const char *str_in, const size_t str_in_len);
+int vm_cpu_fastlib_case_downcase_str(char *str_out, size_t *str_out_len, \
+        const char *str_in, const size_t str_in_len);
+
 #endif
 
@@ -0,0 +1,178 @@
+#!/usr/bin/env python
+# -*- coding=utf-8 -*-
+
+# Case mapping table generator for multiple
+# Copyright(C) 2014 Cheryl Natsu
+
+# Turns the pair list (vm_cpu_fastlib_case.txt) into the two-stage
+# lookup tables used by vm_cpu_fastlib_case.c
+#
+# Usage:
+#   vm_cpu_fastlib_case_gen.py <pairs> <table>          regenerate <table>
+#   vm_cpu_fastlib_case_gen.py --check <pairs> <table>  fail if <table> is stale
+
+import sys
+
+
+BLOCK_SHIFT = 8
+BLOCK_SIZE = 1 << BLOCK_SHIFT
+
+template_head = r'''/* Virtual Machine CPU : Fast Library : Case : Tables
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+/* Generated by vm_cpu_fastlib_case_gen.py from vm_cpu_fastlib_case.txt,
+ * do not edit */
+
+#ifndef _VM_CPU_FASTLIB_CASE_TABLE_H_
+#define _VM_CPU_FASTLIB_CASE_TABLE_H_
+
+#include <stdint.h>
+
+/* The mapping is stored as a two-stage table. The high bits of a code point
+ * select a block through the stage 1 index, and the low 8 bits select the
+ * delta (mapped - original) inside that block of stage 2. Blocks without any
+ * mapping share the all-zero block 0, so a lookup is two loads and an add. */
+
+#define CASE_BLOCK_SHIFT %d
+#define CASE_BLOCK_SIZE (1 << CASE_BLOCK_SHIFT)
+#define CASE_BLOCK_MASK (CASE_BLOCK_SIZE - 1)
+''' % BLOCK_SHIFT
+
+template_tail = r'''
+#endif
+
+'''
+
+
+def load_pairs(pathname):
+    pairs = []
+    f = open(pathname, 'r')
+    for line in f:
+        line = line.strip()
+        if len(line) == 0 or line.startswith('#'):
+            continue
+        fields = line.split()
+        pairs.append((int(fields[0], 16), int(fields[1], 16)))
+    f.close()
+    return pairs
+
+
+def build_mapping(pairs, src, dst):
+    # The first pair mentioning a code point wins
+    mapping = {}
+    for pair in pairs:
+        if pair[src] not in mapping:
+            mapping[pair[src]] = pair[dst]
+    return mapping
+
+
+def build_table(mapping):
+    stage1_count = (max(mapping.keys()) >> BLOCK_SHIFT) + 1
+    stage1 = [0] * stage1_count
+    stage2 = [[0] * BLOCK_SIZE]
+    for block in range(stage1_count):
+        deltas = [0] * BLOCK_SIZE
+        used = False
+        for low in range(BLOCK_SIZE):
+            code = (block << BLOCK_SHIFT) | low
+            if code in mapping:
+                deltas[low] = mapping[code] - code
+                used = True
+        if used:
+            stage1[block] = len(stage2)
+            stage2.append(deltas)
+    # Stage 1 entries are uint8_t
+    if len(stage2) > 256:
+        sys.stderr.write('error: too many blocks for the stage 1 index\n')
+        sys.exit(1)
+    return stage1, stage2
+
+
+def emit_table(title, name, stage1, stage2):
+    name_upper = name.upper()
+    lines = []
+    lines.append('')
+    lines.append('/* %s */' % title)
+    lines.append('')
+    lines.append('#define CASE_%s_STAGE1_COUNT %d' % (name_upper, len(stage1)))
+    lines.append('#define CASE_%s_STAGE2_COUNT %d' % (name_upper, len(stage2)))
+    lines.append('')
+    lines.append('static const uint8_t case_%s_stage1[CASE_%s_STAGE1_COUNT] = ' % (name, name_upper))
+    lines.append('{')
+    for i in range(0, len(stage1), 16):
+        lines.append('   ' + ''.join(['%3d,' % x for x in stage1[i:i + 16]]))
+    lines.append('};')
+    lines.append('')
+    lines.append('static const int32_t case_%s_stage2[CASE_%s_STAGE2_COUNT][CASE_BLOCK_SIZE] = ' % (name, name_upper))
+    lines.append('{')
+    for deltas in stage2:
+        lines.append('    {')
+        for i in range(0, BLOCK_SIZE, 8):
+            lines.append('       ' + ''.join(['%7d,' % x for x in deltas[i:i + 8]]))
+        lines.append('    },')
+    lines.append('};')
+    return '\n'.join(lines) + '\n'
+
+
+def generate(pathname_pairs):
+    pairs = load_pairs(pathname_pairs)
+    text = template_head
+    stage1, stage2 = build_table(build_mapping(pairs, 1, 0))
+    text += emit_table('Lower to Upper', 'upcase', stage1, stage2)
+    stage1, stage2 = build_table(build_mapping(pairs, 0, 1))
+    text += emit_table('Upper to Lower', 'downcase', stage1, stage2)
+    text += template_tail
+    return text
+
+
+def read_file(pathname):
+    try:
+        f = open(pathname, 'r')
+    except IOError:
+        return None
+    text = f.read()
+    f.close()
+    return text
+
+
+def main():
+    args = sys.argv[1:]
+    check = False
+    if len(args) != 0 and args[0] == '--check':
+        check = True
+        args = args[1:]
+    if len(args) != 2:
+        sys.stderr.write('usage: vm_cpu_fastlib_case_gen.py [--check] <pairs> <table>\n')
+        sys.exit(1)
+    pathname_pairs, pathname_table = args
+
+    text = generate(pathname_pairs)
+    if check:
+        if read_file(pathname_table) != text:
+            sys.stderr.write('error: ' + pathname_table + ' is out of date, ' + \
+                    'regenerate it with vm_cpu_fastlib_case_gen.py\n')
+            sys.exit(1)
+        return
+    f = open(pathname_table, 'w')
+    f.write(text)
+    f.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,1322 @@
+/* Virtual Machine CPU : Fast Library : Case : Tables
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+/* Generated by vm_cpu_fastlib_case_gen.py from vm_cpu_fastlib_case.txt,
+ * do not edit */
+
+#ifndef _VM_CPU_FASTLIB_CASE_TABLE_H_
+#define _VM_CPU_FASTLIB_CASE_TABLE_H_
+
+#include <stdint.h>
+
+/* The mapping is stored as a two-stage table. The high bits of a code point
+ * select a block through the stage 1 index, and the low 8 bits select the
+ * delta (mapped - original) inside that block of stage 2. Blocks without any
+ * mapping share the all-zero block 0, so a lookup is two loads and an add. */
+
+#define CASE_BLOCK_SHIFT 8
+#define CASE_BLOCK_SIZE (1 << CASE_BLOCK_SHIFT)
+#define CASE_BLOCK_MASK (CASE_BLOCK_SIZE - 1)
+
+/* Lower to Upper */
+
+#define CASE_UPCASE_STAGE1_COUNT 261
+#define CASE_UPCASE_STAGE2_COUNT 18
+
+static const uint8_t case_upcase_stage1[CASE_UPCASE_STAGE1_COUNT] = 
+{
+     1,  2,  3,  4,  5,  6,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  7,  8,  9,
+     0, 10,  0,  0, 11,  0,  0,  0,  0,  0,  0,  0, 12, 13,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0, 14, 15,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 16,
+     0,  0,  0,  0, 17,
+};
+
+static const int32_t case_upcase_stage2[CASE_UPCASE_STAGE2_COUNT][CASE_BLOCK_SIZE] = 
+{
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,   7615,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,      0,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    121,
+    },
+    {
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,   -232,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,     -1,      0,     -1,      0,     -1,      0,
+            -1,      0,     -1,      0,     -1,      0,     -1,      0,
+            -1,      0,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,     -1,      0,     -1,      0,     -1,      0,
+           195,      0,      0,     -1,      0,     -1,      0,      0,
+            -1,      0,      0,      0,     -1,      0,      0,      0,
+             0,      0,     -1,      0,      0,     97,      0,      0,
+             0,     -1,    163,      0,      0,      0,    130,      0,
+             0,     -1,      0,     -1,      0,     -1,      0,      0,
+            -1,      0,      0,      0,      0,     -1,      0,      0,
+            -1,      0,      0,      0,     -1,      0,     -1,      0,
+             0,     -1,      0,      0,      0,     -1,      0,     56,
+             0,      0,      0,      0,      0,      0,     -2,      0,
+             0,     -2,      0,      0,     -2,      0,     -1,      0,
+            -1,      0,     -1,      0,     -1,      0,     -1,      0,
+            -1,      0,     -1,      0,     -1,    -79,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      0,     -2,      0,     -1,      0,      0,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+    },
+    {
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,      0,      0,      0,
+             0,      0,      0,      0,     -1,      0,      0,  10815,
+         10815,      0,     -1,      0,      0,      0,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+         10783,  10780,  10782,   -210,   -206,      0,   -205,   -205,
+             0,   -202,      0,   -203,      0,      0,      0,      0,
+          -205,      0,      0,   -207,      0,  42280,  42308,      0,
+          -209,   -211,      0,  10743,      0,      0,      0,   -211,
+             0,  10749,   -213,      0,      0,   -214,      0,      0,
+             0,      0,      0,      0,      0,  10727,      0,      0,
+          -218,      0,      0,   -218,      0,      0,      0,      0,
+          -218,    -69,   -217,   -217,    -71,      0,      0,      0,
+             0,      0,   -219,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,   -371,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     -1,      0,     -1,      0,      0,      0,     -1,
+             0,      0,      0,    130,    130,    130,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,    -38,    -37,    -37,    -37,
+             0,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,   -116,    -32,    -32,   -775,    -32,    -32,    -32,
+           -32,    -32,      0,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -64,    -63,    -63,      0,
+             0,      0,      0,      0,      0,      0,      0,     -8,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      7,      0,      0,      0,      0,      0,
+            -1,      0,      0,     -1,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -80,    -80,    -80,    -80,    -80,    -80,    -80,    -80,
+           -80,    -80,    -80,    -80,    -80,    -80,    -80,    -80,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,     -1,      0,     -1,      0,     -1,      0,
+            -1,      0,     -1,      0,     -1,      0,     -1,    -15,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+    },
+    {
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,  35332,      0,      0,      0,   3814,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+    },
+    {
+             8,      8,      8,      8,      8,      8,      8,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      8,      8,      8,      8,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      8,      8,      8,      8,      8,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      8,      8,      8,      8,      8,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      8,      8,      8,      8,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      8,      0,      8,      0,      8,      0,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      8,      8,      8,      8,      8,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            66,     74,     86,     86,     78,     86,    100,    100,
+           128,    128,    112,    112,    118,    126,      0,      0,
+             8,      8,      8,      8,      8,      8,      8,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      8,      8,      8,      8,      8,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      8,      8,      8,      8,      8,      8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      0,      9,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      9,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             8,      8,      0,      0,      0,      7,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      9,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,    -28,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+           -16,    -16,    -16,    -16,    -16,    -16,    -16,    -16,
+           -16,    -16,    -16,    -16,    -16,    -16,    -16,    -16,
+             0,      0,      0,      0,     -1,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+           -26,    -26,    -26,    -26,    -26,    -26,    -26,    -26,
+           -26,    -26,    -26,    -26,    -26,    -26,    -26,    -26,
+           -26,    -26,    -26,    -26,    -26,    -26,    -26,    -26,
+           -26,    -26,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,    -48,
+           -48,    -48,    -48,    -48,    -48,    -48,    -48,      0,
+             0,     -1,      0,      0,      0, -10795, -10792,      0,
+            -1,      0,     -1,      0,     -1,      0,      0,      0,
+             0,      0,      0,     -1,      0,      0,     -1,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,      0,      0,      0,
+             0,      0,      0,      0,     -1,      0,     -1,      0,
+             0,      0,      0,     -1,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+         -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,
+         -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,
+         -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,
+         -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,  -7264,
+         -7264,  -7264,  -7264,  -7264,  -7264,  -7264,      0,  -7264,
+             0,      0,      0,      0,      0,  -7264,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,     -1,      0,     -1,      0,      0,     -1,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,      0,      0,      0,     -1,      0,      0,      0,
+             0,     -1,      0,     -1,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     -1,      0,     -1,      0,     -1,      0,     -1,
+             0,     -1,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,    -32,    -32,    -32,    -32,    -32,
+           -32,    -32,    -32,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+           -40,    -40,    -40,    -40,    -40,    -40,    -40,    -40,
+           -40,    -40,    -40,    -40,    -40,    -40,    -40,    -40,
+           -40,    -40,    -40,    -40,    -40,    -40,    -40,    -40,
+           -40,    -40,    -40,    -40,    -40,    -40,    -40,    -40,
+           -40,    -40,    -40,    -40,    -40,    -40,    -40,    -40,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+};
+
+/* Upper to Lower */
+
+#define CASE_DOWNCASE_STAGE1_COUNT 261
+#define CASE_DOWNCASE_STAGE2_COUNT 18
+
+static const uint8_t case_downcase_stage1[CASE_DOWNCASE_STAGE1_COUNT] = 
+{
+     1,  2,  3,  4,  5,  6,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     7,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  8,  9,
+     0, 10,  0,  0, 11,  0,  0,  0,  0,  0,  0,  0, 12,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0, 13, 14,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 15,  0,  0,  0, 16,
+     0,  0,  0,  0, 17,
+};
+
+static const int32_t case_downcase_stage2[CASE_DOWNCASE_STAGE2_COUNT][CASE_BLOCK_SIZE] = 
+{
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,    775,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,      0,
+            32,     32,     32,     32,     32,     32,     32,   -108,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+          -199,      0,      1,      0,      1,      0,      1,      0,
+             0,      1,      0,      1,      0,      1,      0,      1,
+             0,      1,      0,      1,      0,      1,      0,      1,
+             0,    371,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+          -121,      1,      0,      1,      0,      1,      0,   -268,
+             0,    210,      1,      0,      1,      0,    206,      1,
+             0,    205,    205,      1,      0,      0,     79,    202,
+           203,      1,      0,    205,    207,      0,    211,    209,
+             1,      0,      0,      0,    211,    213,      0,    214,
+             1,      0,      1,      0,      1,      0,    218,      1,
+             0,    218,      0,      0,      1,      0,    218,      1,
+             0,    217,    217,      1,      0,      1,      0,    219,
+             1,      0,      0,      0,      1,      0,      0,      0,
+             0,      0,      0,      0,      2,      1,      0,      2,
+             1,      0,      2,      1,      0,      1,      0,      1,
+             0,      1,      0,      1,      0,      1,      0,      1,
+             0,      1,      0,      1,      0,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+          -390,      2,      1,      0,      1,      0,    -97,    -56,
+             1,      0,      1,      0,      1,      0,      1,      0,
+    },
+    {
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+          -130,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      0,      0,      0,      0,
+             0,      0,  10795,      1,      0,   -163,  10792,      0,
+             0,      1,      0,   -195,     69,     71,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,    116,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             1,      0,      1,      0,      0,      0,      1,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,     38,      0,
+            37,     37,     37,      0,     64,      0,     63,     63,
+            41,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,      0,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,      0,      0,      0,      0,
+            21,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      1,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      8,
+           -30,    -25,      0,      0,      0,    -15,    -22,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+           -54,    -48,      0,      0,    -60,    -64,      0,      1,
+             0,     -7,      1,      0,      0,   -130,   -130,   -130,
+    },
+    {
+            80,     80,     80,     80,     80,     80,     80,     80,
+            80,     80,     80,     80,     80,     80,     80,     80,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+            15,      1,      0,      1,      0,      1,      0,      1,
+             0,      1,      0,      1,      0,      1,      0,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+    },
+    {
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,    -34,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+          7264,   7264,   7264,   7264,   7264,   7264,   7264,   7264,
+          7264,   7264,   7264,   7264,   7264,   7264,   7264,   7264,
+          7264,   7264,   7264,   7264,   7264,   7264,   7264,   7264,
+          7264,   7264,   7264,   7264,   7264,   7264,   7264,   7264,
+          7264,   7264,   7264,   7264,   7264,   7264,      0,   7264,
+             0,      0,      0,      0,      0,   7264,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,  -7726,  -7715,
+         -7713,  -7712,  -7737,    -58,      0,      0,  -7723,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+            -8,     -8,     -8,     -8,     -8,     -8,     -8,     -8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            -8,     -8,     -8,     -8,     -8,     -8,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            -8,     -8,     -8,     -8,     -8,     -8,     -8,     -8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            -8,     -8,     -8,     -8,     -8,     -8,     -8,     -8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            -8,     -8,     -8,     -8,     -8,     -8,      0,      0,
+         -7051,      0,  -7053,      0,  -7055,      0,  -7057,      0,
+             0,     -8,      0,     -8,      0,     -8,      0,     -8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            -8,     -8,     -8,     -8,     -8,     -8,     -8,     -8,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+          -128,   -128,   -128,   -128,   -128,   -128,   -128,   -128,
+          -136,   -136,   -136,   -136,   -136,   -136,   -136,   -136,
+          -112,   -112,   -112,   -112,   -112,   -112,   -112,   -112,
+          -120,   -120,   -120,   -120,   -120,   -120,   -120,   -120,
+           -64,    -64,    -64,    -64,    -64,    -64,    -64,    -64,
+           -72,    -72,    -72,    -72,    -72,    -72,    -72,    -72,
+             0,      0,    -66,  -7170,  -7176,      0,  -7173,  -7174,
+            -8,     -8,    -74,    -74,  -7179,      0,  -7173,      0,
+             0,      0,    -78,  -7180,  -7190,      0,  -7183,  -7184,
+           -86,    -86,    -86,    -86,  -7189,      0,      0,      0,
+             0,      0,  -7193,  -7194,      0,      0,  -7197,  -7198,
+            -8,     -8,   -100,   -100,      0,      0,      0,      0,
+             0,      0,  -7197,  -7198,  -7203,      0,  -7201,  -7202,
+            -8,     -8,   -112,   -112,     -7,      0,      0,      0,
+             0,      0,   -118,  -7210,  -7206,      0,  -7213,  -7214,
+          -128,   -128,   -126,   -126,  -7219,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,  -7517,      0,
+             0,      0,  -8383,  -8262,      0,      0,      0,      0,
+             0,      0,     28,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+            16,     16,     16,     16,     16,     16,     16,     16,
+            16,     16,     16,     16,     16,     16,     16,     16,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      1,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,     26,     26,
+            26,     26,     26,     26,     26,     26,     26,     26,
+            26,     26,     26,     26,     26,     26,     26,     26,
+            26,     26,     26,     26,     26,     26,     26,     26,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,     48,
+            48,     48,     48,     48,     48,     48,     48,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             1,      0, -10743,  -3814, -10727,      0,      0,      1,
+             0,      1,      0,      1,      0, -10780, -10749, -10783,
+        -10782,      0,      1,      0,      0,      1,      0,      0,
+             0,      0,      0,      0,      0,      0, -10815, -10815,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      0,      0,      0,      0,
+             0,      0,      0,      1,      0,      1,      0,      0,
+             0,      0,      1,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             0,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      1,      0,      1,      0, -35332,      1,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             0,      0,      0,      1,      0, -42280,      0,      0,
+             1,      0,      1,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             1,      0,      1,      0,      1,      0,      1,      0,
+             1,      0, -42308,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+        -64154, -64155, -64156, -64157, -64158, -64146, -64147,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0, -62879, -62880, -62881, -62872, -62883,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,     32,     32,     32,     32,     32,
+            32,     32,     32,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+    {
+            40,     40,     40,     40,     40,     40,     40,     40,
+            40,     40,     40,     40,     40,     40,     40,     40,
+            40,     40,     40,     40,     40,     40,     40,     40,
+            40,     40,     40,     40,     40,     40,     40,     40,
+            40,     40,     40,     40,     40,     40,     40,     40,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+             0,      0,      0,      0,      0,      0,      0,      0,
+    },
+};
+
+#endif
+
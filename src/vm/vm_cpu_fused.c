@@ -0,0 +1,362 @@
+/* Virtual Machine CPU : Superinstruments
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include "selfcheck.h"
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_object_aio.h"
+#include "vm_infrastructure.h"
+#include "vm_cpu_fused.h"
+#include "vm_err.h"
+
+/* Names and lengths of superinstruments */
+static const struct
+{
+    const char *name;
+    uint32_t length;
+} virtual_machine_fused_items[OP_FUSED_COUNT] =
+{
+    { "none", 1 },
+    { "push2", 2 },
+    { "cmpjmpc", 2 },
+    { "varinc", 3 },
+};
+
+#define IS_CMP(opcode) \
+    (((opcode)==OP_EQ)||((opcode)==OP_NE)|| \
+     ((opcode)==OP_L)||((opcode)==OP_G)||((opcode)==OP_LE)||((opcode)==OP_GE))
+#define IS_JMP_CONDITIONAL(opcode) (((opcode)==OP_JMPC)||((opcode)==OP_JMPCR))
+#define IS_JMP_RELATIVE(opcode) (((opcode)==OP_JMPR)||((opcode)==OP_JMPCR))
+
+/* Complement to Sign and Magnitude */
+static int32_t snr_cmp_to_sam(uint32_t num)
+{
+    int sign = (int)(num >> 31);
+    if (sign == 0) return (int32_t)num;
+    else
+    {
+        return -(~((int32_t)(num - 1)));
+    }
+}
+
+const char *virtual_machine_fused_name(uint32_t fused)
+{
+    if (fused >= OP_FUSED_COUNT) return NULL;
+    return virtual_machine_fused_items[fused].name;
+}
+
+uint32_t virtual_machine_fused_length(uint32_t fused)
+{
+    if (fused >= OP_FUSED_COUNT) return 1;
+    return virtual_machine_fused_items[fused].length;
+}
+
+
+/* Fusing */
+
+size_t virtual_machine_text_section_target(struct virtual_machine_text_section *text_section, \
+        size_t idx)
+{
+    int32_t rel;
+    uint32_t operand = text_section->instruments[idx].operand;
+
+    switch (text_section->instruments[idx].opcode)
+    {
+        case OP_JMP:
+        case OP_JMPC:
+        case OP_RETURNTO:
+        case OP_TRAPSET:
+        case OP_NFUNCMK:
+        case OP_LAMBDAMK:
+        case OP_PROMMK:
+        case OP_CONTMK:
+            return (size_t)operand;
+        case OP_JMPR:
+        case OP_JMPCR:
+            rel = snr_cmp_to_sam(operand);
+            if ((rel < 0) && ((size_t)(-(int64_t)rel) > idx)) return text_section->size;
+            return (size_t)((int64_t)idx + rel);
+        default:
+            return text_section->size;
+    }
+}
+
+static uint32_t virtual_machine_text_section_fused_match( \
+        struct virtual_machine_module *module, \
+        const char *leaders, size_t idx)
+{
+    struct virtual_machine_text_section_instrument *instruments = module->text_section->instruments;
+    size_t size = module->text_section->size;
+
+    /* push x; push y; add|sub; pop x,
+     * the 'pop' is left to the interpreter */
+    if ((idx + 3 < size) && \
+            (instruments[idx].opcode == OP_PUSH) && \
+            (instruments[idx + 1].opcode == OP_PUSH) && \
+            ((instruments[idx + 2].opcode == OP_ADD) || (instruments[idx + 2].opcode == OP_SUB)) && \
+            (instruments[idx + 3].opcode == OP_POP) && \
+            (instruments[idx].operand == instruments[idx + 3].operand) && \
+            (module->data_section->items[instruments[idx].data_id].type == MULTIPLE_IR_DATA_SECTION_ITEM_TYPE_IDENTIFIER) && \
+            (leaders[idx + 1] == 0) && (leaders[idx + 2] == 0))
+    { return OP_FUSED_VARINC; }
+
+    /* compare; jmpc */
+    if ((idx + 1 < size) && \
+            (IS_CMP(instruments[idx].opcode)) && \
+            (IS_JMP_CONDITIONAL(instruments[idx + 1].opcode)) && \
+            (leaders[idx + 1] == 0))
+    { return OP_FUSED_CMPJMPC; }
+
+    /* push; push */
+    if ((idx + 1 < size) && \
+            (instruments[idx].opcode == OP_PUSH) && \
+            (instruments[idx + 1].opcode == OP_PUSH) && \
+            (leaders[idx + 1] == 0))
+    { return OP_FUSED_PUSH2; }
+
+    return OP_FUSED_NONE;
+}
+
+int virtual_machine_text_section_fuse(struct virtual_machine *vm, \
+        struct virtual_machine_module *module)
+{
+    int ret = 0;
+    struct virtual_machine_text_section *text_section = module->text_section;
+    char *leaders = NULL;
+    size_t idx, target;
+    uint32_t fused;
+
+    if (text_section->size == 0) return 0;
+
+    if ((leaders = (char *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(char) * text_section->size)) == NULL)
+    { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+    for (idx = 0; idx != text_section->size; idx++) leaders[idx] = 0;
+
+    /* Entered from somewhere other than the previous instrument */
+    if (module->export_section != NULL)
+    {
+        for (idx = 0; idx != module->export_section->size; idx++)
+        {
+            target = (size_t)module->export_section->exports[idx].instrument_number;
+            if (target < text_section->size) leaders[target] = 1;
+        }
+    }
+    for (idx = 0; idx != text_section->size; idx++)
+    {
+        target = virtual_machine_text_section_target(text_section, idx);
+        if (target < text_section->size) leaders[target] = 1;
+    }
+
+    idx = 0;
+    while (idx < text_section->size)
+    {
+        fused = virtual_machine_text_section_fused_match(module, leaders, idx);
+        text_section->instruments[idx].fused = fused;
+        if (fused != OP_FUSED_NONE) vm->fused[fused] += 1;
+        idx += (size_t)virtual_machine_fused_items[fused].length;
+    }
+
+    goto done;
+fail:
+done:
+    if (leaders != NULL) virtual_machine_resource_free(vm->resource, leaders);
+    return ret;
+}
+
+
+/* Executing */
+
+static int virtual_machine_thread_step_fused_push2(struct virtual_machine *vm)
+{
+    int ret = 0;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+    struct virtual_machine_module *current_module = current_frame->module;
+    struct virtual_machine_text_section_instrument *instrument = \
+            current_module->text_section->instruments + (size_t)current_frame->pc;
+    struct virtual_machine_object *new_object = NULL;
+    int idx;
+
+    for (idx = 0; idx != 2; idx++)
+    {
+        if ((new_object = virtual_machine_object_new_from_data_section_item(vm, \
+                        current_module->data_section->items + instrument[idx].data_id)) == NULL)
+        { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+        if ((ret = virtual_machine_computing_stack_push(current_frame->computing_stack, new_object)) != 0)
+        { VM_ERR_INTERNAL(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+        new_object = NULL;
+    }
+
+    /* Update PC */
+    current_frame->pc += 2;
+
+    goto done;
+fail:
+    if (new_object != NULL) _virtual_machine_object_destroy(vm, new_object);
+done:
+    return ret;
+}
+
+static int virtual_machine_thread_step_fused_cmpjmpc(struct virtual_machine *vm, int *handled)
+{
+    int ret = 0;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+    struct virtual_machine_computing_stack *current_computing_stack = current_frame->computing_stack;
+    struct virtual_machine_text_section_instrument *instrument = \
+            current_frame->module->text_section->instruments + (size_t)current_frame->pc;
+    struct virtual_machine_object *new_object = NULL;
+    int value;
+    int32_t rel;
+
+    /* Leave the errors to the compare instrument */
+    if (current_computing_stack->size < 2) { *handled = 0; return 0; }
+
+    if ((ret = virtual_machine_object_binary_operate(&new_object, \
+                    current_computing_stack->top->prev, current_computing_stack->top, \
+                    instrument[0].opcode, vm)) != 0)
+    { goto fail; }
+
+    /* The result is taken without pushing it, or left to be pushed */
+    if (virtual_machine_object_bool_valid(new_object) != 0)
+    {
+        *handled = 0;
+        goto done;
+    }
+    if ((ret = virtual_machine_object_bool_get_value(new_object, &value)) != 0)
+    { goto fail; }
+
+    /* Pop the top 2 elements */
+    ret = virtual_machine_computing_stack_pop(vm, current_computing_stack);
+    if (ret != 0) { goto fail; }
+    ret = virtual_machine_computing_stack_pop(vm, current_computing_stack);
+    if (ret != 0) { goto fail; }
+
+    /* Update PC, as the jump instrument does */
+    if (value == VIRTUAL_MACHINE_OBJECT_BOOL_VALUE_TRUE)
+    {
+        if (IS_JMP_RELATIVE(instrument[1].opcode))
+        {
+            rel = snr_cmp_to_sam(instrument[1].operand);
+            current_frame->pc += 1;
+            if (rel >= 0) { current_frame->pc += (uint32_t)(rel); }
+            else { current_frame->pc -= (uint32_t)(-rel); }
+        }
+        else
+        {
+            current_frame->pc = instrument[1].operand;
+        }
+    }
+    else
+    {
+        current_frame->pc += 2;
+    }
+
+    goto done;
+fail:
+done:
+    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
+    return ret;
+}
+
+static int virtual_machine_thread_step_fused_varinc(struct virtual_machine *vm)
+{
+    int ret = 0;
+    struct virtual_machine_running_stack_frame *current_frame = vm->tp->running_stack->top;
+    struct virtual_machine_module *current_module = current_frame->module;
+    struct virtual_machine_text_section_instrument *instrument = \
+            current_module->text_section->instruments + (size_t)current_frame->pc;
+    struct virtual_machine_object *object_id = NULL;
+    struct virtual_machine_object *object_operand = NULL;
+    struct virtual_machine_object *new_object = NULL;
+
+    if ((object_id = virtual_machine_object_new_from_data_section_item(vm, \
+                    current_module->data_section->items + instrument[0].data_id)) == NULL)
+    { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+    if ((object_operand = virtual_machine_object_new_from_data_section_item(vm, \
+                    current_module->data_section->items + instrument[1].data_id)) == NULL)
+    { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+
+    /* Errors are reported on the arithmetic instrument */
+    vm->r->opcode = instrument[2].opcode;
+    vm->r->operand = instrument[2].operand;
+    vm->r->pc = current_frame->pc + 2;
+    if ((ret = virtual_machine_object_binary_operate(&new_object, \
+                    object_id, object_operand, \
+                    instrument[2].opcode, vm)) != 0)
+    { goto fail; }
+
+    /* Push the result, the variable is stored by the 'pop' following */
+    if ((ret = virtual_machine_computing_stack_push(current_frame->computing_stack, new_object)) != 0)
+    { VM_ERR_INTERNAL(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+    new_object = NULL;
+
+    /* Update PC */
+    current_frame->pc += 3;
+
+    goto done;
+fail:
+    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
+done:
+    if (object_id != NULL) virtual_machine_object_destroy(vm, object_id);
+    if (object_operand != NULL) virtual_machine_object_destroy(vm, object_operand);
+    return ret;
+}
+
+int virtual_machine_thread_step_fused(struct virtual_machine *vm, \
+        uint32_t fused, int *handled)
+{
+    int ret = 0;
+
+    *handled = 1;
+
+    switch (fused)
+    {
+        case OP_FUSED_PUSH2:
+            ret = virtual_machine_thread_step_fused_push2(vm);
+            break;
+        case OP_FUSED_CMPJMPC:
+            ret = virtual_machine_thread_step_fused_cmpjmpc(vm, handled);
+            break;
+        case OP_FUSED_VARINC:
+            ret = virtual_machine_thread_step_fused_varinc(vm);
+            break;
+        default:
+            *handled = 0;
+            break;
+    }
+    if (ret != 0) goto fail;
+
+    /* Each instrument in the sequence counts as a step */
+    if (*handled != 0)
+    {
+        vm->step_in_time_slice += (size_t)virtual_machine_fused_items[fused].length - 1;
+        vm->step_since_gc += (size_t)virtual_machine_fused_items[fused].length - 1;
+        vm->fused_executed[fused] += 1;
+    }
+
+fail:
+    return ret;
+}
+
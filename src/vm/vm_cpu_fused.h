@@ -0,0 +1,46 @@
+/* Virtual Machine CPU : Superinstruments
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>. 
+   */
+
+#ifndef _VM_CPU_FUSED_H_
+#define _VM_CPU_FUSED_H_
+
+#include "vm_infrastructure.h"
+
+/* Name of superinstrument, NULL for unknown */
+const char *virtual_machine_fused_name(uint32_t fused);
+/* Instruments in the sequence of superinstrument, 1 for none */
+uint32_t virtual_machine_fused_length(uint32_t fused);
+
+/* Instrument number the operand at 'idx' refers to, 'size' for none */
+size_t virtual_machine_text_section_target(struct virtual_machine_text_section *text_section, \
+        size_t idx);
+
+/* Mark the superinstruments of the text section of a loaded module, 
+ * no sequence entered in the middle by a jump or an export is fused */
+int virtual_machine_text_section_fuse(struct virtual_machine *vm, \
+        struct virtual_machine_module *module);
+
+/* Execute the superinstrument at pc, 'handled' is 0 when it is not 
+ * applicable at the moment, and the first instrument should be executed 
+ * as usual */
+int virtual_machine_thread_step_fused(struct virtual_machine *vm, \
+        uint32_t fused, int *handled);
+
+#endif
+
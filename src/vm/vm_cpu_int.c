@@ -30,6 +30,7 @@
 #include "vm_object.h"
 #include "vm_object_aio.h"
 #include "vm_err.h"
+#include "vm_stats.h"
 
 #include "vm_cpu_int.h"
 
@@ -58,6 +59,8 @@ int virtual_machine_interrupt(struct virtual_machine *vm)
     struct virtual_machine_data_section_item *data_section_item_operand = NULL;
 
     int interrupt_number;
+    int priority;
+    int time_slice[2];
 
     current_running_stack = current_thread->running_stack;
     current_frame = current_running_stack->top;
@@ -95,7 +98,7 @@ int virtual_machine_interrupt(struct virtual_machine *vm)
                 goto fail; 
             }
 
-            interrupt_number = ((struct virtual_machine_object_int *)(new_object_solved->ptr))->value;
+            interrupt_number = virtual_machine_object_int_get_primitive_value_saturated(new_object_solved);
             virtual_machine_object_destroy(vm, new_object_solved);
             new_object_solved = NULL;
 
@@ -274,11 +277,136 @@ int virtual_machine_interrupt(struct virtual_machine *vm)
                 case VM_INT_DBG_START:
 
                     /* Start debugging */
-                    current_thread->type = VIRTUAL_MACHINE_THREAD_TYPE_DEBUGGER;
+                    virtual_machine_thread_list_set_type(vm->threads, current_thread, \
+                            VIRTUAL_MACHINE_THREAD_TYPE_DEBUGGER);
                     vm->debug_mode = 1;
 
                     break;
 
+                case VM_INT_THREAD_PRIORITY_SET:
+
+                    /* Set Priority of Current Thread */
+
+                    /* Stack Top element : priority */
+                    if (current_computing_stack->size < 1)
+                    {
+                        vm_err_update(vm->r, -VM_ERR_COMPUTING_STACK_EMPTY, \
+                                "runtime error: computing stack empty");
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail;
+                    }
+                    if ((ret = virtual_machine_variable_solve(&new_object_solved, current_computing_stack->top, current_frame, 1, vm)) != 0)
+                    { goto fail; }
+                    if (new_object_solved->type != OBJECT_TYPE_INT)
+                    {
+                        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                                "runtime error: unsupported operand type");
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail; 
+                    }
+                    priority = virtual_machine_object_int_get_primitive_value_saturated(new_object_solved);
+                    virtual_machine_object_destroy(vm, new_object_solved);
+                    new_object_solved = NULL;
+                    if ((priority < 0) || (priority >= VIRTUAL_MACHINE_THREAD_PRIORITY_COUNT))
+                    {
+                        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                                "runtime error: invalid priority %d", priority);
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail; 
+                    }
+
+                    ret = virtual_machine_computing_stack_pop(vm, current_frame->computing_stack);
+                    if (ret != 0) { goto fail; }
+
+                    virtual_machine_thread_list_set_priority(vm->threads, current_thread, priority);
+
+                    break;
+
+                case VM_INT_THREAD_PRIORITY_GET:
+
+                    /* Get Priority of Current Thread */
+                    new_object = virtual_machine_object_int_new_with_value( \
+                            vm, \
+                            current_thread->priority);
+                    if (new_object == NULL)
+                    {
+                        VM_ERR_MALLOC(vm->r);
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail; 
+                    }
+                    if ((ret = virtual_machine_computing_stack_push(current_computing_stack, new_object)) != 0)
+                    {
+                        VM_ERR_INTERNAL(vm->r);
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail;
+                    }
+                    new_object = NULL;
+
+                    break;
+
+                case VM_INT_TIME_SLICE_SET:
+
+                    /* Set Minimum and Maximum Time Slice */
+
+                    /* Stack Top elements : minimum, maximum */
+                    if (current_computing_stack->size < 2)
+                    {
+                        vm_err_update(vm->r, -VM_ERR_COMPUTING_STACK_EMPTY, \
+                                "runtime error: computing stack empty");
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail;
+                    }
+                    for (i = 0; i != 2; i++)
+                    {
+                        if ((ret = virtual_machine_variable_solve(&new_object_solved, \
+                                        i == 0 ? current_computing_stack->top : current_computing_stack->top->prev, \
+                                        current_frame, 1, vm)) != 0)
+                        { goto fail; }
+                        if (new_object_solved->type != OBJECT_TYPE_INT)
+                        {
+                            vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                                    "runtime error: unsupported operand type");
+                            ret = -MULTIPLE_ERR_VM;
+                            goto fail; 
+                        }
+                        time_slice[i] = virtual_machine_object_int_get_primitive_value_saturated(new_object_solved);
+                        virtual_machine_object_destroy(vm, new_object_solved);
+                        new_object_solved = NULL;
+                    }
+                    if ((time_slice[0] < 1) || (time_slice[1] < time_slice[0]))
+                    {
+                        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                                "runtime error: invalid time slice %d to %d", time_slice[0], time_slice[1]);
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail; 
+                    }
+
+                    ret = virtual_machine_computing_stack_pop(vm, current_frame->computing_stack);
+                    if (ret != 0) { goto fail; }
+                    ret = virtual_machine_computing_stack_pop(vm, current_frame->computing_stack);
+                    if (ret != 0) { goto fail; }
+
+                    vm->time_slice = (size_t)time_slice[0];
+                    vm->time_slice_max = (size_t)time_slice[1];
+                    virtual_machine_thread_time_slice_reset(vm, current_thread);
+
+                    break;
+
+                case VM_INT_STATS:
+
+                    /* Statistics of GC and Memory */
+                    if ((ret = virtual_machine_stats_to_object(vm, &new_object)) != 0)
+                    { goto fail; }
+                    if ((ret = virtual_machine_computing_stack_push(current_computing_stack, new_object)) != 0)
+                    {
+                        VM_ERR_INTERNAL(vm->r);
+                        ret = -MULTIPLE_ERR_VM;
+                        goto fail;
+                    }
+                    new_object = NULL;
+
+                    break;
+
                 default:
                     /* Invalid interrupt number */
                     break;
@@ -29,6 +29,10 @@ enum
     VM_INT_EE_UNINSTALL = 5, /* Uninstall External Event */
     VM_INT_EE_WAIT = 6, /* Wait for External Event */
     VM_INT_DBG_START = 7, /* Start Debugging */
+    VM_INT_THREAD_PRIORITY_SET = 8, /* Set Priority of Current Thread */
+    VM_INT_THREAD_PRIORITY_GET = 9, /* Get Priority of Current Thread */
+    VM_INT_TIME_SLICE_SET = 10, /* Set Minimum and Maximum Time Slice */
+    VM_INT_STATS = 11, /* Statistics of GC and Memory */
 };
 
 int virtual_machine_interrupt(struct virtual_machine *vm);
@@ -85,16 +85,7 @@ static int virtual_machine_thread_step_thread_message(struct virtual_machine *vm
             }
 
             /* Search the target thread */
-            target_thread = vm->threads->begin;
-            while (target_thread != NULL)
-            {
-                if (target_thread->tid == target_tid)
-                {
-                    break;
-                }
-                target_thread = target_thread->next;
-            }
-
+            target_thread = virtual_machine_thread_list_lookup_by_tid(vm->threads, target_tid);
             if (target_thread == NULL)
             {
                 vm_err_update(vm->r, -VM_ERR_OBJECT_NOT_FOUND, \
@@ -109,6 +100,7 @@ static int virtual_machine_thread_step_thread_message(struct virtual_machine *vm
             if ((ret = virtual_machine_message_queue_push_with_configure(vm, target_thread->messages, new_object_message, current_thread->tid)) != 0)
             { goto fail; }
             new_object_message = NULL;
+            virtual_machine_thread_time_slice_reset(vm, target_thread);
 
             /* Pop the top 2 element */
             ret = virtual_machine_computing_stack_pop(vm, current_computing_stack);
@@ -366,7 +358,7 @@ static int virtual_machine_thread_step_thread_semaphore(struct virtual_machine *
                 ret = -MULTIPLE_ERR_VM;
                 goto fail;
             }
-            value = virtual_machine_object_int_get_primitive_value(new_object);
+            value = virtual_machine_object_int_get_primitive_value_saturated(new_object);
             virtual_machine_object_destroy(vm, new_object);
 
             /* Pop the top 1 element */
@@ -526,12 +518,8 @@ int virtual_machine_thread_step_thread(struct virtual_machine *vm)
             new_thread->running_stack->top->pc++;
 
             /* Append the thread into thread list */
-            if ((ret = virtual_machine_thread_list_append(vm->threads, new_thread)) != 0)
-            {
-                VM_ERR_INTERNAL(vm->r);
-                ret = -MULTIPLE_ERR_VM;
-                goto fail;
-            }
+            if ((ret = virtual_machine_thread_list_append(vm, vm->threads, new_thread)) != 0)
+            { goto fail; }
 
             /* Return child thread id to parent thread */
             if ((new_object = virtual_machine_object_thread_new_with_tid(vm, new_thread->tid)) == NULL)
@@ -586,9 +574,10 @@ int virtual_machine_thread_step_thread(struct virtual_machine *vm)
                         vm->threads, \
                         ((struct virtual_machine_object_thread *)(new_object->ptr))->tid) != 0)
             {
-                /* Exists, should wait for it */
-                /* Skip to next thread */
-                if (vm->tp->next != NULL) { vm->tp = vm->tp->next; }
+                /* Exists, should wait for it, 
+                 * sleep until it exits and execute this instrument again */
+                virtual_machine_thread_list_wait_tid(vm, vm->threads, current_thread, \
+                        ((struct virtual_machine_object_thread *)(new_object->ptr))->tid);
             }
             else
             {
@@ -729,6 +718,9 @@ int virtual_machine_thread_step_thread(struct virtual_machine *vm)
 
         case OP_TYIELD:
 
+            /* Give up the rest of time slice */
+            vm->yielded = 1;
+
             /* Update PC */
             current_thread->running_stack->top->pc++;
             break;
@@ -64,6 +64,7 @@ enum
     VM_ERR_NO_AVALIABLE_MODULE,
     VM_ERR_DATA_TYPE,
     VM_ERR_DLCALL,
+    VM_ERR_OUT_OF_MEMORY,
 };
 
 #define VM_ERR_PATHNAME_LEN 256
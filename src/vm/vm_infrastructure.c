@@ -37,6 +37,9 @@
 #include "vm_object_aio.h"
 #include "vm_err.h"
 #include "vm_dynlib.h"
+#include "vm_block_cache.h"
+#include "vm_prof.h"
+#include "vm_sampler.h"
 
 #include "gc.h"
 
@@ -231,6 +234,7 @@ struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_
     new_stack_frame->trap_pc = 0;
     new_stack_frame->trap_enabled = 0;
     new_stack_frame->next = new_stack_frame->prev = NULL;
+    new_stack_frame->generator_next = NULL;
     goto done;
 fail:
     if (new_stack_frame != NULL)
@@ -314,8 +318,12 @@ static struct virtual_machine_running_stack_frame *virtual_machine_running_stack
     while (generator_cur != NULL)
     {
         new_generator = virtual_machine_running_stack_frame_clone(vm, generator_cur);
-        if (new_generator != NULL) goto fail;
-        virtual_machine_running_stack_frame_list_append(new_frame->generators, new_generator);
+        if (new_generator == NULL) goto fail;
+        if (virtual_machine_running_stack_frame_list_append_generator(vm, new_frame->generators, new_generator) != 0)
+        {
+            virtual_machine_running_stack_frame_destroy(vm, new_generator);
+            goto fail;
+        }
         new_generator = NULL;
         generator_cur = generator_cur->next;
     }
@@ -335,19 +343,51 @@ fail:
     return NULL;
 }
 
-struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_new_with_configure(struct virtual_machine *vm, \
+/* Empty the frame for reusing, the sub-structures are kept */
+static int virtual_machine_running_stack_frame_clear(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack_frame *stack_frame)
+{
+    int ret = 0;
+    struct virtual_machine_variable *variable_cur, *variable_next;
+
+    if ((ret = virtual_machine_computing_stack_clear(vm, stack_frame->computing_stack)) != 0)
+    { return ret; }
+    if ((ret = virtual_machine_computing_stack_clear(vm, stack_frame->arguments)) != 0)
+    { return ret; }
+
+    variable_cur = stack_frame->variables->begin;
+    while (variable_cur != NULL)
+    {
+        variable_next = variable_cur->next;
+        virtual_machine_variable_destroy(vm, variable_cur);
+        variable_cur = variable_next;
+    }
+    stack_frame->variables->begin = stack_frame->variables->end = NULL;
+    stack_frame->variables->size = 0;
+
+    virtual_machine_running_stack_frame_list_clear(vm, stack_frame->generators);
+
+    if (stack_frame->environment_entrance != NULL)
+    {
+        virtual_machine_object_destroy(vm, stack_frame->environment_entrance);
+        stack_frame->environment_entrance = NULL;
+    }
+    stack_frame->next = stack_frame->prev = NULL;
+
+    return 0;
+}
+
+static int virtual_machine_running_stack_frame_configure(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack_frame *new_stack_frame, \
         struct virtual_machine_module *module, uint32_t pc, \
         size_t args_count, int closure, uint32_t trap_pc, int trap_enabled, \
         struct virtual_machine_object *environment_entrance, \
         struct virtual_machine_variable_list *variables)
 {
     int ret = 0;
-    struct virtual_machine_running_stack_frame *new_stack_frame = NULL;
     struct virtual_machine_variable *variable_cur = NULL, *new_variable = NULL;
     char *bad_type_name;
 
-    if ((new_stack_frame = virtual_machine_running_stack_frame_new(vm)) == NULL)
-    { goto fail; }
     new_stack_frame->module = module;
     new_stack_frame->pc_start = pc;
     new_stack_frame->pc = pc;
@@ -365,7 +405,7 @@ struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_
                     "runtime error: unsupported operand type, " \
                     "\'%s\'",  
                     ret == 0 ? bad_type_name : "undefined type");
-            goto fail;
+            return -MULTIPLE_ERR_VM;
         }
         new_stack_frame->environment_entrance = virtual_machine_object_clone(vm, environment_entrance);
     }
@@ -373,7 +413,7 @@ struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_
     {
         new_stack_frame->environment_entrance = virtual_machine_object_environment_entrance_make_blank(vm);
     }
-    if (new_stack_frame->environment_entrance == NULL) { goto fail; }
+    if (new_stack_frame->environment_entrance == NULL) { return -MULTIPLE_ERR_MALLOC; }
 
     if (variables != NULL)
     {
@@ -381,38 +421,114 @@ struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_
         while (variable_cur != NULL)
         {
             new_variable = virtual_machine_variable_clone(vm, variable_cur);
-            if (new_variable == NULL) goto fail;
-            ret = virtual_machine_variable_list_append(new_stack_frame->variables, new_variable);
-            if (ret != 0) goto fail;
-            new_variable = NULL;
+            if (new_variable == NULL) return -MULTIPLE_ERR_MALLOC;
+            if ((ret = virtual_machine_variable_list_append(new_stack_frame->variables, new_variable)) != 0)
+            {
+                virtual_machine_variable_destroy(vm, new_variable);
+                return ret;
+            }
 
             variable_cur = variable_cur->next;
         }
     }
 
+    return 0;
+}
+
+struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_new_with_configure(struct virtual_machine *vm, \
+        struct virtual_machine_module *module, uint32_t pc, \
+        size_t args_count, int closure, uint32_t trap_pc, int trap_enabled, \
+        struct virtual_machine_object *environment_entrance, \
+        struct virtual_machine_variable_list *variables)
+{
+    struct virtual_machine_running_stack_frame *new_stack_frame = NULL;
+
+    if ((new_stack_frame = virtual_machine_running_stack_frame_new(vm)) == NULL)
+    { goto fail; }
+    if (virtual_machine_running_stack_frame_configure(vm, new_stack_frame, \
+                module, pc, args_count, closure, trap_pc, trap_enabled, \
+                environment_entrance, variables) != 0)
+    { goto fail; }
+
     goto done;
 fail:
-    if (new_stack_frame != NULL)  virtual_machine_running_stack_frame_destroy(vm, new_stack_frame);
+    if (new_stack_frame != NULL)
+    {
+        virtual_machine_running_stack_frame_destroy(vm, new_stack_frame);
+        new_stack_frame = NULL;
+    }
 done:
     return new_stack_frame;
 }
 
+static size_t virtual_machine_generator_hash(struct virtual_machine_module *module, uint32_t pc_start)
+{
+    return ((size_t)module >> 4) ^ ((size_t)pc_start * 2654435761U);
+}
+
+/* Link the generator at the end of its bucket, 
+ * the first one suspended is found first as before */
+static void virtual_machine_generator_bucket_append(struct virtual_machine_running_stack_frame_list *list, \
+        struct virtual_machine_running_stack_frame *generator_frame)
+{
+    struct virtual_machine_running_stack_frame **slot;
+
+    slot = list->buckets + (virtual_machine_generator_hash(generator_frame->module, generator_frame->pc_start) & \
+            (list->buckets_size - 1));
+    while (*slot != NULL) slot = &((*slot)->generator_next);
+    *slot = generator_frame;
+    generator_frame->generator_next = NULL;
+}
+
+static int virtual_machine_generator_buckets_grow(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack_frame_list *list)
+{
+    struct virtual_machine_running_stack_frame **new_buckets;
+    struct virtual_machine_running_stack_frame *frame_cur;
+    size_t new_buckets_size;
+
+    new_buckets_size = (list->buckets_size == 0) ? VIRTUAL_MACHINE_GENERATOR_BUCKETS_INIT : list->buckets_size * 2;
+    if ((new_buckets = (struct virtual_machine_running_stack_frame **)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_running_stack_frame *) * new_buckets_size)) == NULL)
+    { return -MULTIPLE_ERR_MALLOC; }
+    memset(new_buckets, 0, sizeof(struct virtual_machine_running_stack_frame *) * new_buckets_size);
+
+    if (list->buckets != NULL) virtual_machine_resource_free(vm->resource, list->buckets);
+    list->buckets = new_buckets;
+    list->buckets_size = new_buckets_size;
+
+    /* Relink in the order suspended */
+    frame_cur = list->begin;
+    while (frame_cur != NULL)
+    {
+        virtual_machine_generator_bucket_append(list, frame_cur);
+        frame_cur = frame_cur->next;
+    }
+
+    return 0;
+}
+
 struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_get_generator(struct virtual_machine_running_stack_frame *current_frame, \
         struct virtual_machine_module *module, \
         uint32_t generator_pc)
 {
+    struct virtual_machine_running_stack_frame_list *generators;
     struct virtual_machine_running_stack_frame *frame_cur;
 
     if (current_frame == NULL) return NULL;
 
-    frame_cur = current_frame->generators->begin;
+    generators = current_frame->generators;
+    if (generators->size == 0) return NULL;
+
+    frame_cur = generators->buckets[virtual_machine_generator_hash(module, generator_pc) & \
+        (generators->buckets_size - 1)];
     while (frame_cur != NULL)
     {
         if ((frame_cur->module == module) && (frame_cur->pc_start == generator_pc))
         {
             return frame_cur;
         }
-        frame_cur = frame_cur->next;
+        frame_cur = frame_cur->generator_next;
     }
 
     return NULL;
@@ -853,6 +969,8 @@ struct virtual_machine_running_stack_frame_list *virtual_machine_running_stack_f
     }
     new_stack_frame_list->begin = new_stack_frame_list->end = NULL;
     new_stack_frame_list->size = 0;
+    new_stack_frame_list->buckets = NULL;
+    new_stack_frame_list->buckets_size = 0;
     return new_stack_frame_list;
 }
 
@@ -868,10 +986,34 @@ int virtual_machine_running_stack_frame_list_destroy(struct virtual_machine *vm,
         virtual_machine_running_stack_frame_destroy(vm, frame_cur);
         frame_cur = frame_next;
     }
+    if (list->buckets != NULL) virtual_machine_resource_free(vm->resource, list->buckets);
     virtual_machine_resource_free(vm->resource, list);
     return 0;
 }
 
+/* Destroy the frames, the buckets are kept */
+int virtual_machine_running_stack_frame_list_clear(struct virtual_machine *vm, struct virtual_machine_running_stack_frame_list *list)
+{
+    struct virtual_machine_running_stack_frame *frame_cur, *frame_next;
+
+    if (list == NULL) return -MULTIPLE_ERR_NULL_PTR;
+    if (list->size == 0) return 0;
+    frame_cur = list->begin;
+    while (frame_cur != NULL)
+    {
+        frame_next = frame_cur->next;
+        virtual_machine_running_stack_frame_destroy(vm, frame_cur);
+        frame_cur = frame_next;
+    }
+    list->begin = list->end = NULL;
+    list->size = 0;
+    if (list->buckets != NULL)
+    {
+        memset(list->buckets, 0, sizeof(struct virtual_machine_running_stack_frame *) * list->buckets_size);
+    }
+    return 0;
+}
+
 int virtual_machine_running_stack_frame_list_append(struct virtual_machine_running_stack_frame_list *stack_frame_list, \
         struct virtual_machine_running_stack_frame *new_frame)
 {
@@ -891,6 +1033,46 @@ int virtual_machine_running_stack_frame_list_append(struct virtual_machine_runni
     return 0;
 }
 
+int virtual_machine_running_stack_frame_list_append_generator(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack_frame_list *list, \
+        struct virtual_machine_running_stack_frame *generator_frame)
+{
+    int ret;
+
+    if (list->size + 1 > list->buckets_size)
+    {
+        if ((ret = virtual_machine_generator_buckets_grow(vm, list)) != 0)
+        { return ret; }
+    }
+    virtual_machine_running_stack_frame_list_append(list, generator_frame);
+    virtual_machine_generator_bucket_append(list, generator_frame);
+
+    return 0;
+}
+
+int virtual_machine_running_stack_frame_list_remove_generator( \
+        struct virtual_machine_running_stack_frame_list *list, \
+        struct virtual_machine_running_stack_frame *generator_frame)
+{
+    struct virtual_machine_running_stack_frame **slot;
+
+    slot = list->buckets + (virtual_machine_generator_hash(generator_frame->module, generator_frame->pc_start) & \
+            (list->buckets_size - 1));
+    while ((*slot != NULL) && (*slot != generator_frame)) slot = &((*slot)->generator_next);
+    if (*slot == NULL) return -MULTIPLE_ERR_NULL_PTR;
+    *slot = generator_frame->generator_next;
+
+    if (generator_frame->prev != NULL) generator_frame->prev->next = generator_frame->next;
+    else list->begin = generator_frame->next;
+    if (generator_frame->next != NULL) generator_frame->next->prev = generator_frame->prev;
+    else list->end = generator_frame->prev;
+    list->size -= 1;
+    generator_frame->next = generator_frame->prev = NULL;
+    generator_frame->generator_next = NULL;
+
+    return 0;
+}
+
 struct virtual_machine_variable_list *virtual_machine_variable_list_clone(struct virtual_machine *vm, \
         struct virtual_machine_variable_list *variable_list)
 {
@@ -1329,6 +1511,8 @@ struct virtual_machine_running_stack *virtual_machine_running_stack_new(struct v
     }
     new_stack->bottom = new_stack->top = NULL;
     new_stack->size = 0;
+    new_stack->pool = NULL;
+    new_stack->pool_size = 0;
     return new_stack;
 }
 
@@ -1344,10 +1528,37 @@ int virtual_machine_running_stack_destroy(struct virtual_machine *vm, struct vir
         virtual_machine_running_stack_frame_destroy(vm, frame_cur);
         frame_cur = frame_next;
     }
+    frame_cur = stack->pool;
+    while (frame_cur != NULL)
+    {
+        frame_next = frame_cur->next;
+        virtual_machine_running_stack_frame_destroy(vm, frame_cur);
+        frame_cur = frame_next;
+    }
     virtual_machine_resource_free(vm->resource, stack);
     return 0;
 }
 
+/* Keep the frame in the pool of the stack if there is room */
+static int virtual_machine_running_stack_frame_recycle(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack *stack, \
+        struct virtual_machine_running_stack_frame *stack_frame)
+{
+    int ret = 0;
+
+    if ((stack->pool_size == VIRTUAL_MACHINE_RUNNING_STACK_POOL_MAX) || \
+            ((ret = virtual_machine_running_stack_frame_clear(vm, stack_frame)) != 0))
+    {
+        virtual_machine_running_stack_frame_destroy(vm, stack_frame);
+        return ret;
+    }
+    stack_frame->next = stack->pool;
+    stack->pool = stack_frame;
+    stack->pool_size++;
+
+    return 0;
+}
+
 int virtual_machine_running_stack_push(struct virtual_machine_running_stack *stack, \
         struct virtual_machine_running_stack_frame *new_frame)
 {
@@ -1382,7 +1593,7 @@ int virtual_machine_running_stack_pop(struct virtual_machine *vm, struct virtual
         return -MULTIPLE_ERR_VM;
     }
     new_top = stack->top->prev;
-    if ((ret = virtual_machine_running_stack_frame_destroy(vm, stack->top)) != 0)
+    if ((ret = virtual_machine_running_stack_frame_recycle(vm, stack, stack->top)) != 0)
     {
         return ret;
     }
@@ -1411,13 +1622,23 @@ int virtual_machine_running_stack_push_with_configure(struct virtual_machine *vm
 
     if (stack == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
-    if ((new_frame = virtual_machine_running_stack_frame_new_with_configure(vm, \
+    /* Reuse a frame returned before */
+    if (stack->pool != NULL)
+    {
+        new_frame = stack->pool;
+        stack->pool = new_frame->next;
+        stack->pool_size--;
+        new_frame->next = NULL;
+    }
+    else if ((new_frame = virtual_machine_running_stack_frame_new(vm)) == NULL)
+    { ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+
+    if ((ret = virtual_machine_running_stack_frame_configure(vm, new_frame, \
                     module, pc, args_count, closure, \
                     trap_pc, trap_enabled, \
                     environment_entrance, \
-                    variables)) == NULL) 
-    { ret = -MULTIPLE_ERR_MALLOC; goto fail; }
-
+                    variables)) != 0) 
+    { goto fail; }
 
     if ((ret = virtual_machine_running_stack_push(stack, new_frame)) != 0)
     { goto fail; }
@@ -1425,7 +1646,7 @@ int virtual_machine_running_stack_push_with_configure(struct virtual_machine *vm
     ret = 0;
     goto done;
 fail:
-    if (new_frame != NULL) virtual_machine_running_stack_frame_destroy(vm, new_frame);
+    if (new_frame != NULL) virtual_machine_running_stack_frame_recycle(vm, stack, new_frame);
 done:
     return ret;
 }
@@ -1445,7 +1666,7 @@ int virtual_machine_running_stack_lift_merge(struct virtual_machine *vm, struct
     }
     else if (stack->size == 2)
     {
-        virtual_machine_running_stack_frame_destroy(vm, stack->top->prev);
+        virtual_machine_running_stack_frame_recycle(vm, stack, stack->top->prev);
         stack->bottom = stack->top;
         stack->top->prev = NULL;
         stack->size = 1;
@@ -1455,7 +1676,7 @@ int virtual_machine_running_stack_lift_merge(struct virtual_machine *vm, struct
         prev_frame = stack->top->prev;
         prev_frame->prev->next = stack->top;
         stack->top->prev = prev_frame->prev;
-        virtual_machine_running_stack_frame_destroy(vm, prev_frame);
+        virtual_machine_running_stack_frame_recycle(vm, stack, prev_frame);
         stack->size -= 1;
     }
 fail:
@@ -1618,13 +1839,21 @@ struct virtual_machine_thread *virtual_machine_thread_new(struct virtual_machine
     { return NULL; }
 
     new_thread->next = new_thread->prev = NULL;
+    new_thread->queue_next = new_thread->queue_prev = NULL;
+    new_thread->waiters.begin = new_thread->waiters.end = NULL;
+    new_thread->waiters.size = 0;
+    new_thread->wait_tid = 0;
     new_thread->zombie = 0;
+    new_thread->detached = 0;
+    new_thread->priority = vm->priority;
+    new_thread->time_slice = vm->time_slice;
     new_thread->state = VIRTUAL_MACHINE_THREAD_STATE_NORMAL;
     new_thread->type = VIRTUAL_MACHINE_THREAD_TYPE_NORMAL;
     new_thread->tid = 0;
     new_thread->continuations = NULL;
     new_thread->messages = NULL;
     new_thread->running_stack = NULL;
+    new_thread->pinned = NULL;
     if ((new_thread->messages = virtual_machine_message_queue_new(vm)) == NULL)
     { goto fail; }
     if ((new_thread->running_stack = virtual_machine_running_stack_new(vm)) == NULL)
@@ -1648,11 +1877,32 @@ int virtual_machine_thread_destroy(struct virtual_machine *vm, struct virtual_ma
     if (thread->continuations != NULL) continuation_list_destroy(vm, thread->continuations);
     if (thread->running_stack != NULL) virtual_machine_running_stack_destroy(vm, thread->running_stack);
     if (thread->messages != NULL) virtual_machine_message_queue_destroy(vm, thread->messages);
+    if (thread->pinned != NULL) virtual_machine_computing_stack_destroy(vm, thread->pinned);
     virtual_machine_resource_free(vm->resource, thread);
 
     return 0;
 }
 
+int virtual_machine_thread_pin(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread, struct virtual_machine_object *object)
+{
+    if (thread->pinned == NULL)
+    {
+        if ((thread->pinned = virtual_machine_computing_stack_new(vm)) == NULL)
+        { return -MULTIPLE_ERR_MALLOC; }
+    }
+
+    return virtual_machine_computing_stack_push(thread->pinned, object);
+}
+
+int virtual_machine_thread_unpin(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread)
+{
+    if (thread->pinned == NULL) return 0;
+
+    return virtual_machine_computing_stack_clear(vm, thread->pinned);
+}
+
 struct virtual_machine_thread *virtual_machine_thread_clone(struct virtual_machine *vm, struct virtual_machine_thread *thread)
 {
     int ret = 0;
@@ -1667,7 +1917,9 @@ struct virtual_machine_thread *virtual_machine_thread_clone(struct virtual_machi
     new_thread->zombie = thread->zombie;
     new_thread->state = thread->state;
     new_thread->type = thread->type;
+    new_thread->priority = thread->priority;
     new_thread->tid = thread->tid;
+    new_thread->wait_tid = thread->wait_tid;
 
     stack_frame_cur = thread->running_stack->bottom;
     while (stack_frame_cur != NULL)
@@ -1725,9 +1977,27 @@ done:
     return new_thread;
 }
 
+/* Used up the whole time slice, give it a longer one next time */
+int virtual_machine_thread_time_slice_grow(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread)
+{
+    thread->time_slice <<= 1;
+    if (thread->time_slice > vm->time_slice_max) thread->time_slice = vm->time_slice_max;
+    return 0;
+}
+
+/* Woken up or messaged, switch back soon after handling it */
+int virtual_machine_thread_time_slice_reset(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread)
+{
+    thread->time_slice = vm->time_slice;
+    return 0;
+}
+
 struct virtual_machine_thread_list *virtual_machine_thread_list_new(struct virtual_machine *vm)
 {
     struct virtual_machine_thread_list *new_list = NULL;
+    int type, priority;
 
     if ((new_list = (struct virtual_machine_thread_list *)virtual_machine_resource_malloc( \
                     vm->resource, sizeof(struct virtual_machine_thread_list))) == NULL)
@@ -1736,13 +2006,79 @@ struct virtual_machine_thread_list *virtual_machine_thread_list_new(struct virtu
     }
     new_list->begin = new_list->end = NULL;
     new_list->size = 0;
-    new_list->tid_pool = 0;
+    new_list->slots = NULL;
+    new_list->slots_capacity = 0;
+    new_list->slots_used = 0;
+    new_list->slot_free = VIRTUAL_MACHINE_THREAD_SLOT_NONE;
+    for (type = 0; type != VIRTUAL_MACHINE_THREAD_TYPE_COUNT; type++)
+    {
+        for (priority = 0; priority != VIRTUAL_MACHINE_THREAD_PRIORITY_COUNT; priority++)
+        {
+            new_list->runnable[type][priority].begin = new_list->runnable[type][priority].end = NULL;
+            new_list->runnable[type][priority].size = 0;
+        }
+    }
+    new_list->starving = 0;
     return new_list;
 }
 
+static void virtual_machine_thread_queue_push( \
+        struct virtual_machine_thread_queue *queue, \
+        struct virtual_machine_thread *thread)
+{
+    thread->queue_next = NULL;
+    thread->queue_prev = queue->end;
+    if (queue->begin == NULL)
+    { queue->begin = thread; }
+    else
+    { queue->end->queue_next = thread; }
+    queue->end = thread;
+    queue->size++;
+}
+
+static void virtual_machine_thread_queue_remove( \
+        struct virtual_machine_thread_queue *queue, \
+        struct virtual_machine_thread *thread)
+{
+    if (thread->queue_prev != NULL)
+    { thread->queue_prev->queue_next = thread->queue_next; }
+    else
+    { queue->begin = thread->queue_next; }
+    if (thread->queue_next != NULL)
+    { thread->queue_next->queue_prev = thread->queue_prev; }
+    else
+    { queue->end = thread->queue_prev; }
+    thread->queue_next = thread->queue_prev = NULL;
+    queue->size--;
+}
+
+/* The queue a thread stays in for its state */
+static struct virtual_machine_thread_queue *virtual_machine_thread_list_queue_of( \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread)
+{
+    struct virtual_machine_thread *thread_target;
+
+    if (thread->detached != 0) return NULL;
+
+    switch (thread->state)
+    {
+        case VIRTUAL_MACHINE_THREAD_STATE_NORMAL:
+            return &list->runnable[thread->type][thread->priority];
+        case VIRTUAL_MACHINE_THREAD_STATE_WAITING:
+            /* The waited thread wakes up all its waiters before exiting, 
+             * so it always exists here */
+            thread_target = virtual_machine_thread_list_lookup_by_tid(list, thread->wait_tid);
+            return (thread_target != NULL) ? &thread_target->waiters : NULL;
+        default:
+            return NULL;
+    }
+}
+
 int virtual_machine_thread_list_clear(struct virtual_machine *vm, struct virtual_machine_thread_list *list)
 {
     struct virtual_machine_thread *thread_cur, *thread_next;
+    int type, priority;
+
     if (list == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
     thread_cur = list->begin;
@@ -1755,6 +2091,23 @@ int virtual_machine_thread_list_clear(struct virtual_machine *vm, struct virtual
 
     list->begin = list->end = NULL;
     list->size = 0;
+    if (list->slots != NULL)
+    {
+        virtual_machine_resource_free(vm->resource, list->slots);
+        list->slots = NULL;
+    }
+    list->slots_capacity = 0;
+    list->slots_used = 0;
+    list->slot_free = VIRTUAL_MACHINE_THREAD_SLOT_NONE;
+    for (type = 0; type != VIRTUAL_MACHINE_THREAD_TYPE_COUNT; type++)
+    {
+        for (priority = 0; priority != VIRTUAL_MACHINE_THREAD_PRIORITY_COUNT; priority++)
+        {
+            list->runnable[type][priority].begin = list->runnable[type][priority].end = NULL;
+            list->runnable[type][priority].size = 0;
+        }
+    }
+    list->starving = 0;
 
     return 0;
 }
@@ -1768,7 +2121,9 @@ int virtual_machine_thread_list_print(struct virtual_machine *vm)
     thread_cur = vm->threads->begin;
     while (thread_cur != NULL)
     {
-        printf("%u (%s)", (unsigned int)thread_cur->tid, thread_cur->state == VIRTUAL_MACHINE_THREAD_STATE_NORMAL ? "normal" : "suspend");
+        printf("%u (%s)", (unsigned int)thread_cur->tid, \
+                thread_cur->state == VIRTUAL_MACHINE_THREAD_STATE_NORMAL ? "normal" : \
+                (thread_cur->state == VIRTUAL_MACHINE_THREAD_STATE_WAITING ? "wait" : "suspend"));
         thread_cur = thread_cur->next;
     }
     printf("\n");
@@ -1784,12 +2139,82 @@ int virtual_machine_thread_list_destroy(struct virtual_machine *vm, struct virtu
     return 0;
 }
 
-int virtual_machine_thread_list_append(struct virtual_machine_thread_list *list, struct virtual_machine_thread *new_thread)
+/* Take a free slot and assign the thread id */
+static int virtual_machine_thread_list_slot_alloc(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread)
+{
+    struct virtual_machine_thread_slot *new_slots;
+    uint32_t new_capacity;
+    uint32_t idx;
+
+    if (list->slot_free != VIRTUAL_MACHINE_THREAD_SLOT_NONE)
+    {
+        idx = list->slot_free;
+        list->slot_free = list->slots[idx].next_free;
+    }
+    else
+    {
+        if (list->slots_used == list->slots_capacity)
+        {
+            if (list->slots_capacity == VIRTUAL_MACHINE_THREAD_SLOT_MAX)
+            {
+                vm_err_update(vm->r, -VM_ERR_INTERNAL, \
+                        "runtime error: too many threads, at most %u threads", \
+                        VIRTUAL_MACHINE_THREAD_SLOT_MAX);
+                return -MULTIPLE_ERR_VM;
+            }
+            new_capacity = (list->slots_capacity == 0) ? \
+                           VIRTUAL_MACHINE_THREAD_SLOTS_INIT : list->slots_capacity * 2;
+            if ((new_slots = (struct virtual_machine_thread_slot *)virtual_machine_resource_malloc( \
+                            vm->resource, sizeof(struct virtual_machine_thread_slot) * new_capacity)) == NULL)
+            {
+                VM_ERR_MALLOC(vm->r);
+                return -MULTIPLE_ERR_VM;
+            }
+            if (list->slots != NULL)
+            {
+                memcpy(new_slots, list->slots, sizeof(struct virtual_machine_thread_slot) * list->slots_used);
+                virtual_machine_resource_free(vm->resource, list->slots);
+            }
+            list->slots = new_slots;
+            list->slots_capacity = new_capacity;
+        }
+        idx = list->slots_used++;
+        list->slots[idx].generation = 0;
+    }
+
+    list->slots[idx].thread = thread;
+    list->slots[idx].next_free = VIRTUAL_MACHINE_THREAD_SLOT_NONE;
+    thread->tid = (list->slots[idx].generation << VIRTUAL_MACHINE_THREAD_SLOT_BITS) | idx;
+
+    return 0;
+}
+
+/* Release the slot, the old thread id never matches again */
+static void virtual_machine_thread_list_slot_free( \
+        struct virtual_machine_thread_list *list, uint32_t tid)
 {
+    uint32_t idx = tid & VIRTUAL_MACHINE_THREAD_SLOT_MASK;
+
+    list->slots[idx].thread = NULL;
+    list->slots[idx].generation++;
+    /* Out of generations, never hand the slot out again */
+    if (list->slots[idx].generation == VIRTUAL_MACHINE_THREAD_GENERATION_MAX) return;
+    list->slots[idx].next_free = list->slot_free;
+    list->slot_free = idx;
+}
+
+int virtual_machine_thread_list_append(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *new_thread)
+{
+    int ret;
+    struct virtual_machine_thread_queue *queue;
+
     if (list == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
     /* Assign with new thread id */
-    new_thread->tid = list->tid_pool++;
+    if ((ret = virtual_machine_thread_list_slot_alloc(vm, list, new_thread)) != 0)
+    { return ret; }
 
     if (list->begin == NULL)
     {
@@ -1802,6 +2227,10 @@ int virtual_machine_thread_list_append(struct virtual_machine_thread_list *list,
         list->end = new_thread;
     }
     list->size++;
+
+    if ((queue = virtual_machine_thread_list_queue_of(list, new_thread)) != NULL)
+    { virtual_machine_thread_queue_push(queue, new_thread); }
+
     return 0;
 }
 
@@ -1821,7 +2250,7 @@ int virtual_machine_thread_list_append_with_configure(struct virtual_machine *vm
         goto fail;
     }
 
-    if ((ret = virtual_machine_thread_list_append(list, new_thread)) != 0)
+    if ((ret = virtual_machine_thread_list_append(vm, list, new_thread)) != 0)
     { goto fail; }
 
     ret = 0;
@@ -1835,89 +2264,156 @@ done:
 
 int virtual_machine_thread_list_remove(struct virtual_machine *vm, struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread)
 {
-    struct virtual_machine_thread *thread_cur = NULL;
+    struct virtual_machine_thread_queue *queue;
 
-    thread_cur = list->begin;
-    while (thread_cur != NULL)
-    {
-        if (thread_cur == thread)
-        {
-            if (thread_cur->prev != NULL)
-            { thread_cur->prev->next = thread_cur->next; }
-            else
-            { list->begin = thread_cur->next; }
-            if (thread_cur->next != NULL)
-            { thread_cur->next->prev = thread_cur->prev; }
-            else
-            { list->end = thread_cur->prev; }
-            list->size--;
-            virtual_machine_thread_destroy(vm, thread_cur);
+    if (virtual_machine_thread_list_lookup_by_tid(list, thread->tid) != thread) return 0;
 
-            return 0;
-        }
-        thread_cur = thread_cur->next;
+    if (thread->prev != NULL)
+    { thread->prev->next = thread->next; }
+    else
+    { list->begin = thread->next; }
+    if (thread->next != NULL)
+    { thread->next->prev = thread->prev; }
+    else
+    { list->end = thread->prev; }
+    list->size--;
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_remove(queue, thread); }
+
+    /* Wake up the threads waiting for this one */
+    while (thread->waiters.begin != NULL)
+    {
+        virtual_machine_thread_list_set_state(vm, list, thread->waiters.begin, \
+                VIRTUAL_MACHINE_THREAD_STATE_NORMAL);
     }
+
+    virtual_machine_thread_list_slot_free(list, thread->tid);
+    virtual_machine_thread_destroy(vm, thread);
+
     return 0;
 }
 
 int virtual_machine_thread_list_remove_by_tid(struct virtual_machine *vm, \
         struct virtual_machine_thread_list *list, uint32_t tid)
 {
-    struct virtual_machine_thread *thread_cur = NULL;
+    struct virtual_machine_thread *thread_target;
 
-    thread_cur = list->begin;
-    while (thread_cur != NULL)
+    if ((thread_target = virtual_machine_thread_list_lookup_by_tid(list, tid)) == NULL)
     {
-        if (thread_cur->tid == tid)
-        {
-            virtual_machine_thread_list_remove(vm, list, thread_cur);
-            return 0;
-        }
-        thread_cur = thread_cur->next;
+        vm_err_update(vm->r, -VM_ERR_OBJECT_NOT_FOUND, \
+                "runtime error: thread which id is %u doesn't exist", tid);
+        return -MULTIPLE_ERR_VM;
     }
 
-    vm_err_update(vm->r, -VM_ERR_OBJECT_NOT_FOUND, \
-            "runtime error: thread which id is %u doesn't exist", tid);
-    return -MULTIPLE_ERR_VM;
+    return virtual_machine_thread_list_remove(vm, list, thread_target);
 }
 
-int virtual_machine_thread_list_set_state_by_tid(struct virtual_machine *vm, \
-        struct virtual_machine_thread_list *list, uint32_t tid, int state)
+int virtual_machine_thread_list_set_state(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, int state)
 {
-    struct virtual_machine_thread *thread_cur = NULL;
+    struct virtual_machine_thread_queue *queue;
 
-    thread_cur = list->begin;
-    while (thread_cur != NULL)
+    if (thread->state == state) return 0;
+
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_remove(queue, thread); }
+    thread->state = state;
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_push(queue, thread); }
+
+    if (state == VIRTUAL_MACHINE_THREAD_STATE_NORMAL)
     {
-        if (thread_cur->tid == tid)
-        {
-            thread_cur->state = state;
-            return 0;
-        }
-        thread_cur = thread_cur->next;
+        virtual_machine_thread_time_slice_reset(vm, thread);
+        virtual_machine_scheduler_wake(vm);
     }
 
-    vm_err_update(vm->r, -VM_ERR_OBJECT_NOT_FOUND, \
-            "runtime error: thread which id is %u doesn't exist", tid);
-    return -MULTIPLE_ERR_VM;
+    return 0;
 }
 
-int virtual_machine_thread_list_is_tid_exists(struct virtual_machine_thread_list *list, uint32_t tid)
+int virtual_machine_thread_list_set_state_by_tid(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, uint32_t tid, int state)
 {
-    struct virtual_machine_thread *thread_cur = NULL;
+    struct virtual_machine_thread *thread_target;
 
-    thread_cur = list->begin;
-    while (thread_cur != NULL)
+    if ((thread_target = virtual_machine_thread_list_lookup_by_tid(list, tid)) == NULL)
     {
-        if (thread_cur->tid == tid)
-        {
-            return 1;
-        }
-        thread_cur = thread_cur->next; 
+        vm_err_update(vm->r, -VM_ERR_OBJECT_NOT_FOUND, \
+                "runtime error: thread which id is %u doesn't exist", tid);
+        return -MULTIPLE_ERR_VM;
     }
+
+    return virtual_machine_thread_list_set_state(vm, list, thread_target, state);
+}
+
+int virtual_machine_thread_list_set_type( \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, int type)
+{
+    struct virtual_machine_thread_queue *queue;
+
+    if (thread->type == type) return 0;
+
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_remove(queue, thread); }
+    thread->type = type;
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_push(queue, thread); }
+
+    return 0;
+}
+
+int virtual_machine_thread_list_set_priority( \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, int priority)
+{
+    struct virtual_machine_thread_queue *queue;
+
+    if (thread->priority == priority) return 0;
+
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_remove(queue, thread); }
+    thread->priority = priority;
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_push(queue, thread); }
+
+    return 0;
+}
+
+/* Put the thread into sleep until the thread with the specified id exits */
+int virtual_machine_thread_list_wait_tid(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, uint32_t tid)
+{
+    struct virtual_machine_thread *thread_target;
+    struct virtual_machine_thread_queue *queue;
+
+    (void)vm;
+
+    if ((thread_target = virtual_machine_thread_list_lookup_by_tid(list, tid)) == NULL) return 0;
+
+    if ((queue = virtual_machine_thread_list_queue_of(list, thread)) != NULL)
+    { virtual_machine_thread_queue_remove(queue, thread); }
+    thread->state = VIRTUAL_MACHINE_THREAD_STATE_WAITING;
+    thread->wait_tid = tid;
+    virtual_machine_thread_queue_push(&thread_target->waiters, thread);
+
     return 0;
 }
 
+struct virtual_machine_thread *virtual_machine_thread_list_lookup_by_tid( \
+        struct virtual_machine_thread_list *list, uint32_t tid)
+{
+    struct virtual_machine_thread *thread_target;
+    uint32_t idx = tid & VIRTUAL_MACHINE_THREAD_SLOT_MASK;
+
+    if (idx >= list->slots_used) return NULL;
+    thread_target = list->slots[idx].thread;
+    if ((thread_target == NULL) || (thread_target->tid != tid)) return NULL;
+
+    return thread_target;
+}
+
+int virtual_machine_thread_list_is_tid_exists(struct virtual_machine_thread_list *list, uint32_t tid)
+{
+    return (virtual_machine_thread_list_lookup_by_tid(list, tid) != NULL) ? 1 : 0;
+}
 
 /* Mutex */
 
@@ -2352,12 +2848,17 @@ struct virtual_machine_semaphore_list *virtual_machine_semaphore_list_new(struct
     new_semaphore_list->size = 0;
     new_semaphore_list->semaphore_id_pool = 0;
     new_semaphore_list->confirm_terminated = 0;
+    new_semaphore_list->woken_threads = NULL;
+    if ((new_semaphore_list->woken_threads = virtual_machine_semaphore_thread_queue_new(vm)) == NULL)
+    { goto fail; }
     thread_mutex_init(&new_semaphore_list->lock);
 
     goto done;
 fail:
     if (new_semaphore_list != NULL)
     {
+        if (new_semaphore_list->woken_threads != NULL)
+        { virtual_machine_semaphore_thread_queue_destroy(vm, new_semaphore_list->woken_threads); }
         virtual_machine_resource_free(vm->resource, new_semaphore_list);
         new_semaphore_list = NULL;
     }
@@ -2376,6 +2877,7 @@ int virtual_machine_semaphore_list_destroy(struct virtual_machine *vm, struct vi
         virtual_machine_semaphore_destroy(vm, semaphore_cur);
         semaphore_cur = semaphore_next;
     }
+    virtual_machine_semaphore_thread_queue_destroy(vm, list->woken_threads);
     thread_mutex_uninit(&list->lock);
     virtual_machine_resource_free(vm->resource, list);
 
@@ -2506,7 +3008,8 @@ int virtual_machine_semaphore_list_try_p( \
                         vm, \
                         semaphore_cur->suspended_threads, \
                         vm_thread);
-                vm_thread->state = VIRTUAL_MACHINE_THREAD_STATE_SUSPENDED;
+                virtual_machine_thread_list_set_state(vm, vm->threads, vm_thread, \
+                        VIRTUAL_MACHINE_THREAD_STATE_SUSPENDED);
 
                 /* Unlock and return BUSY */
                 thread_mutex_unlock(&list->lock);
@@ -2600,7 +3103,7 @@ int virtual_machine_semaphore_list_v( \
     struct virtual_machine_semaphore *semaphore_cur;
     int thread_type;
     int *ptr_channel;
-    struct virtual_machine_thread *ptr_thread;
+    struct virtual_machine_semaphore_thread_queue_item *item_woken;
 
     thread_mutex_lock(&list->lock);
 
@@ -2623,10 +3126,23 @@ int virtual_machine_semaphore_list_v( \
                         break;
 
                     case VIRTUAL_MACHINE_SEMAPHORE_THREAD_QUEUE_ITEM_TYPE_VM:
-                        ptr_thread = virtual_machine_semaphore_thread_queue_pop( \
-                                vm, \
-                                semaphore_cur->suspended_threads);
-                        ptr_thread->state = VIRTUAL_MACHINE_THREAD_STATE_NORMAL;
+                        /* V could be performed by a native thread without GIL, 
+                         * hand the thread over to the scheduler */
+                        item_woken = semaphore_cur->suspended_threads->begin;
+                        semaphore_cur->suspended_threads->begin = item_woken->next;
+                        if (semaphore_cur->suspended_threads->begin == NULL) 
+                        { semaphore_cur->suspended_threads->end = NULL; }
+                        semaphore_cur->suspended_threads->size -= 1;
+
+                        item_woken->next = NULL;
+                        if (list->woken_threads->begin == NULL)
+                        { list->woken_threads->begin = item_woken; }
+                        else
+                        { list->woken_threads->end->next = item_woken; }
+                        list->woken_threads->end = item_woken;
+                        list->woken_threads->size += 1;
+
+                        virtual_machine_scheduler_wake(vm);
                         break;
 
                     case VIRTUAL_MACHINE_SEMAPHORE_THREAD_QUEUE_ITEM_TYPE_NATIVE:
@@ -2656,6 +3172,29 @@ int virtual_machine_semaphore_list_v( \
     return VIRTUAL_MACHINE_SEMAPHORE_NO_FOUND;
 }
 
+/* Resume the threads woken up by V operation (With GIL) */
+int virtual_machine_semaphore_list_resume_woken( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_semaphore_list *list)
+{
+    struct virtual_machine_thread *ptr_thread;
+
+    /* The queue is filled by the waking side with the lock held, 
+     * so it is only looked at with the lock held as well */
+    thread_mutex_lock(&list->lock);
+    while (list->woken_threads->size != 0)
+    {
+        ptr_thread = virtual_machine_semaphore_thread_queue_pop( \
+                vm, \
+                list->woken_threads);
+        virtual_machine_thread_list_set_state(vm, vm->threads, ptr_thread, \
+                VIRTUAL_MACHINE_THREAD_STATE_NORMAL);
+    }
+    thread_mutex_unlock(&list->lock);
+
+    return 0;
+}
+
 
 /* Program Loading */
 
@@ -2723,6 +3262,7 @@ struct virtual_machine_text_section *virtual_machine_text_section_new(struct vir
         virtual_machine_resource_free(vm->resource, new_virtual_machine_text_section);
         return NULL;
     }
+    new_virtual_machine_text_section->block_cache = NULL;
     return new_virtual_machine_text_section;
 }
 
@@ -2731,6 +3271,7 @@ int virtual_machine_text_section_destroy(struct virtual_machine *vm, struct virt
     if (text_section == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
     if (text_section->instruments != NULL) virtual_machine_resource_free(vm->resource, text_section->instruments);
+    if (text_section->block_cache != NULL) virtual_machine_block_cache_section_destroy(vm, text_section->block_cache);
     virtual_machine_resource_free(vm->resource, text_section);
     return 0;
 }
@@ -3188,6 +3729,8 @@ int virtual_machine_external_event_list_raise( \
 
     external_event_target->raised += 1;
 
+    virtual_machine_scheduler_wake(vm);
+
     return 0;
 }
 
@@ -3374,6 +3917,7 @@ int virtual_machine_interrupt_init(struct virtual_machine *vm);
 struct virtual_machine *virtual_machine_new(struct virtual_machine_startup *startup, struct vm_err *r)
 {
     struct virtual_machine *new_vm = NULL;
+    int idx;
 
     if ((new_vm = (struct virtual_machine *)malloc( \
                     sizeof(struct virtual_machine))) == NULL)
@@ -3385,7 +3929,39 @@ struct virtual_machine *virtual_machine_new(struct virtual_machine_startup *star
     new_vm->keep_dll = 0;
     new_vm->tp = NULL;
     new_vm->step_in_time_slice = 0;
-    new_vm->time_slice = TIME_SLICE_DEFAULT;
+    new_vm->time_slice = startup->time_slice;
+    new_vm->time_slice_max = startup->time_slice_max;
+    new_vm->yielded = 0;
+    new_vm->priority = startup->priority;
+    new_vm->gc_interval = GC_INTERVAL_DEFAULT;
+    new_vm->step_since_gc = 0;
+    new_vm->gc_slice_work = startup->gc_slice_work;
+    new_vm->gc_slice_us = startup->gc_slice_us;
+    new_vm->gc_threads = startup->gc_threads;
+    new_vm->gc_concurrent_sweep = startup->gc_concurrent_sweep;
+    new_vm->gc_generational = startup->gc_generational;
+    new_vm->gc_eden_limit = startup->gc_eden;
+    new_vm->gc_promote_age = startup->gc_promote_age;
+    new_vm->gc_old_growth = startup->gc_old_growth;
+    new_vm->gc_old_limit = startup->gc_eden;
+    new_vm->stats = startup->stats;
+    new_vm->stats_json = startup->stats_json;
+    new_vm->optimize = startup->optimize;
+    new_vm->optimize_stats.before = new_vm->optimize_stats.after = 0;
+    new_vm->optimize_stats.folded = new_vm->optimize_stats.threaded = 0;
+    new_vm->optimize_stats.paired = new_vm->optimize_stats.unreachable = 0;
+    for (idx = 0; idx != OP_FUSED_COUNT; idx++)
+    { new_vm->fused[idx] = new_vm->fused_executed[idx] = 0; }
+    new_vm->block_cache = startup->block_cache;
+    new_vm->block_cache_stats.blocks = 0;
+    new_vm->block_cache_stats.instruments = 0;
+    new_vm->block_cache_stats.runs = new_vm->block_cache_stats.exits = 0;
+    new_vm->block_cache_stats.unboxed = new_vm->block_cache_stats.guards = 0;
+    new_vm->prof = NULL;
+    new_vm->prof_print = startup->prof;
+    new_vm->prof_json = startup->prof_json;
+    new_vm->sampler = NULL;
+    new_vm->sample = startup->sample;
     new_vm->stack_size = STACK_SIZE_DEFAULT + STACK_SIZE_RESERVED;
     new_vm->threads = NULL;
     new_vm->variables_global = NULL;
@@ -3400,11 +3976,17 @@ struct virtual_machine *virtual_machine_new(struct virtual_machine_startup *star
     new_vm->debugger = NULL;
     new_vm->debug_mode = 0;
     new_vm->debug_info = 0;
-    thread_mutex_init(&new_vm->gil);
+    new_vm->workers_count = startup->workers;
+    new_vm->workers_exit = 0;
+    new_vm->native_sections = 0;
+    thread_lock_init(&new_vm->gil);
+    if (thread_event_init(&new_vm->idle_event) != 0) goto fail;
+    if (thread_event_init(&new_vm->spare_event) != 0) goto fail;
     virtual_machine_interrupt_init(new_vm);
     /* Resource */
     if ((new_vm->gc_stub = gc_stub_new()) == NULL) goto fail;
     if ((new_vm->resource = virtual_machine_resource_new(startup)) == NULL) goto fail;
+    new_vm->resource->r = r;
     if ((new_vm->modules = virtual_machine_module_list_new(new_vm)) == NULL) goto fail;
     if ((new_vm->shared_libraries = virtual_machine_shared_library_list_new(new_vm)) == NULL) goto fail;
     if ((new_vm->threads = virtual_machine_thread_list_new(new_vm)) == NULL) goto fail;
@@ -3416,6 +3998,14 @@ struct virtual_machine *virtual_machine_new(struct virtual_machine_startup *star
     if ((new_vm->mutexes = virtual_machine_mutex_list_new(new_vm)) == NULL) goto fail;
     if ((new_vm->semaphores = virtual_machine_semaphore_list_new(new_vm)) == NULL) goto fail;
     if ((new_vm->debugger = virtual_machine_debugger_new()) == NULL) goto fail;
+    if ((new_vm->prof_print != 0) || (new_vm->prof_json != NULL))
+    {
+        if ((new_vm->prof = virtual_machine_prof_new()) == NULL) goto fail;
+    }
+    if (new_vm->sample != NULL)
+    {
+        if ((new_vm->sampler = virtual_machine_sampler_new((unsigned int)startup->sample_interval)) == NULL) goto fail;
+    }
     goto done;
 fail:
     if (new_vm != NULL)
@@ -3431,6 +4021,8 @@ fail:
         if (new_vm->data_types != NULL) virtual_machine_data_type_list_destroy(new_vm, new_vm->data_types);
         if (new_vm->resource != NULL) virtual_machine_resource_destroy(new_vm->resource);
         if (new_vm->debugger != NULL) virtual_machine_debugger_destroy(new_vm->debugger);
+        if (new_vm->prof != NULL) virtual_machine_prof_destroy(new_vm->prof);
+        if (new_vm->sampler != NULL) virtual_machine_sampler_destroy(new_vm->sampler);
         free(new_vm);
         new_vm = NULL;
     }
@@ -3482,7 +4074,11 @@ int virtual_machine_destroy(struct virtual_machine *vm, int error_occurred)
 
     if (vm->shared_libraries != NULL) virtual_machine_shared_library_list_destroy(vm, vm->shared_libraries);
     if (vm->debugger != NULL) virtual_machine_debugger_destroy(vm->debugger);
-    thread_mutex_uninit(&vm->gil);
+    if (vm->prof != NULL) virtual_machine_prof_destroy(vm->prof);
+    if (vm->sampler != NULL) virtual_machine_sampler_destroy(vm->sampler);
+    thread_lock_uninit(&vm->gil);
+    thread_event_uninit(&vm->idle_event);
+    thread_event_uninit(&vm->spare_event);
 
     free(vm);
 
@@ -3511,13 +4107,89 @@ int virtual_machine_interrupt_gc_disable(struct virtual_machine *vm)
 /* GIL */
 int virtual_machine_gil_lock(struct virtual_machine *vm)
 {
-    thread_mutex_lock(&vm->gil);
+    thread_lock_lock(&vm->gil);
     return 0;
 }
 
 int virtual_machine_gil_unlock(struct virtual_machine *vm)
 {
-    thread_mutex_unlock(&vm->gil);
+    thread_lock_unlock(&vm->gil);
+    return 0;
+}
+
+
+/* Scheduler */
+
+/* Tell the scheduler some thread may become runnable, 
+ * the spare workers are only told while they could run it */
+int virtual_machine_scheduler_wake(struct virtual_machine *vm)
+{
+    thread_event_signal(&vm->idle_event);
+    if (vm->native_sections != 0) thread_event_signal(&vm->spare_event);
+    return 0;
+}
+
+/* Sleep until woken up (Without GIL) */
+int virtual_machine_scheduler_idle(struct virtual_machine *vm)
+{
+    return thread_event_wait(&vm->idle_event, VIRTUAL_MACHINE_IDLE_TIMEOUT);
+}
+
+/* Sleep of a spare worker (Without GIL) */
+int virtual_machine_scheduler_spare_idle(struct virtual_machine *vm)
+{
+    return thread_event_wait(&vm->spare_event, VIRTUAL_MACHINE_IDLE_TIMEOUT);
+}
+
+
+/* Native Section */
+
+/* Take current thread out of scheduling and release GIL */
+struct virtual_machine_native_section *virtual_machine_native_section_enter(struct virtual_machine *vm)
+{
+    struct virtual_machine_native_section *new_section = NULL;
+    struct virtual_machine_thread_queue *queue;
+
+    if ((new_section = (struct virtual_machine_native_section *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_native_section))) == NULL)
+    { return NULL; }
+    new_section->tp = vm->tp;
+    new_section->step_in_time_slice = vm->step_in_time_slice;
+    new_section->locked = vm->locked;
+
+    /* Nobody else should pick the thread up */
+    if ((queue = virtual_machine_thread_list_queue_of(vm->threads, vm->tp)) != NULL)
+    { virtual_machine_thread_queue_remove(queue, vm->tp); }
+    vm->tp->detached = 1;
+    vm->tp = NULL;
+    vm->locked = 0;
+    vm->native_sections++;
+
+    thread_lock_unlock(&vm->gil);
+    /* Let a spare worker take over */
+    thread_event_signal(&vm->spare_event);
+
+    return new_section;
+}
+
+/* Acquire GIL and continue the thread */
+int virtual_machine_native_section_leave(struct virtual_machine *vm, \
+        struct virtual_machine_native_section *section)
+{
+    struct virtual_machine_thread_queue *queue;
+
+    thread_lock_lock(&vm->gil);
+
+    vm->native_sections--;
+    vm->tp = section->tp;
+    vm->step_in_time_slice = section->step_in_time_slice;
+    vm->locked = section->locked;
+    vm->tp->detached = 0;
+    if ((queue = virtual_machine_thread_list_queue_of(vm->threads, vm->tp)) != NULL)
+    { virtual_machine_thread_queue_push(queue, vm->tp); }
+
+    virtual_machine_resource_free(vm->resource, section);
+
     return 0;
 }
 
@@ -4112,6 +4784,7 @@ struct virtual_machine_data_type *virtual_machine_data_type_new(
     new_data_type->func_print = NULL;
     new_data_type->func_destroy = NULL;
     new_data_type->func_eq = NULL;
+    new_data_type->shared = 0;
 
     new_data_type->name = (char *)malloc( \
             sizeof(char) * (len + 1));
@@ -24,7 +24,9 @@
 #include <stdarg.h>
 
 #include "multiple_ir.h"
+#include "multiple_ir_opt.h"
 #include "multiple_tunnel.h"
+#include "vm_opcode.h"
 #include "vm_res.h"
 #include "gc.h"
 
@@ -248,6 +250,9 @@ struct virtual_machine_running_stack_frame
 
     struct virtual_machine_running_stack_frame *next;
     struct virtual_machine_running_stack_frame *prev;
+
+    /* Next generator in the same bucket of the index */
+    struct virtual_machine_running_stack_frame *generator_next;
 };
 
 struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_new(struct virtual_machine *vm);
@@ -264,26 +269,51 @@ struct virtual_machine_running_stack_frame *virtual_machine_running_stack_frame_
         uint32_t generator_pc);
 
 
+#define VIRTUAL_MACHINE_GENERATOR_BUCKETS_INIT 8
+
 struct virtual_machine_running_stack_frame_list
 {
     struct virtual_machine_running_stack_frame *begin; 
     struct virtual_machine_running_stack_frame *end; 
     size_t size;
+
+    /* Generators indexed by module and pc_start, 
+     * allocated on the first one suspended */
+    struct virtual_machine_running_stack_frame **buckets;
+    size_t buckets_size;
 };
 
 struct virtual_machine_running_stack_frame_list *virtual_machine_running_stack_frame_list_new(struct virtual_machine *vm);
 int virtual_machine_running_stack_frame_list_destroy(struct virtual_machine *vm, \
         struct virtual_machine_running_stack_frame_list *list);
+int virtual_machine_running_stack_frame_list_clear(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack_frame_list *list);
 int virtual_machine_running_stack_frame_list_append( \
         struct virtual_machine_running_stack_frame_list *list, \
         struct virtual_machine_running_stack_frame *new_frame);
 
+/* Suspend a generator into the list of the frame which called it,
+ * and take it out for resuming */
+int virtual_machine_running_stack_frame_list_append_generator(struct virtual_machine *vm, \
+        struct virtual_machine_running_stack_frame_list *list, \
+        struct virtual_machine_running_stack_frame *generator_frame);
+int virtual_machine_running_stack_frame_list_remove_generator( \
+        struct virtual_machine_running_stack_frame_list *list, \
+        struct virtual_machine_running_stack_frame *generator_frame);
+
+
+/* Frames kept for reusing by calls after returned */
+#define VIRTUAL_MACHINE_RUNNING_STACK_POOL_MAX 64
 
 struct virtual_machine_running_stack
 {
     struct virtual_machine_running_stack_frame *bottom; 
     struct virtual_machine_running_stack_frame *top; 
     size_t size;
+
+    /* Returned frames emptied, linked by 'next' */
+    struct virtual_machine_running_stack_frame *pool;
+    size_t pool_size;
 };
 
 struct virtual_machine_running_stack *virtual_machine_running_stack_new(struct virtual_machine *vm);
@@ -345,12 +375,34 @@ enum
 {
     VIRTUAL_MACHINE_THREAD_STATE_NORMAL = 0, 
     VIRTUAL_MACHINE_THREAD_STATE_SUSPENDED = 1, 
+    VIRTUAL_MACHINE_THREAD_STATE_WAITING = 2, /* Waiting for another thread to exit */
 };
 enum 
 {
     VIRTUAL_MACHINE_THREAD_TYPE_NORMAL = 0, 
     VIRTUAL_MACHINE_THREAD_TYPE_DEBUGGER = 1, 
 };
+#define VIRTUAL_MACHINE_THREAD_TYPE_COUNT 2
+/* Threads of higher priority are scheduled first */
+enum 
+{
+    VIRTUAL_MACHINE_THREAD_PRIORITY_LOW = 0, 
+    VIRTUAL_MACHINE_THREAD_PRIORITY_NORMAL = 1, 
+    VIRTUAL_MACHINE_THREAD_PRIORITY_HIGH = 2, 
+};
+#define VIRTUAL_MACHINE_THREAD_PRIORITY_COUNT 3
+/* Lower priority gets a turn after this number of time slices 
+ * passed to busy higher priority threads */
+#define VIRTUAL_MACHINE_THREAD_PRIORITY_AGING 8
+
+struct virtual_machine_thread;
+struct virtual_machine_thread_queue
+{
+    struct virtual_machine_thread *begin;
+    struct virtual_machine_thread *end;
+    size_t size;
+};
+
 struct continuation_list;
 struct virtual_machine_thread
 {
@@ -369,9 +421,30 @@ struct virtual_machine_thread
     int state;
     int type;
     int zombie; /* for marking suicide */
+    int detached; /* Running native code without GIL, kept out of run queue */
+    int priority;
+
+    /* Adaptive time slice (number of instruments), 
+     * grows while the thread keeps using it up, 
+     * drops back to the minimum when the thread gets woken up or messaged */
+    size_t time_slice;
+
+    /* The thread id waiting for (VIRTUAL_MACHINE_THREAD_STATE_WAITING) */
+    uint32_t wait_tid;
 
     struct virtual_machine_thread *next;
     struct virtual_machine_thread *prev;
+
+    /* Run queue (normal state) or wait queue (waiting state) */
+    struct virtual_machine_thread *queue_next;
+    struct virtual_machine_thread *queue_prev;
+
+    /* Threads waiting for this thread to exit */
+    struct virtual_machine_thread_queue waiters;
+
+    /* Objects whose payloads are borrowed by the running native function, 
+     * kept alive even if it gives up GIL (Created on the first use) */
+    struct virtual_machine_computing_stack *pinned;
 };
 
 struct virtual_machine_thread *virtual_machine_thread_new(struct virtual_machine *vm);
@@ -384,25 +457,78 @@ struct virtual_machine_thread *virtual_machine_thread_new_with_configure(struct
         struct virtual_machine_module *module, uint32_t pc, \
         size_t args_count);
 
+/* Keep an object alive till the native function returns */
+int virtual_machine_thread_pin(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread, struct virtual_machine_object *object);
+/* Native function returned, release the objects pinned */
+int virtual_machine_thread_unpin(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread);
+
+/* Adaptive time slice */
+int virtual_machine_thread_time_slice_grow(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread);
+int virtual_machine_thread_time_slice_reset(struct virtual_machine *vm, \
+        struct virtual_machine_thread *thread);
 
-struct virtual_machine_thread_list
+
+/* Thread id is made of a slot index in the low bits and 
+ * the generation of the slot in the high bits, 
+ * an id stays invalid after the thread exits even if the slot is reused. 
+ * A slot whose generation runs out is retired rather than wrapped around, 
+ * so an old id never resolves to a newer thread */
+#define VIRTUAL_MACHINE_THREAD_SLOT_BITS 16
+#define VIRTUAL_MACHINE_THREAD_SLOT_MAX (1U << VIRTUAL_MACHINE_THREAD_SLOT_BITS)
+#define VIRTUAL_MACHINE_THREAD_SLOT_MASK (VIRTUAL_MACHINE_THREAD_SLOT_MAX - 1)
+#define VIRTUAL_MACHINE_THREAD_GENERATION_MAX ((1U << (32 - VIRTUAL_MACHINE_THREAD_SLOT_BITS)) - 1)
+#define VIRTUAL_MACHINE_THREAD_SLOT_NONE 0xFFFFFFFFU
+#define VIRTUAL_MACHINE_THREAD_SLOTS_INIT 16
+
+struct virtual_machine_thread_slot
 {
-    uint32_t tid_pool;
+    struct virtual_machine_thread *thread; /* NULL if free */
+    uint32_t generation;
+    uint32_t next_free;
+};
 
+struct virtual_machine_thread_list
+{
     struct virtual_machine_thread *begin;
     struct virtual_machine_thread *end;
     size_t size;
+
+    /* Thread id indexed table */
+    struct virtual_machine_thread_slot *slots;
+    uint32_t slots_capacity;
+    uint32_t slots_used;
+    uint32_t slot_free;
+
+    /* Threads could be scheduled (one queue for each thread type and priority), 
+     * suspended and waiting threads stay out of them */
+    struct virtual_machine_thread_queue runnable[VIRTUAL_MACHINE_THREAD_TYPE_COUNT][VIRTUAL_MACHINE_THREAD_PRIORITY_COUNT];
+    /* Time slices passed to higher priority while lower ones are runnable */
+    size_t starving;
 };
 
 struct virtual_machine_thread_list *virtual_machine_thread_list_new(struct virtual_machine *vm);
 int virtual_machine_thread_list_destroy(struct virtual_machine *vm, struct virtual_machine_thread_list *list);
 int virtual_machine_thread_list_print(struct virtual_machine *vm);
 int virtual_machine_thread_list_clear(struct virtual_machine *vm, struct virtual_machine_thread_list *list);
-int virtual_machine_thread_list_append(struct virtual_machine_thread_list *list, struct virtual_machine_thread *new_thread);
+int virtual_machine_thread_list_append(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *new_thread);
 int virtual_machine_thread_list_remove(struct virtual_machine *vm, struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread);
 int virtual_machine_thread_list_remove_by_tid(struct virtual_machine *vm, struct virtual_machine_thread_list *list, uint32_t tid);
+int virtual_machine_thread_list_set_state(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, int state);
 int virtual_machine_thread_list_set_state_by_tid(struct virtual_machine *vm, \
         struct virtual_machine_thread_list *list, uint32_t tid, int state);
+int virtual_machine_thread_list_set_type( \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, int type);
+int virtual_machine_thread_list_set_priority( \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, int priority);
+int virtual_machine_thread_list_wait_tid(struct virtual_machine *vm, \
+        struct virtual_machine_thread_list *list, struct virtual_machine_thread *thread, uint32_t tid);
+struct virtual_machine_thread *virtual_machine_thread_list_lookup_by_tid( \
+        struct virtual_machine_thread_list *list, uint32_t tid);
 int virtual_machine_thread_list_is_tid_exists(struct virtual_machine_thread_list *list, uint32_t tid);
 
 int virtual_machine_thread_list_append_with_configure(struct virtual_machine *vm, \
@@ -529,6 +655,10 @@ struct virtual_machine_semaphore_list
     int confirm_terminated;
     mutex_t lock;
 
+    /* Virtual machine threads woken up by V operation, 
+     * waiting for the scheduler to put them back into run queue */
+    struct virtual_machine_semaphore_thread_queue *woken_threads;
+
     struct virtual_machine_semaphore *begin;
     struct virtual_machine_semaphore *end;
     size_t size;
@@ -568,6 +698,11 @@ int virtual_machine_semaphore_list_v( \
         struct virtual_machine_semaphore_list *list, \
         uint32_t id);
 
+/* Resume the threads woken up by V operation (With GIL) */
+int virtual_machine_semaphore_list_resume_woken( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_semaphore_list *list);
+
 
 /* Virtual Machine */
 
@@ -598,12 +733,32 @@ struct virtual_machine_text_section_instrument
     uint32_t operand;
 
     uint32_t data_id;
+
+    /* OP_FUSED_*, the superinstrument starting here */
+    uint32_t fused;
+};
+
+/* What the block cache did */
+struct virtual_machine_block_cache_stats
+{
+    size_t blocks;
+    size_t instruments;
+    size_t runs;
+    size_t exits; /* runs left before the end of the block */
+    size_t unboxed; /* 'int' sequences done on the values */
+    size_t guards; /* 'int' sequences left to the interpreter */
 };
 
+struct virtual_machine_block_cache_section;
+struct virtual_machine_prof;
+struct virtual_machine_sampler;
 struct virtual_machine_text_section
 {
     struct virtual_machine_text_section_instrument *instruments;
     size_t size;
+
+    /* Entry counters and blocks decoded, NULL before the first entry */
+    struct virtual_machine_block_cache_section *block_cache;
 };
 
 struct virtual_machine_text_section *virtual_machine_text_section_new(struct virtual_machine *vm, size_t size);
@@ -659,6 +814,7 @@ int virtual_machine_source_section_destroy(struct virtual_machine *vm, struct vi
 
 #define TIME_SLICE_DEFAULT 100
 #define STACK_SIZE_DEFAULT 100
+#define GC_INTERVAL_DEFAULT 4096
 
 struct virtual_machine_data_type;
 struct virtual_machine_data_type_list;
@@ -819,9 +975,64 @@ struct virtual_machine
 
     /* Settings */
     /* Instrument number for every time executing 
-     * After hitting the limit, switch to the next thread */
+     * After hitting the limit, switch to the next thread 
+     * (the time slice of each thread adapts between the minimum and the maximum) */
     size_t time_slice; 
+    size_t time_slice_max;
     size_t step_in_time_slice;
+    int yielded; /* Current thread gave up the rest of its time slice */
+
+    /* Priority of threads not forked from another one */
+    int priority;
+
+    /* Instrument number between two checks for garbage collection, 
+     * independent from the time slice */
+    size_t gc_interval;
+    size_t step_since_gc;
+
+    /* Budget of a slice of incremental GC, both 0 for stop-the-world */
+    size_t gc_slice_work;
+    size_t gc_slice_us;
+
+    /* Threads marking a major GC, and the background sweeper */
+    size_t gc_threads;
+    int gc_concurrent_sweep;
+
+    /* Generational policy, minor GC when eden holds 'gc_eden_limit' items, 
+     * major GC when the old tables reach 'gc_old_limit' items */
+    int gc_generational;
+    size_t gc_eden_limit;
+    size_t gc_promote_age;
+    size_t gc_old_growth;
+    size_t gc_old_limit;
+
+    /* Statistics on exit, to stderr and to a JSON file (NULL for none) */
+    int stats;
+    const char *stats_json;
+
+    /* Level of the IR optimizer, and what it did to all the modules */
+    int optimize;
+    struct multiple_ir_opt_stats optimize_stats;
+
+    /* Superinstruments fused on loading, and the times they ran,
+     * indexed by OP_FUSED_* */
+    size_t fused[OP_FUSED_COUNT];
+    size_t fused_executed[OP_FUSED_COUNT];
+
+    /* Entries of an instrument before decoding the block starting 
+     * there, 0 for disabled */
+    size_t block_cache;
+    struct virtual_machine_block_cache_stats block_cache_stats;
+
+    /* Profile on exit, to stderr and to a JSON file (NULL for none),
+     * 'prof' is NULL when neither */
+    struct virtual_machine_prof *prof;
+    int prof_print;
+    const char *prof_json;
+
+    /* Folded stacks sampled, written on exit (NULL for none) */
+    struct virtual_machine_sampler *sampler;
+    const char *sample;
 
     size_t stack_size; /* Maximum number of running stack frames */
 
@@ -856,8 +1067,27 @@ struct virtual_machine
     /* Print Brief Debug Info */
     int debug_info;
 
-    /* Global Interpreter Lock */
-    mutex_t gil;
+    /* Global Interpreter Lock 
+     * Held by a worker for a whole time slice, 
+     * bytecode of the virtual machine never runs in parallel */
+    thread_lock_t gil;
+
+    /* Signalled when a thread may become runnable, 
+     * the scheduler sleeps on it when no thread is runnable */
+    thread_event_t idle_event;
+    /* The spare workers sleep on their own event, a wakeup taken by 
+     * one of them would otherwise be lost to the first worker */
+    thread_event_t spare_event;
+
+    /* OS threads running the scheduler, the first one is always active, 
+     * the spare ones only take over while some threads are inside native 
+     * sections and their OS threads are busy in native code 
+     * (Not an M:N scheduler, bytecode never runs on two of them at once) */
+    size_t workers_count;
+    volatile int workers_exit;
+    /* Threads inside native sections (Changed with GIL held, 
+     * read without it when waking the scheduler up) */
+    volatile size_t native_sections;
 
     uint32_t interrupt_enabled;
 };
@@ -878,6 +1108,28 @@ int virtual_machine_interrupt_gc_disable(struct virtual_machine *vm);
 int virtual_machine_gil_lock(struct virtual_machine *vm);
 int virtual_machine_gil_unlock(struct virtual_machine *vm);
 
+/* Scheduler */
+/* Maximum time (in milliseconds) sleeping without being woken up */
+#define VIRTUAL_MACHINE_IDLE_TIMEOUT 100
+int virtual_machine_scheduler_wake(struct virtual_machine *vm);
+int virtual_machine_scheduler_idle(struct virtual_machine *vm);
+int virtual_machine_scheduler_spare_idle(struct virtual_machine *vm);
+
+/* Native Section 
+ * Native code could give up GIL during a long operation, 
+ * a spare worker keeps running the other threads meanwhile. 
+ * Objects of virtual machine must not be touched inside the section, 
+ * which also makes it a safe point for garbage collection */
+struct virtual_machine_native_section
+{
+    struct virtual_machine_thread *tp;
+    size_t step_in_time_slice;
+    int locked;
+};
+struct virtual_machine_native_section *virtual_machine_native_section_enter(struct virtual_machine *vm);
+int virtual_machine_native_section_leave(struct virtual_machine *vm, \
+        struct virtual_machine_native_section *section);
+
 /* Utilities */
 
 #define LOOKUP_FOUND 1
@@ -1021,6 +1273,9 @@ struct virtual_machine_data_type
     int (*func_print)(const void *ptr);
     int (*func_eq)(const void *ptr_left, const void *ptr_right);
 
+    /* Objects share the payload instead of cloning it on every read */
+    int shared;
+
     struct virtual_machine_data_type *next;
 };
 
@@ -31,6 +31,7 @@
 #include "vm_types.h"
 #include "vm_infrastructure.h"
 #include "vm_object_aio.h"
+#include "vm_gc.h"
 
 #include "vm_err.h"
 
@@ -80,6 +81,8 @@ static struct virtual_machine_object_general_interface virtual_machine_object_ge
     DEF_INTERFACE(_symbol_),
     DEF_INTERFACE(_environment_),
     DEF_INTERFACE(_environment_entrance_),
+    DEF_INTERFACE(_buffer_),
+    DEF_INTERFACE(_bigint_),
 };
 #define VIRTUAL_MACHINE_OBJECT_GENERAL_INTERFACES_COUNT \
     sizeof(virtual_machine_object_general_interfaces)/sizeof(struct virtual_machine_object_general_interface)
@@ -295,6 +298,11 @@ int virtual_machine_object_size(struct virtual_machine *vm, \
         if ((ret = virtual_machine_object_hash_size(vm, object_out, object_src)) != 0)
         { goto fail; }
     }
+    else if (object_src->type == OBJECT_TYPE_BUFFER)
+    {
+        if ((ret = virtual_machine_object_buffer_size(vm, object_out, object_src)) != 0)
+        { goto fail; }
+    }
     else
     {
         virtual_machine_object_id_to_type_name(&type_name, NULL, object_src->type);
@@ -553,7 +561,9 @@ static struct virtual_machine_opcode_to_unary_func_tbl_item virtual_machine_opco
     {OP_NEG, OBJECT_TYPE_INT, 1, &virtual_machine_object_int_unary},
     {OP_NEG, OBJECT_TYPE_NAN, 1, &virtual_machine_object_nan_unary},
     {OP_NEG, OBJECT_TYPE_INF, 1, &virtual_machine_object_inf_unary},
+    {OP_NEG, OBJECT_TYPE_BIGINT, 1, &virtual_machine_object_bigint_unary},
     {OP_NOTA, OBJECT_TYPE_INT, 1, &virtual_machine_object_int_unary},
+    {OP_NOTA, OBJECT_TYPE_BIGINT, 1, &virtual_machine_object_bigint_unary},
     {OP_NOTL, OBJECT_TYPE_BOOL, 1, &virtual_machine_object_bool_unary},
 };
 
@@ -641,34 +651,45 @@ static int virtual_machine_object_generic_equality(struct virtual_machine *vm, \
 static struct virtual_machine_opcode_to_binary_func_tbl_item virtual_machine_opcode_to_binary_func_tbl_item[] =
 {
     {OP_ADD, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_ADD, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
     {OP_ADD, OBJECT_TYPE_STR, 1, 1, &virtual_machine_object_str_add},
     {OP_ADD, OBJECT_TYPE_FLOAT, 1, 1, &virtual_machine_object_float_binary_arithmetic},
 
     {OP_SUB, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_SUB, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
     {OP_SUB, OBJECT_TYPE_FLOAT, 1, 1, &virtual_machine_object_float_binary_arithmetic},
 
     {OP_MUL, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_MUL, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
     {OP_MUL, OBJECT_TYPE_STR, 1, 1, &virtual_machine_object_str_mul},
     {OP_MUL, OBJECT_TYPE_FLOAT, 1, 1, &virtual_machine_object_float_binary_arithmetic},
 
     {OP_DIV, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_DIV, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
     {OP_DIV, OBJECT_TYPE_FLOAT, 1, 1, &virtual_machine_object_float_binary_arithmetic},
 
     {OP_MOD, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_MOD, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
 
     {OP_LSHIFT, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_LSHIFT, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
 
     {OP_RSHIFT, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_RSHIFT, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
 
     {OP_ANDA, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_ANDA, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
     {OP_ORA, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_ORA, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
     {OP_XORA, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_arithmetic_shift_bitwise},
+    {OP_XORA, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_arithmetic_shift_bitwise},
 
     {OP_ANDL, OBJECT_TYPE_BOOL, 1, 1, &virtual_machine_object_bool_binary_logical},
     {OP_ORL, OBJECT_TYPE_BOOL, 1, 1, &virtual_machine_object_bool_binary_logical},
     {OP_XORL, OBJECT_TYPE_BOOL, 1, 1, &virtual_machine_object_bool_binary_logical},
 
     {OP_EQ, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_equality_relational},
+    {OP_EQ, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_equality_relational},
     {OP_EQ, OBJECT_TYPE_NONE, 1, 1, &virtual_machine_object_none_binary},
     {OP_EQ, OBJECT_TYPE_NAN, 1, 1, &virtual_machine_object_nan_binary},
     {OP_EQ, OBJECT_TYPE_INF, 1, 1, &virtual_machine_object_inf_binary},
@@ -685,6 +706,7 @@ static struct virtual_machine_opcode_to_binary_func_tbl_item virtual_machine_opc
     {OP_EQ, OBJECT_TYPE_CLASS, 1, 1, &virtual_machine_object_generic_equality},
 
     {OP_NE, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_equality_relational},
+    {OP_NE, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_equality_relational},
     {OP_NE, OBJECT_TYPE_NONE, 1, 1, &virtual_machine_object_none_binary},
     {OP_NE, OBJECT_TYPE_NAN, 1, 1, &virtual_machine_object_nan_binary},
     {OP_NE, OBJECT_TYPE_INF, 1, 1, &virtual_machine_object_inf_binary},
@@ -701,9 +723,13 @@ static struct virtual_machine_opcode_to_binary_func_tbl_item virtual_machine_opc
     {OP_NE, OBJECT_TYPE_CLASS, 1, 1, &virtual_machine_object_generic_equality},
 
     {OP_L, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_equality_relational},
+    {OP_L, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_equality_relational},
     {OP_G, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_equality_relational},
+    {OP_G, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_equality_relational},
     {OP_LE, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_equality_relational},
+    {OP_LE, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_equality_relational},
     {OP_GE, OBJECT_TYPE_INT, 1, 1, &virtual_machine_object_int_binary_equality_relational},
+    {OP_GE, OBJECT_TYPE_BIGINT, 1, 1, &virtual_machine_object_bigint_binary_equality_relational},
     {OP_L, OBJECT_TYPE_CHAR, 1, 1, &virtual_machine_object_char_binary_equality_relational},
     {OP_G, OBJECT_TYPE_CHAR, 1, 1, &virtual_machine_object_char_binary_equality_relational},
     {OP_LE, OBJECT_TYPE_CHAR, 1, 1, &virtual_machine_object_char_binary_equality_relational},
@@ -834,6 +860,11 @@ static struct virtual_machine_convert_tbl_item virtual_machine_convert_tbl_item[
     {OBJECT_TYPE_INT, OBJECT_TYPE_STR, &virtual_machine_object_int_convert},
     {OBJECT_TYPE_INT, OBJECT_TYPE_FLOAT, &virtual_machine_object_int_convert},
     {OBJECT_TYPE_INT, OBJECT_TYPE_CHAR, &virtual_machine_object_int_convert},
+    {OBJECT_TYPE_BIGINT, OBJECT_TYPE_BIGINT, &virtual_machine_object_bigint_convert},
+    {OBJECT_TYPE_BIGINT, OBJECT_TYPE_INT, &virtual_machine_object_bigint_convert},
+    {OBJECT_TYPE_BIGINT, OBJECT_TYPE_BOOL, &virtual_machine_object_bigint_convert},
+    {OBJECT_TYPE_BIGINT, OBJECT_TYPE_STR, &virtual_machine_object_bigint_convert},
+    {OBJECT_TYPE_BIGINT, OBJECT_TYPE_FLOAT, &virtual_machine_object_bigint_convert},
     {OBJECT_TYPE_FLOAT, OBJECT_TYPE_INT, &virtual_machine_object_float_convert},
     {OBJECT_TYPE_FLOAT, OBJECT_TYPE_BOOL, &virtual_machine_object_float_convert},
     {OBJECT_TYPE_FLOAT, OBJECT_TYPE_STR, &virtual_machine_object_float_convert},
@@ -920,6 +951,24 @@ done:
     return ret;
 }
 
+static int virtual_machine_object_type_upgrade_bigint_to_float( \
+        struct virtual_machine_object **object_dst, \
+        struct virtual_machine_object *object_src, \
+        struct virtual_machine *vm)
+{
+    struct virtual_machine_object *new_object = NULL;
+
+    new_object = virtual_machine_object_float_new_with_value(vm, virtual_machine_object_bigint_to_float(object_src));
+    if (new_object == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        return -MULTIPLE_ERR_VM;
+    }
+    *object_dst = new_object;
+
+    return 0;
+}
+
 struct virtual_machine_object_type_upgrade_convertion_matrix_item
 {
     uint32_t type_small;
@@ -932,6 +981,7 @@ static const struct virtual_machine_object_type_upgrade_convertion_matrix_item \
           virtual_machine_object_type_upgrade_convertion_matrix_items[] = 
 {
     { OBJECT_TYPE_INT, OBJECT_TYPE_FLOAT, &virtual_machine_object_type_upgrade_int_to_float },
+    { OBJECT_TYPE_BIGINT, OBJECT_TYPE_FLOAT, &virtual_machine_object_type_upgrade_bigint_to_float },
 };
 #define VIRTUAL_MACHINE_OBJECT_TYPE_UPGRADE_CONVERTION_MATRIX_ITEMS_COUNT \
     (sizeof(virtual_machine_object_type_upgrade_convertion_matrix_items)/sizeof(struct virtual_machine_object_type_upgrade_convertion_matrix_item))
@@ -968,6 +1018,7 @@ int virtual_machine_object_type_upgrade( \
             *object_out_right = object_src_right_converted;
             *object_out_left = object_src_left_solved;
             virtual_machine_object_destroy(vm, object_src_right_solved); object_src_right_solved = NULL;
+            break;
         }
         else if ((virtual_machine_object_type_upgrade_convertion_matrix_items[i].type_large == object_src_right_solved->type) && \
                 (virtual_machine_object_type_upgrade_convertion_matrix_items[i].type_small == object_src_left_solved->type))
@@ -977,6 +1028,7 @@ int virtual_machine_object_type_upgrade( \
             *object_out_left = object_src_left_converted;
             *object_out_right = object_src_right_solved;
             virtual_machine_object_destroy(vm, object_src_left_solved); object_src_left_solved = NULL;
+            break;
         }
     }
 
@@ -1012,6 +1064,8 @@ int objects_eq(const struct virtual_machine_object *object_left, const struct vi
     /*struct virtual_machine_object_func *object_function_left = NULL, *object_function_right = NULL;*/
     /* Symbol */
     struct virtual_machine_object_symbol *object_symbol_left = NULL, *object_symbol_right = NULL;
+    /* Big Integer */
+    struct virtual_machine_object_bigint *object_bigint_left = NULL, *object_bigint_right = NULL;
 
     /* Type Check */
     if (object_left->type != object_right->type)
@@ -1033,6 +1087,14 @@ int objects_eq(const struct virtual_machine_object *object_left, const struct vi
             return (((struct virtual_machine_object_int *)(object_left->ptr))->value == \
                     ((struct virtual_machine_object_int *)(object_right->ptr))->value) ? OBJECTS_EQ : OBJECTS_NE;
             break;
+        case OBJECT_TYPE_BIGINT:
+            object_bigint_left = object_left->ptr;
+            object_bigint_right = object_right->ptr;
+            return ((object_bigint_left->sign == object_bigint_right->sign) && \
+                    (object_bigint_left->size == object_bigint_right->size) && \
+                    (memcmp(object_bigint_left->digits, object_bigint_right->digits, \
+                            sizeof(uint32_t) * object_bigint_left->size) == 0)) ? OBJECTS_EQ : OBJECTS_NE;
+            break;
         case OBJECT_TYPE_CHAR:
             return (((struct virtual_machine_object_char *)(object_left->ptr))->value == \
                     ((struct virtual_machine_object_char *)(object_right->ptr))->value) ? OBJECTS_EQ : OBJECTS_NE;
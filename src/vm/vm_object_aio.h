@@ -50,6 +50,8 @@
 #include "vm_object_symbol.h"
 #include "vm_object_env.h"
 #include "vm_object_env_ent.h"
+#include "vm_object_buffer.h"
+#include "vm_object_bigint.h"
 
 #endif
 
@@ -29,6 +29,11 @@
 #include "vm_gc.h"
 #include "vm_err.h"
 
+#ifndef MAX
+#define MAX(a, b) ((a)>(b)?(a):(b))
+#endif
+#define VIRTUAL_MACHINE_OBJECT_ARRAY_CAPACITY_MINIMUM_REQUIRED 9
+
 
 /* Declarations */
 int virtual_machine_object_array_internal_destroy( \
@@ -40,6 +45,8 @@ int virtual_machine_object_array_internal_destroy( \
 int virtual_machine_object_array_internal_append(struct virtual_machine *vm, \
         struct virtual_machine_object_array_internal *object_array_internal, \
         struct virtual_machine_object *object_new_sub, int order);
+static int virtual_machine_object_array_internal_unshare(struct virtual_machine *vm, \
+        struct virtual_machine_object_array_internal *object_array_internal);
 
 
 /* Internal Marker */
@@ -47,9 +54,21 @@ int virtual_machine_object_array_internal_marker(void *object_internal)
 {
     struct virtual_machine_object_array_internal *object_array_internal = object_internal;
     struct virtual_machine_object_array_internal_node *object_array_internal_node;
-    size_t idx;
+    size_t idx, idx_begin, idx_end;
 
-    for (idx = object_array_internal->pos; idx != object_array_internal->pos + object_array_internal->size; idx++)
+    /* Elements out of the range of a slice still live in the shared buffer */
+    if (object_array_internal->shared != NULL)
+    {
+        idx_begin = object_array_internal->shared->pos;
+        idx_end = object_array_internal->shared->pos + object_array_internal->shared->size;
+    }
+    else
+    {
+        idx_begin = object_array_internal->pos;
+        idx_end = object_array_internal->pos + object_array_internal->size;
+    }
+
+    for (idx = idx_begin; idx != idx_end; idx++)
     {
         object_array_internal_node = object_array_internal->nodes + idx;
         virtual_machine_marks_object(object_array_internal_node->ptr, VIRTUAL_MACHINE_GARBAGE_COLLECT_MAJOR);
@@ -88,6 +107,7 @@ static struct virtual_machine_object_array_internal *virtual_machine_object_arra
     new_object_array_internal->size = count;
     new_object_array_internal->capacity = new_object_array_internal->size * 3;
     new_object_array_internal->pos = new_object_array_internal->size;
+    new_object_array_internal->shared = NULL;
     new_object_array_internal->nodes = NULL;
     new_object_array_internal->nodes = (struct virtual_machine_object_array_internal_node *)virtual_machine_resource_malloc( \
             vm->resource, sizeof(struct virtual_machine_object_array_internal_node) * new_object_array_internal->capacity);
@@ -122,11 +142,31 @@ int virtual_machine_object_array_internal_destroy( \
         struct virtual_machine_object_array_internal *object_array_internal)
 {
     struct virtual_machine_object *virtual_machine_object_array_node_object;
-    size_t idx;
+    struct virtual_machine_object_array_internal_shared *shared;
+    size_t idx, idx_begin, idx_end;
 
     if (object_array_internal == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
-    for (idx = object_array_internal->pos; idx != object_array_internal->pos + object_array_internal->size; idx++)
+    shared = object_array_internal->shared;
+    if (shared != NULL)
+    {
+        /* Others still using the buffer */
+        if (--shared->refcount != 0) 
+        {
+            virtual_machine_resource_free(vm->resource, object_array_internal);
+            return 0;
+        }
+        idx_begin = shared->pos;
+        idx_end = shared->pos + shared->size;
+        virtual_machine_resource_free(vm->resource, shared);
+    }
+    else
+    {
+        idx_begin = object_array_internal->pos;
+        idx_end = object_array_internal->pos + object_array_internal->size;
+    }
+
+    for (idx = idx_begin; idx != idx_end; idx++)
     {
         virtual_machine_object_array_node_object = object_array_internal->nodes[idx].ptr;
         virtual_machine_object_destroy(vm, virtual_machine_object_array_node_object);
@@ -139,37 +179,78 @@ int virtual_machine_object_array_internal_destroy( \
     return 0;
 }
 
-static struct virtual_machine_object_array_internal *virtual_machine_object_array_internal_clone(struct virtual_machine *vm, \
-        const struct virtual_machine_object_array_internal *object_array_internal)
+/* Get a private copy of the nodes before modifying a shared array */
+static int virtual_machine_object_array_internal_unshare(struct virtual_machine *vm, \
+        struct virtual_machine_object_array_internal *object_array_internal)
 {
-    struct vm_err r_local;
-    struct virtual_machine_object *new_sub_object = NULL;
-    struct virtual_machine_object_array_internal *new_object_array_internal = NULL;
+    int ret = 0;
+    struct virtual_machine_object_array_internal_shared *shared = object_array_internal->shared;
+    struct virtual_machine_object_array_internal_node *new_nodes = NULL;
+    size_t new_capacity = 0, new_pos;
     size_t idx;
 
-    if (object_array_internal == NULL) return NULL;
-
-    vm_err_clear(&r_local);
+    if (shared == NULL) return 0;
 
-    if ((new_object_array_internal = virtual_machine_object_array_internal_new(vm, object_array_internal->size)) == NULL)
-    { goto fail; }
-    new_object_array_internal->pos = object_array_internal->pos;
+    if (shared->refcount == 1)
+    {
+        /* The last one using the buffer, take it over */
+        for (idx = shared->pos; idx != shared->pos + shared->size; idx++)
+        {
+            if ((idx < object_array_internal->pos) || \
+                    (idx >= object_array_internal->pos + object_array_internal->size))
+            {
+                virtual_machine_object_destroy(vm, object_array_internal->nodes[idx].ptr);
+                object_array_internal->nodes[idx].ptr = NULL;
+            }
+        }
+        virtual_machine_resource_free(vm->resource, shared);
+        object_array_internal->shared = NULL;
+        goto done;
+    }
 
-    for (idx = object_array_internal->pos; idx != object_array_internal->pos + object_array_internal->size; idx++)
+    new_capacity = MAX(object_array_internal->size * 3, VIRTUAL_MACHINE_OBJECT_ARRAY_CAPACITY_MINIMUM_REQUIRED);
+    new_pos = new_capacity / 3;
+    new_nodes = (struct virtual_machine_object_array_internal_node *)virtual_machine_resource_malloc( \
+            vm->resource, sizeof(struct virtual_machine_object_array_internal_node) * new_capacity);
+    if (new_nodes == NULL)
     {
-        if ((new_sub_object = virtual_machine_object_clone(vm, object_array_internal->nodes[idx].ptr)) == NULL)
-        { goto fail; }
-        new_object_array_internal->nodes[idx].ptr = new_sub_object; new_sub_object = NULL;
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    for (idx = 0; idx != new_capacity; idx++)
+    {
+        new_nodes[idx].ptr = NULL;
     }
+    for (idx = 0; idx != object_array_internal->size; idx++)
+    {
+        if ((new_nodes[new_pos + idx].ptr = virtual_machine_object_clone(vm, \
+                        object_array_internal->nodes[object_array_internal->pos + idx].ptr)) == NULL)
+        {
+            VM_ERR_MALLOC(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+    }
+
+    shared->refcount -= 1;
+    object_array_internal->shared = NULL;
+    object_array_internal->nodes = new_nodes; new_nodes = NULL;
+    object_array_internal->pos = new_pos;
+    object_array_internal->capacity = new_capacity;
 
     goto done;
 fail:
-    if (new_sub_object != NULL) virtual_machine_object_destroy(vm, new_sub_object);
-    new_sub_object = NULL;
-    if (new_object_array_internal != NULL) virtual_machine_object_array_internal_destroy(vm, new_object_array_internal);
-    new_object_array_internal = NULL;
+    if (new_nodes != NULL)
+    {
+        for (idx = 0; idx != new_capacity; idx++)
+        {
+            if (new_nodes[idx].ptr != NULL) virtual_machine_object_destroy(vm, new_nodes[idx].ptr);
+        }
+        virtual_machine_resource_free(vm->resource, new_nodes);
+    }
 done:
-    return new_object_array_internal;
+    return ret;
 }
 
 static int virtual_machine_object_array_internal_print(const struct virtual_machine_object_array_internal *object_array_internal)
@@ -324,7 +405,6 @@ int virtual_machine_object_array_ref_get(struct virtual_machine *vm, \
     struct virtual_machine_object *object_src_solved= NULL;
     struct virtual_machine_object_array *object_src_solved_array = NULL;
     struct virtual_machine_object *object_idx_solved= NULL;
-    struct virtual_machine_object_int *object_ref_index = NULL;
     int ref_index;
 
     *object_out = NULL;
@@ -349,8 +429,7 @@ int virtual_machine_object_array_ref_get(struct virtual_machine *vm, \
         goto fail; 
     }
 
-    object_ref_index = (struct virtual_machine_object_int *)object_idx_solved->ptr;
-    ref_index = object_ref_index->value;
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
     object_src_solved_array = object_src_solved->ptr;
 
     if ((ret = _virtual_machine_object_array_internal_ref_get_by_raw_index(object_out, object_src_solved_array->ptr_internal, ref_index, vm)) != 0)
@@ -362,13 +441,11 @@ fail:
     return ret;
 }
 
-static int _virtual_machine_object_array_internal_ref_set_by_raw_index(const struct virtual_machine_object_array_internal *object_array_internal_src, \
+static int _virtual_machine_object_array_internal_ref_set_by_raw_index(struct virtual_machine_object_array_internal *object_array_internal_src, \
         int ref_index, const struct virtual_machine_object *object_value, struct virtual_machine *vm)
 {
     int ret = 0;
 
-    (void)vm;
-
     if (object_array_internal_src->size == 0) 
     {
         vm_err_update(vm->r, -VM_ERR_OUT_OF_BOUNDS, \
@@ -386,6 +463,10 @@ static int _virtual_machine_object_array_internal_ref_set_by_raw_index(const str
         goto fail; 
     }
 
+    /* Slices sharing the element should not see the change */
+    if ((ret = virtual_machine_object_array_internal_unshare(vm, object_array_internal_src)) != 0)
+    { goto fail; }
+
     if (object_array_internal_src->nodes[object_array_internal_src->pos + (size_t)ref_index].ptr != NULL)
     {
         virtual_machine_object_destroy(vm, \
@@ -416,7 +497,6 @@ int virtual_machine_object_array_ref_set(struct virtual_machine *vm, \
     struct virtual_machine_object_array *object_src_solved_array = NULL;
     struct virtual_machine_object *object_idx_solved= NULL;
     struct virtual_machine_object *object_value_solved = NULL;
-    struct virtual_machine_object_int *object_ref_index = NULL;
     int ref_index;
 
     *object_out = NULL;
@@ -443,10 +523,10 @@ int virtual_machine_object_array_ref_set(struct virtual_machine *vm, \
         goto fail; 
     }
 
-    object_ref_index = (struct virtual_machine_object_int *)object_idx_solved->ptr;
-    ref_index = object_ref_index->value;
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
 
     object_src_solved_array = object_src_solved->ptr;
+    gc_write_barrier(object_src_solved->object_table_item_ptr, object_value_solved->object_table_item_ptr);
     if ((ret = _virtual_machine_object_array_internal_ref_set_by_raw_index(object_src_solved_array->ptr_internal, ref_index, object_value_solved, vm)) != 0)
     { goto fail; }
 
@@ -490,120 +570,193 @@ fail:
     return ret;
 }
 
-static int virtual_machine_object_array_internal_cdr( \
+/* The result shares the node buffer with the source */
+static int virtual_machine_object_array_internal_slice( \
         struct virtual_machine *vm, \
         struct virtual_machine_object_array_internal **object_array_internal_out, \
-        const struct virtual_machine_object_array_internal *object_array_internal_src)
+        struct virtual_machine_object_array_internal *object_array_internal_src, \
+        size_t offset, size_t length)
 {
     int ret = 0;
-
     struct virtual_machine_object_array_internal *new_object_array_internal = NULL;
 
     *object_array_internal_out = NULL;
 
-    /* Element number checking */
-    if (object_array_internal_src->size == 0)
+    if ((offset > object_array_internal_src->size) || (length > object_array_internal_src->size - offset))
     {
-        vm_err_update(vm->r, -VM_ERR_EMPTY_LIST, \
-                "runtime error: empty array has no element");
+        vm_err_update(vm->r, -VM_ERR_OUT_OF_BOUNDS, \
+                "runtime error: out of bounds, slice of %u elements from \'%u\' isn't in bound of %u to %u", \
+                (unsigned int)length, (unsigned int)offset, 0, (unsigned int)object_array_internal_src->size);
         ret = -MULTIPLE_ERR_VM;
         goto fail;
     }
 
-    /* Complete clone the internal of original array */
-    if ((new_object_array_internal = virtual_machine_object_array_internal_clone(vm, object_array_internal_src)) == NULL)
+    if ((new_object_array_internal = (struct virtual_machine_object_array_internal *)virtual_machine_resource_malloc( \
+            vm->resource, sizeof(struct virtual_machine_object_array_internal))) == NULL)
     {
         VM_ERR_MALLOC(vm->r);
         ret = -MULTIPLE_ERR_VM;
         goto fail; 
     }
-    
-    if (new_object_array_internal->size != 0)
-    {
 
-        if ((ret = virtual_machine_object_destroy(vm, new_object_array_internal->nodes[new_object_array_internal->pos].ptr)) != 0) 
+    /* Start sharing */
+    if (object_array_internal_src->shared == NULL)
+    {
+        if ((object_array_internal_src->shared = (struct virtual_machine_object_array_internal_shared *)virtual_machine_resource_malloc( \
+                        vm->resource, sizeof(struct virtual_machine_object_array_internal_shared))) == NULL)
         {
-            VM_ERR_INTERNAL(vm->r);
+            VM_ERR_MALLOC(vm->r);
             ret = -MULTIPLE_ERR_VM;
             goto fail; 
         }
-        
-        new_object_array_internal->pos += 1;
-        new_object_array_internal->size -= 1;
+        object_array_internal_src->shared->pos = object_array_internal_src->pos;
+        object_array_internal_src->shared->size = object_array_internal_src->size;
+        object_array_internal_src->shared->refcount = 1;
     }
 
+    new_object_array_internal->nodes = object_array_internal_src->nodes;
+    new_object_array_internal->pos = object_array_internal_src->pos + offset;
+    new_object_array_internal->size = length;
+    new_object_array_internal->capacity = object_array_internal_src->capacity;
+    new_object_array_internal->shared = object_array_internal_src->shared;
+    new_object_array_internal->shared->refcount += 1;
+    new_object_array_internal->vm = vm;
+
     *object_array_internal_out = new_object_array_internal;
     new_object_array_internal = NULL;
 
     ret = 0;
 fail:
-    if (new_object_array_internal != NULL) virtual_machine_object_array_internal_destroy(vm, new_object_array_internal);
+    if (new_object_array_internal != NULL) virtual_machine_resource_free(vm->resource, new_object_array_internal);
     return ret;
 }
 
-int virtual_machine_object_array_cdr( \
+/* Wrap an internal part with a new array object */
+static struct virtual_machine_object *virtual_machine_object_array_new_with_internal( \
         struct virtual_machine *vm, \
-        struct virtual_machine_object **object_out, \
-        const struct virtual_machine_object *object_src)
+        struct virtual_machine_object_array_internal *object_array_internal)
 {
-    int ret = 0;
     struct virtual_machine_object *new_object = NULL;
     struct virtual_machine_object_array *new_object_array = NULL;
-    struct virtual_machine_object_array_internal *new_object_array_internal = NULL;
-
-    struct virtual_machine_object *object_src_solved = NULL;
-    struct virtual_machine_object_array *object_array_src = NULL;
-    struct virtual_machine_object_array_internal *object_array_internal_src = NULL;
-
-    if ((ret = virtual_machine_variable_solve(&object_src_solved, (struct virtual_machine_object *)object_src, NULL, 1, vm)) != 0)
-    { goto fail; }
-
-    object_array_src = object_src_solved->ptr;
-    object_array_internal_src = object_array_src->ptr_internal;
-
-    /* Create a 'cdred' internal */
-    ret = virtual_machine_object_array_internal_cdr( \
-            vm, \
-            &new_object_array_internal, \
-            object_array_internal_src);
-    if (ret != 0) { goto fail; }
 
     /* Create the shell part */
     if ((new_object_array = (struct virtual_machine_object_array *)virtual_machine_resource_malloc( \
                     vm->resource, sizeof(struct virtual_machine_object_array))) == NULL)
     { goto fail; }
-    new_object_array->ptr_internal = new_object_array_internal; new_object_array_internal = NULL;
+    new_object_array->ptr_internal = object_array_internal;
 
     /* Create the array's infrastructure */
     if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_ARRAY)) == NULL)
     { goto fail; }
     if (_virtual_machine_object_ptr_set(new_object, new_object_array) != 0)
     { goto fail; }
+    new_object_array = NULL;
 
     if (virtual_machine_resource_reference_register( \
                 vm->gc_stub, \
                 new_object, \
-                new_object_array->ptr_internal, \
+                object_array_internal, \
                 &virtual_machine_object_array_internal_marker, \
                 &virtual_machine_object_array_internal_collector) != 0)
     { goto fail; }
 
-    new_object_array = NULL;
+    return new_object;
+fail:
+    if (new_object_array != NULL) virtual_machine_resource_free(vm->resource, new_object_array);
+    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
+    return NULL;
+}
 
-    *object_out = new_object; new_object = NULL;
+int virtual_machine_object_array_slice( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        size_t offset, size_t length)
+{
+    int ret = 0;
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_array_internal *new_object_array_internal = NULL;
+
+    struct virtual_machine_object *object_src_solved = NULL;
+    struct virtual_machine_object_array *object_array_src = NULL;
+
+    *object_out = NULL;
+
+    if ((ret = virtual_machine_variable_solve(&object_src_solved, (struct virtual_machine_object *)object_src, NULL, 1, vm)) != 0)
+    { goto fail; }
+
+    if (object_src_solved->type != OBJECT_TYPE_ARRAY)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail; 
+    }
+    object_array_src = object_src_solved->ptr;
+
+    if ((ret = virtual_machine_object_array_internal_slice( \
+                    vm, \
+                    &new_object_array_internal, \
+                    object_array_src->ptr_internal, \
+                    offset, length)) != 0)
+    { goto fail; }
 
+    if ((new_object = virtual_machine_object_array_new_with_internal(vm, new_object_array_internal)) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail; 
+    }
+    new_object_array_internal = NULL;
+
+    *object_out = new_object; new_object = NULL;
 fail:
     if (new_object_array_internal != NULL) virtual_machine_object_array_internal_destroy(vm, new_object_array_internal);
-    if (new_object_array != NULL) virtual_machine_resource_free(vm->resource, new_object_array);
-    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
     if (object_src_solved != NULL) virtual_machine_object_destroy(vm, object_src_solved);
     return ret;
 }
 
-#ifndef MAX
-#define MAX(a, b) ((a)>(b)?(a):(b))
-#endif
-#define VIRTUAL_MACHINE_OBJECT_ARRAY_CAPACITY_MINIMUM_REQUIRED 9
+int virtual_machine_object_array_cdr( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src)
+{
+    int ret = 0;
+
+    struct virtual_machine_object *object_src_solved = NULL;
+    struct virtual_machine_object_array *object_array_src = NULL;
+
+    *object_out = NULL;
+
+    if ((ret = virtual_machine_variable_solve(&object_src_solved, (struct virtual_machine_object *)object_src, NULL, 1, vm)) != 0)
+    { goto fail; }
+
+    if (object_src_solved->type != OBJECT_TYPE_ARRAY)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail; 
+    }
+    object_array_src = object_src_solved->ptr;
+
+    /* Element number checking */
+    if (object_array_src->ptr_internal->size == 0)
+    {
+        vm_err_update(vm->r, -VM_ERR_EMPTY_LIST, \
+                "runtime error: empty array has no element");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    if ((ret = virtual_machine_object_array_slice(vm, object_out, object_src_solved, \
+                    1, object_array_src->ptr_internal->size - 1)) != 0)
+    { goto fail; }
+
+fail:
+    if (object_src_solved != NULL) virtual_machine_object_destroy(vm, object_src_solved);
+    return ret;
+}
 
 static int virtual_machine_object_array_internal_extend(struct virtual_machine *vm, \
         struct virtual_machine_object_array_internal *object_array_internal)
@@ -636,6 +789,7 @@ static int virtual_machine_object_array_internal_extend(struct virtual_machine *
         idx_dst++;
     }
 
+    virtual_machine_resource_free(vm->resource, object_array_internal->nodes);
     object_array_internal->nodes = new_nodes;
     object_array_internal->pos = new_pos;
     object_array_internal->size = new_size;
@@ -660,6 +814,10 @@ int virtual_machine_object_array_internal_append(struct virtual_machine *vm, \
 
     if (object_array_internal == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
+    /* Slices should not see the new element */
+    if ((ret = virtual_machine_object_array_internal_unshare(vm, object_array_internal)) != 0)
+    { return ret; }
+
     if ((order == VIRTUAL_MACHINE_OBJECT_ARRAY_INTERNAL_APPEND_TO_TAIL) && \
             (object_array_internal->pos + object_array_internal->size >= object_array_internal->capacity))
     {
@@ -702,33 +860,19 @@ struct virtual_machine_object *virtual_machine_object_array_new( \
         struct virtual_machine *vm)
 {
     struct virtual_machine_object *new_object = NULL;
-    struct virtual_machine_object_array *new_object_array = NULL;
-
-    /* Create array object */
-    if ((new_object_array = (struct virtual_machine_object_array *)virtual_machine_resource_malloc( \
-                    vm->resource, sizeof(struct virtual_machine_object_array))) == NULL)
-    { goto fail; }
-    new_object_array->ptr_internal = NULL;
-    new_object_array->ptr_internal = virtual_machine_object_array_internal_new(vm, 0);
-    if (new_object_array->ptr_internal == NULL) { goto fail; }
+    struct virtual_machine_object_array_internal *new_object_array_internal = NULL;
 
-    /* Create the object's infrastructure */
-    if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_ARRAY)) == NULL)
-    { goto fail; }
-    if (_virtual_machine_object_ptr_set(new_object, new_object_array) != 0)
-    { goto fail; }
-    new_object_array = NULL;
+    if ((new_object_array_internal = virtual_machine_object_array_internal_new(vm, 0)) == NULL)
+    { return NULL; }
 
-    return new_object;
-fail:
-    if (new_object_array != NULL) 
+    /* Create array object, registered to GC */
+    if ((new_object = virtual_machine_object_array_new_with_internal(vm, new_object_array_internal)) == NULL)
     {
-        if (new_object_array->ptr_internal != NULL) virtual_machine_object_array_internal_destroy(vm, new_object_array->ptr_internal);
-        virtual_machine_resource_free(vm->resource, new_object_array);
+        virtual_machine_object_array_internal_destroy(vm, new_object_array_internal);
+        return NULL;
     }
-    if (new_object != NULL) _virtual_machine_object_destroy(vm, new_object);
 
-    return NULL;
+    return new_object;
 }
 
 int virtual_machine_object_array_destroy( \
@@ -867,6 +1011,7 @@ int virtual_machine_object_array_append( \
 
     object_array = object->ptr;
     object_array_internal = object_array->ptr_internal;
+    gc_write_barrier(object->object_table_item_ptr, object_new_sub->object_table_item_ptr);
 
     if ((ret = virtual_machine_object_array_internal_append(vm, \
             object_array_internal, object_new_sub, VIRTUAL_MACHINE_OBJECT_ARRAY_INTERNAL_APPEND_TO_TAIL)) != 0)
@@ -35,6 +35,17 @@ struct virtual_machine_object_array_internal_node
     struct virtual_machine_object *ptr;
 };
 
+/* Node buffer shared between an array and the slices taken from it, 
+ * the buffer is not modified while it is shared */
+struct virtual_machine_object_array_internal_shared
+{
+    /* Range of nodes owned by the buffer */
+    size_t pos;
+    size_t size;
+
+    size_t refcount;
+};
+
 struct virtual_machine_object_array_internal
 {
     struct virtual_machine_object_array_internal_node *nodes;
@@ -42,6 +53,10 @@ struct virtual_machine_object_array_internal
     size_t size;
     size_t capacity;
 
+    /* NULL if the nodes are owned by this array only, 
+     * the array gets its own copy before modifying otherwise */
+    struct virtual_machine_object_array_internal_shared *shared;
+
     struct virtual_machine *vm;
 };
 
@@ -100,6 +115,12 @@ int virtual_machine_object_array_cdr( \
         struct virtual_machine *vm, \
         struct virtual_machine_object **object_out, \
         const struct virtual_machine_object *object_src);
+/* Slice of 'length' elements from 'offset', shares elements with the source */
+int virtual_machine_object_array_slice( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        size_t offset, size_t length);
 
 /* Append */
 int virtual_machine_object_array_append( \
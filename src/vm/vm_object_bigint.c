@@ -0,0 +1,948 @@
+/* Big Integer Objects
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "selfcheck.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+
+#include "vm_opcode.h"
+#include "vm_types.h"
+
+#include "vm_infrastructure.h"
+#include "vm_object_aio.h"
+#include "vm_err.h"
+
+/* Compatible */
+#if defined(_MSC_VER)
+#define snprintf _snprintf
+#elif defined(WIN32)
+#define snprintf _snprintf
+#endif
+
+#define BIGINT_DIGIT_BITS 32
+#define BIGINT_DIGIT_BASE ((uint64_t)1 << BIGINT_DIGIT_BITS)
+#define BIGINT_DIGIT_MAX (0xFFFFFFFFU)
+
+/* Decimal chunks for printing */
+#define BIGINT_DECIMAL_BASE (1000000000U)
+#define BIGINT_DECIMAL_DIGITS 9
+
+
+/* Magnitudes */
+
+static size_t bigint_mag_trim(const uint32_t *a, size_t size)
+{
+    while ((size != 0) && (a[size - 1] == 0)) size--;
+    return size;
+}
+
+static int bigint_mag_cmp(const uint32_t *a, const size_t a_size, \
+        const uint32_t *b, const size_t b_size)
+{
+    size_t idx;
+
+    if (a_size != b_size) return a_size < b_size ? -1 : 1;
+    idx = a_size;
+    while (idx-- != 0)
+    {
+        if (a[idx] != b[idx]) return a[idx] < b[idx] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/* r = a + b, 'r' has max(a_size, b_size) + 1 digits */
+static size_t bigint_mag_add(uint32_t *r, \
+        const uint32_t *a, size_t a_size, \
+        const uint32_t *b, size_t b_size)
+{
+    const uint32_t *t;
+    uint64_t carry = 0;
+    size_t idx;
+
+    if (a_size < b_size)
+    {
+        t = a; a = b; b = t;
+        idx = a_size; a_size = b_size; b_size = idx;
+    }
+    for (idx = 0; idx != a_size; idx++)
+    {
+        carry += (uint64_t)a[idx] + (idx < b_size ? b[idx] : 0);
+        r[idx] = (uint32_t)carry;
+        carry >>= BIGINT_DIGIT_BITS;
+    }
+    r[a_size] = (uint32_t)carry;
+
+    return bigint_mag_trim(r, a_size + 1);
+}
+
+/* r = a - b, a >= b, 'r' has a_size digits */
+static size_t bigint_mag_sub(uint32_t *r, \
+        const uint32_t *a, const size_t a_size, \
+        const uint32_t *b, const size_t b_size)
+{
+    uint64_t borrow = 0, t;
+    size_t idx;
+
+    for (idx = 0; idx != a_size; idx++)
+    {
+        t = (uint64_t)a[idx] - (idx < b_size ? b[idx] : 0) - borrow;
+        r[idx] = (uint32_t)t;
+        borrow = t >> 63;
+    }
+
+    return bigint_mag_trim(r, a_size);
+}
+
+/* r = a * b, 'r' has a_size + b_size digits */
+static size_t bigint_mag_mul(uint32_t *r, \
+        const uint32_t *a, const size_t a_size, \
+        const uint32_t *b, const size_t b_size)
+{
+    uint64_t carry;
+    size_t i, j;
+
+    memset(r, 0, sizeof(uint32_t) * (a_size + b_size));
+    for (i = 0; i != a_size; i++)
+    {
+        carry = 0;
+        for (j = 0; j != b_size; j++)
+        {
+            carry += (uint64_t)a[i] * b[j] + r[i + j];
+            r[i + j] = (uint32_t)carry;
+            carry >>= BIGINT_DIGIT_BITS;
+        }
+        r[i + b_size] = (uint32_t)carry;
+    }
+
+    return bigint_mag_trim(r, a_size + b_size);
+}
+
+/* q = a / d, returns a % d, 'q' has a_size digits */
+static uint32_t bigint_mag_divmod_digit(uint32_t *q, \
+        const uint32_t *a, const size_t a_size, const uint32_t d)
+{
+    uint64_t rem = 0;
+    size_t idx = a_size;
+
+    while (idx-- != 0)
+    {
+        rem = (rem << BIGINT_DIGIT_BITS) | a[idx];
+        q[idx] = (uint32_t)(rem / d);
+        rem %= d;
+    }
+
+    return (uint32_t)rem;
+}
+
+static unsigned int bigint_digit_nlz(uint32_t x)
+{
+    unsigned int n = 0;
+
+    while ((x & 0x80000000U) == 0) { x <<= 1; n++; }
+
+    return n;
+}
+
+/* q = a / b, r = a % b with Knuth's algorithm D, a_size >= b_size >= 2,
+ * 'q' has a_size - b_size + 1 digits and 'r' has b_size digits */
+static int bigint_mag_divmod(uint32_t *q, uint32_t *r, \
+        const uint32_t *a, const size_t a_size, \
+        const uint32_t *b, const size_t b_size)
+{
+    uint32_t *un, *vn;
+    uint64_t qhat, rhat, p, carry;
+    int64_t t, k;
+    unsigned int s;
+    size_t i, j;
+
+    if ((un = (uint32_t *)malloc(sizeof(uint32_t) * (a_size + 1 + b_size))) == NULL)
+    { return -MULTIPLE_ERR_MALLOC; }
+    vn = un + a_size + 1;
+
+    /* Normalize to make the leading digit of the divisor large */
+    s = bigint_digit_nlz(b[b_size - 1]);
+    for (i = b_size - 1; i != 0; i--)
+    { vn[i] = (b[i] << s) | (s != 0 ? (b[i - 1] >> (BIGINT_DIGIT_BITS - s)) : 0); }
+    vn[0] = b[0] << s;
+    un[a_size] = s != 0 ? (a[a_size - 1] >> (BIGINT_DIGIT_BITS - s)) : 0;
+    for (i = a_size - 1; i != 0; i--)
+    { un[i] = (a[i] << s) | (s != 0 ? (a[i - 1] >> (BIGINT_DIGIT_BITS - s)) : 0); }
+    un[0] = a[0] << s;
+
+    j = a_size - b_size + 1;
+    while (j-- != 0)
+    {
+        /* Estimate the digit of the quotient */
+        p = ((uint64_t)un[j + b_size] << BIGINT_DIGIT_BITS) | un[j + b_size - 1];
+        qhat = p / vn[b_size - 1];
+        rhat = p % vn[b_size - 1];
+        while ((qhat >= BIGINT_DIGIT_BASE) || \
+                (qhat * vn[b_size - 2] > ((rhat << BIGINT_DIGIT_BITS) | un[j + b_size - 2])))
+        {
+            qhat--;
+            rhat += vn[b_size - 1];
+            if (rhat >= BIGINT_DIGIT_BASE) break;
+        }
+
+        /* Multiply and subtract */
+        k = 0;
+        for (i = 0; i != b_size; i++)
+        {
+            p = qhat * vn[i];
+            t = (int64_t)un[i + j] - k - (int64_t)(p & BIGINT_DIGIT_MAX);
+            un[i + j] = (uint32_t)t;
+            k = (int64_t)(p >> BIGINT_DIGIT_BITS) - (t >> BIGINT_DIGIT_BITS);
+        }
+        t = (int64_t)un[j + b_size] - k;
+        un[j + b_size] = (uint32_t)t;
+
+        q[j] = (uint32_t)qhat;
+        if (t < 0)
+        {
+            /* Estimated one too large, add back */
+            q[j]--;
+            carry = 0;
+            for (i = 0; i != b_size; i++)
+            {
+                carry += (uint64_t)un[i + j] + vn[i];
+                un[i + j] = (uint32_t)carry;
+                carry >>= BIGINT_DIGIT_BITS;
+            }
+            un[j + b_size] = (uint32_t)(un[j + b_size] + carry);
+        }
+    }
+
+    /* Unnormalize the remainder */
+    for (i = 0; i != b_size - 1; i++)
+    { r[i] = s != 0 ? ((un[i] >> s) | (un[i + 1] << (BIGINT_DIGIT_BITS - s))) : un[i]; }
+    r[b_size - 1] = un[b_size - 1] >> s;
+
+    free(un);
+
+    return 0;
+}
+
+/* r = a << n, 'r' has a_size + n / 32 + 1 digits */
+static size_t bigint_mag_shl(uint32_t *r, \
+        const uint32_t *a, const size_t a_size, const size_t n)
+{
+    size_t words = n / BIGINT_DIGIT_BITS, idx;
+    unsigned int bits = (unsigned int)(n % BIGINT_DIGIT_BITS);
+
+    memset(r, 0, sizeof(uint32_t) * (a_size + words + 1));
+    for (idx = 0; idx != a_size; idx++)
+    {
+        r[idx + words] |= a[idx] << bits;
+        if (bits != 0) r[idx + words + 1] = a[idx] >> (BIGINT_DIGIT_BITS - bits);
+    }
+
+    return bigint_mag_trim(r, a_size + words + 1);
+}
+
+/* r = a >> n, 'r' has a_size digits */
+static size_t bigint_mag_shr(uint32_t *r, \
+        const uint32_t *a, const size_t a_size, const size_t n)
+{
+    size_t words = n / BIGINT_DIGIT_BITS, idx;
+    unsigned int bits = (unsigned int)(n % BIGINT_DIGIT_BITS);
+
+    if (words >= a_size) return 0;
+    for (idx = 0; idx != a_size - words; idx++)
+    {
+        r[idx] = a[idx + words] >> bits;
+        if ((bits != 0) && (idx + words + 1 < a_size))
+        { r[idx] |= a[idx + words + 1] << (BIGINT_DIGIT_BITS - bits); }
+    }
+
+    return bigint_mag_trim(r, a_size - words);
+}
+
+/* Two's complement in 'size' digits, size > a->size */
+static void bigint_to_twos_complement(uint32_t *r, const size_t size, \
+        const struct virtual_machine_object_bigint *a)
+{
+    uint64_t carry = 1;
+    uint32_t digit;
+    size_t idx;
+
+    for (idx = 0; idx != size; idx++)
+    {
+        digit = idx < a->size ? a->digits[idx] : 0;
+        if (a->sign != 0)
+        {
+            carry += (uint32_t)~digit;
+            r[idx] = (uint32_t)carry;
+            carry >>= BIGINT_DIGIT_BITS;
+        }
+        else
+        {
+            r[idx] = digit;
+        }
+    }
+}
+
+/* Back to sign and magnitude, in place */
+static void bigint_from_twos_complement(struct virtual_machine_object_bigint *r, const size_t size)
+{
+    uint64_t carry = 1;
+    size_t idx;
+
+    r->sign = (r->digits[size - 1] >> (BIGINT_DIGIT_BITS - 1)) != 0 ? 1 : 0;
+    if (r->sign != 0)
+    {
+        for (idx = 0; idx != size; idx++)
+        {
+            carry += (uint32_t)~r->digits[idx];
+            r->digits[idx] = (uint32_t)carry;
+            carry >>= BIGINT_DIGIT_BITS;
+        }
+    }
+    r->size = bigint_mag_trim(r->digits, size);
+}
+
+
+/* Signed */
+
+/* r = a + b, or a - b with 'negate_b', 'r' has max(a->size, b->size) + 1 digits */
+static void bigint_add(struct virtual_machine_object_bigint *r, \
+        const struct virtual_machine_object_bigint *a, \
+        const struct virtual_machine_object_bigint *b, const int negate_b)
+{
+    int sign_b = b->sign ^ negate_b;
+
+    if (a->sign == sign_b)
+    {
+        r->size = bigint_mag_add(r->digits, a->digits, a->size, b->digits, b->size);
+        r->sign = a->sign;
+    }
+    else if (bigint_mag_cmp(a->digits, a->size, b->digits, b->size) >= 0)
+    {
+        r->size = bigint_mag_sub(r->digits, a->digits, a->size, b->digits, b->size);
+        r->sign = a->sign;
+    }
+    else
+    {
+        r->size = bigint_mag_sub(r->digits, b->digits, b->size, a->digits, a->size);
+        r->sign = sign_b;
+    }
+    if (r->size == 0) r->sign = 0;
+}
+
+static int bigint_cmp(const struct virtual_machine_object_bigint *a, \
+        const struct virtual_machine_object_bigint *b)
+{
+    int result;
+
+    if (a->sign != b->sign) return a->sign != 0 ? -1 : 1;
+    result = bigint_mag_cmp(a->digits, a->size, b->digits, b->size);
+
+    return a->sign != 0 ? -result : result;
+}
+
+/* View an 'int' or a 'bigint' object as a bigint, 'buffer' holds the digits of an 'int' */
+static void bigint_operand(struct virtual_machine_object_bigint *operand, \
+        uint32_t *buffer, const struct virtual_machine_object *object)
+{
+    int64_t value;
+    uint64_t magnitude;
+
+    if (object->type == OBJECT_TYPE_INT)
+    {
+        value = ((struct virtual_machine_object_int *)(object->ptr))->value;
+        magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+        buffer[0] = (uint32_t)magnitude;
+        buffer[1] = (uint32_t)(magnitude >> BIGINT_DIGIT_BITS);
+        operand->sign = value < 0 ? 1 : 0;
+        operand->digits = buffer;
+        operand->size = bigint_mag_trim(buffer, 2);
+    }
+    else
+    {
+        *operand = *((struct virtual_machine_object_bigint *)(object->ptr));
+    }
+}
+
+static int bigint_is_integer(const struct virtual_machine_object *object)
+{
+    return ((object->type == OBJECT_TYPE_INT) || (object->type == OBJECT_TYPE_BIGINT)) ? 1 : 0;
+}
+
+/* Decimal representation, allocated with malloc() */
+static char *bigint_to_str(const struct virtual_machine_object_bigint *a, size_t *len_out)
+{
+    uint32_t *digits = NULL, *chunks = NULL;
+    size_t size = a->size, chunks_count = 0;
+    char *str = NULL, *str_p;
+
+    if ((digits = (uint32_t *)malloc(sizeof(uint32_t) * (size + 1))) == NULL) goto fail;
+    /* Each digit takes less than 10 decimal digits */
+    if ((chunks = (uint32_t *)malloc(sizeof(uint32_t) * (size * 2 + 1))) == NULL) goto fail;
+    if ((str = (char *)malloc(sizeof(char) * (size * 20 + 3))) == NULL) goto fail;
+
+    if (size != 0) memcpy(digits, a->digits, sizeof(uint32_t) * size);
+    do
+    {
+        chunks[chunks_count++] = bigint_mag_divmod_digit(digits, digits, size, BIGINT_DECIMAL_BASE);
+        size = bigint_mag_trim(digits, size);
+    } while (size != 0);
+
+    str_p = str;
+    if (a->sign != 0) *str_p++ = '-';
+    str_p += sprintf(str_p, "%u", (unsigned int)chunks[--chunks_count]);
+    while (chunks_count-- != 0)
+    { str_p += sprintf(str_p, "%0*u", BIGINT_DECIMAL_DIGITS, (unsigned int)chunks[chunks_count]); }
+    *len_out = (size_t)(str_p - str);
+
+    goto done;
+fail:
+    if (str != NULL) { free(str); str = NULL; }
+done:
+    if (digits != NULL) free(digits);
+    if (chunks != NULL) free(chunks);
+    return str;
+}
+
+
+/* Basic */
+
+/* Create a new bigint object with specified value */
+struct virtual_machine_object *virtual_machine_object_bigint_new_with_value( \
+        struct virtual_machine *vm, \
+        const int sign, const uint32_t *digits, const size_t size)
+{
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_bigint *new_object_bigint = NULL;
+    uint64_t magnitude;
+    size_t new_size = bigint_mag_trim(digits, size);
+
+    /* Fits in 'int' */
+    if (new_size <= 2)
+    {
+        magnitude = (new_size > 0 ? (uint64_t)digits[0] : 0) | \
+                    (new_size > 1 ? ((uint64_t)digits[1] << BIGINT_DIGIT_BITS) : 0);
+        if ((sign == 0) && (magnitude <= (uint64_t)INT64_MAX))
+        { return virtual_machine_object_int_new_with_value(vm, (int64_t)magnitude); }
+        if ((sign != 0) && (magnitude <= (uint64_t)INT64_MAX + 1))
+        { return virtual_machine_object_int_new_with_value(vm, -(int64_t)(magnitude - 1) - 1); }
+    }
+
+    /* Create the object's infrastructure */
+    if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_BIGINT)) == NULL)
+    {
+        return NULL;
+    }
+
+    /* The digits follow the header */
+    if ((new_object_bigint = (struct virtual_machine_object_bigint *)virtual_machine_resource_malloc_primitive( \
+                    vm->resource, sizeof(struct virtual_machine_object_bigint) + sizeof(uint32_t) * new_size)) == NULL)
+    {
+        _virtual_machine_object_destroy(vm, new_object);
+        return NULL;
+    }
+
+    if (_virtual_machine_object_ptr_set(new_object, new_object_bigint) != 0)
+    {
+        virtual_machine_resource_free_primitive(vm->resource, new_object_bigint);
+        _virtual_machine_object_destroy(vm, new_object);
+        return NULL;
+    }
+    new_object_bigint->sign = sign != 0 ? 1 : 0;
+    new_object_bigint->size = new_size;
+    new_object_bigint->digits = (uint32_t *)(new_object_bigint + 1);
+    memcpy(new_object_bigint->digits, digits, sizeof(uint32_t) * new_size);
+
+    return new_object;
+}
+
+/* Destroy a bigint object */
+int virtual_machine_object_bigint_destroy(struct virtual_machine *vm, \
+        struct virtual_machine_object *object)
+{
+    if (object == NULL) return -MULTIPLE_ERR_NULL_PTR;
+
+    if (object->ptr != NULL) virtual_machine_resource_free_primitive(vm->resource, object->ptr);
+    _virtual_machine_object_destroy(vm, object);
+
+    return 0;
+}
+
+/* Clone a bigint object */
+struct virtual_machine_object *virtual_machine_object_bigint_clone( \
+        struct virtual_machine *vm, \
+        const struct virtual_machine_object *object)
+{
+    struct virtual_machine_object_bigint *object_bigint = NULL;
+
+    if ((object == NULL) || (object->ptr == NULL)) return NULL;
+
+    object_bigint = ((struct virtual_machine_object_bigint *)(object->ptr));
+
+    return virtual_machine_object_bigint_new_with_value(vm, \
+            object_bigint->sign, object_bigint->digits, object_bigint->size);
+}
+
+/* print */
+int virtual_machine_object_bigint_print(const struct virtual_machine_object *object)
+{
+    char *str;
+    size_t len;
+
+    if ((object == NULL) || (object->ptr == NULL)) return -MULTIPLE_ERR_NULL_PTR;
+
+    if ((str = bigint_to_str(object->ptr, &len)) == NULL) return -MULTIPLE_ERR_MALLOC;
+    fwrite(str, len, 1, stdout);
+    free(str);
+
+    return 0;
+}
+
+double virtual_machine_object_bigint_to_float(const struct virtual_machine_object *object)
+{
+    struct virtual_machine_object_bigint *object_bigint = object->ptr;
+    double value = 0.0;
+    size_t idx = object_bigint->size;
+
+    while (idx-- != 0)
+    { value = value * (double)BIGINT_DIGIT_BASE + (double)object_bigint->digits[idx]; }
+
+    return object_bigint->sign != 0 ? -value : value;
+}
+
+/* convert */
+int virtual_machine_object_bigint_convert( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        const uint32_t type)
+{
+    int ret = 0;
+    struct virtual_machine_object *new_object = NULL;
+    char *str;
+    size_t len;
+
+    if (object_src == NULL) return -MULTIPLE_ERR_NULL_PTR;
+
+    *object_out = NULL;
+
+    switch (type)
+    {
+        case OBJECT_TYPE_INT:
+        case OBJECT_TYPE_BIGINT:
+            /* Already the widest integer */
+            new_object = virtual_machine_object_bigint_clone(vm, object_src);
+            break;
+        case OBJECT_TYPE_FLOAT:
+            new_object = virtual_machine_object_float_new_with_value( \
+                    vm, \
+                    virtual_machine_object_bigint_to_float(object_src));
+            break;
+        case OBJECT_TYPE_BOOL:
+            /* Never zero */
+            new_object = virtual_machine_object_bool_new_with_value( \
+                    vm, \
+                    VIRTUAL_MACHINE_OBJECT_BOOL_VALUE_TRUE);
+            break;
+        case OBJECT_TYPE_STR:
+            if ((str = bigint_to_str(object_src->ptr, &len)) == NULL) break;
+            new_object = virtual_machine_object_str_new_with_value( \
+                    vm, \
+                    str, len);
+            free(str);
+            break;
+    }
+    if (new_object == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    *object_out = new_object;
+
+fail:
+
+    return ret;
+}
+
+
+/* Operations */
+
+#define OP_LITERAL_LEN 32
+
+static int bigint_shift(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object_bigint *a, \
+        const struct virtual_machine_object_bigint *count, \
+        const uint32_t opcode)
+{
+    int ret = 0;
+    struct virtual_machine_object_bigint r;
+    uint32_t *digits = NULL;
+    uint32_t one_digit = 1;
+    uint64_t count_value;
+    size_t n;
+
+    if (count->sign != 0)
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: negative shift count");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    count_value = (count->size > 0 ? (uint64_t)count->digits[0] : 0) | \
+                  (count->size > 1 ? ((uint64_t)count->digits[1] << BIGINT_DIGIT_BITS) : 0);
+    if (opcode == OP_RSHIFT)
+    {
+        /* Shifted out completely, the result is 0 or -1 */
+        if ((count->size > 2) || (count_value >= (uint64_t)a->size * BIGINT_DIGIT_BITS))
+        {
+            *object_out = virtual_machine_object_int_new_with_value(vm, a->sign != 0 ? -1 : 0);
+            goto finish;
+        }
+    }
+    else if ((count->size > 2) || (count_value > (uint64_t)(SIZE_MAX / 8)))
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: shift count too large");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    n = (size_t)count_value;
+
+    if (opcode == OP_LSHIFT)
+    {
+        if ((digits = (uint32_t *)malloc(sizeof(uint32_t) * (a->size + n / BIGINT_DIGIT_BITS + 1))) == NULL)
+        { goto finish; }
+        r.sign = a->sign;
+        r.size = bigint_mag_shl(digits, a->digits, a->size, n);
+    }
+    else
+    {
+        if ((digits = (uint32_t *)malloc(sizeof(uint32_t) * (a->size + 1))) == NULL)
+        { goto finish; }
+        r.sign = a->sign;
+        if (a->sign == 0)
+        {
+            r.size = bigint_mag_shr(digits, a->digits, a->size, n);
+        }
+        else
+        {
+            /* Rounded towards negative infinity as 'int' does, -(((|a| - 1) >> n) + 1) */
+            r.size = bigint_mag_sub(digits, a->digits, a->size, &one_digit, 1);
+            r.size = bigint_mag_shr(digits, digits, r.size, n);
+            r.size = bigint_mag_add(digits, digits, r.size, &one_digit, 1);
+        }
+    }
+    *object_out = virtual_machine_object_bigint_new_with_value(vm, r.sign, digits, r.size);
+
+finish:
+    if (*object_out == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+fail:
+    if (digits != NULL) free(digits);
+    return ret;
+}
+
+/* add, sub, mul, div, mod */
+/* lshift, rshift */
+/* anda, ora, xora */
+int virtual_machine_object_bigint_binary_arithmetic_shift_bitwise(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_left, const struct virtual_machine_object *object_right, \
+        const uint32_t opcode)
+{
+    int ret = 0;
+    struct virtual_machine_object *new_object = NULL;
+    char *bad_type_name;
+    char op_literal[OP_LITERAL_LEN];
+    struct virtual_machine_object_bigint a, b, r, rem;
+    uint32_t buffer_left[2], buffer_right[2];
+    uint32_t *digits = NULL;
+    size_t size_max, idx;
+
+    if ((object_left == NULL) || (object_right == NULL)) return -MULTIPLE_ERR_NULL_PTR;
+
+    *object_out = NULL;
+
+    /* Type check */
+    if (bigint_is_integer(object_right) == 0)
+    {
+        op_literal[0] = '\0';
+        switch (opcode)
+        {
+            case OP_ADD: snprintf(op_literal, OP_LITERAL_LEN, "+"); break;
+            case OP_SUB: snprintf(op_literal, OP_LITERAL_LEN, "-"); break;
+            case OP_MUL: snprintf(op_literal, OP_LITERAL_LEN, "*"); break;
+            case OP_DIV: snprintf(op_literal, OP_LITERAL_LEN, "/"); break;
+            case OP_MOD: snprintf(op_literal, OP_LITERAL_LEN, "%%"); break;
+            case OP_LSHIFT: snprintf(op_literal, OP_LITERAL_LEN, "<<"); break;
+            case OP_RSHIFT: snprintf(op_literal, OP_LITERAL_LEN, ">>"); break;
+            case OP_ANDA: snprintf(op_literal, OP_LITERAL_LEN, "bit::and"); break;
+            case OP_ORA: snprintf(op_literal, OP_LITERAL_LEN, "bit::or"); break;
+            case OP_XORA: snprintf(op_literal, OP_LITERAL_LEN, "bit::xor"); break;
+            default: snprintf(op_literal, OP_LITERAL_LEN, "unknown op"); break;
+        }
+        ret = virtual_machine_object_id_to_type_name(&bad_type_name, NULL, object_right->type);
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type, " \
+                "\'bigint\' %s \'%s\'",  \
+                op_literal, ret == 0 ? bad_type_name : "undefined type");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    bigint_operand(&a, buffer_left, object_left);
+    bigint_operand(&b, buffer_right, object_right);
+
+    if ((opcode == OP_DIV || opcode == OP_MOD) && (b.size == 0))
+    {
+        /* 0 can't be divided by */
+        vm_err_update(vm->r, -VM_ERR_DIVIDE_BY_ZERO, \
+                "runtime error: divide by zero");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    if (opcode == OP_LSHIFT || opcode == OP_RSHIFT)
+    {
+        return bigint_shift(vm, object_out, &a, &b, opcode);
+    }
+
+    /* Enough digits for the results of all the operations */
+    size_max = (a.size > b.size ? a.size : b.size) + 1;
+    if ((digits = (uint32_t *)malloc(sizeof(uint32_t) * (a.size + b.size + size_max * 3 + 1))) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    r.digits = digits;
+
+    /* Perform operation */
+    switch (opcode)
+    {
+        case OP_ADD:
+        case OP_SUB:
+            bigint_add(&r, &a, &b, opcode == OP_SUB ? 1 : 0);
+            break;
+        case OP_MUL:
+            r.size = bigint_mag_mul(r.digits, a.digits, a.size, b.digits, b.size);
+            r.sign = r.size != 0 ? (a.sign ^ b.sign) : 0;
+            break;
+        case OP_DIV:
+        case OP_MOD:
+            /* Truncated towards zero as 'int' does */
+            rem.digits = digits + a.size + 1;
+            if (bigint_mag_cmp(a.digits, a.size, b.digits, b.size) < 0)
+            {
+                r.size = 0;
+                rem.size = a.size;
+                memcpy(rem.digits, a.digits, sizeof(uint32_t) * a.size);
+            }
+            else if (b.size == 1)
+            {
+                rem.digits[0] = bigint_mag_divmod_digit(r.digits, a.digits, a.size, b.digits[0]);
+                r.size = bigint_mag_trim(r.digits, a.size);
+                rem.size = bigint_mag_trim(rem.digits, 1);
+            }
+            else
+            {
+                if (bigint_mag_divmod(r.digits, rem.digits, a.digits, a.size, b.digits, b.size) != 0)
+                {
+                    VM_ERR_MALLOC(vm->r);
+                    ret = -MULTIPLE_ERR_VM;
+                    goto fail;
+                }
+                r.size = bigint_mag_trim(r.digits, a.size - b.size + 1);
+                rem.size = bigint_mag_trim(rem.digits, b.size);
+            }
+            r.sign = r.size != 0 ? (a.sign ^ b.sign) : 0;
+            rem.sign = rem.size != 0 ? a.sign : 0;
+            if (opcode == OP_MOD) r = rem;
+            break;
+        case OP_ANDA:
+        case OP_ORA:
+        case OP_XORA:
+            /* On two's complement as 'int' does */
+            rem.digits = digits + size_max;
+            bigint_to_twos_complement(r.digits, size_max, &a);
+            bigint_to_twos_complement(rem.digits, size_max, &b);
+            for (idx = 0; idx != size_max; idx++)
+            {
+                switch (opcode)
+                {
+                    case OP_ANDA: r.digits[idx] &= rem.digits[idx]; break;
+                    case OP_ORA: r.digits[idx] |= rem.digits[idx]; break;
+                    default: r.digits[idx] ^= rem.digits[idx]; break;
+                }
+            }
+            bigint_from_twos_complement(&r, size_max);
+            break;
+        default:
+            VM_ERR_INTERNAL(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+    }
+    if ((new_object = virtual_machine_object_bigint_new_with_value(vm, r.sign, r.digits, r.size)) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    *object_out = new_object;
+
+fail:
+    if (digits != NULL) free(digits);
+    return ret;
+}
+
+/* eq, ne, l, g, le, ge */
+int virtual_machine_object_bigint_binary_equality_relational(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_left, const struct virtual_machine_object *object_right, \
+        const uint32_t opcode)
+{
+    int ret = 0;
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_bigint a, b;
+    uint32_t buffer_left[2], buffer_right[2];
+    int result;
+
+    if ((object_left == NULL) || (object_right == NULL))
+    {
+        return -MULTIPLE_ERR_NULL_PTR;
+    }
+
+    *object_out = NULL;
+
+    /* Type check */
+    if (bigint_is_integer(object_right) == 0)
+    {
+        switch (opcode)
+        {
+            case OP_EQ:
+                new_object = virtual_machine_object_bool_new_with_value(vm, VIRTUAL_MACHINE_OBJECT_BOOL_VALUE_FALSE);
+                goto finish;
+                break;
+            case OP_NE:
+                new_object = virtual_machine_object_bool_new_with_value(vm, VIRTUAL_MACHINE_OBJECT_BOOL_VALUE_TRUE);
+                goto finish;
+                break;
+            default:
+                VM_ERR_INTERNAL(vm->r);
+                ret = -MULTIPLE_ERR_VM;
+                goto fail;
+        }
+    }
+
+    bigint_operand(&a, buffer_left, object_left);
+    bigint_operand(&b, buffer_right, object_right);
+    result = bigint_cmp(&a, &b);
+
+    /* Perform operation */
+    switch (opcode)
+    {
+        case OP_EQ: new_object = virtual_machine_object_bool_new_with_value(vm, TO_BOOL_VALUE(result == 0));break;
+        case OP_NE: new_object = virtual_machine_object_bool_new_with_value(vm, TO_BOOL_VALUE(result != 0));break;
+        case OP_L: new_object = virtual_machine_object_bool_new_with_value(vm, TO_BOOL_VALUE(result < 0));break;
+        case OP_G: new_object = virtual_machine_object_bool_new_with_value(vm, TO_BOOL_VALUE(result > 0));break;
+        case OP_LE: new_object = virtual_machine_object_bool_new_with_value(vm, TO_BOOL_VALUE(result <= 0));break;
+        case OP_GE: new_object = virtual_machine_object_bool_new_with_value(vm, TO_BOOL_VALUE(result >= 0));break;
+        default:
+                      VM_ERR_INTERNAL(vm->r);
+                      ret = -MULTIPLE_ERR_VM;
+                      goto fail;
+                      break;
+    }
+finish:
+    if (new_object == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    *object_out = new_object;
+
+fail:
+
+    return ret;
+}
+
+/* neg, nota */
+int virtual_machine_object_bigint_unary(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        const uint32_t opcode)
+{
+    int ret = 0;
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_bigint a, one, r;
+    uint32_t buffer[2], one_digit = 1;
+    uint32_t *digits = NULL;
+
+    if (object_src == NULL) return -MULTIPLE_ERR_NULL_PTR;
+
+    *object_out = NULL;
+
+    bigint_operand(&a, buffer, object_src);
+    switch (opcode)
+    {
+        case OP_NEG:
+            new_object = virtual_machine_object_bigint_new_with_value(vm, \
+                    a.size != 0 ? !a.sign : 0, a.digits, a.size);
+            break;
+        case OP_NOTA:
+            /* ~a = -a - 1 */
+            if ((digits = (uint32_t *)malloc(sizeof(uint32_t) * (a.size + 2))) == NULL) break;
+            one.sign = 0; one.digits = &one_digit; one.size = 1;
+            a.sign = a.size != 0 ? !a.sign : 0;
+            r.digits = digits;
+            bigint_add(&r, &a, &one, 1);
+            new_object = virtual_machine_object_bigint_new_with_value(vm, r.sign, r.digits, r.size);
+            break;
+        default:
+            VM_ERR_INTERNAL(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+    }
+    if (new_object == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    *object_out = new_object;
+
+fail:
+    if (digits != NULL) free(digits);
+    return ret;
+}
+
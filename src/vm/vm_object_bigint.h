@@ -0,0 +1,89 @@
+/* Big Integer Objects
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM_OBJECT_BIGINT_H_
+#define _VM_OBJECT_BIGINT_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+struct virtual_machine_object;
+
+/* Integers out of the range of 'int', which the arithmetic of 'int'
+ * promotes to on overflow. Values fitting in 'int' are always kept
+ * as 'int', so the two types never hold the same value */
+struct virtual_machine_object_bigint
+{
+    int sign; /* 1 for negative */
+    size_t size;
+    uint32_t *digits; /* Base 2^32, the least significant first, the last one non-zero */
+};
+
+/* new, gives an 'int' object when the value fits in it */
+struct virtual_machine_object *virtual_machine_object_bigint_new_with_value( \
+        struct virtual_machine *vm, \
+        const int sign, const uint32_t *digits, const size_t size);
+/* destroy */
+int virtual_machine_object_bigint_destroy( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object *object);
+/* clone */
+struct virtual_machine_object *virtual_machine_object_bigint_clone( \
+        struct virtual_machine *vm, \
+        const struct virtual_machine_object *object);
+/* print */
+int virtual_machine_object_bigint_print(const struct virtual_machine_object *object);
+
+/* convert */
+int virtual_machine_object_bigint_convert( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        const uint32_t type);
+
+/* The operands below could be 'int' or 'bigint' on both sides */
+
+/* add, sub, mul, div, mod */
+/* lshift, rshift */
+/* anda, ora, xora */
+int virtual_machine_object_bigint_binary_arithmetic_shift_bitwise( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_left, const struct virtual_machine_object *object_right, \
+        const uint32_t opcode);
+
+/* eq, ne, l, g, le, ge */
+int virtual_machine_object_bigint_binary_equality_relational( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_left, const struct virtual_machine_object *object_right, \
+        const uint32_t opcode);
+
+/* neg, nota */
+int virtual_machine_object_bigint_unary( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        const uint32_t opcode);
+
+/* Approximate value */
+double virtual_machine_object_bigint_to_float(const struct virtual_machine_object *object);
+
+#endif
+
@@ -0,0 +1,660 @@
+/* Buffer Objects
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "multiple_err.h"
+
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_object_aio.h"
+#include "vm_gc.h"
+#include "vm_err.h"
+
+
+/* Internal Marker */
+int virtual_machine_object_buffer_internal_marker(void *object_internal)
+{
+    (void)object_internal;
+
+    /* Bytes only */
+    return 0;
+}
+
+/* Internal Collector */
+int virtual_machine_object_buffer_internal_collector(void *object_internal, int *confirm)
+{
+    struct virtual_machine_object_buffer_internal *object_buffer_internal = object_internal;
+
+    *confirm = VIRTUAL_MACHINE_GARBAGE_COLLECT_CONFIRM;
+
+    if (object_buffer_internal->data != NULL) virtual_machine_resource_free_reference(object_buffer_internal->vm->resource, object_buffer_internal->data);
+    virtual_machine_resource_free(object_buffer_internal->vm->resource, object_buffer_internal);
+
+    return 0;
+}
+
+
+/* Basic */
+
+/* Create a buffer object owning 'data' */
+static struct virtual_machine_object *virtual_machine_object_buffer_new_with_internal_data( \
+        struct virtual_machine *vm, unsigned char *data, const size_t size)
+{
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_buffer *new_object_buffer = NULL;
+    struct virtual_machine_object_buffer_internal *new_object_buffer_internal = NULL;
+
+    /* Create the internal part */
+    if ((new_object_buffer_internal = (struct virtual_machine_object_buffer_internal *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_object_buffer_internal))) == NULL)
+    { goto fail; }
+    new_object_buffer_internal->data = data;
+    new_object_buffer_internal->size = size;
+    new_object_buffer_internal->vm = vm;
+
+    /* Create the shell part */
+    if ((new_object_buffer = (struct virtual_machine_object_buffer *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_object_buffer))) == NULL)
+    { goto fail; }
+    new_object_buffer->ptr_internal = new_object_buffer_internal;
+    new_object_buffer->offset = 0;
+    new_object_buffer->size = size;
+
+    /* Create the object's infrastructure */
+    if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_BUFFER)) == NULL)
+    { goto fail; }
+    if (_virtual_machine_object_ptr_set(new_object, new_object_buffer) != 0)
+    { goto fail; }
+    new_object_buffer = NULL;
+
+    if (virtual_machine_resource_reference_register( \
+                vm->gc_stub, \
+                new_object, \
+                new_object_buffer_internal, \
+                &virtual_machine_object_buffer_internal_marker, \
+                &virtual_machine_object_buffer_internal_collector) != 0)
+    {
+        virtual_machine_object_buffer_destroy(vm, new_object);
+        new_object = NULL;
+        goto fail;
+    }
+
+    return new_object;
+fail:
+    if (new_object_buffer != NULL) virtual_machine_resource_free(vm->resource, new_object_buffer);
+    if (new_object != NULL) _virtual_machine_object_destroy(vm, new_object);
+    if (new_object_buffer_internal != NULL) virtual_machine_resource_free(vm->resource, new_object_buffer_internal);
+
+    return NULL;
+}
+
+struct virtual_machine_object *virtual_machine_object_buffer_new_with_size( \
+        struct virtual_machine *vm, const size_t size)
+{
+    struct virtual_machine_object *new_object = NULL;
+    unsigned char *new_data = NULL;
+
+    /* At least 1 byte for the allocator */
+    if ((new_data = (unsigned char *)virtual_machine_resource_malloc_reference( \
+                    vm->resource, sizeof(unsigned char) * (size + 1))) == NULL)
+    { return NULL; }
+    memset(new_data, 0, size + 1);
+    if ((new_object = virtual_machine_object_buffer_new_with_internal_data(vm, new_data, size)) == NULL)
+    { virtual_machine_resource_free_reference(vm->resource, new_data); return NULL; }
+
+    return new_object;
+}
+
+struct virtual_machine_object *virtual_machine_object_buffer_new_with_data( \
+        struct virtual_machine *vm, const void *data, const size_t size)
+{
+    struct virtual_machine_object *new_object = NULL;
+    unsigned char *new_data = NULL;
+
+    if ((new_data = (unsigned char *)virtual_machine_resource_malloc_reference( \
+                    vm->resource, sizeof(unsigned char) * (size + 1))) == NULL)
+    { return NULL; }
+    memcpy(new_data, data, size);
+    if ((new_object = virtual_machine_object_buffer_new_with_internal_data(vm, new_data, size)) == NULL)
+    { virtual_machine_resource_free_reference(vm->resource, new_data); return NULL; }
+
+    return new_object;
+}
+
+int virtual_machine_object_buffer_destroy( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object *object)
+{
+    if (object == NULL) return -MULTIPLE_ERR_NULL_PTR;
+
+    /* The internal part is freed by the garbage collector */
+    if (object->ptr != NULL) virtual_machine_resource_free(vm->resource, object->ptr);
+    _virtual_machine_object_destroy(vm, object);
+
+    return 0;
+}
+
+/* Create a view on the internal part of a buffer */
+static struct virtual_machine_object *virtual_machine_object_buffer_new_view( \
+        struct virtual_machine *vm, \
+        const struct virtual_machine_object *object, \
+        size_t offset, size_t size)
+{
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_buffer *object_buffer = NULL;
+    struct virtual_machine_object_buffer *new_object_buffer = NULL;
+
+    object_buffer = object->ptr;
+
+    if ((new_object_buffer = (struct virtual_machine_object_buffer *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_object_buffer))) == NULL)
+    { goto fail; }
+    new_object_buffer->ptr_internal = object_buffer->ptr_internal;
+    new_object_buffer->offset = offset;
+    new_object_buffer->size = size;
+
+    /* Create the object's infrastructure */
+    if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_BUFFER)) == NULL)
+    { goto fail; }
+    if (_virtual_machine_object_ptr_set(new_object, new_object_buffer) != 0)
+    { goto fail; }
+    new_object_buffer = NULL;
+
+    return new_object;
+fail:
+    if (new_object_buffer != NULL) virtual_machine_resource_free(vm->resource, new_object_buffer);
+    if (new_object != NULL) _virtual_machine_object_destroy(vm, new_object);
+    return NULL;
+}
+
+struct virtual_machine_object *virtual_machine_object_buffer_clone( \
+        struct virtual_machine *vm, \
+        const struct virtual_machine_object *object)
+{
+    struct virtual_machine_object_buffer *object_buffer = NULL;
+
+    if ((object == NULL) || (object->ptr == NULL)) return NULL;
+
+    object_buffer = object->ptr;
+    return virtual_machine_object_buffer_new_view(vm, object, object_buffer->offset, object_buffer->size);
+}
+
+int virtual_machine_object_buffer_print(const struct virtual_machine_object *object)
+{
+    unsigned char *data = NULL;
+    size_t size = 0, idx;
+
+    virtual_machine_object_buffer_data(object, &data, &size);
+
+    printf("<buffer");
+    for (idx = 0; idx != size; idx++)
+    {
+        printf(" %02x", (unsigned int)data[idx]);
+    }
+    printf(">");
+
+    return 0;
+}
+
+int virtual_machine_object_buffer_data(const struct virtual_machine_object *object, \
+        unsigned char **data_out, size_t *size_out)
+{
+    struct virtual_machine_object_buffer *object_buffer = NULL;
+
+    if ((object == NULL) || (object->ptr == NULL)) return -MULTIPLE_ERR_NULL_PTR;
+
+    object_buffer = object->ptr;
+    *data_out = object_buffer->ptr_internal->data + object_buffer->offset;
+    *size_out = object_buffer->size;
+
+    return 0;
+}
+
+/* Size */
+int virtual_machine_object_buffer_size( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, const struct virtual_machine_object *object_src)
+{
+    int ret = 0;
+    struct virtual_machine_object_buffer *object_buffer = object_src->ptr;
+    struct virtual_machine_object *new_object = NULL;
+
+    if ((new_object = virtual_machine_object_int_new_with_value(vm, (int)(object_buffer->size))) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    *object_out = new_object;
+fail:
+    return ret;
+}
+
+/* Check if 'width' bytes from 'offset' are in the buffer */
+static int virtual_machine_object_buffer_range_check(struct virtual_machine *vm, \
+        const struct virtual_machine_object_buffer *object_buffer, \
+        size_t offset, size_t width)
+{
+    if ((offset > object_buffer->size) || (width > object_buffer->size - offset))
+    {
+        vm_err_update(vm->r, -VM_ERR_OUT_OF_BOUNDS, \
+                "runtime error: out of bounds, %u bytes from \'%u\' isn't in bound of %u to %u", \
+                (unsigned int)width, (unsigned int)offset, 0, (unsigned int)object_buffer->size);
+        return -MULTIPLE_ERR_VM;
+    }
+
+    return 0;
+}
+
+/* Index */
+int virtual_machine_object_buffer_ref_get(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        const struct virtual_machine_object *object_idx)
+{
+    int ret = 0;
+    struct virtual_machine_object *object_idx_solved = NULL;
+    struct virtual_machine_object *new_object = NULL;
+    unsigned char *data = NULL;
+    size_t size = 0;
+    int ref_index;
+
+    *object_out = NULL;
+
+    if ((ret = virtual_machine_variable_solve(&object_idx_solved, (struct virtual_machine_object *)object_idx, NULL, 1, vm)) != 0)
+    { goto fail; }
+    if (object_idx_solved->type != OBJECT_TYPE_INT)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type, reference of buffer should be in type \'int\'");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
+
+    virtual_machine_object_buffer_data(object_src, &data, &size);
+    if ((ref_index < 0) || ((size_t)ref_index >= size))
+    {
+        vm_err_update(vm->r, -VM_ERR_OUT_OF_BOUNDS, \
+                "runtime error: out of bounds, reference of element \'%d\' isn't in bound of %u to %u", \
+                ref_index, 0, (unsigned int)size);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    if ((new_object = virtual_machine_object_int_new_with_value(vm, (int)data[ref_index])) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    *object_out = new_object;
+
+fail:
+    if (object_idx_solved != NULL) virtual_machine_object_destroy(vm, object_idx_solved);
+    return ret;
+}
+
+int virtual_machine_object_buffer_ref_set(struct virtual_machine *vm, \
+        struct virtual_machine_object *object_src, \
+        struct virtual_machine_object *object_idx, \
+        struct virtual_machine_object *object_value)
+{
+    int ret = 0;
+    struct virtual_machine_object *object_idx_solved = NULL;
+    struct virtual_machine_object *object_value_solved = NULL;
+    unsigned char *data = NULL;
+    size_t size = 0;
+    int ref_index;
+
+    if ((ret = virtual_machine_variable_solve(&object_idx_solved, object_idx, NULL, 1, vm)) != 0)
+    { goto fail; }
+    if ((ret = virtual_machine_variable_solve(&object_value_solved, object_value, NULL, 1, vm)) != 0)
+    { goto fail; }
+    if ((object_idx_solved->type != OBJECT_TYPE_INT) || (object_value_solved->type != OBJECT_TYPE_INT))
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type, reference and value of buffer should be in type \'int\'");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
+
+    virtual_machine_object_buffer_data(object_src, &data, &size);
+    if ((ref_index < 0) || ((size_t)ref_index >= size))
+    {
+        vm_err_update(vm->r, -VM_ERR_OUT_OF_BOUNDS, \
+                "runtime error: out of bounds, reference of element \'%d\' isn't in bound of %u to %u", \
+                ref_index, 0, (unsigned int)size);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    data[ref_index] = (unsigned char)virtual_machine_object_int_get_primitive_value(object_value_solved);
+
+fail:
+    if (object_idx_solved != NULL) virtual_machine_object_destroy(vm, object_idx_solved);
+    if (object_value_solved != NULL) virtual_machine_object_destroy(vm, object_value_solved);
+    return ret;
+}
+
+/* Slice */
+int virtual_machine_object_buffer_slice(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        size_t offset, size_t length)
+{
+    int ret = 0;
+    struct virtual_machine_object_buffer *object_buffer = NULL;
+    struct virtual_machine_object *new_object = NULL;
+
+    *object_out = NULL;
+
+    if (object_src->type != OBJECT_TYPE_BUFFER)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type");
+        return -MULTIPLE_ERR_VM;
+    }
+    object_buffer = object_src->ptr;
+    if ((ret = virtual_machine_object_buffer_range_check(vm, object_buffer, offset, length)) != 0)
+    { return ret; }
+
+    if ((new_object = virtual_machine_object_buffer_new_view(vm, object_src, \
+                    object_buffer->offset + offset, length)) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        return -MULTIPLE_ERR_VM;
+    }
+    /* Keeps the bytes alive as a clone does */
+    new_object->object_table_item_ptr = object_src->object_table_item_ptr;
+    *object_out = new_object;
+
+    return 0;
+}
+
+/* Integers and floats */
+
+int virtual_machine_object_buffer_get_uint(struct virtual_machine *vm, \
+        uint64_t *value_out, \
+        const struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order)
+{
+    int ret = 0;
+    unsigned char *data = NULL;
+    size_t size = 0, idx;
+    uint64_t value = 0;
+
+    *value_out = 0;
+
+    if ((width == 0) || (width > sizeof(uint64_t)))
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: invalid operand, %u bytes integer isn't supported", (unsigned int)width);
+        return -MULTIPLE_ERR_VM;
+    }
+    if ((ret = virtual_machine_object_buffer_range_check(vm, object->ptr, offset, width)) != 0)
+    { return ret; }
+
+    virtual_machine_object_buffer_data(object, &data, &size);
+    data += offset;
+    for (idx = 0; idx != width; idx++)
+    {
+        value |= (uint64_t)data[order == VIRTUAL_MACHINE_OBJECT_BUFFER_ORDER_LITTLE ? idx : width - 1 - idx] << (8 * idx);
+    }
+    *value_out = value;
+
+    return 0;
+}
+
+int virtual_machine_object_buffer_set_uint(struct virtual_machine *vm, \
+        struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order, uint64_t value)
+{
+    int ret = 0;
+    unsigned char *data = NULL;
+    size_t size = 0, idx;
+
+    if ((width == 0) || (width > sizeof(uint64_t)))
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: invalid operand, %u bytes integer isn't supported", (unsigned int)width);
+        return -MULTIPLE_ERR_VM;
+    }
+    if ((ret = virtual_machine_object_buffer_range_check(vm, object->ptr, offset, width)) != 0)
+    { return ret; }
+
+    virtual_machine_object_buffer_data(object, &data, &size);
+    data += offset;
+    for (idx = 0; idx != width; idx++)
+    {
+        data[order == VIRTUAL_MACHINE_OBJECT_BUFFER_ORDER_LITTLE ? idx : width - 1 - idx] = (unsigned char)(value & 0xff);
+        value >>= 8;
+    }
+
+    return 0;
+}
+
+int virtual_machine_object_buffer_get_float(struct virtual_machine *vm, \
+        double *value_out, \
+        const struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order)
+{
+    int ret = 0;
+    uint64_t bits;
+    uint32_t bits32;
+    float value_float;
+    double value_double;
+
+    *value_out = 0.0;
+
+    if ((width != sizeof(float)) && (width != sizeof(double)))
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: invalid operand, %u bytes float isn't supported", (unsigned int)width);
+        return -MULTIPLE_ERR_VM;
+    }
+    if ((ret = virtual_machine_object_buffer_get_uint(vm, &bits, object, offset, width, order)) != 0)
+    { return ret; }
+
+    if (width == sizeof(float))
+    {
+        bits32 = (uint32_t)bits;
+        memcpy(&value_float, &bits32, sizeof(float));
+        *value_out = (double)value_float;
+    }
+    else
+    {
+        memcpy(&value_double, &bits, sizeof(double));
+        *value_out = value_double;
+    }
+
+    return 0;
+}
+
+int virtual_machine_object_buffer_set_float(struct virtual_machine *vm, \
+        struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order, double value)
+{
+    uint64_t bits;
+    uint32_t bits32;
+    float value_float;
+
+    if ((width != sizeof(float)) && (width != sizeof(double)))
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: invalid operand, %u bytes float isn't supported", (unsigned int)width);
+        return -MULTIPLE_ERR_VM;
+    }
+
+    if (width == sizeof(float))
+    {
+        value_float = (float)value;
+        memcpy(&bits32, &value_float, sizeof(float));
+        bits = bits32;
+    }
+    else
+    {
+        memcpy(&bits, &value, sizeof(double));
+    }
+
+    return virtual_machine_object_buffer_set_uint(vm, object, offset, width, order, bits);
+}
+
+/* Search */
+
+#if defined(__SSE2__)
+/* Index of the lowest set bit of a non-zero mask */
+static size_t virtual_machine_object_buffer_mask_first(unsigned int mask)
+{
+#if defined(__GNUC__)
+    return (size_t)__builtin_ctz(mask);
+#else
+    size_t idx = 0;
+    while ((mask & 1) == 0) { mask >>= 1; idx++; }
+    return idx;
+#endif
+}
+#endif
+
+/* Candidates are filtered by the first and the last byte of the needle
+ * in 32 (AVX2) or 16 (SSE2) positions a time, then verified by memcmp() */
+static int virtual_machine_object_buffer_find_bytes(size_t *pos_out, \
+        const unsigned char *data, const size_t size, \
+        const unsigned char *needle, const size_t needle_len)
+{
+    size_t idx = 0, idx_end = size - needle_len + 1;
+    const unsigned char *p;
+
+#if defined(__AVX2__)
+    {
+        const __m256i v_first = _mm256_set1_epi8((char)needle[0]);
+        const __m256i v_last = _mm256_set1_epi8((char)needle[needle_len - 1]);
+        __m256i v_block_first, v_block_last;
+        unsigned int mask;
+
+        while (idx + 32 <= idx_end)
+        {
+            v_block_first = _mm256_loadu_si256((const __m256i *)(const void *)(data + idx));
+            v_block_last = _mm256_loadu_si256((const __m256i *)(const void *)(data + idx + needle_len - 1));
+            mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256( \
+                        _mm256_cmpeq_epi8(v_block_first, v_first), \
+                        _mm256_cmpeq_epi8(v_block_last, v_last)));
+            while (mask != 0)
+            {
+                p = data + idx + virtual_machine_object_buffer_mask_first(mask);
+                if (memcmp(p + 1, needle + 1, needle_len - 1) == 0)
+                {
+                    *pos_out = (size_t)(p - data);
+                    return 1;
+                }
+                mask &= mask - 1;
+            }
+            idx += 32;
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    {
+        const __m128i v_first_sse = _mm_set1_epi8((char)needle[0]);
+        const __m128i v_last_sse = _mm_set1_epi8((char)needle[needle_len - 1]);
+        __m128i v_block_first_sse, v_block_last_sse;
+        unsigned int mask_sse;
+
+        while (idx + 16 <= idx_end)
+        {
+            v_block_first_sse = _mm_loadu_si128((const __m128i *)(const void *)(data + idx));
+            v_block_last_sse = _mm_loadu_si128((const __m128i *)(const void *)(data + idx + needle_len - 1));
+            mask_sse = (unsigned int)_mm_movemask_epi8(_mm_and_si128( \
+                        _mm_cmpeq_epi8(v_block_first_sse, v_first_sse), \
+                        _mm_cmpeq_epi8(v_block_last_sse, v_last_sse)));
+            while (mask_sse != 0)
+            {
+                p = data + idx + virtual_machine_object_buffer_mask_first(mask_sse);
+                if (memcmp(p + 1, needle + 1, needle_len - 1) == 0)
+                {
+                    *pos_out = (size_t)(p - data);
+                    return 1;
+                }
+                mask_sse &= mask_sse - 1;
+            }
+            idx += 16;
+        }
+    }
+#endif
+
+    /* Remaining candidates */
+    for (; idx != idx_end; idx++)
+    {
+        if ((data[idx] == needle[0]) && \
+                (memcmp(data + idx + 1, needle + 1, needle_len - 1) == 0))
+        {
+            *pos_out = idx;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int virtual_machine_object_buffer_find(const struct virtual_machine_object *object, \
+        size_t *pos_out, size_t from, \
+        const void *needle, const size_t needle_len)
+{
+    unsigned char *data = NULL;
+    size_t size = 0, pos = 0;
+
+    virtual_machine_object_buffer_data(object, &data, &size);
+    if ((from > size) || (needle_len > size - from)) return 0;
+    if (needle_len == 0) { *pos_out = from; return 1; }
+
+    if (virtual_machine_object_buffer_find_bytes(&pos, data + from, size - from, needle, needle_len) == 0)
+    { return 0; }
+    *pos_out = from + pos;
+
+    return 1;
+}
+
+/* memcmp() of libc picks its vector implementation at runtime, 
+ * which is faster than the SSE2 or AVX2 code built here */
+int virtual_machine_object_buffer_compare(const struct virtual_machine_object *object_left, \
+        const struct virtual_machine_object *object_right)
+{
+    unsigned char *data_left = NULL, *data_right = NULL;
+    size_t size_left = 0, size_right = 0;
+    int ret;
+
+    virtual_machine_object_buffer_data(object_left, &data_left, &size_left);
+    virtual_machine_object_buffer_data(object_right, &data_right, &size_right);
+
+    ret = memcmp(data_left, data_right, size_left < size_right ? size_left : size_right);
+    if (ret != 0) return ret < 0 ? -1 : 1;
+    if (size_left == size_right) return 0;
+    return size_left < size_right ? -1 : 1;
+}
+
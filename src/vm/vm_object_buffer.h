@@ -0,0 +1,125 @@
+/* Buffer Objects
+ * Copyright(C) 2013-2014 Cheryl Natsu
+
+ * This file is part of multiple - Multiple Paradigm Language Emulator
+
+ * multiple is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * multiple is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VM_OBJECT_BUFFER_H_
+#define _VM_OBJECT_BUFFER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "vm_infrastructure.h"
+#include "vm_err.h"
+
+struct virtual_machine_object;
+
+/* Internal Part */
+
+/* Bytes shared by a buffer, its clones and its slices */
+struct virtual_machine_object_buffer_internal
+{
+    /* Allocated from the reference objects of the resource allocator */
+    unsigned char *data;
+    size_t size;
+
+    struct virtual_machine *vm;
+};
+
+/* Internal Marker */
+int virtual_machine_object_buffer_internal_marker(void *object_internal);
+/* Internal Collector */
+int virtual_machine_object_buffer_internal_collector(void *object_internal, int *confirm);
+
+
+/* Shell Part */
+struct virtual_machine_object_buffer
+{
+    /* Pointer to internal (the kernel part) */
+    struct virtual_machine_object_buffer_internal *ptr_internal;
+
+    /* The range visible through this object */
+    size_t offset;
+    size_t size;
+};
+
+/* Basic */
+struct virtual_machine_object *virtual_machine_object_buffer_new_with_size( \
+        struct virtual_machine *vm, const size_t size);
+struct virtual_machine_object *virtual_machine_object_buffer_new_with_data( \
+        struct virtual_machine *vm, const void *data, const size_t size);
+int virtual_machine_object_buffer_destroy( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object *object);
+struct virtual_machine_object *virtual_machine_object_buffer_clone( \
+        struct virtual_machine *vm, \
+        const struct virtual_machine_object *object);
+int virtual_machine_object_buffer_print(const struct virtual_machine_object *object);
+
+/* Bytes visible through the object, no copy */
+int virtual_machine_object_buffer_data(const struct virtual_machine_object *object, \
+        unsigned char **data_out, size_t *size_out);
+
+/* Size */
+int virtual_machine_object_buffer_size( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, const struct virtual_machine_object *object_src);
+
+/* Index, byte values */
+int virtual_machine_object_buffer_ref_get(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        const struct virtual_machine_object *object_idx);
+int virtual_machine_object_buffer_ref_set(struct virtual_machine *vm, \
+        struct virtual_machine_object *object_src, \
+        struct virtual_machine_object *object_idx, \
+        struct virtual_machine_object *object_value);
+
+/* Slice of 'length' bytes from 'offset', shares bytes with the source */
+int virtual_machine_object_buffer_slice(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src, \
+        size_t offset, size_t length);
+
+/* Integers and floats in 'width' bytes at 'offset' */
+#define VIRTUAL_MACHINE_OBJECT_BUFFER_ORDER_LITTLE 0
+#define VIRTUAL_MACHINE_OBJECT_BUFFER_ORDER_BIG 1
+int virtual_machine_object_buffer_get_uint(struct virtual_machine *vm, \
+        uint64_t *value_out, \
+        const struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order);
+int virtual_machine_object_buffer_set_uint(struct virtual_machine *vm, \
+        struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order, uint64_t value);
+int virtual_machine_object_buffer_get_float(struct virtual_machine *vm, \
+        double *value_out, \
+        const struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order);
+int virtual_machine_object_buffer_set_float(struct virtual_machine *vm, \
+        struct virtual_machine_object *object, \
+        size_t offset, size_t width, int order, double value);
+
+/* Search 'needle' from 'from', 1 for found, 0 for not */
+int virtual_machine_object_buffer_find(const struct virtual_machine_object *object, \
+        size_t *pos_out, size_t from, \
+        const void *needle, const size_t needle_len);
+/* Compare bytes in memcmp() order, gives -1, 0 or 1 */
+int virtual_machine_object_buffer_compare(const struct virtual_machine_object *object_left, \
+        const struct virtual_machine_object *object_right);
+
+#endif
+
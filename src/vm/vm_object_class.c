@@ -171,7 +171,7 @@ static int virtual_machine_run_internal_function(struct virtual_machine *vm, \
     { goto fail; }
     new_running_stack_frame = NULL;
 
-    if ((ret = virtual_machine_thread_list_append(vm->threads, new_thread)) != 0)
+    if ((ret = virtual_machine_thread_list_append(vm, vm->threads, new_thread)) != 0)
     { goto fail; }
 
     /* Warning: Because the new running stack frame (Including the new thread) been created, 
@@ -707,6 +707,7 @@ int virtual_machine_object_class_property_set(struct virtual_machine_object **ob
 
     object_identifier_property = object_property->ptr;
     object_class = object_src_solved->ptr;
+    gc_write_barrier(object_src_solved->object_table_item_ptr, object_value_solved->object_table_item_ptr);
 
     ret = virtual_machine_variable_list_update_with_configure(vm, \
             object_class->ptr_internal->properties, \
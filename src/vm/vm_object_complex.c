@@ -79,8 +79,8 @@ struct virtual_machine_object *virtual_machine_object_complex_new_with_ff( \
 
 struct virtual_machine_object *virtual_machine_object_complex_new_with_rr( \
         struct virtual_machine *vm, \
-        int real_sign, const unsigned int real_rat_numerator, const unsigned int real_rat_denumerator, \
-        int image_sign, const unsigned int image_rat_numerator, const unsigned int image_rat_denumerator)
+        int real_sign, const uint64_t real_rat_numerator, const uint64_t real_rat_denumerator, \
+        int image_sign, const uint64_t image_rat_numerator, const uint64_t image_rat_denumerator)
 {
     struct virtual_machine_object *new_object = NULL;
     struct virtual_machine_object_complex *new_object_complex = NULL;
@@ -192,11 +192,12 @@ int virtual_machine_object_complex_print(const struct virtual_machine_object *ob
             }
 			else if (object_complex->real.numeric.rat.denominator == 1)
             {
-				printf("%u", object_complex->real.numeric.rat.numerator);
+				printf("%llu", (unsigned long long)object_complex->real.numeric.rat.numerator);
             }
             else
             {
-				printf("%u/%u", object_complex->real.numeric.rat.numerator, object_complex->real.numeric.rat.denominator);
+				printf("%llu/%llu", (unsigned long long)object_complex->real.numeric.rat.numerator, \
+                        (unsigned long long)object_complex->real.numeric.rat.denominator);
             }
             break;
     }
@@ -219,11 +220,12 @@ int virtual_machine_object_complex_print(const struct virtual_machine_object *ob
             }
             else if (object_complex->image.numeric.rat.denominator == 1)
             {
-                printf("%u", object_complex->image.numeric.rat.numerator); 
+                printf("%llu", (unsigned long long)object_complex->image.numeric.rat.numerator); 
             }
             else
             {
-				printf("%u/%u", object_complex->image.numeric.rat.numerator, object_complex->image.numeric.rat.denominator);
+				printf("%llu/%llu", (unsigned long long)object_complex->image.numeric.rat.numerator, \
+                        (unsigned long long)object_complex->image.numeric.rat.denominator);
             }
             break;
     }
@@ -37,8 +37,8 @@ struct virtual_machine_object_complex
         {
 			struct virtual_machine_object_complex_part_numeric_rat
             {
-                unsigned int numerator;
-                unsigned int denominator;
+                uint64_t numerator;
+                uint64_t denominator;
             } rat;
             double flt;
 		} numeric;
@@ -56,8 +56,8 @@ struct virtual_machine_object *virtual_machine_object_complex_new_with_ff( \
         int image_sign, const double image_flt);
 struct virtual_machine_object *virtual_machine_object_complex_new_with_rr( \
         struct virtual_machine *vm, \
-        int real_sign, const unsigned int real_rat_numerator, const unsigned int real_rat_denumerator, \
-        int image_sign, const unsigned int image_rat_numerator, const unsigned int image_rat_denumerator);
+        int real_sign, const uint64_t real_rat_numerator, const uint64_t real_rat_denumerator, \
+        int image_sign, const uint64_t image_rat_numerator, const uint64_t image_rat_denumerator);
 /* destroy */
 int virtual_machine_object_complex_destroy( \
         struct virtual_machine *vm, \
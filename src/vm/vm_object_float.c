@@ -335,7 +335,7 @@ int virtual_machine_object_float_convert(struct virtual_machine *vm, \
         case OBJECT_TYPE_INT:
             new_object = virtual_machine_object_int_new_with_value(
                     vm, \
-                    (int)(((struct virtual_machine_object_float *)(object_src->ptr))->value));
+                    (int64_t)(((struct virtual_machine_object_float *)(object_src->ptr))->value));
             break;
         case OBJECT_TYPE_BOOL:
             new_object = virtual_machine_object_bool_new_with_value( \
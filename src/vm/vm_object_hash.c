@@ -517,6 +517,8 @@ int virtual_machine_object_hash_append( \
 
     object_hash = object->ptr;
     object_hash_internal = object_hash->ptr_internal;
+    gc_write_barrier(object->object_table_item_ptr, object_new_sub_value->object_table_item_ptr);
+    gc_shade(object_new_sub_key->object_table_item_ptr);
 
     if ((ret = virtual_machine_object_hash_internal_append(vm, \
             object_hash_internal, object_new_sub_key, object_new_sub_value)) != 0)
@@ -862,6 +864,7 @@ int virtual_machine_object_hash_ref_set(struct virtual_machine *vm, \
         ret = -MULTIPLE_ERR_VM;
         goto fail; 
     }
+    gc_write_barrier(object_src->object_table_item_ptr, object_value_solved->object_table_item_ptr);
 
     if ((ret = _virtual_machine_object_hash_ref_set_by_raw_index(object_src, object_idx, object_value_solved, vm, &exists)) != 0)
     { goto fail; }
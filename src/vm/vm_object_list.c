@@ -39,6 +39,8 @@ int virtual_machine_object_list_internal_destroy( \
 int virtual_machine_object_list_internal_append(struct virtual_machine *vm, \
         struct virtual_machine_object_list_internal *object_list_internal, \
         struct virtual_machine_object *object_new_sub, int order);
+static int virtual_machine_object_list_internal_unshare(struct virtual_machine *vm, \
+        struct virtual_machine_object_list_internal *object_list_internal);
 
 
 /* Internal Marker */
@@ -132,6 +134,7 @@ static struct virtual_machine_object_list_internal *virtual_machine_object_list_
     new_object_list_internal->size = 0;
     new_object_list_internal->index = NULL;
     new_object_list_internal->ref_by_idx_count = 0;
+    new_object_list_internal->shared = 0;
     new_object_list_internal->vm = vm;
 
     goto done;
@@ -145,25 +148,30 @@ done:
     return new_object_list_internal;
 }
 
+/* Drop a reference to the node, 
+ * nodes no longer referenced are destroyed along the chain */
+static void virtual_machine_object_list_internal_node_release( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object_list_internal_node *object_list_node)
+{
+    struct virtual_machine_object_list_internal_node *object_list_node_next;
+
+    while ((object_list_node != NULL) && (--object_list_node->refcount == 0))
+    {
+        object_list_node_next = object_list_node->next; 
+        virtual_machine_object_destroy(vm, object_list_node->ptr);
+        virtual_machine_resource_free(vm->resource, object_list_node);
+        object_list_node = object_list_node_next;
+    }
+}
+
 int virtual_machine_object_list_internal_destroy( \
         struct virtual_machine *vm, \
         struct virtual_machine_object_list_internal *object_list_internal)
 {
-    struct virtual_machine_object_list_internal_node *object_list_node_cur, *object_list_node_next;
-    struct virtual_machine_object *virtual_machine_object_list_node_object;
-
     if (object_list_internal == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
-    object_list_node_cur = object_list_internal->begin;
-
-    while (object_list_node_cur != NULL)
-    {
-        object_list_node_next = object_list_node_cur->next; 
-        virtual_machine_object_list_node_object = object_list_node_cur->ptr;
-        virtual_machine_object_destroy(vm, virtual_machine_object_list_node_object);
-        virtual_machine_resource_free(vm->resource, object_list_node_cur);
-        object_list_node_cur = object_list_node_next;
-    }
+    virtual_machine_object_list_internal_node_release(vm, object_list_internal->begin);
 
     if (object_list_internal->index != NULL) 
     {
@@ -404,7 +412,6 @@ int virtual_machine_object_list_ref_get(struct virtual_machine *vm, \
     struct virtual_machine_object *object_src_solved= NULL;
     struct virtual_machine_object_list *object_src_solved_list = NULL;
     struct virtual_machine_object *object_idx_solved= NULL;
-    struct virtual_machine_object_int *object_ref_index = NULL;
     int ref_index;
 
     *object_out = NULL;
@@ -429,8 +436,7 @@ int virtual_machine_object_list_ref_get(struct virtual_machine *vm, \
         goto fail; 
     }
 
-    object_ref_index = (struct virtual_machine_object_int *)object_idx_solved->ptr;
-    ref_index = object_ref_index->value;
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
     object_src_solved_list = object_src_solved->ptr;
 
     if ((ret = _virtual_machine_object_list_internal_ref_get_by_raw_index(object_out, object_src_solved_list->ptr_internal, ref_index, vm)) != 0)
@@ -442,14 +448,12 @@ fail:
     return ret;
 }
 
-static int _virtual_machine_object_list_internal_ref_set_by_raw_index(const struct virtual_machine_object_list_internal *object_list_internal_src, \
+static int _virtual_machine_object_list_internal_ref_set_by_raw_index(struct virtual_machine_object_list_internal *object_list_internal_src, \
         int ref_index, const struct virtual_machine_object *object_value, struct virtual_machine *vm)
 {
     int ret = 0;
     struct virtual_machine_object_list_internal_node *list_internal_node_cur = NULL;
 
-    (void)vm;
-
     if (object_list_internal_src->size == 0) 
     {
         vm_err_update(vm->r, -VM_ERR_OUT_OF_BOUNDS, \
@@ -467,6 +471,10 @@ static int _virtual_machine_object_list_internal_ref_set_by_raw_index(const stru
         goto fail; 
     }
 
+    /* Other lists sharing the node should not see the change */
+    if ((ret = virtual_machine_object_list_internal_unshare(vm, object_list_internal_src)) != 0)
+    { goto fail; }
+
     list_internal_node_cur = object_list_internal_src->begin;
     while (list_internal_node_cur != NULL)
     {
@@ -503,7 +511,6 @@ int virtual_machine_object_list_ref_set(struct virtual_machine *vm, \
     struct virtual_machine_object_list *object_src_solved_list = NULL;
     struct virtual_machine_object *object_idx_solved= NULL;
     struct virtual_machine_object *object_value_solved = NULL;
-    struct virtual_machine_object_int *object_ref_index = NULL;
     int ref_index;
 
     *object_out = NULL;
@@ -530,10 +537,10 @@ int virtual_machine_object_list_ref_set(struct virtual_machine *vm, \
         goto fail; 
     }
 
-    object_ref_index = (struct virtual_machine_object_int *)object_idx_solved->ptr;
-    ref_index = object_ref_index->value;
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
 
     object_src_solved_list = object_src_solved->ptr;
+    gc_write_barrier(object_src_solved->object_table_item_ptr, object_value_solved->object_table_item_ptr);
     if ((ret = _virtual_machine_object_list_internal_ref_set_by_raw_index(object_src_solved_list->ptr_internal, ref_index, object_value_solved, vm)) != 0)
     { goto fail; }
 
@@ -577,15 +584,15 @@ fail:
     return ret;
 }
 
+/* The result shares the nodes after the first one with the source */
 static int virtual_machine_object_list_internal_cdr( \
         struct virtual_machine *vm, \
         struct virtual_machine_object_list_internal **object_list_internal_out, \
-        const struct virtual_machine_object_list_internal *object_list_internal_src)
+        struct virtual_machine_object_list_internal *object_list_internal_src)
 {
     int ret = 0;
 
     struct virtual_machine_object_list_internal *new_object_list_internal = NULL;
-    struct virtual_machine_object_list_internal_node *object_list_internal_node_first = NULL;
 
     *object_list_internal_out = NULL;
 
@@ -598,42 +605,67 @@ static int virtual_machine_object_list_internal_cdr( \
         goto fail;
     }
 
-    /* Complete clone the internal of original list */
-    if ((new_object_list_internal = virtual_machine_object_list_internal_clone(vm, object_list_internal_src)) == NULL)
+    if ((new_object_list_internal = virtual_machine_object_list_internal_new(vm)) == NULL)
     {
         VM_ERR_MALLOC(vm->r);
         ret = -MULTIPLE_ERR_VM;
         goto fail; 
     }
-    
-    if (new_object_list_internal->size != 0)
-    {
 
-        /* Remove the first one */
-        object_list_internal_node_first = new_object_list_internal->begin;
-        new_object_list_internal->begin = new_object_list_internal->begin->next;
-
-        if ((ret = virtual_machine_object_destroy(vm, object_list_internal_node_first->ptr)) != 0) 
-        {
-            VM_ERR_INTERNAL(vm->r);
-            ret = -MULTIPLE_ERR_VM;
-            goto fail; 
-        }
-        virtual_machine_resource_free(vm->resource, object_list_internal_node_first);
-
-        /* Decrease size */
-        new_object_list_internal->size -= 1;
+    /* Share the tail */
+    if (object_list_internal_src->begin->next != NULL)
+    {
+        new_object_list_internal->begin = object_list_internal_src->begin->next;
+        new_object_list_internal->end = object_list_internal_src->end;
+        new_object_list_internal->size = object_list_internal_src->size - 1;
+        new_object_list_internal->begin->refcount++;
+        new_object_list_internal->shared = 1;
+        object_list_internal_src->shared = 1;
     }
 
     *object_list_internal_out = new_object_list_internal;
-    new_object_list_internal = NULL;
 
     ret = 0;
 fail:
-    if (new_object_list_internal != NULL) virtual_machine_object_list_internal_destroy(vm, new_object_list_internal);
     return ret;
 }
 
+/* Wrap an internal part with a new list object */
+static struct virtual_machine_object *virtual_machine_object_list_new_with_internal( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object_list_internal *object_list_internal)
+{
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_list *new_object_list = NULL;
+
+    /* Create the shell part */
+    if ((new_object_list = (struct virtual_machine_object_list *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_object_list))) == NULL)
+    { goto fail; }
+    new_object_list->ptr_internal = object_list_internal;
+
+    /* Create the list's infrastructure */
+    if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_LIST)) == NULL)
+    { goto fail; }
+    if (_virtual_machine_object_ptr_set(new_object, new_object_list) != 0)
+    { goto fail; }
+    new_object_list = NULL;
+
+    if (virtual_machine_resource_reference_register( \
+                vm->gc_stub, \
+                new_object, \
+                object_list_internal, \
+                &virtual_machine_object_list_internal_marker, \
+                &virtual_machine_object_list_internal_collector) != 0)
+    { goto fail; }
+
+    return new_object;
+fail:
+    if (new_object_list != NULL) virtual_machine_resource_free(vm->resource, new_object_list);
+    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
+    return NULL;
+}
+
 int virtual_machine_object_list_cdr( \
         struct virtual_machine *vm, \
         struct virtual_machine_object **object_out, \
@@ -641,7 +673,6 @@ int virtual_machine_object_list_cdr( \
 {
     int ret = 0;
     struct virtual_machine_object *new_object = NULL;
-    struct virtual_machine_object_list *new_object_list = NULL;
     struct virtual_machine_object_list_internal *new_object_list_internal = NULL;
 
     struct virtual_machine_object *object_src_solved = NULL;
@@ -661,34 +692,18 @@ int virtual_machine_object_list_cdr( \
             object_list_internal_src);
     if (ret != 0) { goto fail; }
 
-    /* Create the shell part */
-    if ((new_object_list = (struct virtual_machine_object_list *)virtual_machine_resource_malloc( \
-                    vm->resource, sizeof(struct virtual_machine_object_list))) == NULL)
-    { goto fail; }
-    new_object_list->ptr_internal = new_object_list_internal; new_object_list_internal = NULL;
-
-    /* Create the list's infrastructure */
-    if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_LIST)) == NULL)
-    { goto fail; }
-    if (_virtual_machine_object_ptr_set(new_object, new_object_list) != 0)
-    { goto fail; }
-
-    if (virtual_machine_resource_reference_register( \
-                vm->gc_stub, \
-                new_object, \
-                new_object_list->ptr_internal, \
-                &virtual_machine_object_list_internal_marker, \
-                &virtual_machine_object_list_internal_collector) != 0)
-    { goto fail; }
-
-    new_object_list = NULL;
+    if ((new_object = virtual_machine_object_list_new_with_internal(vm, new_object_list_internal)) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail; 
+    }
+    new_object_list_internal = NULL;
 
     *object_out = new_object; new_object = NULL;
 
 fail:
     if (new_object_list_internal != NULL) virtual_machine_object_list_internal_destroy(vm, new_object_list_internal);
-    if (new_object_list != NULL) virtual_machine_resource_free(vm->resource, new_object_list);
-    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
     if (object_src_solved != NULL) virtual_machine_object_destroy(vm, object_src_solved);
     return ret;
 }
@@ -704,10 +719,12 @@ int virtual_machine_object_list_cdr_set( \
     struct virtual_machine_object *object_src_solved = NULL;
     struct virtual_machine_object *object_member_solved = NULL;
     struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object *new_object_car = NULL;
 
     struct virtual_machine_object_list *object_list = NULL;
     struct virtual_machine_object_list_internal *object_list_internal = NULL;
-    struct virtual_machine_object_list_internal_node *object_list_internal_node = NULL;
+    struct virtual_machine_object_list_internal *object_list_internal_member = NULL;
+    struct virtual_machine_object_list_internal *new_object_list_internal = NULL;
 
     if ((ret = virtual_machine_variable_solve(&object_src_solved, (struct virtual_machine_object *)object_src, NULL, 1, vm)) != 0)
     { goto fail; }
@@ -722,47 +739,50 @@ int virtual_machine_object_list_cdr_set( \
         goto fail; 
     }
 
-    if (object_src_solved->type != OBJECT_TYPE_LIST)
+    object_list = object_src_solved->ptr;
+    object_list_internal = object_list->ptr_internal;
+    if (object_list_internal->size == 0)
     {
-        /* cdr is a list, so the result is a list */
-
-        if ((new_object = virtual_machine_object_list_new(vm)) == NULL)
-        { goto fail; }
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: empty list");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail; 
+    }
 
-        /* Append the car from the src */
-        object_list = object_src_solved->ptr;
-        object_list_internal = object_list->ptr_internal;
-        object_list_internal_node = object_list_internal->begin; 
-        if ((ret = virtual_machine_object_list_append(vm, \
-                        new_object, \
-                        object_list_internal_node->ptr)) != 0)
+    if (object_member_solved->type == OBJECT_TYPE_LIST)
+    {
+        /* cdr is a list, so the result is a list, 
+         * the car from the src followed by the nodes shared with the cdr */
+
+        if ((new_object_list_internal = virtual_machine_object_list_internal_new(vm)) == NULL)
+        { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+        if ((new_object_car = virtual_machine_object_clone(vm, object_list_internal->begin->ptr)) == NULL)
+        { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+        if ((ret = virtual_machine_object_list_internal_append(vm, \
+                        new_object_list_internal, new_object_car, \
+                        VIRTUAL_MACHINE_OBJECT_LIST_INTERNAL_APPEND_TO_TAIL)) != 0)
         { goto fail; }
+        new_object_car = NULL;
 
-        /* Append the cdr part */
-        object_list_internal = object_member_solved->ptr;
-        object_list_internal_node = object_list_internal->begin; 
-        while (object_list_internal_node != NULL)
+        object_list_internal_member = ((struct virtual_machine_object_list *)(object_member_solved->ptr))->ptr_internal;
+        if (object_list_internal_member->begin != NULL)
         {
-            if ((ret = virtual_machine_object_list_append(vm, \
-                            new_object, \
-                            object_list_internal_node->ptr)) != 0)
-            { goto fail; }
-            object_list_internal_node = object_list_internal_node->next; 
+            new_object_list_internal->begin->next = object_list_internal_member->begin;
+            new_object_list_internal->end = object_list_internal_member->end;
+            new_object_list_internal->size += object_list_internal_member->size;
+            object_list_internal_member->begin->refcount++;
+            new_object_list_internal->shared = 1;
+            object_list_internal_member->shared = 1;
         }
+
+        if ((new_object = virtual_machine_object_list_new_with_internal(vm, new_object_list_internal)) == NULL)
+        { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
+        new_object_list_internal = NULL;
     }
     else
     {
         /* cdr is not a list, so the result is a pair */
 
-        object_list = object_src_solved->ptr;
-        object_list_internal = object_list->ptr_internal;
-        if (object_list_internal->size == 0)
-        {
-            vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
-                    "runtime error: empty list");
-            ret = -MULTIPLE_ERR_VM;
-            goto fail; 
-        }
         if ((new_object = virtual_machine_object_pair_make(vm, \
                         object_list_internal->begin->ptr, object_member_solved)) == NULL)
         { goto fail; }
@@ -771,6 +791,8 @@ int virtual_machine_object_list_cdr_set( \
     *object_out = new_object; new_object = NULL;
 
 fail:
+    if (new_object_car != NULL) virtual_machine_object_destroy(vm, new_object_car);
+    if (new_object_list_internal != NULL) virtual_machine_object_list_internal_destroy(vm, new_object_list_internal);
     if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
     if (object_src_solved != NULL) virtual_machine_object_destroy(vm, object_src_solved);
     if (object_member_solved != NULL) virtual_machine_object_destroy(vm, object_member_solved);
@@ -788,6 +810,10 @@ int virtual_machine_object_list_internal_append(struct virtual_machine *vm, \
 
     if (object_list_internal == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
+    /* Other lists sharing the nodes should not see the change */
+    if ((ret = virtual_machine_object_list_internal_unshare(vm, object_list_internal)) != 0)
+    { return ret; }
+
     /* Clean index */
     if (object_list_internal->index != NULL) 
     {
@@ -808,6 +834,7 @@ int virtual_machine_object_list_internal_append(struct virtual_machine *vm, \
     }
     new_object_list_internal_node->next = NULL;
     new_object_list_internal_node->prev = NULL;
+    new_object_list_internal_node->refcount = 1;
     new_object_list_internal_node->ptr = (struct virtual_machine_object *)object_new_sub_solved;
     object_new_sub_solved = NULL;
 
@@ -842,6 +869,55 @@ done:
     return ret;
 }
 
+/* Copy on write, 
+ * take own copy of the nodes if any of them is still shared with another list */
+static int virtual_machine_object_list_internal_unshare(struct virtual_machine *vm, \
+        struct virtual_machine_object_list_internal *object_list_internal)
+{
+    struct virtual_machine_object_list_internal *new_object_list_internal = NULL;
+    struct virtual_machine_object_list_internal_node *list_internal_node_cur;
+
+    if (object_list_internal->shared == 0) return 0;
+
+    /* The other lists might have gone already */
+    list_internal_node_cur = object_list_internal->begin;
+    while ((list_internal_node_cur != NULL) && (list_internal_node_cur->refcount == 1))
+    { list_internal_node_cur = list_internal_node_cur->next; }
+
+    if (list_internal_node_cur != NULL)
+    {
+        if ((new_object_list_internal = virtual_machine_object_list_internal_clone(vm, object_list_internal)) == NULL)
+        {
+            VM_ERR_MALLOC(vm->r);
+            return -MULTIPLE_ERR_VM;
+        }
+
+        /* Swap the nodes */
+        virtual_machine_object_list_internal_node_release(vm, object_list_internal->begin);
+        object_list_internal->begin = new_object_list_internal->begin;
+        object_list_internal->end = new_object_list_internal->end;
+        new_object_list_internal->begin = new_object_list_internal->end = NULL;
+        new_object_list_internal->size = 0;
+        virtual_machine_object_list_internal_destroy(vm, new_object_list_internal);
+
+        /* Index refers to the old nodes */
+        if (object_list_internal->index != NULL) 
+        {
+            virtual_machine_object_list_internal_index_destroy(object_list_internal->index);
+            object_list_internal->index = NULL;
+            object_list_internal->ref_by_idx_count = 0;
+        }
+    }
+    else
+    {
+        /* The previous node belonged to the list sharing nodes */
+        if (object_list_internal->begin != NULL) object_list_internal->begin->prev = NULL;
+    }
+    object_list_internal->shared = 0;
+
+    return 0;
+}
+
 static int virtual_machine_object_list_internal_unpack( \
         struct virtual_machine *vm, \
         struct virtual_machine_object_list_internal *object_list_internal, \
@@ -849,20 +925,36 @@ static int virtual_machine_object_list_internal_unpack( \
 {
     int ret = 0;
     struct virtual_machine_object_list_internal_node *list_internal_node_cur = NULL;
+    struct virtual_machine_object_list_internal_node **list_internal_nodes = NULL;
     struct virtual_machine_object *new_object = NULL;
+    size_t idx;
 
-    switch (order)
+    /* Nodes in order of pushing, 
+     * walk forward only, 'prev' of shared nodes might lead to another list */
+    if (object_list_internal->size != 0)
     {
-        case VIRTUAL_MACHINE_OBJECT_LIST_UNPACK_ORDER_DEFAULT:
-            list_internal_node_cur = object_list_internal->end;
-            break;
-        case VIRTUAL_MACHINE_OBJECT_LIST_UNPACK_ORDER_REVERSE:
-            list_internal_node_cur = object_list_internal->begin;
-            break;
+        if ((list_internal_nodes = (struct virtual_machine_object_list_internal_node **)virtual_machine_resource_malloc( \
+                        vm->resource, sizeof(struct virtual_machine_object_list_internal_node *) * object_list_internal->size)) == NULL)
+        { VM_ERR_MALLOC(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
     }
-    while (list_internal_node_cur != NULL)
+    list_internal_node_cur = object_list_internal->begin;
+    for (idx = 0; idx != object_list_internal->size; idx++)
+    {
+        switch (order)
+        {
+            case VIRTUAL_MACHINE_OBJECT_LIST_UNPACK_ORDER_DEFAULT:
+                list_internal_nodes[object_list_internal->size - 1 - idx] = list_internal_node_cur;
+                break;
+            case VIRTUAL_MACHINE_OBJECT_LIST_UNPACK_ORDER_REVERSE:
+                list_internal_nodes[idx] = list_internal_node_cur;
+                break;
+        }
+        list_internal_node_cur = list_internal_node_cur->next; 
+    }
+
+    for (idx = 0; idx != object_list_internal->size; idx++)
     {
-        if ((new_object = virtual_machine_object_clone(vm, list_internal_node_cur->ptr)) == NULL)
+        if ((new_object = virtual_machine_object_clone(vm, list_internal_nodes[idx]->ptr)) == NULL)
         {
             VM_ERR_MALLOC(vm->r);
             ret = -MULTIPLE_ERR_VM;
@@ -873,16 +965,6 @@ static int virtual_machine_object_list_internal_unpack( \
                         new_object)) != 0)
         { VM_ERR_INTERNAL(vm->r); ret = -MULTIPLE_ERR_VM; goto fail; }
         new_object = NULL;
-
-        switch (order)
-        {
-            case VIRTUAL_MACHINE_OBJECT_LIST_UNPACK_ORDER_DEFAULT:
-                list_internal_node_cur = list_internal_node_cur->prev; 
-                break;
-            case VIRTUAL_MACHINE_OBJECT_LIST_UNPACK_ORDER_REVERSE:
-                list_internal_node_cur = list_internal_node_cur->next; 
-                break;
-        }
     }
 
     if ((new_object = virtual_machine_object_int_new_with_value( \
@@ -898,6 +980,7 @@ static int virtual_machine_object_list_internal_unpack( \
 fail:
     if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
 done:
+    if (list_internal_nodes != NULL) virtual_machine_resource_free(vm->resource, list_internal_nodes);
     return ret;
 }
 
@@ -908,33 +991,19 @@ struct virtual_machine_object *virtual_machine_object_list_new( \
         struct virtual_machine *vm)
 {
     struct virtual_machine_object *new_object = NULL;
-    struct virtual_machine_object_list *new_object_list = NULL;
-
-    /* Create list object */
-    if ((new_object_list = (struct virtual_machine_object_list *)virtual_machine_resource_malloc( \
-                    vm->resource, sizeof(struct virtual_machine_object_list))) == NULL)
-    { goto fail; }
-    new_object_list->ptr_internal = NULL;
-    new_object_list->ptr_internal = virtual_machine_object_list_internal_new(vm);
-    if (new_object_list->ptr_internal == NULL) { goto fail; }
+    struct virtual_machine_object_list_internal *new_object_list_internal = NULL;
 
-    /* Create the object's infrastructure */
-    if ((new_object = _virtual_machine_object_new(vm, OBJECT_TYPE_LIST)) == NULL)
-    { goto fail; }
-    if (_virtual_machine_object_ptr_set(new_object, new_object_list) != 0)
-    { goto fail; }
-    new_object_list = NULL;
+    if ((new_object_list_internal = virtual_machine_object_list_internal_new(vm)) == NULL)
+    { return NULL; }
 
-    return new_object;
-fail:
-    if (new_object_list != NULL) 
+    /* Create list object, registered to GC */
+    if ((new_object = virtual_machine_object_list_new_with_internal(vm, new_object_list_internal)) == NULL)
     {
-        if (new_object_list->ptr_internal != NULL) virtual_machine_object_list_internal_destroy(vm, new_object_list->ptr_internal);
-        virtual_machine_resource_free(vm->resource, new_object_list);
+        virtual_machine_object_list_internal_destroy(vm, new_object_list_internal);
+        return NULL;
     }
-    if (new_object != NULL) _virtual_machine_object_destroy(vm, new_object);
 
-    return NULL;
+    return new_object;
 }
 
 int virtual_machine_object_list_destroy( \
@@ -1073,6 +1142,7 @@ int virtual_machine_object_list_append( \
 
     object_list = object->ptr;
     object_list_internal = object_list->ptr_internal;
+    gc_write_barrier(object->object_table_item_ptr, object_new_sub->object_table_item_ptr);
 
     if ((ret = virtual_machine_object_list_internal_append(vm, \
             object_list_internal, object_new_sub, VIRTUAL_MACHINE_OBJECT_LIST_INTERNAL_APPEND_TO_TAIL)) != 0)
@@ -1092,6 +1162,7 @@ int virtual_machine_object_list_append_to_head( \
 
     object_list = object->ptr;
     object_list_internal = object_list->ptr_internal;
+    gc_write_barrier(object->object_table_item_ptr, object_new_sub->object_table_item_ptr);
 
     if ((ret = virtual_machine_object_list_internal_append(vm, \
             object_list_internal, object_new_sub, VIRTUAL_MACHINE_OBJECT_LIST_INTERNAL_APPEND_TO_HEAD)) != 0)
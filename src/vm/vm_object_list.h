@@ -38,11 +38,16 @@ struct virtual_machine_object_list_internal_index
     size_t size;
 };
 
+/* Nodes are shared between a list and the lists made from its tail (cdr), 
+ * 'prev' of a shared node might point into another list */
 struct virtual_machine_object_list_internal_node
 {
     struct virtual_machine_object *ptr;
     struct virtual_machine_object_list_internal_node *next;
     struct virtual_machine_object_list_internal_node *prev;
+
+    /* References from the previous node or from the beginning of lists */
+    size_t refcount;
 };
 
 struct virtual_machine_object_list_internal
@@ -54,6 +59,10 @@ struct virtual_machine_object_list_internal
     struct virtual_machine_object_list_internal_index *index;
     size_t ref_by_idx_count;
 
+    /* Nodes might be shared with other lists, 
+     * copied before modifying if they really are */
+    int shared;
+
     struct virtual_machine *vm;
 };
 
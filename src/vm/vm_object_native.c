@@ -26,6 +26,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
 
 #include "multiple_err.h"
 
@@ -46,7 +48,7 @@
 /* Create a new native object with specified value */
 struct virtual_machine_object *virtual_machine_object_int_new_with_value( \
         struct virtual_machine *vm, \
-        const int value)
+        const int64_t value)
 {
     struct virtual_machine_object *new_object = NULL;
     struct virtual_machine_object_int *new_object_int = NULL;
@@ -108,13 +110,13 @@ int virtual_machine_object_int_print(const struct virtual_machine_object *object
 {
     if ((object == NULL) || (object->ptr == NULL)) return -MULTIPLE_ERR_NULL_PTR;
 
-    printf("%d", ((struct virtual_machine_object_int *)(object->ptr))->value);
+    printf("%lld", (long long)((struct virtual_machine_object_int *)(object->ptr))->value);
 
     return 0;
 }
 
 /* get primitive value */
-int virtual_machine_object_int_get_primitive_value(const struct virtual_machine_object *object)
+int64_t virtual_machine_object_int_get_primitive_value(const struct virtual_machine_object *object)
 {
     struct virtual_machine_object_int *object_int;
 
@@ -123,8 +125,38 @@ int virtual_machine_object_int_get_primitive_value(const struct virtual_machine_
     return object_int->value; 
 }
 
+int virtual_machine_object_int_get_primitive_value_saturated(const struct virtual_machine_object *object)
+{
+    struct virtual_machine_object_int *object_int;
+
+    object_int = object->ptr;
+
+    if (object_int->value > INT_MAX) return INT_MAX;
+    if (object_int->value < INT_MIN) return INT_MIN;
+    return (int)object_int->value; 
+}
+
+/* get primitive value as a count */
+int virtual_machine_object_int_get_count(struct virtual_machine *vm, \
+        size_t *count_out, const struct virtual_machine_object *object, const size_t limit)
+{
+    int64_t value;
+
+    value = ((struct virtual_machine_object_int *)object->ptr)->value;
+    if ((value < 0) || ((uint64_t)value > (uint64_t)limit))
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: invalid operand, count \'%lld\' isn't in bound of 0 to %u", \
+                (long long)value, (unsigned int)limit);
+        return -MULTIPLE_ERR_VM;
+    }
+    *count_out = (size_t)value;
+
+    return 0;
+}
+
 /* set primitive value */
-int virtual_machine_object_int_set_primitive_value(const struct virtual_machine_object *object, int value)
+int virtual_machine_object_int_set_primitive_value(const struct virtual_machine_object *object, int64_t value)
 {
     struct virtual_machine_object_int *object_int;
 
@@ -137,6 +169,57 @@ int virtual_machine_object_int_set_primitive_value(const struct virtual_machine_
 
 #define OP_LITERAL_LEN 32
 
+/* Overflow checked arithmetic, 1 for overflowed */
+#if (defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__)
+#define int_add_overflow(a, b, r) __builtin_add_overflow(a, b, r)
+#define int_sub_overflow(a, b, r) __builtin_sub_overflow(a, b, r)
+#define int_mul_overflow(a, b, r) __builtin_mul_overflow(a, b, r)
+#else
+static int int_add_overflow(const int64_t a, const int64_t b, int64_t *r)
+{
+    if (((b > 0) && (a > INT64_MAX - b)) || ((b < 0) && (a < INT64_MIN - b))) return 1;
+    *r = a + b;
+    return 0;
+}
+
+static int int_sub_overflow(const int64_t a, const int64_t b, int64_t *r)
+{
+    if (((b < 0) && (a > INT64_MAX + b)) || ((b > 0) && (a < INT64_MIN + b))) return 1;
+    *r = a - b;
+    return 0;
+}
+
+static int int_mul_overflow(const int64_t a, const int64_t b, int64_t *r)
+{
+    if (a > 0)
+    {
+        if ((b > 0) ? (a > INT64_MAX / b) : (b < INT64_MIN / a)) return 1;
+    }
+    else if (a < 0)
+    {
+        if ((b > 0) ? (a < INT64_MIN / b) : ((b != 0) && (b < INT64_MAX / a))) return 1;
+    }
+    *r = a * b;
+    return 0;
+}
+#endif
+
+int virtual_machine_object_int_arithmetic_value(int64_t *value_out, \
+        const int64_t value_left, const int64_t value_right, \
+        const uint32_t opcode)
+{
+    switch (opcode)
+    {
+        case OP_ADD: return int_add_overflow(value_left, value_right, value_out) != 0 ? 1 : 0;
+        case OP_SUB: return int_sub_overflow(value_left, value_right, value_out) != 0 ? 1 : 0;
+        case OP_MUL: return int_mul_overflow(value_left, value_right, value_out) != 0 ? 1 : 0;
+        case OP_ANDA: *value_out = value_left & value_right; return 0;
+        case OP_ORA: *value_out = value_left | value_right; return 0;
+        case OP_XORA: *value_out = value_left ^ value_right; return 0;
+        default: return 1;
+    }
+}
+
 /* add, sub, mul, div, mod */
 /* lshift, rshift */
 /* anda, ora, xora */
@@ -150,7 +233,7 @@ int virtual_machine_object_int_binary_arithmetic_shift_bitwise(struct virtual_ma
     char *bad_type_name;
     char op_literal[OP_LITERAL_LEN];
 
-    int value_left, value_right;
+    int64_t value_left, value_right, value_result;
 
     (void)vm;
 
@@ -159,7 +242,12 @@ int virtual_machine_object_int_binary_arithmetic_shift_bitwise(struct virtual_ma
     *object_out = NULL;
 
     /* Type check */
-    if (object_right->type != OBJECT_TYPE_INT)
+    if (object_right->type == OBJECT_TYPE_BIGINT)
+    {
+        return virtual_machine_object_bigint_binary_arithmetic_shift_bitwise(vm, \
+                object_out, object_left, object_right, opcode);
+    }
+    else if (object_right->type != OBJECT_TYPE_INT)
     {
         op_literal[0] = '\0';
         switch (opcode)
@@ -192,7 +280,7 @@ int virtual_machine_object_int_binary_arithmetic_shift_bitwise(struct virtual_ma
         {
             vm_err_update(vm->r, -VM_ERR_DIVIDE_BY_ZERO, \
                     "runtime error: divide by zero");
-            ret = -VM_ERR_DIVIDE_BY_ZERO; 
+            ret = -MULTIPLE_ERR_VM;
             goto fail; 
         }
     }
@@ -200,16 +288,51 @@ int virtual_machine_object_int_binary_arithmetic_shift_bitwise(struct virtual_ma
     value_left = ((struct virtual_machine_object_int *)(object_left->ptr))->value;
     value_right = ((struct virtual_machine_object_int *)(object_right->ptr))->value;
 
-    /* Perform operation */
+    if ((opcode == OP_LSHIFT || opcode == OP_RSHIFT) && (value_right < 0))
+    {
+        vm_err_update(vm->r, -VM_ERR_INVALID_OPERAND, \
+                "runtime error: negative shift count");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    /* Perform operation, the overflowed ones are done again in 'bigint' */
     switch (opcode)
     {
-        case OP_ADD: new_object = virtual_machine_object_int_new_with_value(vm, value_left + value_right); break;
-        case OP_SUB: new_object = virtual_machine_object_int_new_with_value(vm, value_left - value_right); break;
-        case OP_MUL: new_object = virtual_machine_object_int_new_with_value(vm, value_left * value_right); break;
-        case OP_DIV: new_object = virtual_machine_object_int_new_with_value(vm, value_left / value_right); break;
-        case OP_MOD: new_object = virtual_machine_object_int_new_with_value(vm, value_left % value_right); break;
-        case OP_LSHIFT: new_object = virtual_machine_object_int_new_with_value(vm, value_left << value_right); break;
-        case OP_RSHIFT: new_object = virtual_machine_object_int_new_with_value(vm, value_left >> value_right); break;
+        case OP_ADD:
+            if (int_add_overflow(value_left, value_right, &value_result) != 0) goto overflow;
+            new_object = virtual_machine_object_int_new_with_value(vm, value_result);
+            break;
+        case OP_SUB:
+            if (int_sub_overflow(value_left, value_right, &value_result) != 0) goto overflow;
+            new_object = virtual_machine_object_int_new_with_value(vm, value_result);
+            break;
+        case OP_MUL:
+            if (int_mul_overflow(value_left, value_right, &value_result) != 0) goto overflow;
+            new_object = virtual_machine_object_int_new_with_value(vm, value_result);
+            break;
+        /* INT64_MIN / -1 and INT64_MIN % -1 trap, neither is executed */
+        case OP_DIV:
+            if ((value_left == INT64_MIN) && (value_right == -1)) goto overflow;
+            new_object = virtual_machine_object_int_new_with_value(vm, value_left / value_right);
+            break;
+        case OP_MOD:
+            new_object = virtual_machine_object_int_new_with_value(vm, value_right == -1 ? 0 : value_left % value_right);
+            break;
+        case OP_LSHIFT:
+            if (value_left == 0) { value_result = 0; }
+            else
+            {
+                if (value_right >= 63) goto overflow;
+                value_result = (int64_t)((uint64_t)value_left << value_right);
+                if ((value_result >> value_right) != value_left) goto overflow;
+            }
+            new_object = virtual_machine_object_int_new_with_value(vm, value_result);
+            break;
+        case OP_RSHIFT:
+            new_object = virtual_machine_object_int_new_with_value(vm, \
+                    value_right >= 63 ? (value_left < 0 ? -1 : 0) : (value_left >> value_right));
+            break;
         case OP_ANDA: new_object = virtual_machine_object_int_new_with_value(vm, value_left & value_right); break;
         case OP_ORA: new_object = virtual_machine_object_int_new_with_value(vm, value_left | value_right); break;
         case OP_XORA: new_object = virtual_machine_object_int_new_with_value(vm, value_left ^ value_right); break;
@@ -227,8 +350,13 @@ int virtual_machine_object_int_binary_arithmetic_shift_bitwise(struct virtual_ma
     }
 
     *object_out = new_object;
-
+    goto done;
+overflow:
+    ret = virtual_machine_object_bigint_binary_arithmetic_shift_bitwise(vm, \
+            object_out, object_left, object_right, opcode);
+    goto done;
 fail:
+done:
     return ret;
 }
 
@@ -238,7 +366,7 @@ int virtual_machine_object_int_binary_equality_relational(struct virtual_machine
     int ret = 0;
     struct virtual_machine_object *new_object = NULL;
 
-    int value_left, value_right;
+    int64_t value_left, value_right;
 
     (void)vm;
 
@@ -250,7 +378,12 @@ int virtual_machine_object_int_binary_equality_relational(struct virtual_machine
     *object_out = NULL;
 
     /* Type check */
-    if (object_right->type != OBJECT_TYPE_INT)
+    if (object_right->type == OBJECT_TYPE_BIGINT)
+    {
+        return virtual_machine_object_bigint_binary_equality_relational(vm, \
+                object_out, object_left, object_right, opcode);
+    }
+    else if (object_right->type != OBJECT_TYPE_INT)
     {
         switch (opcode)
         {
@@ -319,6 +452,9 @@ int virtual_machine_object_int_unary(struct virtual_machine *vm, struct virtual_
     switch (opcode)
     {
         case OP_NEG:
+            /* -INT64_MIN */
+            if (((struct virtual_machine_object_int *)(object_src->ptr))->value == INT64_MIN)
+            { return virtual_machine_object_bigint_unary(vm, object_out, object_src, opcode); }
             new_object = virtual_machine_object_int_new_with_value( \
                     vm, \
                     -(((struct virtual_machine_object_int *)(object_src->ptr))->value));
@@ -388,7 +524,7 @@ int virtual_machine_object_int_convert( \
                     VIRTUAL_MACHINE_OBJECT_BOOL_VALUE_TRUE);
             break;
         case OBJECT_TYPE_STR:
-            str_len = sprintf(str, "%d", ((struct virtual_machine_object_int *)(object_src->ptr))->value);
+            str_len = sprintf(str, "%lld", (long long)((struct virtual_machine_object_int *)(object_src->ptr))->value);
             new_object = virtual_machine_object_str_new_with_value( \
                     vm, \
                     str, (size_t)str_len);
@@ -24,15 +24,16 @@
 
 struct virtual_machine_object;
 
+/* Promoted to 'bigint' on overflow */
 struct virtual_machine_object_int
 {
-    int value;
+    int64_t value;
 };
 
 /* new */
 struct virtual_machine_object *virtual_machine_object_int_new_with_value( \
         struct virtual_machine *vm, \
-        const int value);
+        const int64_t value);
 /* destroy */
 int virtual_machine_object_int_destroy( \
         struct virtual_machine *vm, \
@@ -45,10 +46,16 @@ struct virtual_machine_object *virtual_machine_object_int_clone( \
 int virtual_machine_object_int_print(const struct virtual_machine_object *object);
 
 /* get primitive value */
-int virtual_machine_object_int_get_primitive_value(const struct virtual_machine_object *object);
+int64_t virtual_machine_object_int_get_primitive_value(const struct virtual_machine_object *object);
+/* get primitive value as a C 'int' for indexes and counts, saturated to INT_MIN or INT_MAX */
+int virtual_machine_object_int_get_primitive_value_saturated(const struct virtual_machine_object *object);
+/* get primitive value as a count of stack items, 
+ * a runtime error if negative or more than 'limit' */
+int virtual_machine_object_int_get_count(struct virtual_machine *vm, \
+        size_t *count_out, const struct virtual_machine_object *object, const size_t limit);
 
 /* set primitive value */
-int virtual_machine_object_int_set_primitive_value(const struct virtual_machine_object *object, int value);
+int virtual_machine_object_int_set_primitive_value(const struct virtual_machine_object *object, int64_t value);
 
 /* convert */
 int virtual_machine_object_int_convert( \
@@ -57,6 +64,12 @@ int virtual_machine_object_int_convert( \
         const struct virtual_machine_object *object_src, \
         const uint32_t type);
 
+/* add, sub, mul, anda, ora, xora on the values, without objects, 
+ * 1 for a result out of the range or any other instrument */
+int virtual_machine_object_int_arithmetic_value(int64_t *value_out, \
+        const int64_t value_left, const int64_t value_right, \
+        const uint32_t opcode);
+
 /* add, sub, mul, div, mod */
 /* lshift, rshift */
 /* anda, ora, xora */
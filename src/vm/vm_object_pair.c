@@ -465,6 +465,7 @@ int virtual_machine_object_pair_car_set( \
     }
     object_pair = object_src_solved->ptr;
     object_pair_internal = object_pair->ptr_internal; 
+    gc_write_barrier(object_src_solved->object_table_item_ptr, object_member_solved->object_table_item_ptr);
 
     if (object_pair_internal->car != NULL)
     {
@@ -509,6 +510,7 @@ int virtual_machine_object_pair_cdr_set( \
     }
     object_pair = object_src_solved->ptr;
     object_pair_internal = object_pair->ptr_internal; 
+    gc_write_barrier(object_src_solved->object_table_item_ptr, object_member_solved->object_table_item_ptr);
 
     if (object_pair_internal->cdr != NULL)
     {
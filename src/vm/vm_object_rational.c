@@ -42,7 +42,7 @@
 /* Create a new native object with specified value */
 struct virtual_machine_object *virtual_machine_object_rational_new_with_value( \
         struct virtual_machine *vm, \
-        int sign, const unsigned int numerator, const unsigned int denominator)
+        int sign, const uint64_t numerator, const uint64_t denominator)
 {
     struct virtual_machine_object *new_object = NULL;
     struct virtual_machine_object_rational *new_object_rational = NULL;
@@ -115,7 +115,8 @@ int virtual_machine_object_rational_print(const struct virtual_machine_object *o
 
     object_rational = ((struct virtual_machine_object_rational *)(object->ptr));
     if (object_rational->sign != 0) { fputc('-', stdout); }
-    printf("%u/%u", object_rational->numerator, object_rational->denominator); 
+    printf("%llu/%llu", (unsigned long long)object_rational->numerator, \
+            (unsigned long long)object_rational->denominator);
 
     return 0;
 }
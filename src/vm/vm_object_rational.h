@@ -27,14 +27,14 @@ struct virtual_machine_object;
 struct virtual_machine_object_rational
 {
     int sign;
-    unsigned int numerator;
-    unsigned int denominator;
+    uint64_t numerator;
+    uint64_t denominator;
 };
 
 /* new */
 struct virtual_machine_object *virtual_machine_object_rational_new_with_value( \
         struct virtual_machine *vm, \
-        int sign, const unsigned int numerator, const unsigned int denominator);
+        int sign, const uint64_t numerator, const uint64_t denominator);
 /* destroy */
 int virtual_machine_object_rational_destroy( \
         struct virtual_machine *vm, \
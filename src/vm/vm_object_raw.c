@@ -28,9 +28,34 @@
 
 #include "vm_infrastructure.h"
 #include "vm_object_aio.h"
+#include "vm_gc.h"
 #include "vm_err.h"
 
 
+/* Internal Marker */
+static int virtual_machine_object_raw_internal_marker(void *object_internal)
+{
+    (void)object_internal;
+
+    /* Nothing inside a foreign payload */
+    return 0;
+}
+
+/* Internal Collector */
+static int virtual_machine_object_raw_internal_collector(void *object_internal, int *confirm)
+{
+    struct virtual_machine_object_raw_internal *object_raw_internal = object_internal;
+
+    *confirm = VIRTUAL_MACHINE_GARBAGE_COLLECT_CONFIRM; 
+
+    if (object_raw_internal->func_destroy != NULL) 
+    { object_raw_internal->func_destroy(object_raw_internal->ptr); }
+    virtual_machine_resource_free(object_raw_internal->vm->resource, object_raw_internal);
+
+    return 0;
+}
+
+
 /* Create a new raw object with specified value */
 struct virtual_machine_object *virtual_machine_object_raw_new_with_value(struct virtual_machine *vm, const char *name, const size_t len, const void *ptr)
 {
@@ -62,6 +87,9 @@ struct virtual_machine_object *virtual_machine_object_raw_new_with_value(struct
     new_object_raw->func_print = NULL;
     new_object_raw->func_eq = NULL;
 
+    new_object_raw->shared = 0;
+    new_object_raw->ptr_internal = NULL;
+
     if (_virtual_machine_object_ptr_set(new_object, new_object_raw) != 0)
     { goto fail; }
     new_object_raw = NULL;
@@ -87,8 +115,12 @@ int virtual_machine_object_raw_destroy(struct virtual_machine *vm, \
     if (object == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
     object_raw = (struct virtual_machine_object_raw *)object->ptr;
-    if (object_raw->func_destroy == NULL) return -MULTIPLE_ERR_NULL_PTR;
-    object_raw->func_destroy(object_raw->ptr);
+    if (object_raw->ptr_internal == NULL)
+    {
+        /* Owns the payload */
+        if (object_raw->func_destroy == NULL) return -MULTIPLE_ERR_NULL_PTR;
+        object_raw->func_destroy(object_raw->ptr);
+    }
     if (object_raw->name != NULL) virtual_machine_resource_free(vm->resource, object_raw->name);
     virtual_machine_resource_free(vm->resource, object_raw);
     _virtual_machine_object_destroy(vm, object);
@@ -96,6 +128,57 @@ int virtual_machine_object_raw_destroy(struct virtual_machine *vm, \
     return 0;
 }
 
+/* Hand the payload over to the garbage collector */
+int virtual_machine_object_raw_share(struct virtual_machine *vm, \
+        struct virtual_machine_object *object)
+{
+    struct virtual_machine_object_raw *object_raw = object->ptr;
+    struct virtual_machine_object_raw_internal *new_object_raw_internal = NULL;
+
+    if (object_raw->ptr_internal != NULL) return 0;
+
+    if ((new_object_raw_internal = (struct virtual_machine_object_raw_internal *)virtual_machine_resource_malloc( \
+                    vm->resource, sizeof(struct virtual_machine_object_raw_internal))) == NULL)
+    { return -MULTIPLE_ERR_MALLOC; }
+    new_object_raw_internal->ptr = object_raw->ptr;
+    new_object_raw_internal->func_destroy = object_raw->func_destroy;
+    new_object_raw_internal->vm = vm;
+
+    if (virtual_machine_resource_reference_register( \
+                vm->gc_stub, \
+                object, \
+                new_object_raw_internal, \
+                &virtual_machine_object_raw_internal_marker, \
+                &virtual_machine_object_raw_internal_collector) != 0)
+    {
+        virtual_machine_resource_free(vm->resource, new_object_raw_internal);
+        return -MULTIPLE_ERR_MALLOC;
+    }
+    object_raw->ptr_internal = new_object_raw_internal;
+
+    return 0;
+}
+
+/* Create a raw object with the same callbacks */
+static struct virtual_machine_object *virtual_machine_object_raw_new_like( \
+        struct virtual_machine *vm, const struct virtual_machine_object_raw *object_raw, void *ptr)
+{
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_raw *new_object_raw = NULL;
+
+    new_object = virtual_machine_object_raw_new_with_value(vm, object_raw->name, object_raw->len, ptr);
+    if (new_object == NULL) return NULL;
+    new_object_raw = (struct virtual_machine_object_raw *)new_object->ptr;
+
+    new_object_raw->func_destroy = object_raw->func_destroy;
+    new_object_raw->func_clone = object_raw->func_clone;
+    new_object_raw->func_print = object_raw->func_print;
+    new_object_raw->func_eq = object_raw->func_eq;
+    new_object_raw->shared = object_raw->shared;
+
+    return new_object;
+}
+
 /* Clone a raw object */
 struct virtual_machine_object *virtual_machine_object_raw_clone( \
         struct virtual_machine *vm, const struct virtual_machine_object *object)
@@ -103,25 +186,47 @@ struct virtual_machine_object *virtual_machine_object_raw_clone( \
     struct virtual_machine_object *new_object = NULL;
     struct virtual_machine_object_raw *object_raw = NULL;
     struct virtual_machine_object_raw *new_object_raw = NULL;
+
+    if ((object == NULL) || (object->ptr == NULL)) return NULL;
+
+    object_raw = (struct virtual_machine_object_raw *)object->ptr;
+    /* Not shared, or not handed over yet (an argument of external event) */
+    if ((object_raw->shared == 0) || (object_raw->ptr_internal == NULL))
+    {
+        return virtual_machine_object_raw_copy(vm, object);
+    }
+
+    if ((new_object = virtual_machine_object_raw_new_like(vm, object_raw, object_raw->ptr)) == NULL)
+    { return NULL; }
+    new_object_raw = (struct virtual_machine_object_raw *)new_object->ptr;
+    new_object_raw->ptr_internal = object_raw->ptr_internal;
+
+    return new_object;
+}
+
+/* Copy a raw object */
+struct virtual_machine_object *virtual_machine_object_raw_copy( \
+        struct virtual_machine *vm, const struct virtual_machine_object *object)
+{
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_raw *object_raw = NULL;
     void *new_ptr = NULL;
 
     if ((object == NULL) || (object->ptr == NULL)) return NULL;
 
     object_raw = (struct virtual_machine_object_raw *)object->ptr;
-    if (object_raw->func_destroy == NULL) return NULL;
+    if ((object_raw->func_destroy == NULL) || (object_raw->func_clone == NULL)) return NULL;
     if ((new_ptr = object_raw->func_clone(object_raw->ptr)) == NULL) return NULL;
-    new_object = virtual_machine_object_raw_new_with_value(vm, object_raw->name, object_raw->len, new_ptr);
-    if (new_object == NULL) 
+    if ((new_object = virtual_machine_object_raw_new_like(vm, object_raw, new_ptr)) == NULL) 
     {
-        object_raw->func_destroy(object_raw->ptr);
+        object_raw->func_destroy(new_ptr);
+        return NULL;
+    }
+    if ((object_raw->shared != 0) && (virtual_machine_object_raw_share(vm, new_object) != 0))
+    {
+        virtual_machine_object_raw_destroy(vm, new_object);
         return NULL;
     }
-    new_object_raw = (struct virtual_machine_object_raw *)new_object->ptr;
-
-    new_object_raw->func_destroy = object_raw->func_destroy;
-    new_object_raw->func_clone = object_raw->func_clone;
-    new_object_raw->func_print = object_raw->func_print;
-    new_object_raw->func_eq = object_raw->func_eq;
 
     return new_object;
 }
@@ -26,6 +26,16 @@
 struct virtual_machine_object;
 struct vm_err;
 
+/* Payload shared by raw objects, 
+ * destroyed by the garbage collector after the last reference dies */
+struct virtual_machine_object_raw_internal
+{
+    void *ptr;
+    int (*func_destroy)(const void *ptr);
+
+    struct virtual_machine *vm;
+};
+
 struct virtual_machine_object_raw
 {
     char *name;
@@ -37,6 +47,11 @@ struct virtual_machine_object_raw
     void *(*func_clone)(const void *ptr);
     int (*func_print)(const void *ptr);
     int (*func_eq)(const void *ptr_left, const void *ptr_right);
+
+    /* Clones share the payload instead of calling 'func_clone' */
+    int shared;
+    /* Created along with a shared raw object */
+    struct virtual_machine_object_raw_internal *ptr_internal;
 };
 
 /* new */
@@ -54,5 +69,16 @@ struct virtual_machine_object *virtual_machine_object_raw_clone( \
 /* print */
 int virtual_machine_object_raw_print(const struct virtual_machine_object *object);
 
+/* Hand the payload of a shared type over to the garbage collector, 
+ * done once right after the object is created, with GIL held */
+int virtual_machine_object_raw_share( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object *object);
+
+/* copy, always duplicates the payload with 'func_clone' */
+struct virtual_machine_object *virtual_machine_object_raw_copy( \
+        struct virtual_machine *vm, \
+        const struct virtual_machine_object *object);
+
 #endif
 
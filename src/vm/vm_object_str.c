@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 
 #include "crc32.h"
 
@@ -231,11 +232,11 @@ int virtual_machine_object_str_print(const struct virtual_machine_object *object
     return 0;
 }
 
-static int convert_str_to_int(struct virtual_machine *vm, int *value_out, char *str, size_t len)
+static int convert_str_to_int(struct virtual_machine *vm, int64_t *value_out, char *str, size_t len)
 {
     int ret = 0;
     int sign = 0;
-    int value = 0;
+    int64_t value = 0;
     int base = 10;
     int digit = 0;
     char *str_p = str, *str_endp = str + len;
@@ -362,7 +363,7 @@ int virtual_machine_object_str_convert(struct virtual_machine *vm, \
     struct virtual_machine_object *new_object = NULL;
     struct virtual_machine_object_str *object_str = NULL;
     struct virtual_machine_object_str_internal *object_str_internal = NULL;
-    int value;
+    int64_t value;
 
     (void)vm;
 
@@ -493,7 +494,7 @@ int virtual_machine_object_str_mul(struct virtual_machine *vm, \
     struct virtual_machine_object_str_internal *object_left_str_internal;
     char *new_str = NULL, *new_str_p;
     size_t new_str_len = 0;
-    int loop;
+    int64_t loop;
     char *bad_type_name;
 
     (void)vm;
@@ -524,6 +525,14 @@ int virtual_machine_object_str_mul(struct virtual_machine *vm, \
         ret = -MULTIPLE_ERR_VM;
         goto fail;
     }
+    if ((object_left_str_internal->len != 0) && \
+            ((uint64_t)((struct virtual_machine_object_int *)(object_right->ptr))->value > \
+             (uint64_t)(SIZE_MAX / object_left_str_internal->len - 1)))
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
 
     /* Construct the concatenated string */
     new_str_len = object_left_str_internal->len *
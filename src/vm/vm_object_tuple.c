@@ -28,9 +28,8 @@
 #include "vm_object_aio.h"
 #include "vm_err.h"
 
-int virtual_machine_object_tuple_append(struct virtual_machine_object *object, \
-        struct virtual_machine_object *object_new_sub, \
-        struct virtual_machine *vm);
+static int virtual_machine_object_tuple_unshare(struct virtual_machine *vm, \
+        struct virtual_machine_object_tuple *object_tuple);
 
 struct virtual_machine_object *virtual_machine_object_tuple_new( \
         struct virtual_machine *vm)
@@ -64,26 +63,35 @@ struct virtual_machine_object *virtual_machine_object_tuple_new( \
     return new_object;
 }
 
+/* Drop a reference to the node, 
+ * nodes no longer referenced are destroyed along the chain */
+static void virtual_machine_object_tuple_node_release( \
+        struct virtual_machine *vm, \
+        struct virtual_machine_object_tuple_node *object_tuple_node)
+{
+    struct virtual_machine_object_tuple_node *object_tuple_node_next;
+
+    while ((object_tuple_node != NULL) && (--object_tuple_node->refcount == 0))
+    {
+        object_tuple_node_next = object_tuple_node->next; 
+        virtual_machine_object_destroy(vm, object_tuple_node->ptr);
+        virtual_machine_resource_free(vm->resource, object_tuple_node);
+        object_tuple_node = object_tuple_node_next;
+    }
+}
+
 int virtual_machine_object_tuple_destroy( \
         struct virtual_machine *vm, \
         struct virtual_machine_object *object)
 {
     struct virtual_machine_object_tuple *object_tuple;
-    struct virtual_machine_object_tuple_node *object_tuple_node_cur, *object_tuple_node_next;
-    struct virtual_machine_object *virtual_machine_object_tuple_node_object;
 
     if (object == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
     object_tuple = (struct virtual_machine_object_tuple *)object->ptr;
-    object_tuple_node_cur = object_tuple->begin;
-
-    while (object_tuple_node_cur != NULL)
+    if (object_tuple != NULL)
     {
-        object_tuple_node_next = object_tuple_node_cur->next; 
-        virtual_machine_object_tuple_node_object = object_tuple_node_cur->ptr;
-        virtual_machine_object_destroy(vm, virtual_machine_object_tuple_node_object);
-        virtual_machine_resource_free(vm->resource, object_tuple_node_cur);
-        object_tuple_node_cur = object_tuple_node_next;
+        virtual_machine_object_tuple_node_release(vm, object_tuple->begin);
     }
 
     if (object->ptr != NULL) virtual_machine_resource_free(vm->resource, object->ptr);
@@ -92,45 +100,80 @@ int virtual_machine_object_tuple_destroy( \
     return 0;
 }
 
+/* Clones share the nodes, which are copied before modifying */
 struct virtual_machine_object *virtual_machine_object_tuple_clone( \
         struct virtual_machine *vm, \
         const struct virtual_machine_object *object)
 {
-    struct virtual_machine_object *new_object = NULL, *new_sub_object = NULL;
-    struct virtual_machine_object_tuple *object_tuple;
-    struct virtual_machine_object_tuple_node *object_tuple_node_cur, *object_tuple_node_next;
-    struct virtual_machine_object *virtual_machine_object_tuple_node_object;
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_tuple *object_tuple, *new_object_tuple;
 
     if (object == NULL) return NULL;
 
     if ((new_object = virtual_machine_object_tuple_new(vm)) == NULL)
-    {
-        goto fail;
-    }
+    { return NULL; }
 
     object_tuple = (struct virtual_machine_object_tuple *)object->ptr;
+    new_object_tuple = (struct virtual_machine_object_tuple *)new_object->ptr;
+
+    new_object_tuple->begin = object_tuple->begin;
+    new_object_tuple->end = object_tuple->end;
+    new_object_tuple->size = object_tuple->size;
+    if (new_object_tuple->begin != NULL) new_object_tuple->begin->refcount++;
+
+    return new_object;
+}
+
+/* Get private nodes before modifying if any node is shared */
+static int virtual_machine_object_tuple_unshare(struct virtual_machine *vm, \
+        struct virtual_machine_object_tuple *object_tuple)
+{
+    int ret = 0;
+    struct virtual_machine_object_tuple_node *object_tuple_node_cur;
+    struct virtual_machine_object_tuple_node *new_begin = NULL, *new_end = NULL, *new_node = NULL;
+
     object_tuple_node_cur = object_tuple->begin;
+    while ((object_tuple_node_cur != NULL) && (object_tuple_node_cur->refcount == 1))
+    {
+        object_tuple_node_cur = object_tuple_node_cur->next;
+    }
+    if (object_tuple_node_cur == NULL) return 0;
 
+    object_tuple_node_cur = object_tuple->begin;
     while (object_tuple_node_cur != NULL)
     {
-        object_tuple_node_next = object_tuple_node_cur->next; 
-        virtual_machine_object_tuple_node_object = object_tuple_node_cur->ptr;
-        if ((new_sub_object = virtual_machine_object_clone(vm, virtual_machine_object_tuple_node_object)) == NULL)
-        { goto fail; }
-        if (virtual_machine_object_tuple_append(new_object, new_sub_object, vm) != 0)
-        { goto fail; }
-        new_sub_object = NULL;
-        object_tuple_node_cur = object_tuple_node_next;
+        new_node = (struct virtual_machine_object_tuple_node *)virtual_machine_resource_malloc( \
+                vm->resource, sizeof(struct virtual_machine_object_tuple_node));
+        if (new_node == NULL)
+        {
+            VM_ERR_MALLOC(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+        new_node->next = NULL;
+        new_node->refcount = 1;
+        if ((new_node->ptr = virtual_machine_object_clone(vm, object_tuple_node_cur->ptr)) == NULL)
+        {
+            virtual_machine_resource_free(vm->resource, new_node);
+            VM_ERR_MALLOC(vm->r);
+            ret = -MULTIPLE_ERR_VM;
+            goto fail;
+        }
+        if (new_begin == NULL) { new_begin = new_node; }
+        else { new_end->next = new_node; }
+        new_end = new_node;
+        object_tuple_node_cur = object_tuple_node_cur->next;
     }
 
+    virtual_machine_object_tuple_node_release(vm, object_tuple->begin);
+    object_tuple->begin = new_begin; new_begin = NULL;
+    object_tuple->end = new_end;
+
     goto done;
 fail:
-    if (new_sub_object != NULL) virtual_machine_object_destroy(vm, new_sub_object);
-    new_sub_object = NULL;
-    if (new_object != NULL) virtual_machine_object_destroy(vm, new_object);
-    new_object = NULL;
 done:
-    return new_object;
+    virtual_machine_object_tuple_node_release(vm, new_begin);
+    return ret;
 }
 
 int virtual_machine_object_tuple_print(const struct virtual_machine_object *object)
@@ -194,6 +237,12 @@ int virtual_machine_object_tuple_append(struct virtual_machine_object *object, \
 
     if (object == NULL) return -MULTIPLE_ERR_NULL_PTR;
 
+    object_tuple = (struct virtual_machine_object_tuple *)object->ptr;
+
+    /* The last node might be shared */
+    if ((ret = virtual_machine_object_tuple_unshare(vm, object_tuple)) != 0)
+    { goto fail; }
+
     if ((ret = virtual_machine_variable_solve(&object_new_sub_solved, (struct virtual_machine_object *)object_new_sub, NULL, 1, vm)) != 0)
     { goto fail; }
 
@@ -207,8 +256,7 @@ int virtual_machine_object_tuple_append(struct virtual_machine_object *object, \
     new_object_tuple_node->ptr = (struct virtual_machine_object *)object_new_sub_solved;
     object_new_sub_solved = NULL;
     new_object_tuple_node->next = NULL;
-
-    object_tuple = (struct virtual_machine_object_tuple *)object->ptr;
+    new_object_tuple_node->refcount = 1;
 
     if (object_tuple->begin == NULL)
     {
@@ -329,7 +377,6 @@ int virtual_machine_object_tuple_ref_get(struct virtual_machine *vm, \
 
     struct virtual_machine_object *object_src_solved= NULL;
     struct virtual_machine_object *object_idx_solved= NULL;
-    struct virtual_machine_object_int *object_ref_index = NULL;
     int ref_index;
 
     *object_out = NULL;
@@ -354,8 +401,7 @@ int virtual_machine_object_tuple_ref_get(struct virtual_machine *vm, \
         goto fail; 
     }
 
-    object_ref_index = (struct virtual_machine_object_int *)object_idx_solved->ptr;
-    ref_index = object_ref_index->value;
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
 
     if ((ret = _virtual_machine_object_tuple_ref_get_by_raw_index(vm, object_out, object_src_solved, ref_index)) != 0)
     { goto fail; }
@@ -376,8 +422,6 @@ static int _virtual_machine_object_tuple_ref_set_by_raw_index(struct virtual_mac
     struct virtual_machine_object_tuple_node *tuple_node_cur = NULL;
     struct virtual_machine_object_tuple *object_tuple = NULL;
 
-    (void)vm;
-
     *object_out = NULL;
 
     object_tuple = (struct virtual_machine_object_tuple *)object_src->ptr;
@@ -398,6 +442,10 @@ static int _virtual_machine_object_tuple_ref_set_by_raw_index(struct virtual_mac
         goto fail; 
     }
 
+    /* Other tuples sharing the node should not see the change */
+    if ((ret = virtual_machine_object_tuple_unshare(vm, object_tuple)) != 0)
+    { goto fail; }
+
     tuple_node_cur = object_tuple->begin;
     while (tuple_node_cur != NULL)
     {
@@ -429,7 +477,6 @@ int virtual_machine_object_tuple_ref_set(struct virtual_machine *vm, struct virt
     struct virtual_machine_object *object_src_solved= NULL;
     struct virtual_machine_object *object_idx_solved= NULL;
     struct virtual_machine_object *object_value_solved = NULL;
-    struct virtual_machine_object_int *object_ref_index = NULL;
     int ref_index;
 
     *object_out = NULL;
@@ -456,8 +503,7 @@ int virtual_machine_object_tuple_ref_set(struct virtual_machine *vm, struct virt
         goto fail; 
     }
 
-    object_ref_index = (struct virtual_machine_object_int *)object_idx_solved->ptr;
-    ref_index = object_ref_index->value;
+    ref_index = virtual_machine_object_int_get_primitive_value_saturated(object_idx_solved);
 
     if ((ret = _virtual_machine_object_tuple_ref_set_by_raw_index(object_out, object_src_solved, ref_index, object_value_solved, vm)) != 0)
     { goto fail; }
@@ -472,3 +518,87 @@ done:
     return ret;
 }
 
+int virtual_machine_object_tuple_car(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src)
+{
+    int ret = 0;
+    struct virtual_machine_object *object_src_solved = NULL;
+
+    *object_out = NULL;
+
+    if ((ret = virtual_machine_variable_solve(&object_src_solved, (struct virtual_machine_object *)object_src, NULL, 1, vm)) != 0)
+    { goto fail; }
+
+    if (object_src_solved->type != OBJECT_TYPE_TUPLE)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail; 
+    }
+
+    if ((ret = _virtual_machine_object_tuple_ref_get_by_raw_index(vm, object_out, object_src_solved, 0)) != 0)
+    { goto fail; }
+
+fail:
+    if (object_src_solved != NULL) virtual_machine_object_destroy(vm, object_src_solved);
+    return ret;
+}
+
+/* The result shares the nodes after the first one with the source */
+int virtual_machine_object_tuple_cdr(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src)
+{
+    int ret = 0;
+    struct virtual_machine_object *object_src_solved = NULL;
+    struct virtual_machine_object *new_object = NULL;
+    struct virtual_machine_object_tuple *object_tuple, *new_object_tuple;
+
+    *object_out = NULL;
+
+    if ((ret = virtual_machine_variable_solve(&object_src_solved, (struct virtual_machine_object *)object_src, NULL, 1, vm)) != 0)
+    { goto fail; }
+
+    if (object_src_solved->type != OBJECT_TYPE_TUPLE)
+    {
+        vm_err_update(vm->r, -VM_ERR_UNSUPPORTED_OPERAND_TYPE, \
+                "runtime error: unsupported operand type");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail; 
+    }
+
+    object_tuple = (struct virtual_machine_object_tuple *)object_src_solved->ptr;
+    if (object_tuple->size == 0)
+    {
+        vm_err_update(vm->r, -VM_ERR_EMPTY_LIST, \
+                "runtime error: empty tuple has no element");
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    if ((new_object = virtual_machine_object_tuple_new(vm)) == NULL)
+    {
+        VM_ERR_MALLOC(vm->r);
+        ret = -MULTIPLE_ERR_VM;
+        goto fail;
+    }
+
+    /* Share the tail */
+    if (object_tuple->begin->next != NULL)
+    {
+        new_object_tuple = (struct virtual_machine_object_tuple *)new_object->ptr;
+        new_object_tuple->begin = object_tuple->begin->next;
+        new_object_tuple->end = object_tuple->end;
+        new_object_tuple->size = object_tuple->size - 1;
+        new_object_tuple->begin->refcount++;
+    }
+
+    *object_out = new_object;
+
+fail:
+    if (object_src_solved != NULL) virtual_machine_object_destroy(vm, object_src_solved);
+    return ret;
+}
+
@@ -24,10 +24,14 @@
 
 struct virtual_machine_object;
 
+/* Nodes are shared between clones of a tuple and the tuples made from its tail (cdr) */
 struct virtual_machine_object_tuple_node
 {
     struct virtual_machine_object *ptr;
     struct virtual_machine_object_tuple_node *next;
+
+    /* References from the previous node or from the beginning of tuples */
+    size_t refcount;
 };
 
 struct virtual_machine_object_tuple
@@ -52,6 +56,10 @@ int virtual_machine_object_tuple_size( \
         struct virtual_machine_object **object_out, \
         const struct virtual_machine_object *object_src);
 
+/* Takes 'object_new_sub', the nodes are copied first if any is shared */
+int virtual_machine_object_tuple_append(struct virtual_machine_object *object, \
+        struct virtual_machine_object *object_new_sub, \
+        struct virtual_machine *vm);
 int virtual_machine_object_tuple_make(struct virtual_machine *vm, \
         struct virtual_machine_object **object_out, \
         const struct virtual_machine_object *object_top, \
@@ -65,6 +73,12 @@ int virtual_machine_object_tuple_ref_set(struct virtual_machine *vm, \
         const struct virtual_machine_object *object_src, \
         const struct virtual_machine_object *object_idx, \
         const struct virtual_machine_object *object_value);
+int virtual_machine_object_tuple_car(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src);
+int virtual_machine_object_tuple_cdr(struct virtual_machine *vm, \
+        struct virtual_machine_object **object_out, \
+        const struct virtual_machine_object *object_src);
 
 #endif
 
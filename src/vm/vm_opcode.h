@@ -50,6 +50,13 @@ enum
 
     OP_FASTLIB_UPCASE, 
     OP_FASTLIB_DOWNCASE, 
+
+    OP_FASTLIB_BUFFER_NEW, 
+    OP_FASTLIB_BUFFER_GET, 
+    OP_FASTLIB_BUFFER_SET, 
+    OP_FASTLIB_BUFFER_SLICE, 
+    OP_FASTLIB_BUFFER_FIND, 
+    OP_FASTLIB_BUFFER_COMPARE, 
 };
 
 /* Opcode */
@@ -272,6 +279,21 @@ enum
 };
 #define OPCODE_COUNT (OP_FINAL)
 
+/* Superinstruments
+ * Fused from the hottest sequences of instruments on loading, kept beside
+ * the opcode of the first instrument of the sequence. The instruments
+ * following it are left as they are. */
+enum
+{
+    OP_FUSED_NONE = 0,
+    OP_FUSED_PUSH2,     /* push a; push b */
+    OP_FUSED_CMPJMPC,   /* eq|ne|l|g|le|ge; jmpc|jmpcr */
+    OP_FUSED_VARINC,    /* push x; push y; add|sub, before pop x */
+
+    OP_FUSED_FINAL,
+};
+#define OP_FUSED_COUNT (OP_FUSED_FINAL)
+
 #define OPERAND_TYPE_NIL 0
 #define OPERAND_TYPE_RES 1
 #define OPERAND_TYPE_NUM 2
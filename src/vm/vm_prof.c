@@ -0,0 +1,610 @@
+/* Virtual Machine : Profiler
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include "selfcheck.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(WINDOWS)
+#include <windows.h>
+#endif
+
+#include "multiple_err.h"
+
+#include "vm_opcode.h"
+#include "vm_types.h"
+#include "vm_infrastructure.h"
+#include "vm_cpu.h"
+#include "vm_err.h"
+#include "vm_prof.h"
+
+
+/* Monotonic clock in nanoseconds */
+static unsigned long long virtual_machine_prof_clock_ns(void)
+{
+#if defined(WINDOWS)
+    LARGE_INTEGER frequency, counter;
+
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (unsigned long long)(counter.QuadPart / frequency.QuadPart) * 1000000000ULL + \
+        (unsigned long long)(counter.QuadPart % frequency.QuadPart) * 1000000000ULL / (unsigned long long)frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+
+/* Profiler */
+
+struct virtual_machine_prof *virtual_machine_prof_new(void)
+{
+    struct virtual_machine_prof *new_prof = NULL;
+
+    if ((new_prof = (struct virtual_machine_prof *)malloc(sizeof(struct virtual_machine_prof))) == NULL)
+    { return NULL; }
+    memset(new_prof->op_counts, 0, sizeof(new_prof->op_counts));
+    memset(new_prof->op_ns, 0, sizeof(new_prof->op_ns));
+    if ((new_prof->pair_counts = (size_t *)calloc( \
+                    (size_t)OPCODE_COUNT * (size_t)OPCODE_COUNT, sizeof(size_t))) == NULL)
+    {
+        free(new_prof);
+        return NULL;
+    }
+    new_prof->pair_thread = NULL;
+    new_prof->pair_frame = NULL;
+    new_prof->pair_pc = 0;
+    new_prof->pair_opcode = OPCODE_COUNT;
+    new_prof->modules = NULL;
+    new_prof->module_last = NULL;
+
+    return new_prof;
+}
+
+int virtual_machine_prof_destroy(struct virtual_machine_prof *prof)
+{
+    struct virtual_machine_prof_module *prof_module_cur, *prof_module_next;
+
+    if (prof == NULL) return -MULTIPLE_ERR_NULL_PTR;
+
+    prof_module_cur = prof->modules;
+    while (prof_module_cur != NULL)
+    {
+        prof_module_next = prof_module_cur->next;
+        free(prof_module_cur->counts);
+        free(prof_module_cur);
+        prof_module_cur = prof_module_next;
+    }
+    free(prof->pair_counts);
+    free(prof);
+
+    return 0;
+}
+
+static struct virtual_machine_prof_module *virtual_machine_prof_module_get( \
+        struct virtual_machine_prof *prof, struct virtual_machine_module *module)
+{
+    struct virtual_machine_prof_module *prof_module_cur;
+
+    if ((prof->module_last != NULL) && (prof->module_last->module == module))
+    { return prof->module_last; }
+
+    prof_module_cur = prof->modules;
+    while (prof_module_cur != NULL)
+    {
+        if (prof_module_cur->module == module) break;
+        prof_module_cur = prof_module_cur->next;
+    }
+
+    if (prof_module_cur == NULL)
+    {
+        if ((prof_module_cur = (struct virtual_machine_prof_module *)malloc( \
+                        sizeof(struct virtual_machine_prof_module))) == NULL)
+        { return NULL; }
+        prof_module_cur->module = module;
+        prof_module_cur->size = module->text_section->size;
+        if ((prof_module_cur->counts = (size_t *)calloc( \
+                        prof_module_cur->size + 1, sizeof(size_t))) == NULL)
+        {
+            free(prof_module_cur);
+            return NULL;
+        }
+        prof_module_cur->next = prof->modules;
+        prof->modules = prof_module_cur;
+    }
+    prof->module_last = prof_module_cur;
+
+    return prof_module_cur;
+}
+
+int virtual_machine_prof_step(struct multiple_error *err, struct virtual_machine *vm)
+{
+    int ret;
+    struct virtual_machine_prof *prof = vm->prof;
+    struct virtual_machine_running_stack_frame *current_frame;
+    struct virtual_machine_prof_module *prof_module;
+    uint32_t opcode;
+    unsigned long long ns_start;
+
+    /* Nothing to count, leave it to the interpreter */
+    if ((vm->tp == NULL) || \
+            ((current_frame = vm->tp->running_stack->top) == NULL) || \
+            ((size_t)current_frame->pc >= current_frame->module->text_section->size))
+    { return virtual_machine_thread_step(err, vm); }
+
+    if ((prof_module = virtual_machine_prof_module_get(prof, current_frame->module)) == NULL)
+    { VM_ERR_MALLOC(vm->r); return -MULTIPLE_ERR_VM; }
+    prof_module->counts[current_frame->pc] += 1;
+    opcode = current_frame->module->text_section->instruments[current_frame->pc].opcode;
+
+    /* Only a fall through could be fused into a superinstrument */
+    if ((opcode < OPCODE_COUNT) && (prof->pair_opcode < OPCODE_COUNT) && \
+            (prof->pair_thread == vm->tp) && (prof->pair_frame == current_frame) && \
+            (prof->pair_pc + 1 == current_frame->pc))
+    { prof->pair_counts[(size_t)prof->pair_opcode * OPCODE_COUNT + opcode] += 1; }
+    prof->pair_thread = vm->tp;
+    prof->pair_frame = current_frame;
+    prof->pair_pc = current_frame->pc;
+    prof->pair_opcode = opcode;
+
+    ns_start = virtual_machine_prof_clock_ns();
+    ret = virtual_machine_thread_step(err, vm);
+    if (opcode < OPCODE_COUNT)
+    {
+        prof->op_counts[opcode] += 1;
+        prof->op_ns[opcode] += virtual_machine_prof_clock_ns() - ns_start;
+    }
+
+    return ret;
+}
+
+
+/* Resolving */
+
+int virtual_machine_prof_function(struct virtual_machine_module *module, uint32_t pc, \
+        const char **name, size_t *len)
+{
+    struct virtual_machine_export_section *export_section = module->export_section;
+    struct virtual_machine_data_section_item *data_section_item;
+    size_t idx;
+    int found = -1;
+
+    for (idx = 0; idx != export_section->size; idx++)
+    {
+        if ((export_section->exports[idx].instrument_number <= pc) && \
+                ((found == -1) || \
+                 (export_section->exports[idx].instrument_number > \
+                  export_section->exports[found].instrument_number)))
+        { found = (int)idx; }
+    }
+    if (found == -1) return -1;
+
+    data_section_item = module->data_section->items + export_section->exports[found].name;
+    *name = data_section_item->ptr;
+    *len = data_section_item->size;
+
+    return found;
+}
+
+uint32_t virtual_machine_prof_line(struct virtual_machine_module *module, uint32_t pc)
+{
+    struct virtual_machine_debug_section *debug_section = module->debug_section;
+    size_t idx, found = debug_section->size;
+
+    if (debug_section->debugs == NULL) return 0;
+    for (idx = 0; idx != debug_section->size; idx++)
+    {
+        if ((debug_section->debugs[idx].asm_ln <= pc) && \
+                ((found == debug_section->size) || \
+                 (debug_section->debugs[idx].asm_ln > debug_section->debugs[found].asm_ln)))
+        { found = idx; }
+    }
+    if (found == debug_section->size) return 0;
+
+    return debug_section->debugs[found].source_ln_start;
+}
+
+
+/* Reports */
+
+struct virtual_machine_prof_row
+{
+    struct virtual_machine_module *module;
+    const char *name;
+    size_t len;
+    /* The next instrument, of pairs */
+    const char *name_next;
+    size_t len_next;
+    uint32_t line;
+
+    size_t count;
+    unsigned long long ns;
+};
+
+struct virtual_machine_prof_report
+{
+    struct virtual_machine_prof_row *opcodes;
+    size_t opcodes_size;
+    struct virtual_machine_prof_row *pairs;
+    size_t pairs_size;
+    struct virtual_machine_prof_row *functions;
+    size_t functions_size;
+    struct virtual_machine_prof_row *lines;
+    size_t lines_size;
+};
+
+static int virtual_machine_prof_row_cmp(const void *a, const void *b)
+{
+    const struct virtual_machine_prof_row *row_a = a, *row_b = b;
+
+    if (row_a->count != row_b->count) return row_a->count < row_b->count ? 1 : -1;
+    return 0;
+}
+
+static int virtual_machine_prof_report_append(struct virtual_machine_prof_row **rows, \
+        size_t *size, size_t *capacity, struct virtual_machine_prof_row *row)
+{
+    struct virtual_machine_prof_row *new_rows;
+
+    if (*size == *capacity)
+    {
+        *capacity = (*capacity == 0) ? 64 : *capacity * 2;
+        if ((new_rows = (struct virtual_machine_prof_row *)realloc(*rows, \
+                        sizeof(struct virtual_machine_prof_row) * (*capacity))) == NULL)
+        { return -MULTIPLE_ERR_MALLOC; }
+        *rows = new_rows;
+    }
+    (*rows)[(*size)++] = *row;
+
+    return 0;
+}
+
+/* Functions and lines of a module, the instruments executed
+ * between the starts go to the one starting last */
+static int virtual_machine_prof_report_module(struct virtual_machine_prof_report *report, \
+        size_t *functions_capacity, size_t *lines_capacity, \
+        struct virtual_machine_prof_module *prof_module)
+{
+    int ret = 0;
+    struct virtual_machine_module *module = prof_module->module;
+    struct virtual_machine_export_section *export_section = module->export_section;
+    struct virtual_machine_debug_section *debug_section = module->debug_section;
+    struct virtual_machine_prof_row row;
+    size_t *function_of = NULL, *function_counts = NULL;
+    uint32_t *line_of = NULL, line_max = 0;
+    size_t *line_counts = NULL;
+    size_t idx, pc;
+
+    /* pc -> export, 'export_section->size' for none */
+    if ((function_of = (size_t *)malloc(sizeof(size_t) * (prof_module->size + 1))) == NULL)
+    { ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+    if ((function_counts = (size_t *)calloc(export_section->size + 1, sizeof(size_t))) == NULL)
+    { ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+    for (pc = 0; pc != prof_module->size; pc++) function_of[pc] = export_section->size;
+    for (idx = 0; idx != export_section->size; idx++)
+    {
+        pc = export_section->exports[idx].instrument_number;
+        if ((pc < prof_module->size) && (function_of[pc] == export_section->size))
+        { function_of[pc] = idx; }
+    }
+    for (pc = 1; pc < prof_module->size; pc++)
+    {
+        if (function_of[pc] == export_section->size) function_of[pc] = function_of[pc - 1];
+    }
+
+    /* pc -> line, 0 for unknown */
+    if ((line_of = (uint32_t *)calloc(prof_module->size + 1, sizeof(uint32_t))) == NULL)
+    { ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+    if (debug_section->debugs != NULL)
+    {
+        for (idx = 0; idx != debug_section->size; idx++)
+        {
+            pc = debug_section->debugs[idx].asm_ln;
+            if ((pc < prof_module->size) && (line_of[pc] == 0))
+            { line_of[pc] = debug_section->debugs[idx].source_ln_start; }
+            if (debug_section->debugs[idx].source_ln_start > line_max)
+            { line_max = debug_section->debugs[idx].source_ln_start; }
+        }
+    }
+    for (pc = 1; pc < prof_module->size; pc++)
+    {
+        if (line_of[pc] == 0) line_of[pc] = line_of[pc - 1];
+    }
+    if ((line_counts = (size_t *)calloc((size_t)line_max + 1, sizeof(size_t))) == NULL)
+    { ret = -MULTIPLE_ERR_MALLOC; goto fail; }
+
+    for (pc = 0; pc != prof_module->size; pc++)
+    {
+        function_counts[function_of[pc]] += prof_module->counts[pc];
+        line_counts[line_of[pc]] += prof_module->counts[pc];
+    }
+
+    memset(&row, 0, sizeof(row));
+    row.module = module;
+    for (idx = 0; idx != export_section->size + 1; idx++)
+    {
+        if (function_counts[idx] == 0) continue;
+        if (idx == export_section->size)
+        {
+            row.name = "(top)";
+            row.len = 5;
+        }
+        else
+        {
+            row.name = module->data_section->items[export_section->exports[idx].name].ptr;
+            row.len = module->data_section->items[export_section->exports[idx].name].size;
+        }
+        row.count = function_counts[idx];
+        if ((ret = virtual_machine_prof_report_append(&report->functions, \
+                        &report->functions_size, functions_capacity, &row)) != 0)
+        { goto fail; }
+    }
+    row.name = NULL;
+    row.len = 0;
+    for (idx = 0; idx != (size_t)line_max + 1; idx++)
+    {
+        if (line_counts[idx] == 0) continue;
+        row.line = (uint32_t)idx;
+        row.count = line_counts[idx];
+        if ((ret = virtual_machine_prof_report_append(&report->lines, \
+                        &report->lines_size, lines_capacity, &row)) != 0)
+        { goto fail; }
+    }
+
+fail:
+    if (function_of != NULL) free(function_of);
+    if (function_counts != NULL) free(function_counts);
+    if (line_of != NULL) free(line_of);
+    if (line_counts != NULL) free(line_counts);
+    return ret;
+}
+
+static void virtual_machine_prof_opcode_name(const char **name, size_t *len, uint32_t opcode)
+{
+    char *instrument_str;
+    size_t instrument_len;
+
+    if (virtual_machine_opcode_to_instrument(&instrument_str, &instrument_len, opcode) != 0)
+    {
+        *name = "(unknown)";
+        *len = 9;
+    }
+    else
+    {
+        *name = instrument_str;
+        *len = instrument_len;
+    }
+}
+
+static void virtual_machine_prof_report_uninit(struct virtual_machine_prof_report *report)
+{
+    if (report->opcodes != NULL) free(report->opcodes);
+    if (report->pairs != NULL) free(report->pairs);
+    if (report->functions != NULL) free(report->functions);
+    if (report->lines != NULL) free(report->lines);
+}
+
+static int virtual_machine_prof_report_init(struct virtual_machine_prof_report *report, \
+        struct virtual_machine_prof *prof)
+{
+    int ret = 0;
+    struct virtual_machine_prof_module *prof_module_cur;
+    struct virtual_machine_prof_row row;
+    size_t opcodes_capacity = 0, pairs_capacity = 0, functions_capacity = 0, lines_capacity = 0;
+    uint32_t opcode, opcode_next;
+
+    report->opcodes = report->pairs = report->functions = report->lines = NULL;
+    report->opcodes_size = report->pairs_size = report->functions_size = report->lines_size = 0;
+
+    memset(&row, 0, sizeof(row));
+    for (opcode = 0; opcode != OPCODE_COUNT; opcode++)
+    {
+        if (prof->op_counts[opcode] == 0) continue;
+        virtual_machine_prof_opcode_name(&row.name, &row.len, opcode);
+        row.count = prof->op_counts[opcode];
+        row.ns = prof->op_ns[opcode];
+        if ((ret = virtual_machine_prof_report_append(&report->opcodes, \
+                        &report->opcodes_size, &opcodes_capacity, &row)) != 0)
+        { goto fail; }
+    }
+
+    memset(&row, 0, sizeof(row));
+    for (opcode = 0; opcode != OPCODE_COUNT; opcode++)
+    {
+        for (opcode_next = 0; opcode_next != OPCODE_COUNT; opcode_next++)
+        {
+            row.count = prof->pair_counts[(size_t)opcode * OPCODE_COUNT + opcode_next];
+            if (row.count == 0) continue;
+            virtual_machine_prof_opcode_name(&row.name, &row.len, opcode);
+            virtual_machine_prof_opcode_name(&row.name_next, &row.len_next, opcode_next);
+            if ((ret = virtual_machine_prof_report_append(&report->pairs, \
+                            &report->pairs_size, &pairs_capacity, &row)) != 0)
+            { goto fail; }
+        }
+    }
+
+    prof_module_cur = prof->modules;
+    while (prof_module_cur != NULL)
+    {
+        if ((ret = virtual_machine_prof_report_module(report, \
+                        &functions_capacity, &lines_capacity, prof_module_cur)) != 0)
+        { goto fail; }
+        prof_module_cur = prof_module_cur->next;
+    }
+
+    if (report->opcodes_size != 0)
+    { qsort(report->opcodes, report->opcodes_size, sizeof(struct virtual_machine_prof_row), virtual_machine_prof_row_cmp); }
+    if (report->pairs_size != 0)
+    { qsort(report->pairs, report->pairs_size, sizeof(struct virtual_machine_prof_row), virtual_machine_prof_row_cmp); }
+    if (report->functions_size != 0)
+    { qsort(report->functions, report->functions_size, sizeof(struct virtual_machine_prof_row), virtual_machine_prof_row_cmp); }
+    if (report->lines_size != 0)
+    { qsort(report->lines, report->lines_size, sizeof(struct virtual_machine_prof_row), virtual_machine_prof_row_cmp); }
+
+    goto done;
+fail:
+    virtual_machine_prof_report_uninit(report);
+done:
+    return ret;
+}
+
+
+/* Text */
+
+int virtual_machine_prof_print(struct virtual_machine *vm, FILE *fp)
+{
+    int ret;
+    struct virtual_machine_prof_report report;
+    struct virtual_machine_prof_row *row;
+    size_t idx;
+
+    if (vm->prof == NULL) return 0;
+    if ((ret = virtual_machine_prof_report_init(&report, vm->prof)) != 0)
+    { return ret; }
+
+    fprintf(fp, "opcodes:%*s %12s %12s %8s\n", 16, "", "count", "us", "ns/op");
+    for (idx = 0; (idx != report.opcodes_size) && (idx != VIRTUAL_MACHINE_PROF_PRINT_MAX); idx++)
+    {
+        row = report.opcodes + idx;
+        fprintf(fp, "  %-22.*s %12lu %12llu %8llu\n", (int)row->len, row->name, \
+                (unsigned long)row->count, row->ns / 1000ULL, \
+                row->ns / (unsigned long long)row->count);
+    }
+    fprintf(fp, "pairs:%*s %12s\n", 18, "", "count");
+    for (idx = 0; (idx != report.pairs_size) && (idx != VIRTUAL_MACHINE_PROF_PRINT_MAX); idx++)
+    {
+        row = report.pairs + idx;
+        fprintf(fp, "  %.*s %-*.*s %12lu\n", (int)row->len, row->name, \
+                (int)(row->len < 21 ? 21 - row->len : 0), \
+                (int)row->len_next, row->name_next, (unsigned long)row->count);
+    }
+    fprintf(fp, "functions:%*s %12s\n", 14, "", "count");
+    for (idx = 0; (idx != report.functions_size) && (idx != VIRTUAL_MACHINE_PROF_PRINT_MAX); idx++)
+    {
+        row = report.functions + idx;
+        fprintf(fp, "  %s:%-*.*s %12lu\n", row->module->name, \
+                (int)(strlen(row->module->name) < 21 ? 21 - strlen(row->module->name) : 0), \
+                (int)row->len, row->name, (unsigned long)row->count);
+    }
+    fprintf(fp, "lines:%*s %12s\n", 18, "", "count");
+    for (idx = 0; (idx != report.lines_size) && (idx != VIRTUAL_MACHINE_PROF_PRINT_MAX); idx++)
+    {
+        row = report.lines + idx;
+        fprintf(fp, "  %s:%-*u %12lu\n", row->module->name, \
+                (int)(strlen(row->module->name) < 21 ? 21 - strlen(row->module->name) : 0), \
+                (unsigned int)row->line, (unsigned long)row->count);
+    }
+
+    virtual_machine_prof_report_uninit(&report);
+
+    return 0;
+}
+
+
+/* JSON */
+
+static void virtual_machine_prof_json_string(FILE *fp, const char *s, size_t len)
+{
+    size_t idx;
+    unsigned char ch;
+
+    fputc('\"', fp);
+    for (idx = 0; idx != len; idx++)
+    {
+        ch = (unsigned char)s[idx];
+        if ((ch == '\"') || (ch == '\\')) { fputc('\\', fp); fputc(ch, fp); }
+        else if (ch < 0x20) { fprintf(fp, "\\u%04x", (unsigned int)ch); }
+        else { fputc(ch, fp); }
+    }
+    fputc('\"', fp);
+}
+
+int virtual_machine_prof_write_json(struct virtual_machine *vm, const char *pathname)
+{
+    int ret = 0;
+    FILE *fp = NULL;
+    struct virtual_machine_prof_report report;
+    struct virtual_machine_prof_row *row;
+    size_t idx;
+
+    report.opcodes = report.pairs = report.functions = report.lines = NULL;
+    if (vm->prof == NULL) return 0;
+    if ((ret = virtual_machine_prof_report_init(&report, vm->prof)) != 0)
+    { return ret; }
+
+    if ((fp = fopen(pathname, "wb")) == NULL)
+    { ret = -MULTIPLE_ERR_STUB; goto fail; }
+
+    fputs("{\n  \"opcodes\": [", fp);
+    for (idx = 0; idx != report.opcodes_size; idx++)
+    {
+        row = report.opcodes + idx;
+        fprintf(fp, "%s\n    {\"opcode\": ", idx == 0 ? "" : ",");
+        virtual_machine_prof_json_string(fp, row->name, row->len);
+        fprintf(fp, ", \"count\": %lu, \"ns\": %llu}", (unsigned long)row->count, row->ns);
+    }
+    fputs("\n  ],\n  \"pairs\": [", fp);
+    for (idx = 0; idx != report.pairs_size; idx++)
+    {
+        row = report.pairs + idx;
+        fprintf(fp, "%s\n    {\"opcode\": ", idx == 0 ? "" : ",");
+        virtual_machine_prof_json_string(fp, row->name, row->len);
+        fputs(", \"next\": ", fp);
+        virtual_machine_prof_json_string(fp, row->name_next, row->len_next);
+        fprintf(fp, ", \"count\": %lu}", (unsigned long)row->count);
+    }
+    fputs("\n  ],\n  \"functions\": [", fp);
+    for (idx = 0; idx != report.functions_size; idx++)
+    {
+        row = report.functions + idx;
+        fprintf(fp, "%s\n    {\"module\": ", idx == 0 ? "" : ",");
+        virtual_machine_prof_json_string(fp, row->module->name, strlen(row->module->name));
+        fputs(", \"function\": ", fp);
+        virtual_machine_prof_json_string(fp, row->name, row->len);
+        fprintf(fp, ", \"count\": %lu}", (unsigned long)row->count);
+    }
+    fputs("\n  ],\n  \"lines\": [", fp);
+    for (idx = 0; idx != report.lines_size; idx++)
+    {
+        row = report.lines + idx;
+        fprintf(fp, "%s\n    {\"module\": ", idx == 0 ? "" : ",");
+        virtual_machine_prof_json_string(fp, row->module->name, strlen(row->module->name));
+        fprintf(fp, ", \"line\": %u, \"count\": %lu}", (unsigned int)row->line, (unsigned long)row->count);
+    }
+    fputs("\n  ]\n}\n", fp);
+
+    if (ferror(fp) != 0)
+    { ret = -MULTIPLE_ERR_STUB; goto fail; }
+
+fail:
+    if (fp != NULL)
+    {
+        if ((fclose(fp) != 0) && (ret == 0)) ret = -MULTIPLE_ERR_STUB;
+    }
+    virtual_machine_prof_report_uninit(&report);
+    return ret;
+}
+
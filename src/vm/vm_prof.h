@@ -0,0 +1,85 @@
+/* Virtual Machine : Profiler
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef _VM_PROF_H_
+#define _VM_PROF_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+#include "vm_opcode.h"
+#include "vm_infrastructure.h"
+
+/* Rows of every section in the text report */
+#define VIRTUAL_MACHINE_PROF_PRINT_MAX 32
+
+/* Instruments executed in a module, indexed by pc */
+struct virtual_machine_prof_module
+{
+    struct virtual_machine_module *module;
+    size_t *counts;
+    size_t size;
+
+    struct virtual_machine_prof_module *next;
+};
+
+struct virtual_machine_prof
+{
+    /* Indexed by opcode */
+    size_t op_counts[OPCODE_COUNT];
+    unsigned long long op_ns[OPCODE_COUNT];
+
+    /* Instruments falling through to the next one, indexed by 
+     * opcode * OPCODE_COUNT + the opcode of the next one */
+    size_t *pair_counts;
+    /* The instrument executed last */
+    struct virtual_machine_thread *pair_thread;
+    struct virtual_machine_running_stack_frame *pair_frame;
+    uint32_t pair_pc;
+    uint32_t pair_opcode;
+
+    struct virtual_machine_prof_module *modules;
+    /* The one used last */
+    struct virtual_machine_prof_module *module_last;
+};
+
+struct virtual_machine_prof *virtual_machine_prof_new(void);
+int virtual_machine_prof_destroy(struct virtual_machine_prof *prof);
+
+/* Execute the current thread as virtual_machine_thread_step() does,
+ * counting and timing the instrument */
+int virtual_machine_prof_step(struct multiple_error *err, struct virtual_machine *vm);
+
+/* The exported function the pc belongs to, the one starting last
+ * before it. -1 for none */
+int virtual_machine_prof_function(struct virtual_machine_module *module, uint32_t pc, \
+        const char **name, size_t *len);
+/* Source line of the pc through the debug section, 0 for unknown */
+uint32_t virtual_machine_prof_line(struct virtual_machine_module *module, uint32_t pc);
+
+/* Sections "opcodes", "pairs", "functions" and "lines", sorted by count */
+
+/* Text, for reading */
+int virtual_machine_prof_print(struct virtual_machine *vm, FILE *fp);
+/* JSON file */
+int virtual_machine_prof_write_json(struct virtual_machine *vm, const char *pathname);
+
+#endif
+
@@ -84,3 +84,9 @@ int virtual_machine_resource_pool_linked_feedback(void *pool_ptr)
     return linked_mem_pool_feedback(linked_mem_pool_ptr);
 }
 
+/* Statistics */
+int virtual_machine_resource_pool_linked_stat(void *pool_ptr, \
+        size_t *size_used, size_t *size_total, size_t *size_extra)
+{
+    return linked_mem_pool_stat(pool_ptr, size_used, size_total, size_extra);
+}
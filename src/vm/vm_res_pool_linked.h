@@ -38,6 +38,10 @@ int virtual_machine_resource_pool_linked_free(void *pool_ptr, void *ptr);
 int virtual_machine_resource_pool_linked_lack(void *pool_ptr);
 int virtual_machine_resource_pool_linked_feedback(void *pool_ptr);
 
+/* Statistics */
+int virtual_machine_resource_pool_linked_stat(void *pool_ptr, \
+        size_t *size_used, size_t *size_total, size_t *size_extra);
+
 #endif
 
 
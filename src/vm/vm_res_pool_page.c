@@ -73,3 +73,11 @@ int virtual_machine_resource_pool_page_lack(void *pool_ptr)
     return (paged_mem_pool_ptr->size_used > (paged_mem_pool_ptr->size_total >> 1)) ? 1 : 0;
 }
 
+/* Statistics */
+int virtual_machine_resource_pool_page_stat(void *pool_ptr, \
+        size_t *size_used, size_t *size_total, size_t *size_extra)
+{
+    /* Allocations out of the pool are not recorded */
+    *size_extra = 0;
+    return paged_mem_pool_stat(pool_ptr, size_used, size_total);
+}
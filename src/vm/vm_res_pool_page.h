@@ -37,5 +37,9 @@ int virtual_machine_resource_pool_page_free(void *pool_ptr, void *ptr);
 /* Lack */
 int virtual_machine_resource_pool_page_lack(void *pool_ptr);
 
+/* Statistics */
+int virtual_machine_resource_pool_page_stat(void *pool_ptr, \
+        size_t *size_used, size_t *size_total, size_t *size_extra);
+
 #endif
 
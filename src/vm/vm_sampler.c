@@ -0,0 +1,335 @@
+/* Virtual Machine : Sampling Profiler
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#include "selfcheck.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "multiple_err.h"
+
+#include "spinlock.h"
+#include "vm_infrastructure.h"
+#include "vm_prof.h"
+#include "vm_sampler.h"
+
+
+struct virtual_machine_sampler *virtual_machine_sampler_new(unsigned int interval_ms)
+{
+    struct virtual_machine_sampler *new_sampler = NULL;
+
+    if ((new_sampler = (struct virtual_machine_sampler *)malloc( \
+                    sizeof(struct virtual_machine_sampler))) == NULL)
+    { goto fail; }
+    new_sampler->pending = 0;
+    new_sampler->stop = 0;
+    new_sampler->interval_ms = interval_ms;
+    new_sampler->timer_started = 0;
+    new_sampler->buckets = NULL;
+    new_sampler->buckets_size = VIRTUAL_MACHINE_SAMPLER_BUCKETS_INIT;
+    new_sampler->stacks = 0;
+    new_sampler->samples = 0;
+    new_sampler->frames = NULL;
+    new_sampler->frames_capacity = 0;
+    if ((new_sampler->buckets = (struct virtual_machine_sampler_stack **)calloc( \
+                    new_sampler->buckets_size, sizeof(struct virtual_machine_sampler_stack *))) == NULL)
+    { goto fail; }
+    thread_event_init(&new_sampler->timer_event);
+
+    goto done;
+fail:
+    if (new_sampler != NULL)
+    {
+        free(new_sampler);
+        new_sampler = NULL;
+    }
+done:
+    return new_sampler;
+}
+
+int virtual_machine_sampler_destroy(struct virtual_machine_sampler *sampler)
+{
+    struct virtual_machine_sampler_stack *stack_cur, *stack_next;
+    size_t idx;
+
+    if (sampler == NULL) return -MULTIPLE_ERR_NULL_PTR;
+
+    virtual_machine_sampler_stop(sampler);
+    for (idx = 0; idx != sampler->buckets_size; idx++)
+    {
+        stack_cur = sampler->buckets[idx];
+        while (stack_cur != NULL)
+        {
+            stack_next = stack_cur->next;
+            free(stack_cur->frames);
+            free(stack_cur);
+            stack_cur = stack_next;
+        }
+    }
+    free(sampler->buckets);
+    if (sampler->frames != NULL) free(sampler->frames);
+    thread_event_uninit(&sampler->timer_event);
+    free(sampler);
+
+    return 0;
+}
+
+
+/* Timer */
+
+static void *virtual_machine_sampler_timer(void *data)
+{
+    struct virtual_machine_sampler *sampler = data;
+
+    while (sampler->stop == 0)
+    {
+        thread_event_wait(&sampler->timer_event, sampler->interval_ms);
+        if (sampler->stop != 0) break;
+        sampler->pending = 1;
+    }
+
+    return NULL;
+}
+
+int virtual_machine_sampler_start(struct virtual_machine_sampler *sampler)
+{
+    if (sampler->timer_started != 0) return 0;
+
+    sampler->stop = 0;
+    if (thread_create(&sampler->timer, virtual_machine_sampler_timer, sampler) != 0)
+    { return -MULTIPLE_ERR_INTERNAL; }
+    sampler->timer_started = 1;
+
+    return 0;
+}
+
+int virtual_machine_sampler_stop(struct virtual_machine_sampler *sampler)
+{
+    if (sampler->timer_started == 0) return 0;
+
+    sampler->stop = 1;
+    thread_event_signal(&sampler->timer_event);
+    thread_join(&sampler->timer);
+    sampler->timer_started = 0;
+    sampler->pending = 0;
+
+    return 0;
+}
+
+
+/* Sampling */
+
+static size_t virtual_machine_sampler_hash(uint32_t tid, \
+        struct virtual_machine_sampler_frame *frames, size_t depth)
+{
+    size_t hash = 2166136261U ^ (size_t)tid;
+    size_t idx;
+
+    for (idx = 0; idx != depth; idx++)
+    {
+        hash = (hash ^ ((size_t)frames[idx].module >> 4)) * 16777619U;
+        hash = (hash ^ (size_t)frames[idx].pc) * 16777619U;
+    }
+
+    return hash;
+}
+
+static int virtual_machine_sampler_buckets_grow(struct virtual_machine_sampler *sampler)
+{
+    struct virtual_machine_sampler_stack **new_buckets;
+    struct virtual_machine_sampler_stack *stack_cur, *stack_next;
+    size_t new_buckets_size = sampler->buckets_size * 2;
+    size_t idx;
+
+    if ((new_buckets = (struct virtual_machine_sampler_stack **)calloc( \
+                    new_buckets_size, sizeof(struct virtual_machine_sampler_stack *))) == NULL)
+    { return -MULTIPLE_ERR_MALLOC; }
+    for (idx = 0; idx != sampler->buckets_size; idx++)
+    {
+        stack_cur = sampler->buckets[idx];
+        while (stack_cur != NULL)
+        {
+            stack_next = stack_cur->next;
+            stack_cur->next = new_buckets[stack_cur->hash & (new_buckets_size - 1)];
+            new_buckets[stack_cur->hash & (new_buckets_size - 1)] = stack_cur;
+            stack_cur = stack_next;
+        }
+    }
+    free(sampler->buckets);
+    sampler->buckets = new_buckets;
+    sampler->buckets_size = new_buckets_size;
+
+    return 0;
+}
+
+/* Count the stack in 'sampler->frames' */
+static int virtual_machine_sampler_count(struct virtual_machine_sampler *sampler, \
+        uint32_t tid, size_t depth)
+{
+    struct virtual_machine_sampler_stack *stack_cur;
+    size_t hash = virtual_machine_sampler_hash(tid, sampler->frames, depth);
+
+    stack_cur = sampler->buckets[hash & (sampler->buckets_size - 1)];
+    while (stack_cur != NULL)
+    {
+        if ((stack_cur->hash == hash) && (stack_cur->tid == tid) && (stack_cur->depth == depth) && \
+                (memcmp(stack_cur->frames, sampler->frames, sizeof(struct virtual_machine_sampler_frame) * depth) == 0))
+        {
+            stack_cur->count += 1;
+            return 0;
+        }
+        stack_cur = stack_cur->next;
+    }
+
+    if (sampler->stacks + 1 > sampler->buckets_size)
+    {
+        if (virtual_machine_sampler_buckets_grow(sampler) != 0) return -MULTIPLE_ERR_MALLOC;
+    }
+    if ((stack_cur = (struct virtual_machine_sampler_stack *)malloc( \
+                    sizeof(struct virtual_machine_sampler_stack))) == NULL)
+    { return -MULTIPLE_ERR_MALLOC; }
+    if ((stack_cur->frames = (struct virtual_machine_sampler_frame *)malloc( \
+                    sizeof(struct virtual_machine_sampler_frame) * (depth + 1))) == NULL)
+    {
+        free(stack_cur);
+        return -MULTIPLE_ERR_MALLOC;
+    }
+    memcpy(stack_cur->frames, sampler->frames, sizeof(struct virtual_machine_sampler_frame) * depth);
+    stack_cur->tid = tid;
+    stack_cur->depth = depth;
+    stack_cur->hash = hash;
+    stack_cur->count = 1;
+    stack_cur->next = sampler->buckets[hash & (sampler->buckets_size - 1)];
+    sampler->buckets[hash & (sampler->buckets_size - 1)] = stack_cur;
+    sampler->stacks += 1;
+
+    return 0;
+}
+
+int virtual_machine_sampler_take(struct virtual_machine *vm)
+{
+    int ret;
+    struct virtual_machine_sampler *sampler = vm->sampler;
+    struct virtual_machine_thread *thread_cur;
+    struct virtual_machine_running_stack_frame *frame_cur;
+    struct virtual_machine_sampler_frame *new_frames;
+    size_t depth;
+
+    sampler->pending = 0;
+    sampler->samples += 1;
+
+    thread_cur = vm->threads->begin;
+    while (thread_cur != NULL)
+    {
+        if (thread_cur->running_stack->size > sampler->frames_capacity)
+        {
+            if ((new_frames = (struct virtual_machine_sampler_frame *)realloc(sampler->frames, \
+                            sizeof(struct virtual_machine_sampler_frame) * thread_cur->running_stack->size)) == NULL)
+            { return -MULTIPLE_ERR_MALLOC; }
+            sampler->frames = new_frames;
+            sampler->frames_capacity = thread_cur->running_stack->size;
+        }
+
+        depth = 0;
+        frame_cur = thread_cur->running_stack->bottom;
+        while ((frame_cur != NULL) && (depth != sampler->frames_capacity))
+        {
+            sampler->frames[depth].module = frame_cur->module;
+            /* The callers are at the instrument after the call */
+            sampler->frames[depth].pc = ((frame_cur->next != NULL) && (frame_cur->pc != 0)) ? \
+                                        frame_cur->pc - 1 : frame_cur->pc;
+            depth++;
+            frame_cur = frame_cur->next;
+        }
+        if ((depth != 0) && \
+                ((ret = virtual_machine_sampler_count(sampler, thread_cur->tid, depth)) != 0))
+        { return ret; }
+
+        thread_cur = thread_cur->next;
+    }
+
+    return 0;
+}
+
+
+/* Folded stacks */
+
+/* Spaces and semicolons separate the stacks and the frames */
+static void virtual_machine_sampler_write_name(FILE *fp, const char *name, size_t len)
+{
+    size_t idx;
+
+    for (idx = 0; idx != len; idx++)
+    {
+        fputc(((name[idx] == ';') || (name[idx] == ' ') || \
+                    (name[idx] == '\n')) ? '_' : name[idx], fp);
+    }
+}
+
+int virtual_machine_sampler_write(struct virtual_machine *vm, const char *pathname)
+{
+    int ret = 0;
+    FILE *fp = NULL;
+    struct virtual_machine_sampler *sampler = vm->sampler;
+    struct virtual_machine_sampler_stack *stack_cur;
+    struct virtual_machine_module *module;
+    const char *name;
+    size_t idx, frame_idx, len;
+
+    if (sampler == NULL) return 0;
+
+    if ((fp = fopen(pathname, "wb")) == NULL)
+    { ret = -MULTIPLE_ERR_STUB; goto fail; }
+
+    for (idx = 0; idx != sampler->buckets_size; idx++)
+    {
+        stack_cur = sampler->buckets[idx];
+        while (stack_cur != NULL)
+        {
+            fprintf(fp, "thread-%u", (unsigned int)stack_cur->tid);
+            for (frame_idx = 0; frame_idx != stack_cur->depth; frame_idx++)
+            {
+                module = stack_cur->frames[frame_idx].module;
+                fputc(';', fp);
+                virtual_machine_sampler_write_name(fp, module->name, strlen(module->name));
+                fputc('`', fp);
+                if (virtual_machine_prof_function(module, stack_cur->frames[frame_idx].pc, &name, &len) < 0)
+                { fputs("(top)", fp); }
+                else
+                { virtual_machine_sampler_write_name(fp, name, len); }
+                fprintf(fp, ":%u", (unsigned int)virtual_machine_prof_line(module, stack_cur->frames[frame_idx].pc));
+            }
+            fprintf(fp, " %lu\n", (unsigned long)stack_cur->count);
+            stack_cur = stack_cur->next;
+        }
+    }
+
+    if (ferror(fp) != 0)
+    { ret = -MULTIPLE_ERR_STUB; goto fail; }
+
+fail:
+    if (fp != NULL)
+    {
+        if ((fclose(fp) != 0) && (ret == 0)) ret = -MULTIPLE_ERR_STUB;
+    }
+    return ret;
+}
+
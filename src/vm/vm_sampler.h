@@ -0,0 +1,83 @@
+/* Virtual Machine : Sampling Profiler
+   Copyright(C) 2013-2014 Cheryl Natsu
+
+   This file is part of multiple - Multiple Paradigm Language Emulator
+
+   multiple is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   multiple is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   */
+
+#ifndef _VM_SAMPLER_H_
+#define _VM_SAMPLER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "spinlock.h"
+#include "vm_infrastructure.h"
+
+#define VIRTUAL_MACHINE_SAMPLER_BUCKETS_INIT 256
+
+struct virtual_machine_sampler_frame
+{
+    struct virtual_machine_module *module;
+    uint32_t pc;
+};
+
+/* A distinct stack of a thread and the times it was seen */
+struct virtual_machine_sampler_stack
+{
+    uint32_t tid;
+    struct virtual_machine_sampler_frame *frames; /* The bottom first */
+    size_t depth;
+    size_t hash;
+    size_t count;
+
+    struct virtual_machine_sampler_stack *next;
+};
+
+struct virtual_machine_sampler
+{
+    /* Raised by the timer, taken by the workers holding the GIL */
+    volatile int pending;
+    volatile int stop;
+    unsigned int interval_ms;
+    thread_handle_t timer;
+    thread_event_t timer_event;
+    int timer_started;
+
+    struct virtual_machine_sampler_stack **buckets;
+    size_t buckets_size;
+    size_t stacks;
+    size_t samples;
+
+    /* For the stack being walked */
+    struct virtual_machine_sampler_frame *frames;
+    size_t frames_capacity;
+};
+
+struct virtual_machine_sampler *virtual_machine_sampler_new(unsigned int interval_ms);
+int virtual_machine_sampler_destroy(struct virtual_machine_sampler *sampler);
+
+int virtual_machine_sampler_start(struct virtual_machine_sampler *sampler);
+int virtual_machine_sampler_stop(struct virtual_machine_sampler *sampler);
+
+/* Record the running stacks of all the threads, with the GIL held */
+int virtual_machine_sampler_take(struct virtual_machine *vm);
+
+/* Folded stacks, a line for each distinct one:
+ * "thread-<tid>;<module>`<function>:<line>;... <count>" */
+int virtual_machine_sampler_write(struct virtual_machine *vm, const char *pathname);
+
+#endif
+
@@ -33,6 +33,27 @@ int virtual_machine_startup_init(struct virtual_machine_startup *startup)
     startup->items[VIRTUAL_MACHINE_STARTUP_MEM_ITEM_REFERENCE].type = VIRTUAL_MACHINE_STARTUP_MEM_OBJECTS_TYPE_DEFAULT;
     startup->items[VIRTUAL_MACHINE_STARTUP_MEM_ITEM_REFERENCE].size = VIRTUAL_MACHINE_STARTUP_MEM_OBJECTS_SIZE_DEFAULT;
     startup->keep_dll = 0;
+    startup->workers = VIRTUAL_MACHINE_STARTUP_WORKERS_DEFAULT;
+    startup->time_slice = VIRTUAL_MACHINE_STARTUP_TIME_SLICE_DEFAULT;
+    startup->time_slice_max = VIRTUAL_MACHINE_STARTUP_TIME_SLICE_MAX_DEFAULT;
+    startup->priority = VIRTUAL_MACHINE_STARTUP_PRIORITY_DEFAULT;
+    startup->gc_slice_work = VIRTUAL_MACHINE_STARTUP_GC_SLICE_WORK_DEFAULT;
+    startup->gc_slice_us = VIRTUAL_MACHINE_STARTUP_GC_SLICE_US_DEFAULT;
+    startup->gc_threads = VIRTUAL_MACHINE_STARTUP_GC_THREADS_DEFAULT;
+    startup->gc_concurrent_sweep = VIRTUAL_MACHINE_STARTUP_GC_CONCURRENT_SWEEP_DEFAULT;
+    startup->gc_generational = VIRTUAL_MACHINE_STARTUP_GC_GENERATIONAL_DEFAULT;
+    startup->gc_eden = VIRTUAL_MACHINE_STARTUP_GC_EDEN_DEFAULT;
+    startup->gc_promote_age = VIRTUAL_MACHINE_STARTUP_GC_PROMOTE_AGE_DEFAULT;
+    startup->gc_old_growth = VIRTUAL_MACHINE_STARTUP_GC_OLD_GROWTH_DEFAULT;
+    startup->heap_limit = VIRTUAL_MACHINE_STARTUP_HEAP_LIMIT_DEFAULT;
+    startup->stats = VIRTUAL_MACHINE_STARTUP_STATS_DEFAULT;
+    startup->stats_json = NULL;
+    startup->optimize = VIRTUAL_MACHINE_STARTUP_OPTIMIZE_DEFAULT;
+    startup->block_cache = VIRTUAL_MACHINE_STARTUP_BLOCK_CACHE_DEFAULT;
+    startup->prof = VIRTUAL_MACHINE_STARTUP_PROF_DEFAULT;
+    startup->prof_json = NULL;
+    startup->sample = NULL;
+    startup->sample_interval = VIRTUAL_MACHINE_STARTUP_SAMPLE_INTERVAL_DEFAULT;
 
     return 0;
 }
@@ -110,3 +131,213 @@ int virtual_machine_startup_memory_usage(struct virtual_machine_startup *startup
     return -1;
 }
 
+int virtual_machine_startup_workers(struct virtual_machine_startup *startup, \
+        const char *workers)
+{
+    long workers_number = 0;
+
+    if (workers == NULL) return -1;
+
+    if (size_atoin(&workers_number, workers, strlen(workers)) != 0) return -1;
+    if ((workers_number < 1) || (workers_number > VIRTUAL_MACHINE_STARTUP_WORKERS_MAX)) return -1;
+
+    startup->workers = (size_t)workers_number;
+
+    return 0;
+}
+
+/* Both of the limits are optional (NULL for unchanged) */
+int virtual_machine_startup_time_slice(struct virtual_machine_startup *startup, \
+        const char *time_slice, const char *time_slice_max)
+{
+    long time_slice_number = (long)startup->time_slice;
+    long time_slice_max_number = (long)startup->time_slice_max;
+
+    if (time_slice != NULL)
+    {
+        if (size_atoin(&time_slice_number, time_slice, strlen(time_slice)) != 0) return -1;
+        if (time_slice_number < 1) return -1;
+    }
+    if (time_slice_max != NULL)
+    {
+        if (size_atoin(&time_slice_max_number, time_slice_max, strlen(time_slice_max)) != 0) return -1;
+    }
+    else if (time_slice_max_number < time_slice_number)
+    {
+        /* Only the minimum specified, keep adaptive range */
+        time_slice_max_number = time_slice_number;
+    }
+    if (time_slice_max_number < time_slice_number) return -1;
+
+    startup->time_slice = (size_t)time_slice_number;
+    startup->time_slice_max = (size_t)time_slice_max_number;
+
+    return 0;
+}
+
+int virtual_machine_startup_priority(struct virtual_machine_startup *startup, \
+        const char *priority)
+{
+    long priority_number = 0;
+
+    if (priority == NULL) return -1;
+
+    if (size_atoin(&priority_number, priority, strlen(priority)) != 0) return -1;
+    if ((priority_number < 0) || (priority_number > VIRTUAL_MACHINE_STARTUP_PRIORITY_MAX)) return -1;
+
+    startup->priority = (int)priority_number;
+
+    return 0;
+}
+
+int virtual_machine_startup_gc_slice(struct virtual_machine_startup *startup, \
+        const char *gc_slice)
+{
+    long gc_slice_number = 0;
+    size_t gc_slice_len;
+    int in_us = 0;
+
+    if (gc_slice == NULL) return -1;
+
+    gc_slice_len = strlen(gc_slice);
+    if ((gc_slice_len > 2) && (strcmp(gc_slice + gc_slice_len - 2, "us") == 0))
+    {
+        in_us = 1;
+        gc_slice_len -= 2;
+    }
+    if (size_atoin(&gc_slice_number, gc_slice, gc_slice_len) != 0) return -1;
+    if (gc_slice_number < 1) return -1;
+
+    if (in_us != 0)
+    {
+        startup->gc_slice_work = 0;
+        startup->gc_slice_us = (size_t)gc_slice_number;
+    }
+    else
+    {
+        startup->gc_slice_work = (size_t)gc_slice_number;
+        startup->gc_slice_us = 0;
+    }
+
+    return 0;
+}
+
+int virtual_machine_startup_gc_threads(struct virtual_machine_startup *startup, \
+        const char *gc_threads)
+{
+    long gc_threads_number = 0;
+
+    if (gc_threads == NULL) return -1;
+
+    if (size_atoin(&gc_threads_number, gc_threads, strlen(gc_threads)) != 0) return -1;
+    if ((gc_threads_number < 1) || (gc_threads_number > VIRTUAL_MACHINE_STARTUP_GC_THREADS_MAX)) return -1;
+
+    startup->gc_threads = (size_t)gc_threads_number;
+
+    return 0;
+}
+
+int virtual_machine_startup_gc(struct virtual_machine_startup *startup, \
+        const char *gc)
+{
+    if (gc == NULL) return -1;
+
+    if (strcmp(gc, "major") == 0)
+    { startup->gc_generational = 0; }
+    else if (strcmp(gc, "generational") == 0)
+    { startup->gc_generational = 1; }
+    else
+    { return -1; }
+
+    return 0;
+}
+
+int virtual_machine_startup_gc_generational(struct virtual_machine_startup *startup, \
+        const char *eden, const char *promote_age, const char *old_growth)
+{
+    long eden_number = (long)startup->gc_eden;
+    long promote_age_number = (long)startup->gc_promote_age;
+    long old_growth_number = (long)startup->gc_old_growth;
+
+    if (eden != NULL)
+    {
+        if (size_atoin(&eden_number, eden, strlen(eden)) != 0) return -1;
+        if (eden_number < 1) return -1;
+    }
+    if (promote_age != NULL)
+    {
+        if (size_atoin(&promote_age_number, promote_age, strlen(promote_age)) != 0) return -1;
+        if (promote_age_number < 1) return -1;
+    }
+    if (old_growth != NULL)
+    {
+        if (size_atoin(&old_growth_number, old_growth, strlen(old_growth)) != 0) return -1;
+        if (old_growth_number < 1) return -1;
+    }
+
+    startup->gc_eden = (size_t)eden_number;
+    startup->gc_promote_age = (size_t)promote_age_number;
+    startup->gc_old_growth = (size_t)old_growth_number;
+
+    return 0;
+}
+
+int virtual_machine_startup_heap_limit(struct virtual_machine_startup *startup, \
+        const char *heap_limit)
+{
+    long heap_limit_number = 0;
+    size_t heap_limit_len;
+    unsigned int shift = 0;
+
+    if (heap_limit == NULL) return -1;
+
+    heap_limit_len = strlen(heap_limit);
+    if (heap_limit_len > 1)
+    {
+        switch (heap_limit[heap_limit_len - 1])
+        {
+            case 'k': case 'K': shift = 10; break;
+            case 'm': case 'M': shift = 20; break;
+            case 'g': case 'G': shift = 30; break;
+            default: break;
+        }
+        if (shift != 0) heap_limit_len--;
+    }
+    if (size_atoin(&heap_limit_number, heap_limit, heap_limit_len) != 0) return -1;
+    if (heap_limit_number < 1) return -1;
+    if ((size_t)heap_limit_number > ((size_t)(-1) >> shift)) return -1;
+
+    startup->heap_limit = (size_t)heap_limit_number << shift;
+
+    return 0;
+}
+
+int virtual_machine_startup_block_cache(struct virtual_machine_startup *startup, \
+        const char *block_cache)
+{
+    long block_cache_number = 0;
+
+    if (block_cache == NULL) return -1;
+
+    if (size_atoin(&block_cache_number, block_cache, strlen(block_cache)) != 0) return -1;
+    if (block_cache_number < 1) return -1;
+
+    startup->block_cache = (size_t)block_cache_number;
+
+    return 0;
+}
+
+int virtual_machine_startup_sample_interval(struct virtual_machine_startup *startup, \
+        const char *sample_interval)
+{
+    long sample_interval_number = 0;
+
+    if (sample_interval == NULL) return -1;
+
+    if (size_atoin(&sample_interval_number, sample_interval, strlen(sample_interval)) != 0) return -1;
+    if (sample_interval_number < 1) return -1;
+
+    startup->sample_interval = (size_t)sample_interval_number;
+
+    return 0;
+}
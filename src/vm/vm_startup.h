@@ -60,10 +60,84 @@ struct virtual_machine_startup_item
     size_t size;
 };
 
+/* Number of OS threads running the scheduler */
+#define VIRTUAL_MACHINE_STARTUP_WORKERS_DEFAULT 1
+#define VIRTUAL_MACHINE_STARTUP_WORKERS_MAX 64
+
+/* Time slice (number of instruments) of a thread, 
+ * starts from the minimum and grows for CPU-bound threads */
+#define VIRTUAL_MACHINE_STARTUP_TIME_SLICE_DEFAULT 100
+#define VIRTUAL_MACHINE_STARTUP_TIME_SLICE_MAX_DEFAULT 3200
+
+/* Priority of threads, 0 (low), 1 (normal) or 2 (high) */
+#define VIRTUAL_MACHINE_STARTUP_PRIORITY_DEFAULT 1
+#define VIRTUAL_MACHINE_STARTUP_PRIORITY_MAX 2
+
+/* Budget of a slice of incremental GC, in units of work (an object 
+ * traced or swept, or a reference scanned) or in microseconds, 
+ * both 0 for stop-the-world collections */
+#define VIRTUAL_MACHINE_STARTUP_GC_SLICE_WORK_DEFAULT 0
+#define VIRTUAL_MACHINE_STARTUP_GC_SLICE_US_DEFAULT 0
+
+/* Threads marking a major GC (the collecting one included), 
+ * and sweeping by a background thread */
+#define VIRTUAL_MACHINE_STARTUP_GC_THREADS_DEFAULT 1
+#define VIRTUAL_MACHINE_STARTUP_GC_THREADS_MAX 64
+#define VIRTUAL_MACHINE_STARTUP_GC_CONCURRENT_SWEEP_DEFAULT 0
+
+/* Generational policy, minor GC when eden holds 'eden' objects, 
+ * objects survived 'promote age' collections move to survivor, 
+ * major GC when survivor and permanent grow by 'old growth' percent */
+#define VIRTUAL_MACHINE_STARTUP_GC_GENERATIONAL_DEFAULT 0
+#define VIRTUAL_MACHINE_STARTUP_GC_EDEN_DEFAULT 10000
+#define VIRTUAL_MACHINE_STARTUP_GC_PROMOTE_AGE_DEFAULT 10
+#define VIRTUAL_MACHINE_STARTUP_GC_OLD_GROWTH_DEFAULT 100
+
+/* Bytes the sources may hand out in total, 0 for unlimited */
+#define VIRTUAL_MACHINE_STARTUP_HEAP_LIMIT_DEFAULT 0
+
+/* Statistics printed to stderr, and written as JSON, when the program exits */
+#define VIRTUAL_MACHINE_STARTUP_STATS_DEFAULT 0
+
+/* Level of the IR optimizer run on loading modules, 0 for none,
+ * superinstruments are fused from level 1 */
+#define VIRTUAL_MACHINE_STARTUP_OPTIMIZE_DEFAULT 0
+
+/* Entries of an instrument before the block starting there gets decoded, 
+ * 0 for interpreting only */
+#define VIRTUAL_MACHINE_STARTUP_BLOCK_CACHE_DEFAULT 0
+
+/* Per-opcode, function and line profile on exit */
+#define VIRTUAL_MACHINE_STARTUP_PROF_DEFAULT 0
+
+/* Milliseconds between the samples of the running stacks */
+#define VIRTUAL_MACHINE_STARTUP_SAMPLE_INTERVAL_DEFAULT 1
+
 struct virtual_machine_startup
 {
     struct virtual_machine_startup_item items[VIRTUAL_MACHINE_STARTUP_MEM_TYPE_COUNT];
     int keep_dll;
+    size_t workers;
+    size_t time_slice;
+    size_t time_slice_max;
+    int priority;
+    size_t gc_slice_work;
+    size_t gc_slice_us;
+    size_t gc_threads;
+    int gc_concurrent_sweep;
+    int gc_generational;
+    size_t gc_eden;
+    size_t gc_promote_age;
+    size_t gc_old_growth;
+    size_t heap_limit;
+    int stats;
+    const char *stats_json;
+    int optimize;
+    size_t block_cache;
+    int prof;
+    const char *prof_json;
+    const char *sample;
+    size_t sample_interval;
 };
 
 int virtual_machine_startup_init(struct virtual_machine_startup *startup);
@@ -71,5 +145,39 @@ int virtual_machine_startup_init(struct virtual_machine_startup *startup);
 int virtual_machine_startup_memory_usage(struct virtual_machine_startup *startup, \
         const char *mem_item, const char *mem_type, const char *mem_size);
 
+int virtual_machine_startup_workers(struct virtual_machine_startup *startup, \
+        const char *workers);
+
+int virtual_machine_startup_time_slice(struct virtual_machine_startup *startup, \
+        const char *time_slice, const char *time_slice_max);
+
+int virtual_machine_startup_priority(struct virtual_machine_startup *startup, \
+        const char *priority);
+
+/* "<num>" for objects, "<num>us" for microseconds */
+int virtual_machine_startup_gc_slice(struct virtual_machine_startup *startup, \
+        const char *gc_slice);
+
+int virtual_machine_startup_gc_threads(struct virtual_machine_startup *startup, \
+        const char *gc_threads);
+
+/* "major" or "generational" */
+int virtual_machine_startup_gc(struct virtual_machine_startup *startup, \
+        const char *gc);
+
+/* All of the values are optional (NULL for unchanged) */
+int virtual_machine_startup_gc_generational(struct virtual_machine_startup *startup, \
+        const char *eden, const char *promote_age, const char *old_growth);
+
+/* "<num>" in bytes, with an optional suffix "k", "m" or "g" */
+int virtual_machine_startup_heap_limit(struct virtual_machine_startup *startup, \
+        const char *heap_limit);
+
+int virtual_machine_startup_block_cache(struct virtual_machine_startup *startup, \
+        const char *block_cache);
+
+int virtual_machine_startup_sample_interval(struct virtual_machine_startup *startup, \
+        const char *sample_interval);
+
 #endif
 
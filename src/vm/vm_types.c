@@ -62,6 +62,8 @@ static struct virtual_machine_object_type_item virtual_machine_object_type_item[
     {OBJECT_TYPE_SYMBOL, "symbol"},
     {OBJECT_TYPE_ENV, "env"},
     {OBJECT_TYPE_ENV_ENT, "envent"},
+    {OBJECT_TYPE_BUFFER, "buffer"},
+    {OBJECT_TYPE_BIGINT, "bigint"},
     {OBJECT_TYPE_FINAL, NULL},
 };
 
@@ -53,6 +53,8 @@ enum virtual_machine_object_type_id
     OBJECT_TYPE_SYMBOL = 25,
     OBJECT_TYPE_ENV = 26,
     OBJECT_TYPE_ENV_ENT = 27,
+    OBJECT_TYPE_BUFFER = 28,
+    OBJECT_TYPE_BIGINT = 29,
     OBJECT_TYPE_FINAL,
 };
 